@@ -204,6 +204,7 @@ CTX.INPUT['common'] = """
  RecoveryProtoMessageBuilder.cpp
  DefaultTupleSerializer.cpp
  StringRef.cpp
+ SharedMemoryRing.cpp
 """
 
 CTX.INPUT['data-migration'] = """
@@ -212,6 +213,8 @@ CTX.INPUT['data-migration'] = """
  typeAttributeMap.cpp
  utils.cpp
  postgres.cpp
+ tableExporter.cpp
+ tableLoader.cpp
 """
 
 CTX.INPUT['execution'] = """
@@ -221,9 +224,12 @@ CTX.INPUT['execution'] = """
 
 CTX.INPUT['executors'] = """
  abstractexecutor.cpp
+ compiledpredicate.cpp
  deleteexecutor.cpp
  distinctexecutor.cpp
  executorutil.cpp
+ flathashaggregator.cpp
+ hashjoinexecutor.cpp
  indexscanexecutor.cpp
  insertexecutor.cpp
  upsertexecutor.cpp
@@ -254,6 +260,7 @@ CTX.INPUT['plannodes'] = """
  aggregatenode.cpp
  deletenode.cpp
  distinctnode.cpp
+ hashjoinnode.cpp
  indexscannode.cpp
  insertnode.cpp
  upsertnode.cpp
@@ -292,6 +299,7 @@ CTX.INPUT['storage'] = """
  PersistentTableUndoDeleteAction.cpp
  PersistentTableUndoInsertAction.cpp
  PersistentTableUndoUpdateAction.cpp
+ PersistentTableUndoTruncateAction.cpp
  StreamedTableStats.cpp
  streamedtable.cpp
  table.cpp
@@ -309,6 +317,7 @@ CTX.INPUT['storage'] = """
 CTX.INPUT['streaming'] = """
  WindowIterator.cpp
  WindowTableTemp.cpp
+ WindowAggregate.cpp
  TupleWindow.cpp
  TimeWindow.cpp
 """
@@ -328,6 +337,9 @@ CTX.INPUT['logging'] = """
  JNILogProxy.cpp
  LogManager.cpp
  AriesLogProxy.cpp
+ AriesLogWriter.cpp
+ AriesReplayLog.cpp
+ AriesRedoPipeline.cpp
  Logrecord.cpp
 """
  
@@ -353,6 +365,9 @@ CTX.TESTS['catalog'] = """
 
 CTX.TESTS['logging'] = """
  logging_test
+ aries_log_writer_test
+ aries_replay_log_test
+ aries_redo_pipeline_test
 """
 
 CTX.TESTS['common'] = """
@@ -363,10 +378,22 @@ CTX.TESTS['common'] = """
  nvalue_test
  tupleschema_test
  tabletuple_test
+ latency_histogram_test
+ shared_memory_ring_test
 """
 
 CTX.TESTS['execution'] = """
  engine_test
+ trigger_batch_test
+ pipelined_fragment_test
+"""
+
+CTX.TESTS['executors'] = """
+ compiledpredicate_test
+ flathashaggregator_test
+ hashjoin_test
+ orderby_test
+ pipeline_test
 """
 
 CTX.TESTS['expressions'] = """
@@ -385,10 +412,12 @@ CTX.TESTS['storage'] = """
  filter_test
  mmap_persistent_table_test
  persistent_table_log_test
+ read_write_tracker_test
  serialize_test
  StreamedTable_test
  table_and_indexes_test
  table_test
+ tableiterator_test
  tabletuple_export_test
  TupleStreamWrapper_test
 """
@@ -398,6 +427,11 @@ CTX.TESTS['streaming'] = """
  timewindow_test
 """
 
+CTX.TESTS['data-migration'] = """
+ table_exporter_test
+ table_loader_test
+"""
+
 # these are incomplete and out of date. need to be replaced
 # CTX.TESTS['expressions'] = """expserialize_test expression_test"""
 
@@ -427,6 +461,9 @@ if CTX.ANTICACHE_BUILD:
 
     if CTX.ANTICACHE_REVERSIBLE_LRU:
         CTX.CPPFLAGS += " -DANTICACHE_REVERSIBLE_LRU"
+
+    if CTX.ANTICACHE_CLOCK:
+        CTX.CPPFLAGS += " -DANTICACHE_CLOCK"
         
     if CTX.ANTICACHE_DRAM:
         CTX.CPPFLAGS += " -DANTICACHE_DRAM"
@@ -441,7 +478,9 @@ if CTX.ANTICACHE_BUILD:
     CTX.INPUT['anticache'] = """
         EvictedTupleAccessException.cpp
         UnknownBlockAccessException.cpp
+        AntiCacheBlockCodec.cpp
         AntiCacheDB.cpp
+        AntiCacheReader.cpp
         AntiCacheEvictionManager.cpp
         EvictionIterator.cpp
         EvictedTable.cpp
@@ -449,6 +488,8 @@ if CTX.ANTICACHE_BUILD:
     
     CTX.TESTS['anticache'] = """
         anticachedb_test
+        anticache_block_codec_test
+        anticache_reader_test
         berkeleydb_test
         anticache_eviction_manager_test
     """
@@ -43,6 +43,7 @@ class BuildContext:
         self.STORAGE_MMAP = False
         self.ANTICACHE_BUILD = True
         self.ANTICACHE_REVERSIBLE_LRU = True
+        self.ANTICACHE_CLOCK = False
         self.ANTICACHE_NVM = False
         self.ANTICACHE_DRAM = False
         self.ARIES= True
@@ -56,7 +57,7 @@ class BuildContext:
                 self.COVERAGE = True
             if arg.startswith("STORAGE_MMAP="):
                 parts = arg.split("=")
-                if len(parts) > 1 and not (parts[1].startswith("${")): self.STORAGE_MMAP = bool(parts[1])
+                if len(parts) > 1 and not (parts[1].startswith("${")): self.STORAGE_MMAP = (parts[1].lower() == "true")
             if arg.startswith("STORAGE_MMAP_FILE_SIZE="):
                 parts = arg.split("=")
                 if len(parts) > 1 and not (parts[1].startswith("${")): self.STORAGE_MMAP_FILE_SIZE = long(parts[1])
@@ -65,26 +66,30 @@ class BuildContext:
                 if len(parts) > 1 and not (parts[1].startswith("${")): self.STORAGE_MMAP_SYNC_FREQUENCY = long(parts[1])
             if arg.startswith("ARIES="):
                 parts = arg.split("=")
-                if len(parts) > 1 and not (parts[1].startswith("${")): self.ARIES = bool(parts[1])
+                if len(parts) > 1 and not (parts[1].startswith("${")): self.ARIES = (parts[1].lower() == "true")
             if arg.startswith("ANTICACHE_ENABLE="):
                 parts = arg.split("=")
-                if len(parts) > 1 and not (parts[1].startswith("${")): self.ANTICACHE_ENABLE = bool(parts[1])
+                if len(parts) > 1 and not (parts[1].startswith("${")): self.ANTICACHE_ENABLE = (parts[1].lower() == "true")
             if arg.startswith("ANTICACHE_REVERSIBLE_LRU="):
                 parts = arg.split("=")
                 if len(parts) > 1 and not parts[1].startswith("${"): 
-                    self.MMAP_STORAGE = bool(parts[1])
+                    self.MMAP_STORAGE = (parts[1].lower() == "true")
             if arg.startswith("ANTICACHE_BUILD="):
                 parts = arg.split("=")
                 if len(parts) > 1 and not parts[1].startswith("${"):
-                    self.ANTICACHE_BUILD = bool(parts[1])
+                    self.ANTICACHE_BUILD = (parts[1].lower() == "true")
             if arg.startswith("ANTICACHE_REVERSIBLE_LRU="):
                 parts = arg.split("=")
                 if len(parts) > 1 and not parts[1].startswith("${"):
-                    self.ANTICACHE_REVERSIBLE_LRU = bool(parts[1])
+                    self.ANTICACHE_REVERSIBLE_LRU = (parts[1].lower() == "true")
+            if arg.startswith("ANTICACHE_CLOCK="):
+                parts = arg.split("=")
+                if len(parts) > 1 and not parts[1].startswith("${"):
+                    self.ANTICACHE_CLOCK = (parts[1].lower() == "true")
             if arg.startswith("ANTICACHE_NVM="):
                 parts = arg.split("=")
                 if len(parts) > 1 and not parts[1].startswith("${"):
-                    self.ANTICACHE_NVM = bool(parts[1])
+                    self.ANTICACHE_NVM = (parts[1].lower() == "true")
                 
             if arg.startswith("LOG_LEVEL="):
                 parts = arg.split("=")
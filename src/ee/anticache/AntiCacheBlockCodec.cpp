@@ -0,0 +1,259 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "anticache/AntiCacheBlockCodec.h"
+#include <string.h>
+#include <vector>
+
+namespace voltdb {
+
+static const NoneBlockCodec noneCodec;
+static const LZBlockCodec lzCodec;
+
+const AntiCacheBlockCodec* AntiCacheBlockCodec::forId(uint8_t id) {
+    switch (id) {
+        case CODEC_NONE:
+            return &noneCodec;
+        case CODEC_LZ:
+            return &lzCodec;
+        default:
+            return NULL;
+    }
+}
+
+char* AntiCacheBlockCodec::encode(const AntiCacheBlockCodec *codec, const char *data, size_t length, size_t &encodedLength) {
+    char *encoded = new char[HEADER_SIZE + length];
+    uint8_t id = CODEC_NONE;
+    size_t payloadLength = 0;
+    if (codec != NULL && codec->id() != CODEC_NONE) {
+        // only worth it if it gets smaller
+        payloadLength = codec->compress(data, length, encoded + HEADER_SIZE, length);
+        if (payloadLength > 0 && payloadLength < length) {
+            id = codec->id();
+        }
+    }
+    if (id == CODEC_NONE) {
+        payloadLength = noneCodec.compress(data, length, encoded + HEADER_SIZE, length);
+    }
+
+    const uint32_t uncompressedLength = static_cast<uint32_t>(length);
+    encoded[0] = static_cast<char>(id);
+    memcpy(encoded + 1, &uncompressedLength, sizeof(uncompressedLength));
+    encodedLength = HEADER_SIZE + payloadLength;
+    return encoded;
+}
+
+char* AntiCacheBlockCodec::decode(const char *data, size_t length, size_t &decodedLength) {
+    if (length < HEADER_SIZE) {
+        return NULL;
+    }
+    const AntiCacheBlockCodec *codec = forId(static_cast<uint8_t>(data[0]));
+    if (codec == NULL) {
+        return NULL;
+    }
+    uint32_t uncompressedLength;
+    memcpy(&uncompressedLength, data + 1, sizeof(uncompressedLength));
+    // a corrupt header must not make us allocate whatever it says, but
+    // blocks are evicted in whatever size the caller asks for, so the
+    // payload itself is the only bound
+    if (uncompressedLength > codec->maxUncompressedLength(length - HEADER_SIZE)) {
+        return NULL;
+    }
+
+    char *decoded = new char[uncompressedLength];
+    if (!codec->decompress(data + HEADER_SIZE, length - HEADER_SIZE, decoded, uncompressedLength)) {
+        delete [] decoded;
+        return NULL;
+    }
+    decodedLength = uncompressedLength;
+    return decoded;
+}
+
+size_t NoneBlockCodec::compress(const char *in, size_t length, char *out, size_t capacity) const {
+    if (length > capacity) {
+        return 0;
+    }
+    memcpy(out, in, length);
+    return length;
+}
+
+bool NoneBlockCodec::decompress(const char *in, size_t length, char *out, size_t uncompressedLength) const {
+    if (length != uncompressedLength) {
+        return false;
+    }
+    memcpy(out, in, length);
+    return true;
+}
+
+size_t NoneBlockCodec::maxUncompressedLength(size_t length) const {
+    return length;
+}
+
+// ------------------------------------------------------------------
+// LZ
+// ------------------------------------------------------------------
+
+static const int LZ_HASH_LOG = 14;
+static const size_t LZ_MAX_LITERALS = 1 << 5;
+static const size_t LZ_MAX_OFFSET = 1 << 13;
+static const size_t LZ_MAX_MATCH = (1 << 8) + (1 << 3);
+
+static inline uint32_t lzHash(const uint8_t *p) {
+    const uint32_t next = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+    return (next * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+/*
+ * A control byte below 32 starts a run of that many literals plus one.
+ * Otherwise its top three bits are the match length minus two (7 means
+ * another byte follows with the rest), and its low five bits and the
+ * next byte are the distance back minus one.
+ */
+size_t LZBlockCodec::compress(const char *in, size_t length, char *out, size_t capacity) const {
+    const uint8_t *input = reinterpret_cast<const uint8_t*>(in);
+    uint8_t *output = reinterpret_cast<uint8_t*>(out);
+    if (length == 0 || capacity == 0) {
+        return 0;
+    }
+
+    // position + 1 of the last three bytes with each hash, 0 for none
+    std::vector<uint32_t> table(1 << LZ_HASH_LOG, 0);
+    size_t ip = 0;
+    size_t op = 1; // the length of the first literal run goes in front of it
+    size_t literals = 0;
+
+    while (ip < length) {
+        if (ip + 2 < length) {
+            const uint32_t hash = lzHash(input + ip);
+            const size_t ref = table[hash];
+            table[hash] = static_cast<uint32_t>(ip + 1);
+
+            const size_t distance = ip - ref; // the distance back minus one
+            if (ref != 0 && distance < LZ_MAX_OFFSET &&
+                    input[ref - 1] == input[ip] &&
+                    input[ref] == input[ip + 1] &&
+                    input[ref + 1] == input[ip + 2]) {
+                const size_t maxLength = (length - ip < LZ_MAX_MATCH) ? length - ip : LZ_MAX_MATCH;
+                size_t matched = 3;
+                while (matched < maxLength && input[ref - 1 + matched] == input[ip + matched]) {
+                    matched++;
+                }
+                if (op + 4 > capacity) {
+                    return 0;
+                }
+
+                // close the literal run, or take back the byte kept for it
+                if (literals > 0) {
+                    output[op - literals - 1] = static_cast<uint8_t>(literals - 1);
+                } else {
+                    op--;
+                }
+                const size_t code = matched - 2;
+                if (code < 7) {
+                    output[op++] = static_cast<uint8_t>((distance >> 8) + (code << 5));
+                } else {
+                    output[op++] = static_cast<uint8_t>((distance >> 8) + (7 << 5));
+                    output[op++] = static_cast<uint8_t>(code - 7);
+                }
+                output[op++] = static_cast<uint8_t>(distance & 0xff);
+                literals = 0;
+                op++;
+
+                ip += matched;
+                continue;
+            }
+        }
+
+        if (op + 2 > capacity) {
+            return 0;
+        }
+        output[op++] = input[ip++];
+        if (++literals == LZ_MAX_LITERALS) {
+            output[op - literals - 1] = static_cast<uint8_t>(literals - 1);
+            literals = 0;
+            op++;
+        }
+    }
+
+    if (literals > 0) {
+        output[op - literals - 1] = static_cast<uint8_t>(literals - 1);
+    } else {
+        op--;
+    }
+    return op;
+}
+
+bool LZBlockCodec::decompress(const char *in, size_t length, char *out, size_t uncompressedLength) const {
+    const uint8_t *input = reinterpret_cast<const uint8_t*>(in);
+    uint8_t *output = reinterpret_cast<uint8_t*>(out);
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < length) {
+        const size_t control = input[ip++];
+        if (control < LZ_MAX_LITERALS) {
+            const size_t run = control + 1;
+            if (ip + run > length || op + run > uncompressedLength) {
+                return false;
+            }
+            memcpy(output + op, input + ip, run);
+            ip += run;
+            op += run;
+            continue;
+        }
+
+        size_t matched = control >> 5;
+        size_t distance = (control & 0x1f) << 8;
+        if (matched == 7) {
+            if (ip >= length) {
+                return false;
+            }
+            matched += input[ip++];
+        }
+        if (ip >= length) {
+            return false;
+        }
+        distance += input[ip++];
+        matched += 2;
+        if (distance >= op || op + matched > uncompressedLength) {
+            return false;
+        }
+        // byte by byte, the match may overlap what it produces
+        const uint8_t *ref = output + op - distance - 1;
+        for (size_t i = 0; i < matched; i++) {
+            output[op + i] = ref[i];
+        }
+        op += matched;
+    }
+    return op == uncompressedLength;
+}
+
+size_t LZBlockCodec::maxUncompressedLength(size_t length) const {
+    // nothing expands more than a chain of the longest back references,
+    // three bytes each
+    return (length / 3 + 1) * LZ_MAX_MATCH;
+}
+
+}
@@ -0,0 +1,118 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREANTICACHEBLOCKCODEC_H
+#define HSTOREANTICACHEBLOCKCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Compresses evicted blocks before the AntiCacheDB stores them. Every
+ * stored block starts with a header holding the id of the codec that
+ * wrote it and the uncompressed size, so blocks written with different
+ * codecs can be read back side by side, and a new codec only needs an
+ * id of its own in forId().
+ */
+class AntiCacheBlockCodec {
+    public:
+        enum CodecId {
+            CODEC_NONE = 0,
+            CODEC_LZ = 1
+        };
+
+        /** codec id (1 byte) and uncompressed size (4 bytes) */
+        static const size_t HEADER_SIZE = 5;
+
+        virtual ~AntiCacheBlockCodec() {}
+
+        virtual uint8_t id() const = 0;
+
+        /**
+         * Compress length bytes into out, which has room for capacity
+         * bytes. Returns the compressed size, or 0 if it would not fit.
+         */
+        virtual size_t compress(const char *in, size_t length, char *out, size_t capacity) const = 0;
+
+        /**
+         * Decompress into out, which has room for exactly the uncompressed
+         * size. Returns false if the input is corrupt.
+         */
+        virtual bool decompress(const char *in, size_t length, char *out, size_t uncompressedLength) const = 0;
+
+        /** The most that length bytes of compressed input can decompress to */
+        virtual size_t maxUncompressedLength(size_t length) const = 0;
+
+        /** The codec with the given id, or NULL for an unknown one */
+        static const AntiCacheBlockCodec* forId(uint8_t id);
+
+        /**
+         * Encode a block with the codec, header first, into a new array
+         * the caller deletes. Falls back to CODEC_NONE when the block does
+         * not get smaller.
+         */
+        static char* encode(const AntiCacheBlockCodec *codec, const char *data, size_t length, size_t &encodedLength);
+
+        /**
+         * Decode a stored block into a new array the caller deletes.
+         * Returns NULL if it is corrupt, claims to be larger than its
+         * payload can decompress to, or was written by an unknown codec.
+         */
+        static char* decode(const char *data, size_t length, size_t &decodedLength);
+};
+
+/**
+ * Stores blocks as they are.
+ */
+class NoneBlockCodec : public AntiCacheBlockCodec {
+    public:
+        uint8_t id() const {
+            return CODEC_NONE;
+        }
+        size_t compress(const char *in, size_t length, char *out, size_t capacity) const;
+        bool decompress(const char *in, size_t length, char *out, size_t uncompressedLength) const;
+        size_t maxUncompressedLength(size_t length) const;
+};
+
+/**
+ * LZ77 in the LZF format: runs of up to 32 literals and back references
+ * of up to 264 bytes into the last 8KB, found through a hash of the next
+ * three bytes. Fast in both directions, and evicted tuples of the same
+ * table repeat their layout and much of their data from one to the next.
+ */
+class LZBlockCodec : public AntiCacheBlockCodec {
+    public:
+        uint8_t id() const {
+            return CODEC_LZ;
+        }
+        size_t compress(const char *in, size_t length, char *out, size_t capacity) const;
+        bool decompress(const char *in, size_t length, char *out, size_t uncompressedLength) const;
+        size_t maxUncompressedLength(size_t length) const;
+};
+
+}
+#endif
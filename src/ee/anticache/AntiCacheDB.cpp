@@ -28,6 +28,7 @@
 #include "common/debuglog.h"
 #include "common/FatalException.hpp"
 #include "common/executorcontext.hpp"
+#include <boost/scoped_array.hpp>
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
@@ -57,8 +58,11 @@ AntiCacheDB::AntiCacheDB(ExecutorContext *ctx, std::string db_dir, long blockSiz
     m_dbDir(db_dir),
     m_blockSize(blockSize),
     m_nextBlockId(0),
+    m_codec(AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ)),
     m_totalBlocks(0) {
         
+    pthread_mutex_init(&m_lock, NULL);
+
     #ifdef ANTICACHE_NVM
         initializeNVM(); 
     #else
@@ -86,7 +90,8 @@ void AntiCacheDB::initializeBerkeleyDB() {
 
         // allocate and initialize new Berkeley DB instance
         m_db = new Db(m_dbEnv, 0); 
-        m_db->open(NULL, ANTICACHE_DB_NAME, NULL, DB_HASH, DB_CREATE, 0); 
+        // DB_THREAD, the AntiCacheReader reads on threads of its own
+        m_db->open(NULL, ANTICACHE_DB_NAME, NULL, DB_HASH, DB_CREATE | DB_THREAD, 0); 
 
     } catch (DbException &e) {
         VOLT_ERROR("Anti-Cache initialization error: %s", e.what());
@@ -215,6 +220,7 @@ AntiCacheDB::~AntiCacheDB() {
     #else
         shutdownBerkeleyDB(); 
     #endif
+    pthread_mutex_destroy(&m_lock);
 }
 
 void AntiCacheDB::writeBlockBerkeleyDB(const std::string tableName,
@@ -284,11 +290,13 @@ void AntiCacheDB::writeBlockNVM(const std::string tableName,
 
 AntiCacheBlock AntiCacheDB::readBlockNVM(std::string tableName, int16_t blockId) {
     
+   pthread_mutex_lock(&m_lock);
    std::map<int16_t, std::pair<int, int32_t> >::iterator itr; 
    itr = m_blockMap.find(blockId); 
   
    if (itr == m_blockMap.end()) 
    {
+     pthread_mutex_unlock(&m_lock);
      VOLT_INFO("Invalid anti-cache blockId '%d' for table '%s'", blockId, tableName.c_str());
      VOLT_ERROR("Invalid anti-cache blockId '%d' for table '%s'", blockId, tableName.c_str());
      throw UnknownBlockAccessException(tableName, blockId);
@@ -306,6 +314,7 @@ AntiCacheBlock AntiCacheDB::readBlockNVM(std::string tableName, int16_t blockId)
    freeNVMBlock(blockId); 
 
    m_blockMap.erase(itr); 
+   pthread_mutex_unlock(&m_lock);
    return (anticache_block);
 }
 
@@ -316,22 +325,75 @@ void AntiCacheDB::writeBlock(const std::string tableName,
                              const char* data,
                              const long size) {
                                  
+    // compressed on the way out, the block's header says how to read it back
+    size_t encodedSize;
+    boost::scoped_array<char> encoded(AntiCacheBlockCodec::encode(m_codec, data, size, encodedSize));
+    VOLT_DEBUG("Block #%d compressed from %ld to %ld bytes", blockId, size, (long)encodedSize);
+
     #ifdef ANTICACHE_NVM
-        return writeBlockNVM(tableName, blockId, tupleCount, data, size); 
+        pthread_mutex_lock(&m_lock);
+        writeBlockNVM(tableName, blockId, tupleCount, encoded.get(), static_cast<long>(encodedSize)); 
+        pthread_mutex_unlock(&m_lock);
     #else
-        return writeBlockBerkeleyDB(tableName, blockId, tupleCount, data, size);
+        writeBlockBerkeleyDB(tableName, blockId, tupleCount, encoded.get(), static_cast<long>(encodedSize));
     #endif
+
+    // only a stored block may be read ahead
+    pthread_mutex_lock(&m_lock);
+    m_tableBlocks[tableName].insert(blockId);
+    pthread_mutex_unlock(&m_lock);
 }
 
 AntiCacheBlock AntiCacheDB::readBlock(std::string tableName, int16_t blockId) {
     
+    // the block as stored is freed once it has been decompressed
     #ifdef ANTICACHE_NVM
-        return readBlockNVM(tableName, blockId);
+        AntiCacheBlock stored = readBlockNVM(tableName, blockId);
     #else
-        return readBlockBerkeleyDB(tableName, blockId); 
+        AntiCacheBlock stored = readBlockBerkeleyDB(tableName, blockId); 
     #endif
+
+    size_t size;
+    char *data = AntiCacheBlockCodec::decode(stored.getData(), stored.getSize(), size);
+    if (data == NULL) {
+        VOLT_ERROR("Corrupt anti-cache block '%d' for table '%s'", blockId, tableName.c_str());
+        throw UnknownBlockAccessException(tableName, blockId);
+    }
+    return AntiCacheBlock(blockId, data, static_cast<long>(size));
+}
+
+std::vector<int16_t> AntiCacheDB::blocksEvictedAfter(const std::string &tableName, int16_t blockId, int count) {
+    std::vector<int16_t> blocks;
+    pthread_mutex_lock(&m_lock);
+    std::map<std::string, std::set<int16_t> >::const_iterator table = m_tableBlocks.find(tableName);
+    if (table != m_tableBlocks.end()) {
+        std::set<int16_t>::const_iterator next = table->second.upper_bound(blockId);
+        for (; next != table->second.end() && (int)blocks.size() < count; ++next) {
+            blocks.push_back(*next);
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+    return blocks;
+}
+
+void AntiCacheDB::blockUnevicted(const std::string &tableName, int16_t blockId) {
+    pthread_mutex_lock(&m_lock);
+    std::map<std::string, std::set<int16_t> >::iterator table = m_tableBlocks.find(tableName);
+    if (table != m_tableBlocks.end()) {
+        table->second.erase(blockId);
+    }
+    pthread_mutex_unlock(&m_lock);
 }
     
+void AntiCacheDB::returnBlock(const std::string &tableName, int16_t blockId,
+                              const char *data, long size) {
+    #ifdef ANTICACHE_NVM
+        // reading it freed its NVM slot
+        writeBlock(tableName, blockId, 0, data, size);
+    #endif
+    // Berkeley DB still has it, reads do not delete
+}
+
 void AntiCacheDB::flushBlocks() {
     
     #ifdef ANTICACHE_NVM
@@ -27,9 +27,14 @@
 #define HSTOREANTICACHE_H
 
 #include <db_cxx.h>
+#include <pthread.h>
 #include <map>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "anticache/AntiCacheBlockCodec.h"
+
 #define ANTICACHE_DB_NAME "anticache.db"
 
 using namespace std;
@@ -82,6 +87,15 @@ class AntiCacheDB {
 		
 		void initializeBerkeleyDB(); 
 
+        /**
+         * The codec that blocks are compressed with from now on (LZ unless
+         * changed). Blocks already written keep the one they were written
+         * with. The codec has to outlive this AntiCacheDB.
+         */
+        inline void setBlockCodec(const AntiCacheBlockCodec *codec) {
+            m_codec = codec;
+        }
+
         /**
          * Write a block of serialized tuples out to the anti-cache database
          */
@@ -91,10 +105,27 @@ class AntiCacheDB {
                         const char* data,
                         const long size);
         /**
-         * Read a block and return its contents
+         * Read a block and return its contents, decompressed
          */
         AntiCacheBlock readBlock(std::string tableName, int16_t blockId);
 
+        /**
+         * Up to count blocks of the table that were evicted after the given
+         * one and have not been read back in yet, oldest first
+         */
+        std::vector<int16_t> blocksEvictedAfter(const std::string &tableName, int16_t blockId, int count);
+
+        /**
+         * The block has been read back into its table
+         */
+        void blockUnevicted(const std::string &tableName, int16_t blockId);
+
+        /**
+         * A block that was read but not unevicted after all. Stores that
+         * free blocks as they are read take it back.
+         */
+        void returnBlock(const std::string &tableName, int16_t blockId, const char *data, long size);
+
         /**
          * Flush the buffered blocks to disk.
          */
@@ -123,6 +154,7 @@ class AntiCacheDB {
         DbEnv* m_dbEnv;
         Db* m_db; 
         int16_t m_nextBlockId;
+        const AntiCacheBlockCodec *m_codec;
 	int m_partitionId; 
 
         FILE* nvm_file;
@@ -141,6 +173,18 @@ class AntiCacheDB {
 		
 	int m_totalBlocks; 
         int m_nextFreeBlock; 
+
+        /**
+         *  Blocks are read on the AntiCacheReader's threads while the partition
+         *  evicts more. Guards m_tableBlocks and the NVM block map; Berkeley DB
+         *  does its own locking.
+         */
+        pthread_mutex_t m_lock;
+
+        /**
+         *  The evicted blocks of each table that have not been read back in
+         */
+        std::map<std::string, std::set<int16_t> > m_tableBlocks;
 		
 		void shutdownNVM(); 
 		
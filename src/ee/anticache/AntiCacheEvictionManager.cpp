@@ -60,6 +60,12 @@ namespace voltdb
  a front-to-back (i.e. from oldest to newest) manner. If a double linked list is used, iterating the chain is done 
  in a back-to-front (i.e. newest to oldest) manner. 
  
+ CLOCK Eviction
+ 
+ When built with ANTICACHE_CLOCK, no chain is kept. Touching a tuple only sets the access bit in its header, 
+ so the read/write path never relinks tuples or looks up their ids. The EvictionIterator sweeps the table's 
+ tuple slots with a clock hand, clearing set bits and evicting the tuples whose bit is already clear. 
+ 
  */
     
 AntiCacheEvictionManager::AntiCacheEvictionManager() {
@@ -119,6 +125,11 @@ void AntiCacheEvictionManager::initEvictResultTable() {
 
 // insert tuple at front of chain, next for eviction 
 bool AntiCacheEvictionManager::updateUnevictedTuple(PersistentTable* table, TableTuple* tuple) {
+#ifdef ANTICACHE_CLOCK
+    // leave the bit clear so the hand takes this tuple again on its next pass
+    tuple->setAccessedFalse();
+    return true;
+#else
     int tuples_in_chain; 
     int current_tuple_id = table->getTupleID(tuple->address()); // scan blocks for this tuple
     
@@ -151,14 +162,19 @@ bool AntiCacheEvictionManager::updateUnevictedTuple(PersistentTable* table, Tabl
     table->setNumTuplesInEvictionChain(tuples_in_chain); 
     
     return true; 
+#endif
 }
     
 bool AntiCacheEvictionManager::updateTuple(PersistentTable* table, TableTuple* tuple, bool is_insert) {
-    int SAMPLE_RATE = 1000; // aLRU sampling rate
-    
     if(table->getEvictedTable() == NULL)  // no need to maintain chain for non-evictable tables
         return true; 
     
+#ifdef ANTICACHE_CLOCK
+    tuple->setAccessedTrue();
+    return true;
+#else
+    int SAMPLE_RATE = 1000; // aLRU sampling rate
+    
     int tuples_in_chain;
 
     uint32_t newest_tuple_id;
@@ -229,9 +245,14 @@ bool AntiCacheEvictionManager::updateTuple(PersistentTable* table, TableTuple* t
     table->setNumTuplesInEvictionChain(tuples_in_chain);
         
     return true; 
+#endif
 }
     
 bool AntiCacheEvictionManager::removeTuple(PersistentTable* table, TableTuple* tuple) {
+#ifdef ANTICACHE_CLOCK
+    // nothing links to the tuple, the hand simply skips its slot once it is gone
+    return true;
+#else
     int current_tuple_id = table->getTupleID(tuple->address());
     
     // the removeTuple() method called is dependent on whether it is a single or double linked list
@@ -240,6 +261,7 @@ bool AntiCacheEvictionManager::removeTuple(PersistentTable* table, TableTuple* t
 #else
     return removeTupleSingleLinkedList(table, current_tuple_id);
 #endif
+#endif
 }
     
 // for the double linked list we start from the tail of the chain and iterate backwards
@@ -491,6 +513,8 @@ Table* AntiCacheEvictionManager::readBlocks(PersistentTable *table, int numBlock
     
     VOLT_INFO("Reading %d evicted blocks.", numBlocks);
 
+    for(int i = 0; i < numBlocks; i++)
+        table->requestEvictedBlock(blockIds[i]);
     for(int i = 0; i < numBlocks; i++)
         table->readEvictedBlock(blockIds[i], tuple_offsets[i]);
 
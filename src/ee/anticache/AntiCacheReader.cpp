@@ -0,0 +1,272 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "anticache/AntiCacheReader.h"
+#include "anticache/AntiCacheDB.h"
+#include "anticache/UnknownBlockAccessException.h"
+#include "common/debuglog.h"
+#include <string.h>
+
+using namespace std;
+
+namespace voltdb {
+
+AntiCacheReader::AntiCacheReader(AntiCacheDB *db, int threads, int readAhead) :
+    m_db(db),
+    m_readAhead(readAhead),
+    m_stopping(false),
+    m_readAheadBlocks(0),
+    m_nextSequence(0) {
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_blockDone, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, AntiCacheReader::run, this) != 0) {
+            // with no threads at all, stage() reads the block itself
+            VOLT_ERROR("AntiCacheReader : cannot start read thread %d", i);
+            continue;
+        }
+        m_threads.push_back(thread);
+    }
+}
+
+AntiCacheReader::~AntiCacheReader() {
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+    for (vector<pthread_t>::iterator iter = m_threads.begin(); iter != m_threads.end(); ++iter) {
+        pthread_join(*iter, NULL);
+    }
+
+    for (map<BlockKey, Block>::iterator iter = m_blocks.begin(); iter != m_blocks.end(); ++iter) {
+        delete [] iter->second.data;
+    }
+    for (map<string, StagedBlocks>::iterator iter = m_staged.begin(); iter != m_staged.end(); ++iter) {
+        for (size_t i = 0; i < iter->second.blocks.size(); i++) {
+            delete [] iter->second.blocks[i];
+        }
+    }
+    pthread_cond_destroy(&m_blockDone);
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void AntiCacheReader::request(const std::string &tableName, int16_t blockId) {
+    pthread_mutex_lock(&m_mutex);
+    demand(BlockKey(tableName, blockId));
+
+    if (m_readAhead > 0) {
+        // blocks evicted next to each other went cold together, so they
+        // are likely to be wanted together too
+        vector<int16_t> next = m_db->blocksEvictedAfter(tableName, blockId, m_readAhead);
+        for (vector<int16_t>::iterator iter = next.begin(); iter != next.end(); ++iter) {
+            BlockKey key(tableName, *iter);
+            if (m_blocks.find(key) != m_blocks.end()) {
+                continue;
+            }
+            // newer read-ahead is the more likely to be wanted
+            if (m_readAheadBlocks >= MAX_READ_AHEAD_BLOCKS && !dropOldestReadAhead()) {
+                break;
+            }
+            Block block;
+            block.state = BLOCK_QUEUED;
+            block.readAhead = true;
+            block.data = NULL;
+            block.size = 0;
+            block.sequence = m_nextSequence++;
+            m_blocks.insert(make_pair(key, block));
+            m_queue.push_back(key);
+            m_readAheadBlocks++;
+            VOLT_DEBUG("Reading ahead block %d of table '%s'", *iter, tableName.c_str());
+        }
+    }
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void AntiCacheReader::stage(const std::string &tableName, int16_t blockId, int32_t tupleOffset) {
+    BlockKey key(tableName, blockId);
+
+    pthread_mutex_lock(&m_mutex);
+    demand(key);
+    pthread_cond_signal(&m_workAvailable);
+
+    map<BlockKey, Block>::iterator pos;
+    while ((pos = m_blocks.find(key)) != m_blocks.end() &&
+           (pos->second.state == BLOCK_QUEUED || pos->second.state == BLOCK_READING)) {
+        if (m_threads.empty() && pos->second.state == BLOCK_QUEUED) {
+            read(key, pos->second);
+        } else {
+            pthread_cond_wait(&m_blockDone, &m_mutex);
+        }
+    }
+    if (pos == m_blocks.end()) {
+        // somebody else staged it while we waited
+        pthread_mutex_unlock(&m_mutex);
+        return;
+    }
+
+    const bool failed = (pos->second.state == BLOCK_FAILED);
+    if (!failed) {
+        StagedBlocks &staged = m_staged[tableName];
+        staged.blocks.push_back(pos->second.data);
+        staged.tupleOffsets.push_back(tupleOffset);
+    }
+    m_blocks.erase(pos);
+    pthread_mutex_unlock(&m_mutex);
+
+    m_db->blockUnevicted(tableName, blockId);
+    if (failed) {
+        throw UnknownBlockAccessException(tableName, blockId);
+    }
+}
+
+void AntiCacheReader::takeStaged(const std::string &tableName,
+                                 std::vector<char*> &blocks,
+                                 std::vector<int32_t> &tupleOffsets) {
+    pthread_mutex_lock(&m_mutex);
+    map<string, StagedBlocks>::iterator pos = m_staged.find(tableName);
+    if (pos != m_staged.end()) {
+        blocks.insert(blocks.end(), pos->second.blocks.begin(), pos->second.blocks.end());
+        tupleOffsets.insert(tupleOffsets.end(), pos->second.tupleOffsets.begin(), pos->second.tupleOffsets.end());
+        m_staged.erase(pos);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+size_t AntiCacheReader::readAheadBlocks() {
+    pthread_mutex_lock(&m_mutex);
+    size_t blocks = m_readAheadBlocks;
+    pthread_mutex_unlock(&m_mutex);
+    return blocks;
+}
+
+void* AntiCacheReader::run(void *reader) {
+    static_cast<AntiCacheReader*>(reader)->readLoop();
+    return NULL;
+}
+
+void AntiCacheReader::readLoop() {
+    pthread_mutex_lock(&m_mutex);
+    while (true) {
+        while (m_queue.empty() && !m_stopping) {
+            pthread_cond_wait(&m_workAvailable, &m_mutex);
+        }
+        if (m_stopping) {
+            break;
+        }
+
+        BlockKey key = m_queue.front();
+        m_queue.pop_front();
+        // a read-ahead block that was asked for is queued a second time
+        map<BlockKey, Block>::iterator pos = m_blocks.find(key);
+        if (pos == m_blocks.end() || pos->second.state != BLOCK_QUEUED) {
+            continue;
+        }
+        read(key, pos->second);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void AntiCacheReader::read(const BlockKey &key, Block &block) {
+    block.state = BLOCK_READING;
+    pthread_mutex_unlock(&m_mutex);
+
+    char *data = NULL;
+    long size = 0;
+    try {
+        AntiCacheBlock value = m_db->readBlock(key.first, key.second);
+        size = value.getSize();
+        data = new char[size];
+        memcpy(data, value.getData(), size);
+    } catch (UnknownBlockAccessException &e) {
+        VOLT_INFO("Failed to read block %d of table '%s'", key.second, key.first.c_str());
+    }
+
+    // the entry stays put while it is being read, nobody erases it before BLOCK_READ
+    pthread_mutex_lock(&m_mutex);
+    if (data == NULL && block.readAhead) {
+        // nobody waits for it; whoever asks for it later gets the error then
+        m_blocks.erase(key);
+        m_readAheadBlocks--;
+    } else {
+        block.data = data;
+        block.size = size;
+        block.state = (data != NULL ? BLOCK_READ : BLOCK_FAILED);
+    }
+    pthread_cond_broadcast(&m_blockDone);
+}
+
+AntiCacheReader::Block& AntiCacheReader::demand(const BlockKey &key) {
+    map<BlockKey, Block>::iterator pos = m_blocks.find(key);
+    if (pos == m_blocks.end()) {
+        Block block;
+        block.state = BLOCK_QUEUED;
+        block.readAhead = false;
+        block.data = NULL;
+        block.size = 0;
+        block.sequence = m_nextSequence++;
+        pos = m_blocks.insert(make_pair(key, block)).first;
+        m_queue.push_front(key);
+    } else if (pos->second.readAhead) {
+        pos->second.readAhead = false;
+        m_readAheadBlocks--;
+        if (pos->second.state == BLOCK_QUEUED) {
+            m_queue.push_front(key);
+        }
+    }
+    return pos->second;
+}
+
+bool AntiCacheReader::dropOldestReadAhead() {
+    map<BlockKey, Block>::iterator oldest = m_blocks.end();
+    for (map<BlockKey, Block>::iterator pos = m_blocks.begin(); pos != m_blocks.end(); ++pos) {
+        if (pos->second.readAhead && pos->second.state != BLOCK_READING &&
+            (oldest == m_blocks.end() || pos->second.sequence < oldest->second.sequence)) {
+            oldest = pos;
+        }
+    }
+    if (oldest == m_blocks.end()) {
+        return false;
+    }
+
+    VOLT_DEBUG("Dropping read-ahead block %d of table '%s'",
+               oldest->first.second, oldest->first.first.c_str());
+    if (oldest->second.state == BLOCK_READ) {
+        m_db->returnBlock(oldest->first.first, oldest->first.second,
+                          oldest->second.data, oldest->second.size);
+        delete [] oldest->second.data;
+    }
+    // a queued one is skipped when the read threads get to it
+    m_blocks.erase(oldest);
+    m_readAheadBlocks--;
+    return true;
+}
+
+}
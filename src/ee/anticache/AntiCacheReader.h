@@ -0,0 +1,146 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREANTICACHEREADER_H
+#define HSTOREANTICACHEREADER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace voltdb {
+
+class AntiCacheDB;
+
+/**
+ * Reads evicted blocks back in from the AntiCacheDB on a pool of
+ * background threads, so that a transaction waiting on the disk does not
+ * hold up the partition.
+ *
+ * request() queues a block along with the next few blocks that were
+ * evicted from the same table after it (read-ahead) and returns at once.
+ * stage() waits for a requested block and leaves it for its table, and
+ * the table's next mergeUnevictedTuples() picks up everything staged for
+ * it with takeStaged() on the partition's own thread. Blocks that were
+ * only read ahead wait in memory until somebody asks for them, or until
+ * newer read-ahead pushes them out and they are handed back to the
+ * AntiCacheDB. Read-ahead that fails is not kept.
+ */
+class AntiCacheReader {
+    public:
+        static const int DEFAULT_THREADS = 2;
+        static const int DEFAULT_READ_AHEAD = 2;
+
+        /** Blocks read ahead that may wait in memory without being asked for */
+        static const size_t MAX_READ_AHEAD_BLOCKS = 32;
+
+        AntiCacheReader(AntiCacheDB *db, int threads, int readAhead);
+        ~AntiCacheReader();
+
+        /**
+         * Queue a read of the block, ahead of any read-ahead, and of the
+         * blocks evicted from the table after it.
+         */
+        void request(const std::string &tableName, int16_t blockId);
+
+        /**
+         * Wait until the block has been read and stage it for the table's
+         * next merge. Requests the block first if nobody has.
+         * Throws UnknownBlockAccessException if the block can't be read.
+         */
+        void stage(const std::string &tableName, int16_t blockId, int32_t tupleOffset);
+
+        /**
+         * Append the blocks staged for the table, and the offset of the
+         * tuple that each was read for, to the given vectors. The caller
+         * then owns the blocks.
+         */
+        void takeStaged(const std::string &tableName,
+                        std::vector<char*> &blocks,
+                        std::vector<int32_t> &tupleOffsets);
+
+        /** Blocks read ahead, or queued to be, that nobody has asked for yet */
+        size_t readAheadBlocks();
+
+    private:
+        typedef std::pair<std::string, int16_t> BlockKey;
+
+        enum BlockState {
+            BLOCK_QUEUED,
+            BLOCK_READING,
+            BLOCK_READ,
+            BLOCK_FAILED
+        };
+
+        struct Block {
+            BlockState state;
+            bool readAhead;  // nobody has asked for it yet
+            char *data;
+            long size;
+            uint64_t sequence;  // order in which the blocks were queued
+        };
+
+        struct StagedBlocks {
+            std::vector<char*> blocks;
+            std::vector<int32_t> tupleOffsets;
+        };
+
+        static void* run(void *reader);
+        void readLoop();
+
+        /** Read a queued block on the calling thread, m_mutex held */
+        void read(const BlockKey &key, Block &block);
+
+        /** Queue the block ahead of the read-ahead, or mark it as asked for, m_mutex held */
+        Block& demand(const BlockKey &key);
+
+        /**
+         * Make room for one more read-ahead block by dropping the oldest one
+         * that is not being read. False if there is none, m_mutex held.
+         */
+        bool dropOldestReadAhead();
+
+        AntiCacheDB *m_db;
+        const int m_readAhead;
+
+        pthread_mutex_t m_mutex;
+        pthread_cond_t m_workAvailable;
+        pthread_cond_t m_blockDone;
+        std::vector<pthread_t> m_threads;
+        bool m_stopping;
+
+        std::map<BlockKey, Block> m_blocks;
+        std::deque<BlockKey> m_queue;
+        size_t m_readAheadBlocks;
+        uint64_t m_nextSequence;
+        std::map<std::string, StagedBlocks> m_staged;
+}; // CLASS
+
+}
+#endif
@@ -57,12 +57,77 @@ EvictionIterator::EvictionIterator(Table *t)
     current_tuple_id = 0;
     current_tuple = new TableTuple(table->schema());
     is_first = true; 
+    swept = 0;
 }
 
 EvictionIterator::~EvictionIterator()
 {
 }
     
+#ifdef ANTICACHE_CLOCK
+
+/*
+ With CLOCK eviction there is no chain to walk. The hand sweeps the table's tuple slots
+ in order, starting where the previous eviction left it. A tuple that was touched since
+ the hand last passed it gets its access bit cleared and a second chance; the first
+ untouched tuple is the next victim. After two full turns every bit has been cleared,
+ so if nothing turned up by then the table has no evictable tuples left.
+ */
+
+bool EvictionIterator::hasNext()
+{
+    PersistentTable* ptable = static_cast<PersistentTable*>(table);
+    
+    if(ptable->activeTupleCount() == 0)
+        return false;
+    if(swept >= 2 * static_cast<uint32_t>(ptable->usedTupleCount()))
+        return false;
+    
+    return true; 
+}
+
+bool EvictionIterator::next(TableTuple &tuple)
+{
+    PersistentTable* ptable = static_cast<PersistentTable*>(table);
+    
+    uint32_t slots = static_cast<uint32_t>(ptable->usedTupleCount());
+    uint32_t hand = ptable->getClockHand();
+    
+    while(swept < 2 * slots)
+    {
+        if(hand >= slots)
+            hand = 0;
+        
+        current_tuple_id = hand;
+        current_tuple->move(ptable->dataPtrForTuple(hand));
+        ++hand;
+        ++swept;
+        
+        if(!current_tuple->isActive() || current_tuple->isEvicted())
+            continue;
+        
+        if(current_tuple->isAccessed())  // second chance
+        {
+            current_tuple->setAccessedFalse();
+            continue;
+        }
+        
+        ptable->setClockHand(hand);
+        tuple.move(current_tuple->address()); 
+        
+        VOLT_DEBUG("current_tuple_id = %d", current_tuple_id);
+        
+        return true; 
+    }
+    
+    ptable->setClockHand(hand);
+    
+    VOLT_DEBUG("No unreferenced tuples left for the CLOCK hand.");
+    return false; 
+}
+
+#else
+
 bool EvictionIterator::hasNext()
 {        
     PersistentTable* ptable = static_cast<PersistentTable*>(table);
@@ -115,4 +180,6 @@ bool EvictionIterator::next(TableTuple &tuple)
     return true; 
 }
     
+#endif
+    
 }
@@ -69,6 +69,9 @@ private:
     uint32_t current_tuple_id;
     TableTuple* current_tuple;
     bool is_first; 
+    
+    // number of slots the CLOCK hand has passed during this iterator's sweep
+    uint32_t swept;
 }; 
 
 }
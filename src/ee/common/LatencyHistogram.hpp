@@ -0,0 +1,136 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCYHISTOGRAM_HPP_
+#define LATENCYHISTOGRAM_HPP_
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+namespace voltdb {
+
+/**
+ * Fixed-size, log-scale histogram of latencies in nanoseconds. Every power
+ * of two is split into 8 linear sub-buckets, so a reported percentile is
+ * within 12.5% of the true value. Recording is a handful of integer ops and
+ * never allocates, which keeps it cheap enough to leave on in production.
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    /** Values at or above 2^MAX_BITS ns (~39 hours) land in the last bucket */
+    static const int MAX_BITS = 47;
+    static const int NUM_BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() { reset(); }
+
+    /** Current value of the monotonic clock in nanoseconds */
+    static inline int64_t now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    inline void record(int64_t nanos) {
+        if (nanos < 0)
+            nanos = 0;
+        m_counts[bucketFor(nanos)]++;
+        m_count++;
+        m_total += nanos;
+        if (nanos > m_max)
+            m_max = nanos;
+    }
+
+    /** Fold another histogram's samples into this one */
+    void merge(const LatencyHistogram &other) {
+        for (int ii = 0; ii < NUM_BUCKETS; ii++)
+            m_counts[ii] += other.m_counts[ii];
+        m_count += other.m_count;
+        m_total += other.m_total;
+        if (other.m_max > m_max)
+            m_max = other.m_max;
+    }
+
+    void reset() {
+        memset(m_counts, 0, sizeof(m_counts));
+        m_count = 0;
+        m_total = 0;
+        m_max = 0;
+    }
+
+    inline int64_t count() const { return m_count; }
+    inline int64_t total() const { return m_total; }
+    inline int64_t max() const { return m_max; }
+    inline int64_t mean() const { return m_count == 0 ? 0 : m_total / m_count; }
+
+    /**
+     * Upper bound of the bucket holding the given quantile (0 < q <= 1),
+     * capped at the largest recorded value. Returns 0 when empty. Uses the
+     * nearest-rank definition: the ceil(q * count)-th smallest sample.
+     */
+    int64_t percentile(double q) const {
+        if (m_count == 0)
+            return 0;
+        int64_t rank = static_cast<int64_t>(ceil(q * static_cast<double>(m_count)));
+        if (rank < 1)
+            rank = 1;
+        if (rank > m_count)
+            rank = m_count;
+        int64_t seen = 0;
+        for (int ii = 0; ii < NUM_BUCKETS; ii++) {
+            seen += m_counts[ii];
+            if (seen >= rank) {
+                int64_t upper = bucketUpperBound(ii);
+                return upper < m_max ? upper : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    static inline int bucketFor(int64_t nanos) {
+        uint64_t value = static_cast<uint64_t>(nanos);
+        if (value < static_cast<uint64_t>(SUB_BUCKETS))
+            return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(value);
+        if (msb > MAX_BITS)
+            return NUM_BUCKETS - 1;
+        int shift = msb - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    static inline int64_t bucketUpperBound(int bucket) {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        int shift = bucket / SUB_BUCKETS - 1;
+        int64_t sub = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    }
+
+private:
+    int64_t m_counts[NUM_BUCKETS];
+    int64_t m_count;
+    int64_t m_total;
+    int64_t m_max;
+};
+
+}
+
+#endif /* LATENCYHISTOGRAM_HPP_ */
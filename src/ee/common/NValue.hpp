@@ -205,6 +205,13 @@ class NValue {
     static const NValue deserializeFromAllocateForStorage(
         SerializeInput &input, Pool *dataPool);
 
+    /* Like deserializeFromAllocateForStorage, but VARCHAR and VARBINARY
+       values point into the input's own bytes instead of being copied
+       into the pool. The input must be writable and must outlive the
+       values; long lengths are re-encoded in place. */
+    static const NValue deserializeReferencingInput(
+        SerializeInput &input, Pool *dataPool);
+
     /* Serialize this NValue to a SerializeOutput */
     void serializeTo(SerializeOutput &output) const;
 
@@ -1558,14 +1565,17 @@ class NValue {
     }
 
     static NValue getStringValue(std::string value) {
+        return getStringValue(value.c_str(), static_cast<int32_t>(value.length()));
+    }
+
+    static NValue getStringValue(const char *value, const int32_t length) {
         NValue retval(VALUE_TYPE_VARCHAR);
-        const int32_t length = static_cast<int32_t>(value.length());
         const int8_t lengthLength = getAppropriateObjectLengthLength(length);
         const int32_t minLength = length + lengthLength;
         StringRef* sref = StringRef::create(minLength);
         char* storage = sref->get();
         setObjectLengthToLocation(length, storage);
-        ::memcpy( storage + lengthLength, value.c_str(), length);
+        ::memcpy( storage + lengthLength, value, length);
         retval.setObjectValue(sref);
         retval.setObjectLength(length);
         retval.setObjectLengthLength(lengthLength);
@@ -2213,6 +2223,34 @@ inline const NValue NValue::deserializeFromAllocateForStorage(SerializeInput &in
     return retval;
 }
 
+inline const NValue NValue::deserializeReferencingInput(SerializeInput &input, Pool *dataPool) {
+    const ValueType type = static_cast<ValueType>(input.readByte());
+    if (type != VALUE_TYPE_VARCHAR && type != VALUE_TYPE_VARBINARY) {
+        input.unread(sizeof(int8_t));
+        return deserializeFromAllocateForStorage(input, dataPool);
+    }
+
+    NValue retval(type);
+    const int32_t length = input.readInt();
+    if (length == OBJECTLENGTH_NULL) {
+        retval.setNull();
+        return retval;
+    }
+    // The serialized length is a big-endian int32 right before the bytes.
+    // Its last byte is already the short form of the length preceding
+    // value, and with the continuation bit set all four are the long form.
+    const int8_t lengthLength = getAppropriateObjectLengthLength(length);
+    char *location = const_cast<char*>(
+        reinterpret_cast<const char*>(input.getRawPointer(length))) - lengthLength;
+    if (lengthLength == LONG_OBJECT_LENGTHLENGTH) {
+        location[0] = static_cast<char>(location[0] | OBJECT_CONTINUATION_BIT);
+    }
+    retval.setObjectValue(StringRef::createReference(location, dataPool));
+    retval.setObjectLength(length);
+    retval.setObjectLengthLength(lengthLength);
+    return retval;
+}
+
 /**
  * Serialize this NValue to the provided SerializeOutput
  */
@@ -2423,8 +2461,10 @@ inline void NValue::hashCombine(std::size_t &seed) const {
         if (getObjectValue() == NULL) {
             boost::hash_combine( seed, std::string(""));
         } else {
+            // same value as hashing a std::string of the bytes, without copying them into one
             const int32_t length = getObjectLength();
-            boost::hash_combine( seed, std::string( reinterpret_cast<const char*>(getObjectValue()), length ));
+            const char* data = reinterpret_cast<const char*>(getObjectValue());
+            boost::hash_combine( seed, boost::hash_range(data, data + length));
         }
         break;
       }
@@ -2433,9 +2473,8 @@ inline void NValue::hashCombine(std::size_t &seed) const {
             boost::hash_combine( seed, std::string(""));
         } else {
             const int32_t length = getObjectLength();
-            char* data = reinterpret_cast<char*>(getObjectValue());
-            for (int32_t i = 0; i < length; i++)
-                boost::hash_combine(seed, data[i]);
+            const char* data = reinterpret_cast<const char*>(getObjectValue());
+            boost::hash_range(seed, data, data + length);
         }
         break;
       }
@@ -0,0 +1,76 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REDOUNDOQUANTUM_HPP_
+#define REDOUNDOQUANTUM_HPP_
+
+#include "common/UndoQuantum.h"
+#include "common/UndoAction.h"
+#include "common/Pool.hpp"
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * UndoQuantum installed while ARIES redo applies log records from several
+ * threads at once. Like DummyUndoQuantum it releases UndoActions as soon
+ * as they are registered, but each applying thread allocates them out of
+ * a Pool of its own, so purging one thread's pool never frees an action
+ * another thread is still building.
+ */
+namespace voltdb {
+class RedoUndoQuantum : public UndoQuantum {
+
+public:
+    RedoUndoQuantum() : UndoQuantum(INT64_MIN + 1, NULL) {
+        pthread_key_create(&m_poolKey, NULL);
+        pthread_mutex_init(&m_mutex, NULL);
+    }
+    ~RedoUndoQuantum() {
+        for (std::vector<Pool*>::iterator iter = m_pools.begin(); iter != m_pools.end(); ++iter) {
+            delete *iter;
+        }
+        pthread_mutex_destroy(&m_mutex);
+        pthread_key_delete(m_poolKey);
+    }
+    void registerUndoAction(UndoAction *undoAction) {
+        undoAction->release();
+        undoAction->~UndoAction();
+        getDataPool()->purge();
+    }
+    Pool* getDataPool() {
+        Pool *pool = static_cast<Pool*>(pthread_getspecific(m_poolKey));
+        if (pool == NULL) {
+            pool = new Pool();
+            pthread_setspecific(m_poolKey, pool);
+            pthread_mutex_lock(&m_mutex);
+            m_pools.push_back(pool);
+            pthread_mutex_unlock(&m_mutex);
+        }
+        return pool;
+    }
+    inline bool isDummy() {return true;}
+
+private:
+    pthread_key_t m_poolKey;
+    pthread_mutex_t m_mutex;
+    // every pool handed out, freed with the quantum
+    std::vector<Pool*> m_pools;
+};
+}
+
+#endif /* REDOUNDOQUANTUM_HPP_ */
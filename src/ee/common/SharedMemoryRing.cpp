@@ -0,0 +1,146 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/SharedMemoryRing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+using namespace voltdb;
+
+SharedMemoryRing::SharedMemoryRing(char *region, size_t capacity, int doorbellFd) :
+    m_head(reinterpret_cast<volatile int64_t*>(region)),
+    m_tail(reinterpret_cast<volatile int64_t*>(region + 64)),
+    m_consumerParked(reinterpret_cast<volatile int32_t*>(region + 128)),
+    m_producerParked(reinterpret_cast<volatile int32_t*>(region + 132)),
+    m_data(region + CONTROL_BYTES), m_capacity(capacity), m_doorbellFd(doorbellFd)
+{
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+}
+
+void SharedMemoryRing::initialize(char *region) {
+    memset(region, 0, CONTROL_BYTES);
+    __sync_synchronize();
+}
+
+bool SharedMemoryRing::write(const char *data, size_t size) {
+    while (size > 0) {
+        if (!hasSpace() && !waitFor(m_producerParked, &SharedMemoryRing::hasSpace)) {
+            return false;
+        }
+        // only this side moves the tail, only the other side the head
+        int64_t tail = *m_tail;
+        size_t space = m_capacity - static_cast<size_t>(tail - *m_head);
+        size_t offset = static_cast<size_t>(tail) & (m_capacity - 1);
+        size_t chunk = std::min(size, std::min(space, m_capacity - offset));
+        memcpy(m_data + offset, data, chunk);
+
+        // publish the bytes before the tail that covers them
+        __sync_synchronize();
+        *m_tail = tail + static_cast<int64_t>(chunk);
+        if (!notify(m_consumerParked)) {
+            return false;
+        }
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::read(char *data, size_t size) {
+    while (size > 0) {
+        if (!hasData() && !waitFor(m_consumerParked, &SharedMemoryRing::hasData)) {
+            return false;
+        }
+        int64_t head = *m_head;
+        size_t available = static_cast<size_t>(*m_tail - head);
+        __sync_synchronize();
+        size_t offset = static_cast<size_t>(head) & (m_capacity - 1);
+        size_t chunk = std::min(size, std::min(available, m_capacity - offset));
+        memcpy(data, m_data + offset, chunk);
+
+        // done with the bytes before handing their space back
+        __sync_synchronize();
+        *m_head = head + static_cast<int64_t>(chunk);
+        if (!notify(m_producerParked)) {
+            return false;
+        }
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::hasData() {
+    return *m_tail != *m_head;
+}
+
+bool SharedMemoryRing::hasSpace() {
+    return static_cast<size_t>(*m_tail - *m_head) < m_capacity;
+}
+
+/*
+ * Spin for a while, then park. The parked flag is raised before the ring
+ * is checked one last time and the other side checks the flag after it
+ * moves its position, so one of the two always notices the other. Only
+ * the side that clears a raised flag rings the doorbell, so each park
+ * costs at most one doorbell byte.
+ */
+bool SharedMemoryRing::waitFor(volatile int32_t *parked, Condition ready) {
+    for (int spins = 0; spins < SPIN_LIMIT; spins++) {
+        if ((this->*ready)()) {
+            return true;
+        }
+    }
+
+    while (true) {
+        *parked = 1;
+        __sync_synchronize();
+        if ((this->*ready)() && __sync_bool_compare_and_swap(parked, 1, 0)) {
+            return true;
+        }
+
+        // the other side cleared the flag and its doorbell byte is on the way
+        char doorbell;
+        ssize_t bytes;
+        do {
+            bytes = ::read(m_doorbellFd, &doorbell, 1);
+        } while (bytes < 0 && errno == EINTR);
+        if (bytes != 1) {
+            return false;
+        }
+        if ((this->*ready)()) {
+            return true;
+        }
+    }
+}
+
+bool SharedMemoryRing::notify(volatile int32_t *parked) {
+    __sync_synchronize();
+    if (*parked == 0 || !__sync_bool_compare_and_swap(parked, 1, 0)) {
+        return true;
+    }
+    char doorbell = 0;
+    ssize_t bytes;
+    do {
+        bytes = ::write(m_doorbellFd, &doorbell, 1);
+    } while (bytes < 0 && errno == EINTR);
+    return bytes == 1;
+}
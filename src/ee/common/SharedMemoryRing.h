@@ -0,0 +1,84 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHAREDMEMORYRING_H_
+#define SHAREDMEMORYRING_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Single producer, single consumer byte stream through a ring in memory
+ * shared with another process. Each side spins briefly when it has to
+ * wait and then parks in a blocking read on a doorbell socket; the other
+ * side writes one byte to that socket only when it sees the waiter parked.
+ * A hung up doorbell means the other process is gone.
+ *
+ * The region starts with CONTROL_BYTES of control words, each on its own
+ * cache line, followed by the data. The layout is shared with Java's
+ * SharedMemoryChannel and must not change without it:
+ *   0    int64 head, bytes consumed so far
+ *   64   int64 tail, bytes produced so far
+ *   128  int32 set while the consumer is parked waiting for data
+ *   132  int32 set while the producer is parked waiting for space
+ *   192  data, capacity bytes
+ */
+class SharedMemoryRing {
+public:
+    static const size_t CONTROL_BYTES = 192;
+
+    /** How many times a waiter polls the ring before it parks */
+    static const int SPIN_LIMIT = 10000;
+
+    /** capacity must be a power of two */
+    SharedMemoryRing(char *region, size_t capacity, int doorbellFd);
+
+    /** Zero the control words of a new region */
+    static void initialize(char *region);
+
+    /** Block until all of data is in the ring; false if the peer hung up */
+    bool write(const char *data, size_t size);
+
+    /** Block until size bytes have been read; false if the peer hung up */
+    bool read(char *data, size_t size);
+
+    inline size_t capacity() const {
+        return m_capacity;
+    }
+
+private:
+    typedef bool (SharedMemoryRing::*Condition)();
+
+    bool hasData();
+    bool hasSpace();
+    bool waitFor(volatile int32_t *parked, Condition ready);
+    bool notify(volatile int32_t *parked);
+
+    volatile int64_t *m_head;
+    volatile int64_t *m_tail;
+    volatile int32_t *m_consumerParked;
+    volatile int32_t *m_producerParked;
+    char *m_data;
+    const size_t m_capacity;
+    const int m_doorbellFd;
+};
+
+}
+
+#endif /* SHAREDMEMORYRING_H_ */
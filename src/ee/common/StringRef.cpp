@@ -65,6 +65,12 @@ StringRef::create(size_t size, Pool* dataPool)
     return retval;
 }
 
+StringRef*
+StringRef::createReference(char* location, Pool* dataPool)
+{
+    return new(dataPool->allocate(sizeof(StringRef))) StringRef(location);
+}
+
 void
 StringRef::destroy(StringRef* sref)
 {
@@ -87,6 +93,14 @@ StringRef::StringRef(std::size_t size, Pool* dataPool)
     setBackPtr();
 }
 
+StringRef::StringRef(char* location)
+{
+    // no back pointer: nothing compacts storage it does not own
+    m_size = 0;
+    m_tempPool = true;
+    m_stringPtr = location - sizeof(StringRef*);
+}
+
 StringRef::~StringRef()
 {
     if (!m_tempPool)
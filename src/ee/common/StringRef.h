@@ -70,6 +70,13 @@ namespace voltdb
         static StringRef* create(std::size_t size,
                                  Pool* dataPool = NULL);
 
+        /// Create and return a StringRef object for length preceded
+        /// string storage owned by someone else, such as the parameter
+        /// buffer shared with Java.  Only the StringRef object comes
+        /// out of the Pool; the storage is never copied, moved or freed
+        /// and must outlive every value that refers to it.
+        static StringRef* createReference(char* location, Pool* dataPool);
+
         /// Destroy the given StringRef object and free any memory, if
         /// any, allocated from pools to store the object.
         /// sref must have been allocated and returned by a call to
@@ -83,6 +90,7 @@ namespace voltdb
     private:
         StringRef(std::size_t size);
         StringRef(std::size_t size, Pool* dataPool);
+        StringRef(char* location);
         ~StringRef();
 
         /// Callback used via the back-pointer in order to update the
@@ -83,6 +83,10 @@ public:
         return NValue::getStringValue(value);
     }
 
+    static inline NValue getStringValue(const char* value, int32_t len) {
+        return NValue::getStringValue(value, len);
+    }
+
     static inline NValue getNullStringValue() {
         return NValue::getNullStringValue();
     }
@@ -52,6 +52,7 @@
 #ifdef ANTICACHE
 #include "anticache/AntiCacheDB.h"
 #include "anticache/AntiCacheEvictionManager.h"
+#include "anticache/AntiCacheReader.h"
 #endif
 
 namespace voltdb {
@@ -61,6 +62,7 @@ namespace voltdb {
     #ifdef ANTICACHE
     class AntiCacheDB;
     class AntiCacheEvictionManager; 
+    class AntiCacheReader;
     #endif
     
     /*
@@ -84,6 +86,8 @@ namespace voltdb {
 
 	#ifdef ANTICACHE
 			if (m_antiCacheEnabled) {
+				// stop its reads before the database goes away
+				delete m_antiCacheReader;
 				delete m_antiCacheDB;
 				delete m_antiCacheEvictionManager;
 			}
@@ -216,6 +220,14 @@ namespace voltdb {
 			return m_antiCacheDB;
 		}
 
+		/**
+		 * Return the reader that brings evicted blocks back in on
+		 * threads of its own
+		 */
+		AntiCacheReader* getAntiCacheReader() const {
+			return m_antiCacheReader;
+		}
+
 		/**
 		 * Return the handle to the anti-cache manager that will update tuple timestamps
 		 * and can select tuples for eviction.
@@ -234,6 +246,8 @@ namespace voltdb {
 			m_antiCacheEnabled = true;
 			m_antiCacheDB = new AntiCacheDB(this, dbDir, blockSize);
 			m_antiCacheEvictionManager = new AntiCacheEvictionManager();
+			m_antiCacheReader = new AntiCacheReader(m_antiCacheDB,
+					AntiCacheReader::DEFAULT_THREADS, AntiCacheReader::DEFAULT_READ_AHEAD);
 		}
 	#endif
 
@@ -311,6 +325,7 @@ namespace voltdb {
 	#ifdef ANTICACHE
 		AntiCacheDB *m_antiCacheDB;
 		AntiCacheEvictionManager *m_antiCacheEvictionManager;
+		AntiCacheReader *m_antiCacheReader;
 	#endif
 
 	#ifdef STORAGE_MMAP
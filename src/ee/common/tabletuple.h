@@ -106,7 +106,10 @@ namespace voltdb {
  ---------------------------------------------------------------------------------------------------
  |  flags (1 byte)  |  "previous" tuple id  (4 bytes)  |  "next" tuple id (4 bytes)  | tuple data  |
  ---------------------------------------------------------------------------------------------------
- 
+
+ (d). Anti-Caching with CLOCK
+ Same layout as (b), but no chain is kept. Touching a tuple only sets the ACCESSED_MASK flag.
+
  */
 
 //TODO: Window tables likely need their own TableTuples.  Right now, all tuples will have a 5-byte header, even if
@@ -130,6 +133,7 @@ namespace voltdb {
 #define DELETED_MASK 1
 #define DIRTY_MASK 2
 #define EVICTED_MASK 4
+#define ACCESSED_MASK 8
 
 class TableColumn;
 
@@ -146,6 +150,8 @@ class TableTuple {
     friend class PersistentTableUndoUpdateAction;
     friend class CopyOnWriteIterator;
     friend class CopyOnWriteContext;
+    friend class AntiCacheEvictionManager;
+    friend class EvictionIterator;
     friend class ::CopyOnWriteTest_TestTableTupleFlags;
     friend class ::TableTupleTest_MarkAsEvicted;
     template<std::size_t keySize> friend class IntsKey;
@@ -306,6 +312,12 @@ public:
         return (*(reinterpret_cast<const char*> (m_data)) & EVICTED_MASK) == 0 ? false : true;
     }
 
+    /** Has the tuple been touched since the CLOCK hand last passed it? */
+    inline bool isAccessed() const
+    {
+        return (*(reinterpret_cast<const char*> (m_data)) & ACCESSED_MASK) == 0 ? false : true;
+    }
+
     /** Is the column value null? */
     inline bool isNull(const int idx) const {
         return getNValue(idx).isNull();
@@ -447,6 +459,18 @@ protected:
         *(reinterpret_cast<char*> (m_data)) &= static_cast<char>(~EVICTED_MASK);
     }
 
+    inline void setAccessedTrue()
+    {
+        // treat the first "value" as a boolean flag
+        *(reinterpret_cast<char*> (m_data)) |= static_cast<char>(ACCESSED_MASK);
+    }
+
+    inline void setAccessedFalse()
+    {
+        // treat the first "value" as a boolean flag
+        *(reinterpret_cast<char*> (m_data)) &= static_cast<char>(~ACCESSED_MASK);
+    }
+
     /** The types of the columns in the tuple */
     const TupleSchema *m_schema;
 
@@ -0,0 +1,470 @@
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "tableExporter.h"
+#include "common/debuglog.h"
+#include "common/NValue.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+
+using voltdb::NValue;
+using voltdb::TableTuple;
+using voltdb::ValuePeeker;
+
+const char TableExporter::PostgresSignature[11] = { 'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0' };
+static const char ColumnarMagic[8] = { 'S', 'S', 'T', 'O', 'R', 'E', 'C', 'F' };
+
+BlockWriter::BlockWriter() :
+		m_fd(-1), m_current(NULL), m_used(0), m_bytesWritten(0), m_pending(NULL),
+		m_pendingLength(0), m_closing(false), m_failed(false) {
+	m_blocks[0] = NULL;
+	m_blocks[1] = NULL;
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_cond_init(&m_changed, NULL);
+}
+
+BlockWriter::~BlockWriter() {
+	if (m_fd >= 0) {
+		close();
+	}
+	delete[] m_blocks[0];
+	delete[] m_blocks[1];
+	pthread_cond_destroy(&m_changed);
+	pthread_mutex_destroy(&m_mutex);
+}
+
+bool BlockWriter::open(const std::string &path) {
+	assert(m_fd < 0);
+	m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (m_fd < 0) {
+		VOLT_ERROR("Could not create %s: %s", path.c_str(), strerror(errno));
+		return false;
+	}
+	if (m_blocks[0] == NULL) {
+		m_blocks[0] = new char[BLOCK_SIZE];
+		m_blocks[1] = new char[BLOCK_SIZE];
+	}
+	m_current = m_blocks[0];
+	m_used = 0;
+	m_closing = false;
+	m_failed = false;
+	if (pthread_create(&m_thread, NULL, BlockWriter::run, this) != 0) {
+		VOLT_ERROR("Could not start the writer thread for %s", path.c_str());
+		::close(m_fd);
+		m_fd = -1;
+		return false;
+	}
+	return true;
+}
+
+bool BlockWriter::close() {
+	if (m_fd < 0) {
+		return false;
+	}
+	if (m_used > 0) {
+		handOff();
+	}
+	pthread_mutex_lock(&m_mutex);
+	while (m_pending != NULL) {
+		pthread_cond_wait(&m_changed, &m_mutex);
+	}
+	m_closing = true;
+	pthread_cond_broadcast(&m_changed);
+	pthread_mutex_unlock(&m_mutex);
+	pthread_join(m_thread, NULL);
+
+	if (::close(m_fd) != 0) {
+		m_failed = true;
+	}
+	m_fd = -1;
+	return !m_failed;
+}
+
+void BlockWriter::write(const void *data, size_t length) {
+	const char *bytes = static_cast<const char*>(data);
+	while (length > 0) {
+		if (m_used == BLOCK_SIZE) {
+			handOff();
+		}
+		size_t chunk = std::min(length, BLOCK_SIZE - m_used);
+		::memcpy(m_current + m_used, bytes, chunk);
+		m_used += chunk;
+		bytes += chunk;
+		length -= chunk;
+	}
+}
+
+void BlockWriter::handOff() {
+	pthread_mutex_lock(&m_mutex);
+	// the writer is done with the other block once nothing is pending
+	while (m_pending != NULL) {
+		pthread_cond_wait(&m_changed, &m_mutex);
+	}
+	m_pending = m_current;
+	m_pendingLength = m_used;
+	pthread_cond_broadcast(&m_changed);
+	pthread_mutex_unlock(&m_mutex);
+
+	m_current = (m_current == m_blocks[0]) ? m_blocks[1] : m_blocks[0];
+	m_used = 0;
+}
+
+void* BlockWriter::run(void *arg) {
+	BlockWriter *writer = static_cast<BlockWriter*>(arg);
+	pthread_mutex_lock(&writer->m_mutex);
+	while (true) {
+		while (writer->m_pending == NULL && !writer->m_closing) {
+			pthread_cond_wait(&writer->m_changed, &writer->m_mutex);
+		}
+		if (writer->m_pending == NULL) {
+			break;
+		}
+		const char *block = writer->m_pending;
+		size_t length = writer->m_pendingLength;
+		bool failed = writer->m_failed;
+		pthread_mutex_unlock(&writer->m_mutex);
+
+		size_t written = 0;
+		while (!failed && written < length) {
+			ssize_t result = ::write(writer->m_fd, block + written, length - written);
+			if (result < 0 && errno != EINTR) {
+				VOLT_ERROR("Failed to write exported data: %s", strerror(errno));
+				failed = true;
+			} else if (result > 0) {
+				written += result;
+			}
+		}
+
+		pthread_mutex_lock(&writer->m_mutex);
+		writer->m_failed = failed;
+		writer->m_bytesWritten += written;
+		writer->m_pending = NULL;
+		pthread_cond_broadcast(&writer->m_changed);
+	}
+	pthread_mutex_unlock(&writer->m_mutex);
+	return NULL;
+}
+
+bool TableExporter::formatForShim(const std::string &shim, Format &format) {
+	if (shim == "psql") {
+		format = FORMAT_PSQL;
+	} else if (shim == "scidb") {
+		format = FORMAT_SCIDB;
+	} else if (shim == "csv") {
+		format = FORMAT_CSV;
+	} else if (shim == "columnar") {
+		format = FORMAT_COLUMNAR;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+TableExporter::TableExporter(const voltdb::TupleSchema *schema, Format format) :
+		m_schema(schema), m_format(format), m_columnCount(schema->columnCount()),
+		m_rowCount(0) {
+}
+
+bool TableExporter::open(const std::string &path) {
+	if (m_format == FORMAT_PSQL || m_format == FORMAT_SCIDB) {
+		for (int i = 0; i < m_columnCount; ++i) {
+			if (m_schema->columnType(i) == voltdb::VALUE_TYPE_DECIMAL) {
+				VOLT_ERROR("DECIMAL column %d can only be exported as csv or columnar", i);
+				return false;
+			}
+		}
+	}
+	if (!m_writer.open(path)) {
+		return false;
+	}
+
+	if (m_format == FORMAT_PSQL) {
+		m_writer.write(PostgresSignature, sizeof(PostgresSignature));
+		m_writer.writeBigEndian<uint32_t>(0); // flags
+		m_writer.writeBigEndian<int32_t>(0); // header extension length
+	} else if (m_format == FORMAT_COLUMNAR) {
+		m_writer.write(ColumnarMagic, sizeof(ColumnarMagic));
+		m_writer.writeHost<int16_t>(static_cast<int16_t>(m_columnCount));
+		for (int i = 0; i < m_columnCount; ++i) {
+			m_writer.writeHost<int8_t>(static_cast<int8_t>(m_schema->columnType(i)));
+			m_writer.writeHost<int8_t>(m_schema->columnAllowNull(i) ? 1 : 0);
+		}
+		m_pendingTuples.reserve(ROWS_PER_BLOCK);
+	}
+	return true;
+}
+
+void TableExporter::append(const TableTuple &tuple) {
+	switch (m_format) {
+	case FORMAT_PSQL:
+		appendPsql(tuple);
+		break;
+	case FORMAT_SCIDB:
+		appendScidb(tuple);
+		break;
+	case FORMAT_CSV:
+		appendCsv(tuple);
+		break;
+	case FORMAT_COLUMNAR:
+		m_pendingTuples.push_back(tuple.address());
+		if (m_pendingTuples.size() == ROWS_PER_BLOCK) {
+			flushColumnarBlock();
+		}
+		break;
+	}
+	++m_rowCount;
+}
+
+bool TableExporter::close() {
+	if (m_format == FORMAT_PSQL) {
+		m_writer.writeBigEndian<int16_t>(-1);
+	} else if (m_format == FORMAT_COLUMNAR) {
+		flushColumnarBlock();
+		m_writer.writeHost<int32_t>(0);
+	}
+	return m_writer.close();
+}
+
+/* a field count, then a length and big-endian value per field; tinyint goes out as smallint */
+void TableExporter::appendPsql(const TableTuple &tuple) {
+	m_writer.writeBigEndian<int16_t>(static_cast<int16_t>(m_columnCount));
+	for (int i = 0; i < m_columnCount; ++i) {
+		const NValue value = tuple.getNValue(i);
+		if (m_schema->columnAllowNull(i) && value.isNull()) {
+			m_writer.writeBigEndian<int32_t>(-1);
+			continue;
+		}
+		switch (m_schema->columnType(i)) {
+		case voltdb::VALUE_TYPE_TINYINT:
+			m_writer.writeBigEndian<int32_t>(sizeof(int16_t));
+			m_writer.writeBigEndian<int16_t>(ValuePeeker::peekTinyInt(value));
+			break;
+		case voltdb::VALUE_TYPE_SMALLINT:
+			m_writer.writeBigEndian<int32_t>(sizeof(int16_t));
+			m_writer.writeBigEndian<int16_t>(ValuePeeker::peekSmallInt(value));
+			break;
+		case voltdb::VALUE_TYPE_INTEGER:
+			m_writer.writeBigEndian<int32_t>(sizeof(int32_t));
+			m_writer.writeBigEndian<int32_t>(ValuePeeker::peekInteger(value));
+			break;
+		case voltdb::VALUE_TYPE_BIGINT:
+			m_writer.writeBigEndian<int32_t>(sizeof(int64_t));
+			m_writer.writeBigEndian<int64_t>(ValuePeeker::peekBigInt(value));
+			break;
+		case voltdb::VALUE_TYPE_TIMESTAMP:
+			m_writer.writeBigEndian<int32_t>(sizeof(int64_t));
+			m_writer.writeBigEndian<int64_t>(ValuePeeker::peekTimestamp(value));
+			break;
+		case voltdb::VALUE_TYPE_DOUBLE:
+			m_writer.writeBigEndian<int32_t>(sizeof(double));
+			m_writer.writeBigEndian<double>(ValuePeeker::peekDouble(value));
+			break;
+		default: {
+			// VARCHAR and VARBINARY
+			int32_t length = ValuePeeker::peekObjectLength(value);
+			m_writer.writeBigEndian<int32_t>(length);
+			m_writer.write(ValuePeeker::peekObjectValue(value), length);
+		}
+		}
+	}
+}
+
+/* nullable fields start with a byte that is -1 or the reason for a NULL; values are in host order */
+void TableExporter::appendScidb(const TableTuple &tuple) {
+	static const char zeros[sizeof(int64_t)] = { 0 };
+	for (int i = 0; i < m_columnCount; ++i) {
+		const NValue value = tuple.getNValue(i);
+		const voltdb::ValueType type = m_schema->columnType(i);
+		const bool isObject = (type == voltdb::VALUE_TYPE_VARCHAR || type == voltdb::VALUE_TYPE_VARBINARY);
+		if (m_schema->columnAllowNull(i)) {
+			if (value.isNull()) {
+				m_writer.writeHost<int8_t>(0);
+				if (isObject) {
+					m_writer.writeHost<uint32_t>(0);
+				} else {
+					m_writer.write(zeros, NValue::getTupleStorageSize(type));
+				}
+				continue;
+			}
+			m_writer.writeHost<int8_t>(-1);
+		}
+		switch (type) {
+		case voltdb::VALUE_TYPE_TINYINT:
+			m_writer.writeHost<int8_t>(ValuePeeker::peekTinyInt(value));
+			break;
+		case voltdb::VALUE_TYPE_SMALLINT:
+			m_writer.writeHost<int16_t>(ValuePeeker::peekSmallInt(value));
+			break;
+		case voltdb::VALUE_TYPE_INTEGER:
+			m_writer.writeHost<int32_t>(ValuePeeker::peekInteger(value));
+			break;
+		case voltdb::VALUE_TYPE_BIGINT:
+			m_writer.writeHost<int64_t>(ValuePeeker::peekBigInt(value));
+			break;
+		case voltdb::VALUE_TYPE_TIMESTAMP:
+			m_writer.writeHost<int64_t>(ValuePeeker::peekTimestamp(value));
+			break;
+		case voltdb::VALUE_TYPE_DOUBLE:
+			m_writer.writeHost<double>(ValuePeeker::peekDouble(value));
+			break;
+		default: {
+			// strings carry their terminating '\0'
+			int32_t length = ValuePeeker::peekObjectLength(value);
+			m_writer.writeHost<uint32_t>(length + 1);
+			m_writer.write(ValuePeeker::peekObjectValue(value), length);
+			m_writer.writeHost<char>('\0');
+		}
+		}
+	}
+}
+
+/* '|' between fields, nothing for a NULL */
+void TableExporter::appendCsv(const TableTuple &tuple) {
+	char text[64];
+	for (int i = 0; i < m_columnCount; ++i) {
+		if (i > 0) {
+			m_writer.writeHost<char>('|');
+		}
+		const NValue value = tuple.getNValue(i);
+		if (value.isNull()) {
+			continue;
+		}
+		int length = 0;
+		switch (m_schema->columnType(i)) {
+		case voltdb::VALUE_TYPE_TINYINT:
+			length = snprintf(text, sizeof(text), "%d", ValuePeeker::peekTinyInt(value));
+			break;
+		case voltdb::VALUE_TYPE_SMALLINT:
+			length = snprintf(text, sizeof(text), "%d", ValuePeeker::peekSmallInt(value));
+			break;
+		case voltdb::VALUE_TYPE_INTEGER:
+			length = snprintf(text, sizeof(text), "%d", ValuePeeker::peekInteger(value));
+			break;
+		case voltdb::VALUE_TYPE_BIGINT:
+			length = snprintf(text, sizeof(text), "%" PRId64, ValuePeeker::peekBigInt(value));
+			break;
+		case voltdb::VALUE_TYPE_TIMESTAMP:
+			length = snprintf(text, sizeof(text), "%" PRId64, ValuePeeker::peekTimestamp(value));
+			break;
+		case voltdb::VALUE_TYPE_DOUBLE:
+			// what std::ostream prints by default
+			length = snprintf(text, sizeof(text), "%g", ValuePeeker::peekDouble(value));
+			break;
+		case voltdb::VALUE_TYPE_DECIMAL: {
+			std::string decimal = ValuePeeker::peekDecimalString(value);
+			m_writer.write(decimal.data(), decimal.length());
+			break;
+		}
+		default:
+			m_writer.write(ValuePeeker::peekObjectValue(value), ValuePeeker::peekObjectLength(value));
+		}
+		m_writer.write(text, length);
+	}
+	m_writer.writeHost<char>('\n');
+}
+
+void TableExporter::flushColumnarBlock() {
+	const int rows = static_cast<int>(m_pendingTuples.size());
+	if (rows == 0) {
+		return;
+	}
+	m_writer.writeHost<int32_t>(rows);
+
+	TableTuple tuple(m_schema);
+	std::vector<char> nulls((rows + 7) / 8);
+	for (int column = 0; column < m_columnCount; ++column) {
+		const voltdb::ValueType type = m_schema->columnType(column);
+
+		std::fill(nulls.begin(), nulls.end(), 0);
+		for (int row = 0; row < rows; ++row) {
+			tuple.move(m_pendingTuples[row]);
+			if (tuple.getNValue(column).isNull()) {
+				nulls[row / 8] = static_cast<char>(nulls[row / 8] | (1 << (row % 8)));
+			}
+		}
+		m_writer.write(&nulls[0], nulls.size());
+
+		if (type == voltdb::VALUE_TYPE_VARCHAR || type == voltdb::VALUE_TYPE_VARBINARY) {
+			int32_t offset = 0;
+			m_writer.writeHost<int32_t>(offset);
+			for (int row = 0; row < rows; ++row) {
+				tuple.move(m_pendingTuples[row]);
+				const NValue value = tuple.getNValue(column);
+				offset += value.isNull() ? 0 : ValuePeeker::peekObjectLength(value);
+				m_writer.writeHost<int32_t>(offset);
+			}
+			for (int row = 0; row < rows; ++row) {
+				tuple.move(m_pendingTuples[row]);
+				const NValue value = tuple.getNValue(column);
+				if (!value.isNull()) {
+					m_writer.write(ValuePeeker::peekObjectValue(value), ValuePeeker::peekObjectLength(value));
+				}
+			}
+			continue;
+		}
+
+		for (int row = 0; row < rows; ++row) {
+			tuple.move(m_pendingTuples[row]);
+			const NValue value = tuple.getNValue(column);
+			switch (type) {
+			case voltdb::VALUE_TYPE_TINYINT:
+				m_writer.writeHost<int8_t>(ValuePeeker::peekTinyInt(value));
+				break;
+			case voltdb::VALUE_TYPE_SMALLINT:
+				m_writer.writeHost<int16_t>(ValuePeeker::peekSmallInt(value));
+				break;
+			case voltdb::VALUE_TYPE_INTEGER:
+				m_writer.writeHost<int32_t>(ValuePeeker::peekInteger(value));
+				break;
+			case voltdb::VALUE_TYPE_BIGINT:
+				m_writer.writeHost<int64_t>(ValuePeeker::peekBigInt(value));
+				break;
+			case voltdb::VALUE_TYPE_TIMESTAMP:
+				m_writer.writeHost<int64_t>(ValuePeeker::peekTimestamp(value));
+				break;
+			case voltdb::VALUE_TYPE_DOUBLE:
+				m_writer.writeHost<double>(ValuePeeker::peekDouble(value));
+				break;
+			default: {
+				const voltdb::TTInt decimal = ValuePeeker::peekDecimal(value);
+				m_writer.write(decimal.table, sizeof(decimal.table));
+			}
+			}
+		}
+	}
+	m_pendingTuples.clear();
+}
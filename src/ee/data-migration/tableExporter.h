@@ -0,0 +1,175 @@
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TABLE_EXPORTER_H
+#define TABLE_EXPORTER_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "endianness.h"
+
+namespace voltdb {
+class TableTuple;
+class TupleSchema;
+}
+
+/**
+ * Sequential output in large blocks. One block is filled while a writer
+ * thread writes the other one to the file, so encoding and I/O overlap
+ * and the file only sees big writes.
+ */
+class BlockWriter {
+public:
+	static const size_t BLOCK_SIZE = 4 * 1024 * 1024;
+
+	BlockWriter();
+	~BlockWriter();
+
+	bool open(const std::string &path);
+	/* flush what is left and close the file; false if any write failed */
+	bool close();
+
+	void write(const void *data, size_t length);
+
+	/* room for a small value that must not straddle two blocks */
+	char* reserve(size_t length) {
+		if (m_used + length > BLOCK_SIZE) {
+			handOff();
+		}
+		char *result = m_current + m_used;
+		m_used += length;
+		return result;
+	}
+
+	template<typename T> void writeHost(T value) {
+		::memcpy(reserve(sizeof(T)), &value, sizeof(T));
+	}
+
+	template<typename T> void writeBigEndian(T value) {
+		endianness::fromHostToBigEndian<T>(value);
+		writeHost<T>(value);
+	}
+
+	int64_t bytesWritten() const {
+		return m_bytesWritten;
+	}
+
+private:
+	/* pass the current block to the writer thread and take the other one */
+	void handOff();
+	static void* run(void *arg);
+
+	int m_fd;
+	char *m_blocks[2];
+	char *m_current;
+	size_t m_used;
+	int64_t m_bytesWritten;
+
+	pthread_t m_thread;
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_changed;
+	/* the block the writer thread has to write, or NULL */
+	char *m_pending;
+	size_t m_pendingLength;
+	bool m_closing;
+	bool m_failed;
+};
+
+/**
+ * Encodes the tuples of a table for one of the data migration shims
+ * straight from tuple storage into a BlockWriter. The psql, scidb and csv
+ * output is byte for byte what the Attribute classes write value by value,
+ * except that scidb strings are written as length + 1 bytes ending in '\0'
+ * where GenericAttribute<char*> wrote one byte past the end of the string.
+ *
+ * The columnar format is S-Store's own:
+ *   header:  "SSTORECF", int16 column count, then an int8 ValueType and an
+ *            int8 nullable flag per column
+ *   block:   int32 row count, then for every column a null bitmap of
+ *            (rows + 7) / 8 bytes with a bit set for every NULL, followed by
+ *            either rows fixed width values as stored in the tuple (NULLs
+ *            hold S-Store's null value) or, for VARCHAR and VARBINARY,
+ *            rows + 1 int32 offsets and the bytes they point into
+ *   trailer: int32 0
+ * Numbers are in host byte order.
+ */
+class TableExporter {
+public:
+	enum Format {
+		FORMAT_PSQL,
+		FORMAT_SCIDB,
+		FORMAT_CSV,
+		FORMAT_COLUMNAR
+	};
+
+	/* rows encoded together in a columnar block */
+	static const int ROWS_PER_BLOCK = 8192;
+
+	/* what Postgres::writeHeader starts a file with */
+	static const char PostgresSignature[11];
+
+	/* false if the shim name is not one we can write */
+	static bool formatForShim(const std::string &shim, Format &format);
+
+	TableExporter(const voltdb::TupleSchema *schema, Format format);
+
+	/* false if the file can't be created or the format can't hold the schema */
+	bool open(const std::string &path);
+
+	/**
+	 * Encode one tuple. The columnar format keeps the tuple's address
+	 * until its block is full, so the tuples must stay in place until
+	 * close().
+	 */
+	void append(const voltdb::TableTuple &tuple);
+
+	/* write the trailer and close the file; false if any write failed */
+	bool close();
+
+	int64_t rowCount() const {
+		return m_rowCount;
+	}
+
+private:
+	void appendPsql(const voltdb::TableTuple &tuple);
+	void appendScidb(const voltdb::TableTuple &tuple);
+	void appendCsv(const voltdb::TableTuple &tuple);
+	void flushColumnarBlock();
+
+	const voltdb::TupleSchema *m_schema;
+	const Format m_format;
+	const int m_columnCount;
+	BlockWriter m_writer;
+	int64_t m_rowCount;
+	std::vector<char*> m_pendingTuples;
+};
+
+#endif // TABLE_EXPORTER_H
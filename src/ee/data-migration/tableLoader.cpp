@@ -0,0 +1,483 @@
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "tableLoader.h"
+#include "endianness.h"
+#include "common/debuglog.h"
+#include "common/NValue.hpp"
+#include "common/SQLException.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "storage/persistenttable.h"
+
+using voltdb::NValue;
+using voltdb::ValueFactory;
+
+BlockReader::BlockReader() :
+		m_fd(-1), m_start(0), m_end(0), m_eof(false), m_failed(false) {
+}
+
+BlockReader::~BlockReader() {
+	if (m_fd >= 0) {
+		close();
+	}
+}
+
+bool BlockReader::open(const std::string &path) {
+	assert(m_fd < 0);
+	m_fd = ::open(path.c_str(), O_RDONLY);
+	if (m_fd < 0) {
+		VOLT_ERROR("Could not open %s: %s", path.c_str(), strerror(errno));
+		return false;
+	}
+	if (m_buffer.size() < BLOCK_SIZE) {
+		m_buffer.resize(BLOCK_SIZE);
+	}
+	m_start = 0;
+	m_end = 0;
+	m_eof = false;
+	m_failed = false;
+	return true;
+}
+
+void BlockReader::close() {
+	::close(m_fd);
+	m_fd = -1;
+}
+
+const char* BlockReader::read(size_t length) {
+	while (m_end - m_start < length) {
+		if (!fill(length)) {
+			return NULL;
+		}
+	}
+	const char *result = &m_buffer[m_start];
+	m_start += length;
+	return result;
+}
+
+bool BlockReader::readLine(const char *&line, size_t &length) {
+	size_t scanned = 0;
+	while (true) {
+		const char *begin = &m_buffer[m_start];
+		const char *newline = static_cast<const char*>(::memchr(begin + scanned, '\n', m_end - m_start - scanned));
+		if (newline != NULL) {
+			line = begin;
+			length = newline - begin;
+			m_start += length + 1;
+			return true;
+		}
+		scanned = m_end - m_start;
+		if (!fill(scanned + 1)) {
+			break;
+		}
+	}
+	if (m_start == m_end) {
+		return false;
+	}
+	// the last line does not end with '\n'
+	line = &m_buffer[m_start];
+	length = m_end - m_start;
+	m_start = m_end;
+	return true;
+}
+
+bool BlockReader::atEnd() {
+	return m_start == m_end && !fill(1);
+}
+
+bool BlockReader::fill(size_t wanted) {
+	if (m_eof || m_failed) {
+		return false;
+	}
+	if (m_start > 0) {
+		::memmove(&m_buffer[0], &m_buffer[m_start], m_end - m_start);
+		m_end -= m_start;
+		m_start = 0;
+	}
+	if (m_buffer.size() < wanted) {
+		m_buffer.resize(std::max(wanted, m_buffer.size() * 2));
+	}
+	while (true) {
+		ssize_t result = ::read(m_fd, &m_buffer[m_end], m_buffer.size() - m_end);
+		if (result > 0) {
+			m_end += result;
+			return true;
+		} else if (result == 0) {
+			m_eof = true;
+			return false;
+		} else if (errno != EINTR) {
+			VOLT_ERROR("Failed to read the data to load: %s", strerror(errno));
+			m_failed = true;
+			return false;
+		}
+	}
+}
+
+template<typename T> static T readNumber(const char *data, bool bigEndian) {
+	T value;
+	::memcpy(&value, data, sizeof(T));
+	if (bigEndian) {
+		// swapping the bytes back is the same swap
+		endianness::fromHostToBigEndian<T>(value);
+	}
+	return value;
+}
+
+static bool truncated(int64_t row) {
+	VOLT_ERROR("The data to load ends in the middle of row %ld", (long) row + 1);
+	return false;
+}
+
+TableLoader::TableLoader(voltdb::PersistentTable *table, TableExporter::Format format) :
+		m_table(table), m_schema(table->schema()), m_format(format),
+		m_columnCount(m_schema->columnCount()),
+		m_stagingData(new char[m_schema->tupleLength() + TUPLE_HEADER_SIZE]),
+		m_staging(m_schema), m_rowCount(0) {
+	::memset(m_stagingData.get(), 0, m_schema->tupleLength() + TUPLE_HEADER_SIZE);
+	m_staging.move(m_stagingData.get());
+	m_staging.setAllNulls();
+}
+
+TableLoader::~TableLoader() {
+}
+
+bool TableLoader::load(const std::string &path) {
+	if (m_format == TableExporter::FORMAT_COLUMNAR) {
+		VOLT_ERROR("Tables can't be loaded from the columnar format");
+		return false;
+	}
+	if (m_format != TableExporter::FORMAT_CSV) {
+		for (int i = 0; i < m_columnCount; ++i) {
+			if (m_schema->columnType(i) == voltdb::VALUE_TYPE_DECIMAL) {
+				VOLT_ERROR("DECIMAL column %d can only be loaded from csv", i);
+				return false;
+			}
+		}
+	}
+	if (!m_reader.open(path)) {
+		return false;
+	}
+
+	m_rowCount = 0;
+	m_table->beginBulkLoad();
+	bool loaded = false;
+	try {
+		switch (m_format) {
+		case TableExporter::FORMAT_PSQL:
+			loaded = loadPsql();
+			break;
+		case TableExporter::FORMAT_SCIDB:
+			loaded = loadScidb();
+			break;
+		default:
+			loaded = loadCsv();
+		}
+	} catch (voltdb::SQLException &e) {
+		VOLT_ERROR("Row %ld of %s can't be loaded: %s", (long) m_rowCount + 1, path.c_str(),
+				e.message().c_str());
+		loaded = false;
+	}
+	if (m_reader.failed()) {
+		loaded = false;
+	}
+	m_reader.close();
+
+	if (!loaded) {
+		// the strings of a row that was not handed over yet
+		m_staging.freeObjectColumns();
+		m_staging.setAllNulls();
+		m_table->abortBulkLoad();
+		m_rowCount = 0;
+		return false;
+	}
+	if (!m_table->finishBulkLoad()) {
+		m_rowCount = 0;
+		return false;
+	}
+	return true;
+}
+
+/* the header, then per row a field count and a big-endian length and value per field, then -1 */
+bool TableLoader::loadPsql() {
+	const size_t headerLength = sizeof(TableExporter::PostgresSignature) + sizeof(uint32_t) + sizeof(int32_t);
+	const char *data = m_reader.read(headerLength);
+	if (data == NULL || ::memcmp(data, TableExporter::PostgresSignature, sizeof(TableExporter::PostgresSignature)) != 0) {
+		VOLT_ERROR("The data to load is not in PostgreSQL binary format");
+		return false;
+	}
+	const int32_t extension = readNumber<int32_t>(data + headerLength - sizeof(int32_t), true);
+	if (extension < 0 || (extension > 0 && m_reader.read(extension) == NULL)) {
+		return truncated(m_rowCount);
+	}
+
+	while (true) {
+		data = m_reader.read(sizeof(int16_t));
+		if (data == NULL) {
+			return truncated(m_rowCount);
+		}
+		const int16_t fields = readNumber<int16_t>(data, true);
+		if (fields == -1) {
+			return true;
+		}
+		if (fields != m_columnCount) {
+			VOLT_ERROR("Row %ld has %d fields but the table has %d columns",
+					(long) m_rowCount + 1, (int) fields, m_columnCount);
+			return false;
+		}
+		for (int i = 0; i < m_columnCount; ++i) {
+			data = m_reader.read(sizeof(int32_t));
+			if (data == NULL) {
+				return truncated(m_rowCount);
+			}
+			const int32_t length = readNumber<int32_t>(data, true);
+			if (length == -1) {
+				m_staging.setNValue(i, NValue::getNullValue(m_schema->columnType(i)));
+				continue;
+			}
+			if (length < 0 || (data = m_reader.read(length)) == NULL) {
+				return truncated(m_rowCount);
+			}
+			const voltdb::ValueType type = m_schema->columnType(i);
+			const bool set = (type == voltdb::VALUE_TYPE_VARCHAR || type == voltdb::VALUE_TYPE_VARBINARY) ?
+					setObject(i, data, length) : setFixed(i, data, length, true);
+			if (!set) {
+				return false;
+			}
+		}
+		if (!appendStaged()) {
+			return false;
+		}
+	}
+}
+
+/* nullable fields start with a byte that is -1 unless the value is NULL; strings end in '\0' */
+bool TableLoader::loadScidb() {
+	while (!m_reader.atEnd()) {
+		for (int i = 0; i < m_columnCount; ++i) {
+			const voltdb::ValueType type = m_schema->columnType(i);
+			bool isNull = false;
+			if (m_schema->columnAllowNull(i)) {
+				const char *marker = m_reader.read(sizeof(int8_t));
+				if (marker == NULL) {
+					return truncated(m_rowCount);
+				}
+				isNull = (static_cast<int8_t>(*marker) != -1);
+			}
+
+			const char *data;
+			int32_t length;
+			if (type == voltdb::VALUE_TYPE_VARCHAR || type == voltdb::VALUE_TYPE_VARBINARY) {
+				data = m_reader.read(sizeof(uint32_t));
+				if (data == NULL) {
+					return truncated(m_rowCount);
+				}
+				length = static_cast<int32_t>(readNumber<uint32_t>(data, false));
+				if (length < 0 || (data = m_reader.read(length)) == NULL) {
+					return truncated(m_rowCount);
+				}
+				if (!isNull) {
+					if (length > 0 && data[length - 1] == '\0') {
+						--length;
+					}
+					if (!setObject(i, data, length)) {
+						return false;
+					}
+					continue;
+				}
+			} else {
+				length = NValue::getTupleStorageSize(type);
+				if ((data = m_reader.read(length)) == NULL) {
+					return truncated(m_rowCount);
+				}
+				if (!isNull) {
+					if (!setFixed(i, data, length, false)) {
+						return false;
+					}
+					continue;
+				}
+			}
+			m_staging.setNValue(i, NValue::getNullValue(type));
+		}
+		if (!appendStaged()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* '|' between fields, and an empty field is NULL */
+bool TableLoader::loadCsv() {
+	const char *line;
+	size_t lineLength;
+	while (m_reader.readLine(line, lineLength)) {
+		const char *field = line;
+		const char *end = line + lineLength;
+		for (int i = 0; i < m_columnCount; ++i) {
+			const char *delimiter = static_cast<const char*>(::memchr(field, '|', end - field));
+			if (delimiter == NULL) {
+				if (i + 1 < m_columnCount) {
+					VOLT_ERROR("Row %ld has %d fields but the table has %d columns",
+							(long) m_rowCount + 1, i + 1, m_columnCount);
+					return false;
+				}
+				delimiter = end;
+			}
+			if (!setText(i, field, delimiter - field)) {
+				return false;
+			}
+			field = delimiter + 1;
+		}
+		if (!appendStaged()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* integers of 1, 2, 4 or 8 bytes are narrowed to the column type (psql has no tinyint) */
+bool TableLoader::setFixed(int column, const char *data, int32_t length, bool bigEndian) {
+	const voltdb::ValueType type = m_schema->columnType(column);
+	if (type == voltdb::VALUE_TYPE_DOUBLE) {
+		if (length != sizeof(double)) {
+			VOLT_ERROR("Row %ld has %d bytes for DOUBLE column %d", (long) m_rowCount + 1, length, column);
+			return false;
+		}
+		m_staging.setNValue(column, ValueFactory::getDoubleValue(readNumber<double>(data, bigEndian)));
+		return true;
+	}
+
+	int64_t value;
+	switch (length) {
+	case sizeof(int8_t):
+		value = readNumber<int8_t>(data, bigEndian);
+		break;
+	case sizeof(int16_t):
+		value = readNumber<int16_t>(data, bigEndian);
+		break;
+	case sizeof(int32_t):
+		value = readNumber<int32_t>(data, bigEndian);
+		break;
+	case sizeof(int64_t):
+		value = readNumber<int64_t>(data, bigEndian);
+		break;
+	default:
+		VOLT_ERROR("Row %ld has %d bytes for %s column %d", (long) m_rowCount + 1, length,
+				voltdb::getTypeName(type).c_str(), column);
+		return false;
+	}
+	if (type == voltdb::VALUE_TYPE_TIMESTAMP) {
+		m_staging.setNValue(column, ValueFactory::getTimestampValue(value));
+	} else {
+		m_staging.setNValue(column, ValueFactory::getBigIntValue(value));
+	}
+	return true;
+}
+
+bool TableLoader::setText(int column, const char *text, size_t length) {
+	const voltdb::ValueType type = m_schema->columnType(column);
+	if (length == 0) {
+		m_staging.setNValue(column, NValue::getNullValue(type));
+		return true;
+	}
+	switch (type) {
+	case voltdb::VALUE_TYPE_VARCHAR:
+	case voltdb::VALUE_TYPE_VARBINARY:
+		return setObject(column, text, static_cast<int32_t>(length));
+	case voltdb::VALUE_TYPE_DECIMAL:
+		m_staging.setNValue(column, ValueFactory::getDecimalValueFromString(std::string(text, length)));
+		return true;
+	default:
+		break;
+	}
+
+	char number[64];
+	if (length >= sizeof(number)) {
+		VOLT_ERROR("Row %ld has a %d character number for column %d", (long) m_rowCount + 1, (int) length, column);
+		return false;
+	}
+	::memcpy(number, text, length);
+	number[length] = '\0';
+	char *parsed;
+	errno = 0;
+	if (type == voltdb::VALUE_TYPE_DOUBLE) {
+		const double value = ::strtod(number, &parsed);
+		m_staging.setNValue(column, ValueFactory::getDoubleValue(value));
+	} else {
+		const int64_t value = ::strtoll(number, &parsed, 10);
+		if (type == voltdb::VALUE_TYPE_TIMESTAMP) {
+			m_staging.setNValue(column, ValueFactory::getTimestampValue(value));
+		} else {
+			m_staging.setNValue(column, ValueFactory::getBigIntValue(value));
+		}
+	}
+	if (parsed != number + length || errno != 0) {
+		VOLT_ERROR("Row %ld has '%s' for %s column %d", (long) m_rowCount + 1, number,
+				voltdb::getTypeName(type).c_str(), column);
+		return false;
+	}
+	return true;
+}
+
+bool TableLoader::setObject(int column, const char *data, int32_t length) {
+	if (length > m_schema->columnLength(column)) {
+		VOLT_ERROR("Row %ld has %d bytes for column %d of at most %d", (long) m_rowCount + 1, length,
+				column, m_schema->columnLength(column));
+		return false;
+	}
+	const NValue value = (m_schema->columnType(column) == voltdb::VALUE_TYPE_VARBINARY) ?
+			ValueFactory::getBinaryValue(reinterpret_cast<unsigned char*>(const_cast<char*>(data)), length) :
+			ValueFactory::getStringValue(data, length);
+	m_staging.setNValue(column, value);
+	// an inlined column keeps a copy of the bytes
+	if (m_schema->columnIsInlined(column)) {
+		value.free();
+	}
+	return true;
+}
+
+bool TableLoader::appendStaged() {
+	if (!m_table->appendTupleForBulkLoad(m_staging)) {
+		VOLT_ERROR("Row %ld has a NULL in a NOT NULL column", (long) m_rowCount + 1);
+		return false;
+	}
+	// the table owns the strings now
+	const uint16_t uninlinedCount = m_schema->getUninlinedObjectColumnCount();
+	for (uint16_t i = 0; i < uninlinedCount; ++i) {
+		const int column = m_schema->getUninlinedObjectColumnInfoIndex(i);
+		m_staging.setNValue(column, NValue::getNullValue(m_schema->columnType(column)));
+	}
+	++m_rowCount;
+	return true;
+}
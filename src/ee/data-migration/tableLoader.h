@@ -0,0 +1,124 @@
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TABLE_LOADER_H
+#define TABLE_LOADER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/scoped_array.hpp>
+
+#include "tableExporter.h"
+#include "common/tabletuple.h"
+
+namespace voltdb {
+class PersistentTable;
+class TupleSchema;
+}
+
+/**
+ * Sequential input in large chunks. The file is read a block at a time
+ * into one buffer and the parser works on the bytes in place.
+ */
+class BlockReader {
+public:
+	static const size_t BLOCK_SIZE = 4 * 1024 * 1024;
+
+	BlockReader();
+	~BlockReader();
+
+	bool open(const std::string &path);
+	void close();
+
+	/* the next length bytes, or NULL if the file ends first; valid until the next call */
+	const char* read(size_t length);
+
+	/* the next line without its '\n'; false at the end of the file */
+	bool readLine(const char *&line, size_t &length);
+
+	/* true once every byte of the file has been consumed */
+	bool atEnd();
+
+	bool failed() const {
+		return m_failed;
+	}
+
+private:
+	/* keep what is left, make room for at least wanted bytes and read more; false if nothing came */
+	bool fill(size_t wanted);
+
+	int m_fd;
+	std::vector<char> m_buffer;
+	size_t m_start;
+	size_t m_end;
+	bool m_eof;
+	bool m_failed;
+};
+
+/**
+ * Loads a file written by one of the data migration shims (psql, scidb
+ * or csv, as TableExporter writes them) into a persistent table. Rows are
+ * parsed from the BlockReader into a staging tuple and appended straight
+ * into the table's blocks, and the indexes are built once at the end
+ * (PersistentTable::finishBulkLoad). Either every row is loaded or none.
+ */
+class TableLoader {
+public:
+	TableLoader(voltdb::PersistentTable *table, TableExporter::Format format);
+	~TableLoader();
+
+	/* false if the file can't be read or parsed, or a row breaks a constraint */
+	bool load(const std::string &path);
+
+	int64_t rowCount() const {
+		return m_rowCount;
+	}
+
+private:
+	bool loadPsql();
+	bool loadScidb();
+	bool loadCsv();
+
+	bool setFixed(int column, const char *data, int32_t length, bool bigEndian);
+	bool setText(int column, const char *text, size_t length);
+	bool setObject(int column, const char *data, int32_t length);
+	/* hand the staging tuple over to the table and start the next one */
+	bool appendStaged();
+
+	voltdb::PersistentTable *m_table;
+	const voltdb::TupleSchema *m_schema;
+	const TableExporter::Format m_format;
+	const int m_columnCount;
+	BlockReader m_reader;
+	boost::scoped_array<char> m_stagingData;
+	voltdb::TableTuple m_staging;
+	int64_t m_rowCount;
+};
+
+#endif // TABLE_LOADER_H
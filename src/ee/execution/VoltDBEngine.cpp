@@ -70,6 +70,7 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <stdio.h>
 #include <inttypes.h>
@@ -113,6 +114,7 @@
 #include "catalog/connector.h"
 #include "plannodes/abstractplannode.h"
 #include "plannodes/abstractscannode.h"
+#include "plannodes/abstractoperationnode.h"
 #include "plannodes/nodes.h"
 #include "plannodes/plannodeutil.h"
 #include "plannodes/plannodefragment.h"
@@ -124,6 +126,7 @@
 #include "storage/constraintutil.h"
 #include "storage/persistenttable.h"
 #include "storage/WindowTable.h"
+#include "streaming/WindowTableTemp.h"
 #include "storage/MaterializedViewMetadata.h"
 #include "storage/StreamBlock.h"
 #include "storage/TableCatalogDelegate.hpp"
@@ -135,9 +138,14 @@
 // ARIES
 #include "logging/Logrecord.h"
 #include "logging/AriesLogProxy.h"
+#include "logging/AriesReplayLog.h"
+#include "logging/AriesRedoPipeline.h"
+#include "common/RedoUndoQuantum.hpp"
 #include <string>
 #include "data-migration/attribute.h"
 #include "data-migration/postgres.h"
+#include "data-migration/tableExporter.h"
+#include "data-migration/tableLoader.h"
 #include "data-migration/typeAttributeMap.h"
 
 #include "common/NValue.hpp"
@@ -159,7 +167,9 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy) :
 		MAX_PARAM_COUNT), m_currentOutputDepId(-1), m_currentInputDepId(-1), m_isELEnabled(
 				false), m_stringPool(16777216, 2), m_numResultDependencies(0), m_templateSingleLongTable(
 				NULL), m_topend(topend), m_logProxy(logProxy), m_logManager(
-				new LogManager(logProxy)), m_ARIESEnabled(false) {
+				new LogManager(logProxy)), m_ARIESEnabled(false), m_ariesRedoThreads(1),
+				m_batchTriggers(false), m_pipelineExecutors(false),
+				m_trackingBlockGranularity(false) {
 	m_currentUndoQuantum = new DummyUndoQuantum();
 
 	// init the number of planfragments executed
@@ -170,6 +180,7 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy) :
 
 	m_ariesWriteOffset = 0;
 	m_isRecovering = false;
+	m_ariesCommittedEntry = 0;
 	// m_logManager.setAriesProxyEngine(this);
 }
 
@@ -355,7 +366,7 @@ int VoltDBEngine::executeQuery(int64_t planfragmentId,
 	std::map<int64_t, boost::shared_ptr<ExecutorVector> >::const_iterator iter =
 			m_executorMap.find(planfragmentId);
 	assert(iter != m_executorMap.end());
-	boost::shared_ptr<ExecutorVector> execsForFrag = iter->second;
+	ExecutorVector *execsForFrag = iter->second.get();
 
 	// Read/Write Set Tracking
 	ReadWriteTracker *tracker = NULL;
@@ -371,12 +382,23 @@ int VoltDBEngine::executeQuery(int64_t planfragmentId,
 	bool send_tuple_count = false;
 
 	// MEEHAN: Moved inner query plan into its own function
-	int errorcode = executeQueryNoOutput(planfragmentId, params, txnId,
-			send_tuple_count);
+	int errorcode = executeQueryNoOutput(execsForFrag, planfragmentId,
+			params, txnId, tracker, send_tuple_count);
 	if (errorcode != ENGINE_ERRORCODE_SUCCESS) {
+		m_pendingTriggerTables.clear();
 		return errorcode;
 	}
 
+	// Coalesced triggers run once the whole batch has been applied. Their
+	// writes dirty the batch but are not part of this fragment's tuple count.
+	if (last && !m_pendingTriggerTables.empty()) {
+		int64_t tuplesModified = m_tuplesModified;
+		firePendingTriggers();
+		if (m_tuplesModified > tuplesModified)
+			m_dirtyFragmentBatch = true;
+		m_tuplesModified = tuplesModified;
+	}
+
 	// assume this is sendless dml
 	if (send_tuple_count || m_numResultDependencies == 0) {
 		// put the number of tuples modified into our simple table
@@ -396,6 +418,14 @@ int VoltDBEngine::executeQuery(int64_t planfragmentId,
 	if (m_tuplesModified > 0)
 		m_dirtyFragmentBatch = true;
 
+#ifdef ARIES
+	// a transaction without undo logging is never released, so its batch
+	// is committed here; the frontend holds the results until it is synced
+	if (last && (m_currentUndoQuantum == NULL || m_currentUndoQuantum->isDummy())) {
+		commitAriesTransaction();
+	}
+#endif
+
 	// write dirty-ness of the batch and number of dependencies output to the FRONT of
 	// the result buffer
 	if (last) {
@@ -426,9 +456,6 @@ int VoltDBEngine::executeQueryNoOutput(int64_t planfragmentId,
 	std::map<int64_t, boost::shared_ptr<ExecutorVector> >::const_iterator iter =
 			m_executorMap.find(planfragmentId);
 	assert(iter != m_executorMap.end());
-	boost::shared_ptr<ExecutorVector> execsForFrag = iter->second;
-
-	Table *cleanUpTable = NULL;
 
 	// Read/Write Set Tracking
 	ReadWriteTracker *tracker = NULL;
@@ -438,11 +465,25 @@ int VoltDBEngine::executeQueryNoOutput(int64_t planfragmentId,
 		tracker = trackerMgr->getTracker(txnId);
 	}
 
+	return executeQueryNoOutput(iter->second.get(), planfragmentId, params,
+			txnId, tracker, send_tuple_count);
+}
+
+int VoltDBEngine::executeQueryNoOutput(ExecutorVector *execsForFrag,
+		int64_t planfragmentId, const NValueArray &params, int64_t txnId,
+		ReadWriteTracker *tracker, bool& send_tuple_count) {
+	assert(execsForFrag);
+	Table *cleanUpTable = NULL;
+
 	size_t ttl = execsForFrag->list.size();
 	for (int ctr = 0; ctr < ttl; ++ctr) {
 		AbstractExecutor *executor = execsForFrag->list[ctr];
 		assert(executor);
 
+		// driven by the child that pushes its input to it
+		if (executor->isPipelined())
+			continue;
+
 		if (executor->needsPostExecuteClear())
 			cleanUpTable =
 					dynamic_cast<Table*>(executor->getPlanNode()->getOutputTable());
@@ -559,46 +600,84 @@ int VoltDBEngine::executePlanFragment(string fragmentString,
 }
 
 void VoltDBEngine::fireTrigger(Trigger* trigger) {
-	/*
-	 struct timeval start_;
-	 struct timeval end_;
-	 struct timespec start;
-	 struct timespec end;
+	VOLT_DEBUG("fireTrigger");
+	// Run each fragment of the trigger's statements through the executors
+	// resolved for it in rebuildPlanFragmentCollections().
+	int64_t txnId = m_executorContext->currentTxnId();
+	ReadWriteTracker *tracker = NULL;
+	if (m_executorContext->isTrackingEnabled()) {
+		tracker = m_executorContext->getTrackerManager()->getTracker(txnId);
+	}
 
+	const vector<ExecutorVector*> &execs = trigger->getExecutorVectors();
+	assert(execs.size() == trigger->getFragments()->size());
+	const vector<const catalog::PlanFragment*> &frags = *trigger->getFragments();
+	// One clock read per fragment boundary; times include any triggers the
+	// fragments cascade into.
+	int64_t firingStart = LatencyHistogram::now();
+	int64_t fragmentStart = firingStart;
+	for (size_t ii = 0; ii < execs.size(); ii++) {
+		bool send_tuple_count = false;
+		executeQueryNoOutput(execs[ii], (int64_t)(frags[ii]->id()),
+				m_triggerParams, txnId, tracker, send_tuple_count);
+		int64_t fragmentEnd = LatencyHistogram::now();
+		trigger->recordFragmentLatency(ii, fragmentEnd - fragmentStart);
+		fragmentStart = fragmentEnd;
+	}
+	trigger->recordFiringLatency(fragmentStart - firingStart);
+}
 
-	 int error = gettimeofday(&start_, NULL);
-	 assert(error == 0);
-	 */
-	VOLT_DEBUG("fireTrigger");
-	// TODO: Loop through all the single-partition plan fragment ids for
-	// the target Statement. Then for each of them, invoke executeQueryNoOutput()
-	// Throw an exception if something bad happens...
-	int64_t txnId = this->getExecutorContext()->currentTxnId();
-	bool send_tuple_count = false;
-	const NValueArray params;
-	//assert(m_frags != NULL);
-	//assert(m_frags.size() != 0);
-	vector<const catalog::PlanFragment*>* frags = trigger->getFragments();
-	vector<const catalog::PlanFragment *>::const_iterator frag_iter =
-			frags->begin();
+void VoltDBEngine::fireTableTriggers(PersistentTable* table) {
+	if (!table->hasTriggers() || !table->fireTriggers())
+		return;
 
-	for (; frag_iter != frags->end(); frag_iter++) {
-		VOLT_DEBUG("fragment");
-		int64_t planfragmentId = (int64_t)((*frag_iter)->id());
-		executeQueryNoOutput(planfragmentId, params, txnId, send_tuple_count);
-		send_tuple_count = false;
+	// Windows decide themselves when a slide is complete and clear their fire
+	// flag after firing, so they never wait for the end of the batch.
+	bool isWindow = dynamic_cast<WindowTable*>(table) != NULL
+			|| dynamic_cast<WindowTableTemp*>(table) != NULL;
+	if (m_batchTriggers && !isWindow) {
+		// The stream keeps accumulating until the batch ends, so each queued
+		// table fires once over everything inserted into it since its last firing.
+		if (std::find(m_pendingTriggerTables.begin(),
+				m_pendingTriggerTables.end(), table)
+				== m_pendingTriggerTables.end()) {
+			VOLT_DEBUG("Deferring triggers of table '%s'", table->name().c_str());
+			m_pendingTriggerTables.push_back(table);
+		}
+		return;
 	}
+	runTableTriggers(table);
+}
 
-	/*
-	 error = gettimeofday(&end_, NULL);
-	 assert(error == 0);
+void VoltDBEngine::firePendingTriggers() {
+	// Trigger fragments may insert into further streams, which queue
+	// themselves behind the current one; drain until the chain settles.
+	while (!m_pendingTriggerTables.empty()) {
+		PersistentTable* table = m_pendingTriggerTables.front();
+		m_pendingTriggerTables.pop_front();
+		runTableTriggers(table);
+	}
+}
 
-	 TIMEVAL_TO_TIMESPEC(&start_, &start);
-	 TIMEVAL_TO_TIMESPEC(&end_, &end);
-	 m_latency = timespecDiffNanoseconds(end, start);
+void VoltDBEngine::runTableTriggers(PersistentTable* table) {
+	VOLT_DEBUG("Start firing triggers of table '%s'", table->name().c_str());
+	std::vector<Trigger*>::iterator trig_iter;
+	for (trig_iter = table->getTriggers()->begin();
+			trig_iter != table->getTriggers()->end(); trig_iter++) {
+		fireTrigger(*trig_iter);
+	}
+	VOLT_DEBUG("End firing triggers of table '%s'", table->name().c_str());
 
-	 VOLT_DEBUG("m_latency: %ld", m_latency);
-	 */
+	if (table->isStream())
+		table->deleteAllTuples(true);
+
+	WindowTable* windowTable = dynamic_cast<WindowTable*>(table);
+	if (windowTable != NULL)
+		windowTable->setFireTriggers(false);
+
+	WindowTableTemp* windowTableTemp = dynamic_cast<WindowTableTemp*>(table);
+	if (windowTableTemp != NULL)
+		windowTableTemp->setFireTriggers(false);
 }
 
 // -------------------------------------------------
@@ -820,7 +899,7 @@ bool VoltDBEngine::loadTable(PersistentTable *table,
 #ifdef ARIES
 	// Don't do this if we are recovering
 	if (isARIESEnabled() && isExecutionNormal) {
-		LogRecord *logrecord = new LogRecord(computeTimeStamp(),
+		LogRecord logrecord(computeTimeStamp(),
 				LogRecord::T_BULKLOAD,	// we are bulk loading bytes directly
 				LogRecord::T_FORWARD,// the system is running normally
 				-1,// XXX: prevLSN
@@ -834,29 +913,13 @@ bool VoltDBEngine::loadTable(PersistentTable *table,
 				NULL// no TableTuple for after image, will store bytes directly
 		);
 
-		size_t logrecordEstLength = logrecord->getEstimatedLength();
-
-		// We could also include the length of the
-		// entire buffer of raw tuples while allocating
-		// the log record buffer but that might just be too slow
-		// and the allocated array just way too big.
-		char *logrecordBuffer = new char[logrecordEstLength];
-
-		FallbackSerializeOutput output;
-		output.initializeWithPosition(logrecordBuffer, logrecordEstLength, 0);
-
-		logrecord->serializeTo(output);
-
-		LogManager* m_logManager = getLogManager();
-		Logger m_ariesLogger = m_logManager->getAriesLogger();
-
-		const Logger *logger = m_logManager->getThreadLogger(LOGGERID_MM_ARIES);
+		const Logger *logger = getLogManager()->getThreadLogger(LOGGERID_MM_ARIES);
 
 		assert(logger != NULL);
 
 		// we could ALSO directly write via writeToAriesLogBuffer(buffer, size)
 		// but not doing that for consistency while logging to Aries.
-		logger->log(LOGLEVEL_INFO, output.data(), output.position());
+		logger->log(LOGLEVEL_INFO, logrecord);
 
 		// CAREFUL -- the number of bytes might just be too many
 		// Its possible they could cause a buffer overflow
@@ -873,12 +936,6 @@ bool VoltDBEngine::loadTable(PersistentTable *table,
 
 		// next log the raw bytes of the bulkload array
 		logger->log(LOGLEVEL_INFO, reinterpret_cast<const char *>(serializeIn.getRawPointer(0)), numBytes);
-
-		delete[] logrecordBuffer;
-		logrecordBuffer = NULL;
-
-		delete logrecord;
-		logrecord = NULL;
 	}
 #endif
 
@@ -904,6 +961,7 @@ bool VoltDBEngine::rebuildTableCollections() {
 
 	// need to re-map all the table ids.
 	getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_TABLE);
+	getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_TRIGGER);
 
 	//map<string, catalog::Table*>::const_iterator it = m_database->tables().begin();
 	map<string, CatalogDelegate*>::iterator cdIt = m_catalogDelegates.begin();
@@ -946,20 +1004,19 @@ bool VoltDBEngine::rebuildTableCollections() {
 						catTable->relativeIndex(), index->getIndexStats());
 			}
 			// add all of the triggers to the stats source
-			/*
-			 if(persistTarget != NULL && persistTarget->hasTriggers())
-			 {
-			 std::vector<Trigger*>::iterator trig_iter;
-			 for(trig_iter = persistTarget->getTriggers()->begin(); trig_iter != persistTarget->getTriggers()->end(); trig_iter++)
-			 {
-			 VOLT_DEBUG("getStatsManager().registerStatsSource for trigger id: %d", (*trig_iter)->id());
-
-			 getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_TRIGGER,
-			 (*trig_iter)->id(), //catTable->relativeIndex(),
-			 (*trig_iter)->getTriggerStats());
-			 }
-			 }
-			 */
+			PersistentTable *persistTarget =
+					dynamic_cast<PersistentTable*>(tcd->getTable());
+			if (persistTarget != NULL && persistTarget->hasTriggers()) {
+				std::vector<Trigger*>::iterator trig_iter;
+				for (trig_iter = persistTarget->getTriggers()->begin();
+						trig_iter != persistTarget->getTriggers()->end(); trig_iter++) {
+					VOLT_DEBUG("getStatsManager().registerStatsSource for trigger id: %d",
+							(*trig_iter)->id());
+					getStatsManager().registerStatsSource(
+							STATISTICS_SELECTOR_TYPE_TRIGGER, (*trig_iter)->id(),
+							(*trig_iter)->getTriggerStats());
+				}
+			}
 		}
 		cdIt++;
 	}
@@ -1007,6 +1064,7 @@ bool VoltDBEngine::rebuildMultipartitionPlanFragment(
  * Delete and rebuild all plan fragments.
  */
 bool VoltDBEngine::rebuildPlanFragmentCollections() {
+	clearTriggerExecutors();
 	for (int ii = 0; ii < m_planFragments.size(); ii++)
 		delete m_planFragments[ii];
 	m_planFragments.clear();
@@ -1105,6 +1163,49 @@ bool VoltDBEngine::rebuildPlanFragmentCollections() {
 		}
 	}
 
+	return resolveTriggerExecutors();
+}
+
+void VoltDBEngine::clearTriggerExecutors() {
+	std::map<int32_t, Table*>::const_iterator table_iter;
+	for (table_iter = m_tables.begin(); table_iter != m_tables.end(); table_iter++) {
+		PersistentTable *table = dynamic_cast<PersistentTable*>(table_iter->second);
+		if (table == NULL || !table->hasTriggers())
+			continue;
+		std::vector<Trigger*>::iterator trig_iter;
+		for (trig_iter = table->getTriggers()->begin();
+				trig_iter != table->getTriggers()->end(); trig_iter++) {
+			(*trig_iter)->clearExecutorVectors();
+		}
+	}
+}
+
+bool VoltDBEngine::resolveTriggerExecutors() {
+	std::map<int32_t, Table*>::const_iterator table_iter;
+	for (table_iter = m_tables.begin(); table_iter != m_tables.end(); table_iter++) {
+		PersistentTable *table = dynamic_cast<PersistentTable*>(table_iter->second);
+		if (table == NULL || !table->hasTriggers())
+			continue;
+		std::vector<Trigger*>::iterator trig_iter;
+		for (trig_iter = table->getTriggers()->begin();
+				trig_iter != table->getTriggers()->end(); trig_iter++) {
+			std::vector<ExecutorVector*> execs;
+			std::vector<const catalog::PlanFragment*>::const_iterator frag_iter;
+			for (frag_iter = (*trig_iter)->getFragments()->begin();
+					frag_iter != (*trig_iter)->getFragments()->end(); frag_iter++) {
+				int64_t planfragmentId = (int64_t)((*frag_iter)->id());
+				std::map<int64_t, boost::shared_ptr<ExecutorVector> >::const_iterator iter =
+						m_executorMap.find(planfragmentId);
+				if (iter == m_executorMap.end()) {
+					VOLT_ERROR("No executors for PlanFragment '%jd' of trigger '%s'",
+							(intmax_t)planfragmentId, (*trig_iter)->name().c_str());
+					return false;
+				}
+				execs.push_back(iter->second.get());
+			}
+			(*trig_iter)->setExecutorVectors(execs);
+		}
+	}
 	return true;
 }
 
@@ -1159,11 +1260,54 @@ bool VoltDBEngine::initPlanFragment(const int64_t fragId,
 			ctr++) {
 		ev->list.push_back(pnf->getExecuteList()[ctr]->getExecutor());
 	}
+	if (m_pipelineExecutors) {
+		pipelineExecutors(ev.get());
+	}
 	m_executorMap[fragId] = ev;
 
 	return true;
 }
 
+/*
+ * Does any scan in the tree under node read the given table?
+ */
+static bool scansTable(AbstractPlanNode* node, Table* table) {
+	AbstractScanPlanNode* scan = dynamic_cast<AbstractScanPlanNode*>(node);
+	if (scan != NULL && scan->getTargetTable() == table)
+		return true;
+	for (int ctr = 0; ctr < (int) node->getChildren().size(); ctr++) {
+		if (scansTable(node->getChildren()[ctr], table))
+			return true;
+	}
+	return false;
+}
+
+void VoltDBEngine::pipelineExecutors(ExecutorVector* execsForFrag) {
+	for (int ctr = 0; ctr < (int) execsForFrag->list.size(); ctr++) {
+		AbstractExecutor* executor = execsForFrag->list[ctr];
+		AbstractPlanNode* node = executor->getPlanNode();
+		if (!executor->canPushOutput() || node->getParents().size() != 1)
+			continue;
+		AbstractPlanNode* parentNode = node->getParents()[0];
+		AbstractExecutor* parent = parentNode->getExecutor();
+		if (parent == NULL || !parent->acceptsPushedTuples() ||
+				parent->forceTupleCount() ||
+				parentNode->getChildren().size() != 1)
+			continue;
+
+		// an operation must not see its own writes through the scan below it
+		AbstractOperationPlanNode* operation =
+				dynamic_cast<AbstractOperationPlanNode*>(parentNode);
+		if (operation != NULL &&
+				scansTable(parentNode, operation->getTargetTable()))
+			continue;
+
+		VOLT_DEBUG("Pipelining PlanNode #%02d into PlanNode #%02d",
+				node->getPlanNodeId(), parentNode->getPlanNodeId());
+		executor->setPipelineParent(parent);
+	}
+}
+
 bool VoltDBEngine::initPlanNode(const int64_t fragId, AbstractPlanNode* node,
 		int* tempTableMemoryInBytes) {
 	assert(node);
@@ -1383,106 +1527,39 @@ long VoltDBEngine::extractTable(int32_t tableId, std::string destinationShim, st
 	VOLT_INFO(" ** destination file %s", destinationFile.c_str());
 	VOLT_INFO(" ** partition id: %d", m_partitionId);
 	VOLT_INFO(" ** total partitions: %d", m_totalPartitions);
-	std::string defaultDelimiter = "|"; // for csv format
-	std::vector<std::string> types = getAttributeTypesVector(tupleSchema);
-	std::vector<boost::shared_ptr<Attribute> > attributes = std::vector<
-			boost::shared_ptr<Attribute> >();
-	TypeAttributeMap mapTypes = TypeAttributeMap();
-	mapTypes.getAttributesFromTypesVector(attributes, types);
-	uint32_t current_tuple_id = 0;
-	TableTuple tuple(tupleSchema);
-	TableIterator iterator(table);
-	long countedRows = 0L;
-	if (destinationShim == "psql") {
-		VOLT_INFO("Exporting data in postgresql binary format.");
-		FILE *fp = fopen(destinationFile.c_str(), "w");
-		Postgres::writeHeader(fp);
-		while (iterator.next(tuple)) {
-			//TODO check header?
-			//VOLT_INFO(" ** Extracting tuple %s", tuple.debug("").c_str());
-			current_tuple_id = table->getTupleID(tuple.address());
-			int attributeCounter = -1;
-			for (std::vector<boost::shared_ptr<Attribute> >::iterator it =
-					attributes.begin(); it != attributes.end(); ++it) {
-				++attributeCounter;
-				const NValue nvalue = tuple.getNValue(attributeCounter);
-				(*it)->readSstore(nvalue);
-				//fwrite(&value,sizeof(int),1,fp);
-				if (it == attributes.begin()) {
-					// write number of attributes in this tuple for postgres bin if it is the first attribute
-					Postgres::writeColNumber(fp, columnCount);
-				}
-				//BOOST_LOG_TRIVIAL(debug) << "do postgres write";
-				(*it)->postgresWriteBinary(fp);
-			}
-			countedRows++;
-			// Delete the tuple if it's for moving
-			if (!caching)
-				table->deleteTupleForUndo(tuple, tuple.tupleLength());
-		}
-		Postgres::writeFileTrailer(fp);
-		fclose(fp);
-	} else if (destinationShim == "scidb") {
-		VOLT_INFO("Exporting data in scidb binary format.");
-		FILE *fp = fopen(destinationFile.c_str(), "w");
-		while (iterator.next(tuple)) {
-			current_tuple_id = table->getTupleID(tuple.address());
-			int attributeCounter = -1;
-			for (std::vector<boost::shared_ptr<Attribute> >::iterator it =
-					attributes.begin(); it != attributes.end(); ++it) {
-				++attributeCounter;
-				const NValue nvalue = tuple.getNValue(attributeCounter);
-				(*it)->readSstore(nvalue);
-				(*it)->scidbWriteBinary(fp);
-			}
-			countedRows++;
-			// Delete the tuple if it's for moving
-			if (!caching)
-				table->deleteTupleForUndo(tuple, tuple.tupleLength());
-		}
-		fclose(fp);
-	} else if (destinationShim == "csv") {
-		VOLT_INFO("Exporting data in csv format.");
-		// change the output: file print (fp) in c++ way
-		std::ofstream fp(destinationFile.c_str());
-		while (iterator.next(tuple)) {
-			current_tuple_id = table->getTupleID(tuple.address());
-			int attributeCounter = -1;
-			for (std::vector<boost::shared_ptr<Attribute> >::iterator it =
-					attributes.begin(); it != attributes.end();) {
-				++attributeCounter;
-				const NValue nvalue = tuple.getNValue(attributeCounter);
-				(*it)->readSstore(nvalue);
-				(*it)->writeCsv(fp);
-				/* insert field delimiters and new line if it is
-				 * the end of the line processing */
-				++it;
-				if (it != attributes.end()) {
-					fp << defaultDelimiter;
-				} else {
-					fp << std::endl;
-				}
-			}
-			countedRows++;
-			// Delete the tuple if it's for moving
-			if (!caching)
-				table->deleteTupleForUndo(tuple, tuple.tupleLength());
-		}
-		fp.close();
-	} else {
+	TableExporter::Format format;
+	if (!TableExporter::formatForShim(destinationShim, format)) {
 		VOLT_ERROR(
 				"Unknown destination shim: %s (for data export of the table ID %d(name '%s')).",
 				destinationShim.c_str(), (int ) tableId, ret->name().c_str());
 		return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
 	}
-	/* if everything went okay, then return success;
-	 * TODO we have to find out how to return number of extracted rows from the table!!! */
-//	return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
-	return countedRows;
+	/* the tuples are encoded straight into large blocks that a writer
+	 * thread writes out while the next block is encoded */
+	TableExporter exporter(tupleSchema, format);
+	if (!exporter.open(destinationFile)) {
+		VOLT_ERROR("Could not export the table ID %d(name '%s') to %s",
+				(int ) tableId, ret->name().c_str(), destinationFile.c_str());
+		return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+	}
+	TableTuple tuple(tupleSchema);
+	TableIterator iterator(table);
+	while (iterator.next(tuple)) {
+		exporter.append(tuple);
+	}
+	if (!exporter.close()) {
+		VOLT_ERROR("Failed to write the export of the table ID %d(name '%s') to %s",
+				(int ) tableId, ret->name().c_str(), destinationFile.c_str());
+		return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+	}
+	/* when moving, everything is in the file now, so drop it all at once */
+	if (!caching)
+		table->dropAllTuples();
+	return exporter.rowCount();
 }
 
 /**
- * The method for data loading from other databases in csv formats.
+ * The method for data loading from other databases in psql, scidb or csv formats.
  *
  *
  */
@@ -1511,113 +1588,27 @@ long VoltDBEngine::loadTableFromFile(int32_t tableId, std::string destinationShi
 	}
 	/** loading */
 	VOLT_INFO("Load table from shim : %s", destinationShim.c_str());
-	/** add partition id to the file name */
-	const size_t bufferSize = 21; // enough to hold all numbers up to 64-bits
-	char partitionNumber[bufferSize];
-	snprintf(partitionNumber, bufferSize, "%d", m_partitionId);
 	VOLT_INFO(" ** source file %s", destinationFile.c_str());
 	VOLT_INFO(" ** partition id: %d", m_partitionId);
 	VOLT_INFO(" ** total partitions: %d", m_totalPartitions);
-	std::string defaultDelimiter = "|"; // for csv format
-	std::vector<std::string> types = getAttributeTypesVector(tupleSchema);
-	std::vector<boost::shared_ptr<Attribute> > attributes = std::vector<
-			boost::shared_ptr<Attribute> >();
-	TypeAttributeMap mapTypes = TypeAttributeMap();
-	mapTypes.getAttributesFromTypesVector(attributes, types);
-//	uint32_t current_tuple_id = 0;
-//	TableTuple tuple(tupleSchema);
-//	TableIterator iterator(table);
-	long countedRows = 0L;
-	if (destinationShim == "psql") {
-//		VOLT_INFO("Exporting data in postgresql binary format.");
-//		FILE *fp = fopen(destinationFile.c_str(), "w");
-//		Postgres::writeHeader(fp);
-//		while (iterator.next(tuple)) {
-//			//TODO check header?
-//			//VOLT_INFO(" ** Extracting tuple %s", tuple.debug("").c_str());
-//			current_tuple_id = table->getTupleID(tuple.address());
-//			int attributeCounter = -1;
-//			for (std::vector<boost::shared_ptr<Attribute> >::iterator it =
-//					attributes.begin(); it != attributes.end(); ++it) {
-//				++attributeCounter;
-//				const NValue nvalue = tuple.getNValue(attributeCounter);
-//				(*it)->readSstore(nvalue);
-//				//fwrite(&value,sizeof(int),1,fp);
-//				if (it == attributes.begin()) {
-//					// write number of attributes in this tuple for postgres bin if it is the first attribute
-//					Postgres::writeColNumber(fp, columnCount);
-//				}
-//				//BOOST_LOG_TRIVIAL(debug) << "do postgres write";
-//				(*it)->postgresWriteBinary(fp);
-//			}
-//			countedRows++;
-//		}
-//		Postgres::writeFileTrailer(fp);
-//		fclose(fp);
-	} else if (destinationShim == "scidb") {
-//		VOLT_INFO("Exporting data in scidb binary format.");
-//		FILE *fp = fopen(destinationFile.c_str(), "w");
-//		while (iterator.next(tuple)) {
-//			current_tuple_id = table->getTupleID(tuple.address());
-//			int attributeCounter = -1;
-//			for (std::vector<boost::shared_ptr<Attribute> >::iterator it =
-//					attributes.begin(); it != attributes.end(); ++it) {
-//				++attributeCounter;
-//				const NValue nvalue = tuple.getNValue(attributeCounter);
-//				(*it)->readSstore(nvalue);
-//				(*it)->scidbWriteBinary(fp);
-//			}
-//			countedRows++;
-//		}
-//		fclose(fp);
-	} else if (destinationShim == "csv") {
-		VOLT_INFO("Loading data in csv format.");
-		// change the output: file print (fp) in c++ way
-		string line;
-//		std::string destinationFile = "/tmp/postgres.out_2";
-		std::ifstream fp(destinationFile.c_str());
-		VOLT_INFO("File opened: %s.", destinationFile.c_str());
-		while (getline(fp, line)) {
-			VOLT_INFO("Read a line");
-//			char *cstr = new char[tupleSchema->tupleLength()];
-//			TableTuple *tuple = new TableTuple(cstr, tupleSchema);
-			TableTuple tuple(tupleSchema);
-			tuple.move(new char[tuple.tupleLength()]);
-
-		    std::vector<std::string> elems = split(line, defaultDelimiter[0]);
-			for (int i = 0; i < columnCount; i++) {
-				string elem = elems.at(i);
-				NValue data = getNValueForType(tupleSchema->columnType(i), elem);
-				tuple.setNValue(i, data);
-			}
-			VOLT_INFO("tuple constructed.");
-//			if (table->activeTupleCount() == 0) {
-//				table->insertTuple(tuple);
-//			}
-//			assert(table->activeTupleCount() > 0);
-			if (!table->insertTupleNoUndo(tuple)) {
-				VOLT_INFO("insertion failed.");
-				VOLT_ERROR("Failed to insert tuple into target table '%s'",
-					table->name().c_str());
-				return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
-			}
-//			delete [] cstr;
-			countedRows++;
-			VOLT_INFO("finish 1 row.");
-		}
-		fp.close();
-		VOLT_INFO("close input stream.");
-	} else {
+	TableExporter::Format format;
+	if (!TableExporter::formatForShim(destinationShim, format)) {
 		VOLT_ERROR(
-				"Unknown destination shim: %s (for data export of the table ID %d(name '%s')).",
+				"Unknown source shim: %s (for data load of the table ID %d(name '%s')).",
 				destinationShim.c_str(), (int ) tableId, ret->name().c_str());
 		return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
 	}
-	/* if everything went okay, then return success;
-	 * TODO we have to find out how to return number of extracted rows from the table!!! */
-//	return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
+	/* the file is read in large blocks, the rows are appended straight
+	 * into the table's blocks and the indexes are built once at the end;
+	 * if any row fails, none of them are loaded */
+	TableLoader loader(table, format);
+	if (!loader.load(destinationFile)) {
+		VOLT_ERROR("Could not load the table ID %d(name '%s') from %s",
+				(int ) tableId, ret->name().c_str(), destinationFile.c_str());
+		return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+	}
 	VOLT_INFO("Loading done in ee. Returning the result to jni.");
-	return countedRows;
+	return loader.rowCount();
 }
 
 
@@ -1946,18 +1937,25 @@ void VoltDBEngine::processRecoveryMessage(RecoveryProtoMsg *message) {
 }
 
 #ifdef ARIES
-void VoltDBEngine::ARIESInitialize(std::string dbDir, std::string logFile) {
+void VoltDBEngine::ARIESInitialize(std::string dbDir, std::string logFile, int redoThreads) {
 	VOLT_WARN("Enabling ARIES Feature at Partition %d ", m_partitionId);
 	setARIESDir(dbDir);
 	setARIESFile(logFile);
 	setARIESEnabled(true);
 
+	// no point in more redo threads than there are cores to run them
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	m_ariesRedoThreads = std::max(1, redoThreads);
+	if (cores > 0 && m_ariesRedoThreads > cores) {
+		m_ariesRedoThreads = static_cast<int>(cores);
+	}
+
 	// Do this only after ARIES dir is set
 	m_logManager = new LogManager(m_logProxy, this);
 	m_executorContext->enableARIES(dbDir);
 }
 #else
-void VoltDBEngine::ARIESInitialize(std::string dbDir, std::string logFile) {
+void VoltDBEngine::ARIESInitialize(std::string dbDir, std::string logFile, int redoThreads) {
 	VOLT_ERROR("ARIES feature was not enabled when compiling the EE");
 }
 #endif
@@ -1968,7 +1966,8 @@ char* VoltDBEngine::readAriesLogForReplay(int64_t* sizes) {
 		return NULL;
 	}
 
-	ifstream logfilestream;
+	// everything queued so far must be in the file we are about to read
+	m_logManager->getThreadLogger(LOGGERID_MM_ARIES)->flush();
 
 	// read custom file names later
 	ostringstream ss;
@@ -1977,53 +1976,149 @@ char* VoltDBEngine::readAriesLogForReplay(int64_t* sizes) {
 	string logFileName = ss.str();
 	VOLT_WARN("readAriesLogForReplay at : --%s--",logFileName.c_str());
 
-	logfilestream.open(logFileName.c_str(), ios::binary | ios::in);
+	// the log is mapped rather than read, replay pages it in as it goes
+	return AriesReplayLog::map(logFileName, &sizes[0]);
+}
 
-	if (!logfilestream.is_open()) {
-		sizes[0] = 0;
-		VOLT_WARN("Did not find aries log file at : %s", logFileName.c_str());
-		return NULL;	// log file does not exist
+void VoltDBEngine::freePointerToReplayLog(char *logData) {
+	if (logData != NULL) {
+		AriesReplayLog::unmap(logData);
 	}
+}
 
-	logfilestream.seekg(0, ios::end);
-	size_t length = logfilestream.tellg();
+/*
+ * Redo one insert, update, delete or truncate record on its table.
+ * Bulk loads are replayed by doAriesRecovery itself.
+ */
+static void redoLogRecord(PersistentTable *table, LogRecord &logrecord) {
+	TableTuple *beforeImage = NULL;
+	TableTuple *afterImage = NULL;
 
-	sizes[0] = length;
+	if (logrecord.getType() == LogRecord::T_INSERT) {
+		VOLT_DEBUG("Log record recovery : INSERT start");
 
-	logfilestream.seekg(0, ios::beg);
+		// at this point, don't worry about
+		// logging during recovery
+		// XXX: note that duplicate inserts won't happen silently:
+		// constraint failure exceptions will get thrown
+		afterImage = logrecord.getTupleAfterImage();
 
-	if (length == 0) {
-		logfilestream.close();
-		VOLT_WARN("Log file is empty : %s", logFileName.c_str());
-		return NULL; //log is empty
-	}
+		if (afterImage != NULL) {
+			table->insertTuple(*afterImage);
 
-	// XXX: change the code NOT to read all of the file at once
-	char *logData = new char[length];
-	logfilestream.read(logData, length);
+			// Job is done, delete the tuple now
+			logrecord.dellocateAfterImageData();
 
-	logfilestream.close();
+			//afterImage->freeObjectColumns();
+			delete afterImage;
+			afterImage = NULL;
+		}
 
-	/*
-	 while (!noMoreLogRecords) {
-	 // read small chunks of the file at a time
-	 char *logData = new char[BUFFER_SIZE];
-	 logfilestream.read(logData, BUFFER_SIZE);
+		VOLT_DEBUG("Log record recovery : INSERT end");
+	} else if (logrecord.getType() == LogRecord::T_UPDATE) {
+		VOLT_DEBUG("Log record recovery : UPDATE start");
 
-	 int64_t actualBufLen = static_cast<int64_t> (logfilestream.gcount());
+		beforeImage = logrecord.getTupleBeforeImage();
+		afterImage = logrecord.getTupleAfterImage();
 
-	 if(logfilestream.eof()) {
-	 noMoreLogRecords = true;
-	 }
-	 */
-	return logData;
+		// XXX: setting updateIndexes to true
+		// for simplicity, originally it comes from the plan
+		// node during forward execution.
+		// Might need to change this if problems arise.
+		// XXX: should I modify the log record to track this
+		// attribute too? That doesn't seem too hard.
+		table->updateTuple(*beforeImage, *afterImage, true);
+
+		logrecord.dellocateBeforeImageData();
+		//beforeImage->freeObjectColumns();
+		delete beforeImage;
+		beforeImage = NULL;
+
+		logrecord.dellocateAfterImageData();
+		//afterImage->freeObjectColumns();
+		delete afterImage;
+		afterImage = NULL;
+
+		VOLT_DEBUG("Log record recovery : UPDATE end");
+	} else if (logrecord.getType() == LogRecord::T_DELETE) {
+		VOLT_DEBUG("Log record recovery : DELETE start");
+
+		beforeImage = logrecord.getTupleBeforeImage();
+
+		table->deleteTuple(*beforeImage, true);
+
+		logrecord.dellocateBeforeImageData();
+		//beforeImage->freeObjectColumns();
+		delete beforeImage;
+		beforeImage = NULL;
+
+		VOLT_DEBUG("Log record recovery : DELETE end");
+	} else if (logrecord.getType() == LogRecord::T_TRUNCATE) {
+		table->deleteAllTuples(true);
+
+		VOLT_DEBUG("Log record recovery : TRUNCATE");
+	} else {
+		// do nothing for invalid records
+		VOLT_WARN("Log record recovery : Invalid Record");
+	}
 }
 
-void VoltDBEngine::freePointerToReplayLog(char *logData) {
-	if (logData != NULL) {
-		delete[] logData;
-		logData = NULL;
+namespace {
+
+/** Redo of one log record, on the lane that owns its table */
+class LogRecordRedoTask : public AriesRedoTask {
+public:
+	LogRecordRedoTask(PersistentTable *table, LogRecord *logrecord) :
+			m_table(table), m_logrecord(logrecord) {
+	}
+
+	~LogRecordRedoTask() {
+		delete m_logrecord;
+	}
+
+	void apply() {
+		// the primary key lookup runs here too, off the parsing thread
+		m_logrecord->populateFields(m_table->schema(), m_table->primaryKeyIndex());
+		if (m_logrecord->isValidRecord()) {
+			redoLogRecord(m_table, *m_logrecord);
+		}
+	}
+
+private:
+	PersistentTable *m_table;
+	LogRecord *m_logrecord;
+};
+
+/**
+ * Redo lanes for the length of one replay. The undo quantum is swapped for
+ * one every lane can use at once and put back when the replay is over.
+ */
+class ParallelRedo {
+public:
+	ParallelRedo(ExecutorContext *context, int lanes) :
+			m_context(context), m_undoQuantum(context->getCurrentUndoQuantum()),
+			m_pipeline(NULL) {
+		m_context->setupForPlanFragments(&m_redoUndoQuantum);
+		m_pipeline = new AriesRedoPipeline(lanes);
+	}
+
+	~ParallelRedo() {
+		// applies whatever is still queued before the quantum goes away
+		delete m_pipeline;
+		m_context->setupForPlanFragments(m_undoQuantum);
+	}
+
+	inline AriesRedoPipeline* pipeline() {
+		return m_pipeline;
 	}
+
+private:
+	ExecutorContext *m_context;
+	UndoQuantum *m_undoQuantum;
+	RedoUndoQuantum m_redoUndoQuantum;
+	AriesRedoPipeline *m_pipeline;
+};
+
 }
 
 /*
@@ -2067,19 +2162,42 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 
 	VOLT_DEBUG("actualBufLen : %ld", actualBufLen);
 
+	// start of the part of the log not yet handed back
+	const char *unreleased = logData;
+
+	// tables are redone on parallel lanes unless anti-cache is on: its
+	// eviction bookkeeping is shared by every table
+	int redoThreads = m_ariesRedoThreads;
+#ifdef ANTICACHE
+	if (m_executorContext->m_antiCacheEnabled) {
+		redoThreads = 1;
+	}
+#endif
+	boost::scoped_ptr<ParallelRedo> parallel(
+			redoThreads > 1 ? new ParallelRedo(m_executorContext, redoThreads) : NULL);
+	AriesRedoPipeline *pipeline = parallel ? parallel->pipeline() : NULL;
+
+	std::set<Table*> exportingTables;
+	for (map<int64_t, Table*>::iterator iter = m_exportingTables.begin();
+			iter != m_exportingTables.end(); ++iter) {
+		exportingTables.insert(iter->second);
+	}
+
 	while (input.getRawPointer(0) < endOfBuffer) {
 		const char* logInitPosition = reinterpret_cast<const char*>(input.getRawPointer(0));
 
+		if (static_cast<size_t>(logInitPosition - unreleased) >= AriesReplayLog::RELEASE_BYTES) {
+			unreleased = AriesReplayLog::release(logData, unreleased, logInitPosition);
+		}
+
 		int32_t recordSize = 0;
 
 		// log header is 4 bytes
 		int64_t breathingSpace = endOfBuffer - (logInitPosition + sizeof(int32_t));
 
 		if (breathingSpace < 0) {
-			// read the full header along with the next chunk
-			// seek in reverse direction
-			break;//XXX:hack when we have a single buffer for the entire file
-			// logfilestream.seekg((logInitPosition - endOfBuffer), ios::cur);
+			// a header cut short by a crash ends the log
+			break;
 		} else {
 			// read log record header to determine its size.
 			memcpy(&recordSize, logInitPosition, sizeof(recordSize));
@@ -2090,16 +2208,11 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 				// hit junk, no more log records.
 				noMoreLogRecords = true;
 				break;
-			} else {
-				/* if (logInitPosition + sizeof(int32_t) + recordSize > endOfBuffer) {
-				 //part of this log record is in the
-				 // next buffer chunk
-				 // rewind back to beginning of log record's header
-				 logfilestream.seekg((logInitPosition - endOfBuffer), ios::cur);
-				 break;
-				 }
-				 // else entire log record is in this chunk
-				 */
+			} else if (recordSize > breathingSpace) {
+				// so does a record cut short by a crash
+				VOLT_WARN("ARIES : log ends in a partial record of %d bytes", recordSize);
+				noMoreLogRecords = true;
+				break;
 			}
 		}
 
@@ -2112,8 +2225,17 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 		int64_t numBulkLoadBytes = 0;
 
 		if (txnType == static_cast<int8_t>(LogRecord::T_BULKLOAD)) {
-			memcpy(&numBulkLoadBytes, logInitPosition + sizeof(int32_t) + recordSize, sizeof(numBulkLoadBytes));
+			const char *loadStart = logInitPosition + sizeof(int32_t) + recordSize;
+			if (endOfBuffer - loadStart < static_cast<int64_t>(sizeof(numBulkLoadBytes))) {
+				VOLT_WARN("ARIES : log ends in a partial bulk load");
+				break;
+			}
+			memcpy(&numBulkLoadBytes, loadStart, sizeof(numBulkLoadBytes));
 			numBulkLoadBytes = ntohll(numBulkLoadBytes);
+			if (numBulkLoadBytes > endOfBuffer - loadStart - static_cast<int64_t>(sizeof(numBulkLoadBytes))) {
+				VOLT_WARN("ARIES : log ends in a partial bulk load");
+				break;
+			}
 		}
 
 		// Run only if txnId is greater than the id to replay from
@@ -2145,20 +2267,33 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 			continue;
 		}
 
-		LogRecord logrecord(input);
+		LogRecord *logrecord = new LogRecord(input);
 
-		PersistentTable* table = dynamic_cast<PersistentTable*>(getTable(logrecord.getTableName()));
+		PersistentTable* table = dynamic_cast<PersistentTable*>(getTable(logrecord->getTableName()));
 
 		if (table == NULL) {
 			// Invalid log record hit
 			// This does not take into account log corruption,
 			// for otherwise log replay semantics are ill-defined.
+			delete logrecord;
 			break;
 		}
 
-		logrecord.populateFields(table->schema(), table->primaryKeyIndex());
+		if (pipeline != NULL && txnType != static_cast<int8_t>(LogRecord::T_BULKLOAD)
+				&& exportingTables.find(table) == exportingTables.end()) {
+			// every record of a table goes down the same lane, in log order
+			counter++;
+			if (!pipeline->dispatch(pipeline->laneFor(table), new LogRecordRedoTask(table, logrecord))) {
+				break;
+			}
+			continue;
+		}
+
+		boost::scoped_ptr<LogRecord> ownedLogrecord(logrecord);
 
-		if (!logrecord.isValidRecord()) {
+		logrecord->populateFields(table->schema(), table->primaryKeyIndex());
+
+		if (!logrecord->isValidRecord()) {
 			// XXX: can actually NEVER happen because
 			// this call always returns true.
 			break;
@@ -2166,58 +2301,14 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 
 		counter++;
 
-		TableTuple *beforeImage = NULL;
-		TableTuple *afterImage = NULL;
-
-		if (logrecord.getType() == LogRecord::T_INSERT) {
-			VOLT_DEBUG("Log record recovery : INSERT start");
-
-			// at this point, don't worry about
-			// logging during recovery
-			// XXX: note that duplicate inserts won't happen silently:
-			// constraint failure exceptions will get thrown
-			afterImage = logrecord.getTupleAfterImage();
-
-			if (afterImage != NULL) {
-				table->insertTuple(*afterImage);
-
-				// Job is done, delete the tuple now
-				logrecord.dellocateAfterImageData();
+		if (logrecord->getType() == LogRecord::T_BULKLOAD) {
+			VOLT_DEBUG("Log record recovery : BULKLOAD start");
 
-				//afterImage->freeObjectColumns();
-				delete afterImage;
-				afterImage = NULL;
+			// the load goes through loadTable here, once the lanes are idle
+			if (pipeline != NULL && !pipeline->barrier()) {
+				break;
 			}
 
-			VOLT_DEBUG("Log record recovery : INSERT end");
-		} else if (logrecord.getType() == LogRecord::T_UPDATE) {
-			VOLT_DEBUG("Log record recovery : UPDATE start");
-
-			beforeImage = logrecord.getTupleBeforeImage();
-			afterImage = logrecord.getTupleAfterImage();
-
-			// XXX: setting updateIndexes to true
-			// for simplicity, originally it comes from the plan
-			// node during forward execution.
-			// Might need to change this if problems arise.
-			// XXX: should I modify the log record to track this
-			// attribute too? That doesn't seem too hard.
-			table->updateTuple(*beforeImage, *afterImage, true);
-
-			logrecord.dellocateBeforeImageData();
-			//beforeImage->freeObjectColumns();
-			delete beforeImage;
-			beforeImage = NULL;
-
-			logrecord.dellocateAfterImageData();
-			//afterImage->freeObjectColumns();
-			delete afterImage;
-			afterImage = NULL;
-
-			VOLT_DEBUG("Log record recovery : UPDATE end");
-		} else if (logrecord.getType() == LogRecord::T_BULKLOAD) {
-			VOLT_DEBUG("Log record recovery : BULKLOAD start");
-
 			numBulkLoadBytes = input.readLong();
 
 			// make sure we create a separate input reader
@@ -2242,27 +2333,19 @@ void VoltDBEngine::doAriesRecovery(char *logData, size_t length, int64_t replay_
 			input.getRawPointer(numBulkLoadBytes);
 
 			VOLT_DEBUG("Log record recovery : BULKLOAD end");
-		} else if (logrecord.getType() == LogRecord::T_DELETE) {
-			VOLT_DEBUG("Log record recovery : DELETE start");
-
-			beforeImage = logrecord.getTupleBeforeImage();
-
-			table->deleteTuple(*beforeImage, true);
-
-			logrecord.dellocateBeforeImageData();
-			//beforeImage->freeObjectColumns();
-			delete beforeImage;
-			beforeImage = NULL;
-
-			VOLT_DEBUG("Log record recovery : DELETE end");
-		} else if (logrecord.getType() == LogRecord::T_TRUNCATE) {
-			table->deleteAllTuples(true);
-
-			VOLT_DEBUG("Log record recovery : TRUNCATE");
 		} else {
-			// do nothing for invalid records
-			VOLT_WARN("Log record recovery : Invalid Record");
+			// exported tables stay here, their streams call back into the topend
+			redoLogRecord(table, *logrecord);
+		}
+	}
+
+	if (parallel) {
+		if (!parallel->pipeline()->barrier()) {
+			throwFatalException("ARIES : parallel redo failed : %s",
+					parallel->pipeline()->failure().c_str());
 		}
+		VOLT_WARN("ARIES : %ld log records redone on %d threads",
+				parallel->pipeline()->appliedTasks(), parallel->pipeline()->laneCount());
 	}
 
 	gettimeofday(&tv2, NULL);
@@ -2396,6 +2479,8 @@ void VoltDBEngine::trackingEnable(int64_t txnId) {
 	if (m_executorContext->isTrackingEnabled() == false) {
 		VOLT_INFO("Setting up Tracking Manager at Partition %d", m_partitionId);
 		m_executorContext->enableTracking();
+		m_executorContext->getTrackerManager()->setBlockGranularity(
+				m_trackingBlockGranularity);
 	}
 	VOLT_INFO("Creating ReadWriteTracker for txn #%ld at Partition %d", txnId,
 			m_partitionId);
@@ -2454,6 +2539,21 @@ int VoltDBEngine::trackingTupleSet(int64_t txnId, bool writes) {
 	return (ENGINE_ERRORCODE_ERROR);
 }
 
+bool VoltDBEngine::trackingConflicts(int64_t txnId0, int64_t txnId1) {
+	if (m_executorContext->isTrackingEnabled() == false) {
+		return (false);
+	}
+	return (m_executorContext->getTrackerManager()->conflicts(txnId0, txnId1));
+}
+
+void VoltDBEngine::setTrackingBlockGranularity(bool blockGranularity) {
+	m_trackingBlockGranularity = blockGranularity;
+	if (m_executorContext != NULL && m_executorContext->isTrackingEnabled()) {
+		m_executorContext->getTrackerManager()->setBlockGranularity(
+				blockGranularity);
+	}
+}
+
 // std::vector<std::string> VoltDBEngine::trackingTablesRead(int64_t txnId) {
 //     if (m_executorContext->isTrackingEnabled()) {
 //         ReadWriteTracker *tracker = m_executorContext->getTrackerManager(txnId);
@@ -2495,9 +2595,14 @@ int VoltDBEngine::antiCacheReadBlocks(int32_t tableId, int numBlocks, int16_t bl
 		throwFatalException("Invalid table id %d", tableId);
 	}
 
-	// We can now ask it directly to read in the evicted blocks that they want
+	// We can now ask it directly to read in the evicted blocks that they want.
+	// All of them are requested first so the reader's threads fetch them
+	// at the same time, then we wait for each to come in.
 	bool finalResult = true;
 	try {
+		for (int i = 0; i < numBlocks; i++) {
+			table->requestEvictedBlock(blockIds[i]);
+		} // FOR
 		for (int i = 0; i < numBlocks; i++) {
 			finalResult = table->readEvictedBlock(blockIds[i], tupleOffsets[i]) && finalResult;
 		} // FOR
@@ -73,6 +73,7 @@
 #ifndef VOLTDBENGINE_H
 #define VOLTDBENGINE_H
 
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -144,6 +145,15 @@ class PlanNodeFragment;
 class ExecutorContext;
 class RecoveryProtoMsg;
 
+/**
+ * Keep a list of executors for runtime. Owned by VoltDBEngine::m_executorMap;
+ * triggers hold raw pointers to the vectors of their fragments.
+ */
+struct ExecutorVector {
+    std::vector<AbstractExecutor*> list;
+    int tempTableMemoryInBytes;
+};
+
 /**
  * Represents an Execution Engine which holds catalog objects (i.e. table) and executes
  * plans on the objects. Every operation starts from this object.
@@ -164,9 +174,14 @@ class __attribute__((visibility("default"))) VoltDBEngine {
           m_templateSingleLongTable(NULL),
           m_topend(NULL),
           m_logProxy(NULL),
-          m_ARIESEnabled(false)
+          m_ARIESEnabled(false),
+          m_ariesRedoThreads(1),
+          m_batchTriggers(false),
+          m_pipelineExecutors(false),
+          m_trackingBlockGranularity(false)
         {
             m_currentUndoQuantum = new DummyUndoQuantum();
+            m_ariesCommittedEntry = 0;
 
             m_logManager = new LogManager(new StdoutLogProxy());
 
@@ -204,11 +219,36 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         //MEEHAN: TODO this needs to be an inline function... this is kind of a mess in general
         int executeQueryNoOutput(int64_t planfragmentId, const NValueArray &params,
 						 int64_t txnId, bool& send_tuple_count);
+        int executeQueryNoOutput(ExecutorVector *execsForFrag, int64_t planfragmentId,
+                                 const NValueArray &params, int64_t txnId,
+                                 ReadWriteTracker *tracker, bool& send_tuple_count);
         int executePlanFragment(std::string fragmentString, int32_t outputDependencyId, int32_t inputDependencyId,
                                 int64_t txnId, int64_t lastCommittedTxnId);
 
         void fireTrigger(Trigger* trigger);
 
+        /**
+         * Fire all triggers of the given table after a statement has inserted
+         * into it, then empty it if it is a stream. When trigger batching is
+         * enabled the table is only queued here and its triggers run once, at
+         * the end of the fragment batch, over every tuple the batch inserted.
+         * Window tables always fire right away.
+         */
+        void fireTableTriggers(PersistentTable* table);
+        /** Run the triggers of every table queued by fireTableTriggers() */
+        void firePendingTriggers();
+
+        inline void setBatchTriggers(bool batchTriggers) { m_batchTriggers = batchTriggers; }
+        inline bool isBatchingTriggers() const { return m_batchTriggers; }
+
+        /**
+         * Let plan fragments loaded from now on stream tuples from an executor
+         * straight into its parent where both support it, instead of
+         * materializing the intermediate temp table.
+         */
+        inline void setPipelineExecutors(bool pipeline) { m_pipelineExecutors = pipeline; }
+        inline bool isPipeliningExecutors() const { return m_pipelineExecutors; }
+
         inline int getUsedParamcnt() const { return m_usedParamcnt;}
         inline void setUsedParamcnt(int usedParamcnt) { m_usedParamcnt = usedParamcnt;}
 
@@ -301,78 +341,7 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         // -------------------------------------------------
         long loadTableFromFile(int32_t table_id, std::string destinationShim, std::string destinationFile);
 
-        std::vector<std::string> split(const std::string &text, char sep) {
-          std::vector<std::string> tokens;
-          std::size_t start = 0, end = 0;
-          while ((end = text.find(sep, start)) != std::string::npos) {
-            tokens.push_back(text.substr(start, end - start));
-            start = end + 1;
-          }
-          tokens.push_back(text.substr(start));
-          return tokens;
-        }
 
-        NValue getNValueForType(voltdb::ValueType type, std::string str) {
-        	if (str.compare("") == 0) {
-        		return ValueFactory::getNullValue();
-        	}
-        	NValue retval;
-        	switch (type) {
-        	case voltdb::VALUE_TYPE_BOOLEAN:
-//        		std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-//        		std::istringstream is(str);
-//        		bool b;
-//        		is >> std::boolalpha >> b;
-//        		retval = ValueFactory::getBooleanValue(b);
-        		if (toupper(str.at(0)) == 'T')
-        			retval = ValueFactory::getBooleanValue(true);
-        		else {
-        			retval = ValueFactory::getBooleanValue(false);
-        		}
-        		break;
-        	case voltdb::VALUE_TYPE_INTEGER:
-        		retval = ValueFactory::getIntegerValue(atoi(str.c_str()));
-        		break;
-        	case voltdb::VALUE_TYPE_TINYINT:
-        		retval = ValueFactory::getTinyIntValue((int8_t)atoi(str.c_str()));
-        		break;
-        	case voltdb::VALUE_TYPE_SMALLINT:
-        		retval = ValueFactory::getSmallIntValue((int16_t)atoi(str.c_str()));
-        		break;
-        	case voltdb::VALUE_TYPE_BIGINT:
-        		retval = ValueFactory::getBigIntValue(atol(str.c_str()));
-        		break;
-        	case voltdb::VALUE_TYPE_DECIMAL:
-        		retval = ValueFactory::getDoubleValue(atof(str.c_str()));
-        		break;
-        	case voltdb::VALUE_TYPE_VARCHAR:
-        		retval = ValueFactory::getStringValue(str);
-        		break;
-        	case voltdb::VALUE_TYPE_TIMESTAMP:
-        		retval = ValueFactory::getTimestampValue(atol(str.c_str()));
-        		break;
-        	default:
-        		retval = ValueFactory::getNullValue();
-        	}
-        	return retval;
-        }
-
-//        std::vector<std::string> &split(const string &s, char delim, std::vector<std::string> &elems) {
-//            std::stringstream ss(s);
-//            std::string item;
-//            while (getline(ss, item, delim)) {
-//                elems.push_back(item);
-//            }
-//            return elems;
-//        }
-//
-//        std::vector<std::string> split(const string &s, char delim) {
-//            std::vector<std::string> elems;
-//            &split(s, delim, elems);
-//            return elems;
-//        }
-//
-//
         // -------------------------------------------------
         // Non-transactional work methods
         // -------------------------------------------------
@@ -414,6 +383,10 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 //         std::vector<std::string> trackingTablesRead(int64_t txnId);
 //         std::vector<std::string> trackingTablesWritten(int64_t txnId);
         int trackingTupleSet(int64_t txnId, bool writes);
+        /** Did the two txns write a row (or block) that the other one read or wrote? */
+        bool trackingConflicts(int64_t txnId0, int64_t txnId1);
+        /** Track blocks instead of rows for the txns that start tracking from now on */
+        void setTrackingBlockGranularity(bool blockGranularity);
         
         // -------------------------------------------------
         // ANTI-CACHE FUNCTIONS
@@ -432,7 +405,7 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
 
         // ARIES
-        void ARIESInitialize(std::string dbDir, std::string logFile) ;
+        void ARIESInitialize(std::string dbDir, std::string logFile, int redoThreads) ;
 
         std::string getARIESDir(){
         	return m_ARIESDir;
@@ -527,10 +500,15 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         inline void releaseUndoToken(int64_t undoToken);
 
         inline void undoUndoToken(int64_t undoToken) {
+#ifdef ARIES
+            // rolled back work was logged as it ran, so close its entry too
+            commitAriesTransaction();
+#endif
             if (m_currentUndoQuantum != NULL && m_currentUndoQuantum->isDummy()) {
                 return;
             }
             VOLT_TRACE("Undoing Buffer Token %ld at partition %d", undoToken, m_partitionId);
+            m_pendingTriggerTables.clear();
             m_undoLog.undo(undoToken);
             m_currentUndoQuantum = NULL;
         }
@@ -578,6 +556,30 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         void writeToAriesLogBuffer(const char *data, size_t size);
 
+        /**
+         * Hand the current transaction's ARIES records to the log writer.
+         * Does not wait for the disk; see waitForAriesSync().
+         */
+        inline void commitAriesTransaction() {
+            if (isARIESEnabled()) {
+                m_ariesCommittedEntry =
+                    m_logManager->getThreadLogger(LOGGERID_MM_ARIES)->commitTransaction();
+            }
+        }
+
+        /** Log entry that has to be synced before the last commit is reported */
+        inline int64_t getAriesCommittedEntry() const { return m_ariesCommittedEntry; }
+
+        /**
+         * Block until the given log entry is on disk; false if the log
+         * writer failed. Safe to call from a thread other than the one
+         * executing transactions.
+         */
+        inline bool waitForAriesSync(int64_t entry) {
+            return !isARIESEnabled() ||
+                m_logManager->getThreadLogger(LOGGERID_MM_ARIES)->waitForSync(entry);
+        }
+
         size_t getArieslogBufferLength();
 
         void rewindArieslogBuffer();
@@ -617,27 +619,31 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         // -------------------------------------------------
         bool initPlanFragment(const int64_t fragId, const std::string planNodeTree);
         bool initPlanNode(const int64_t fragId, AbstractPlanNode* node, int* tempTableMemoryInBytes);
+        /** Link each executor that can push its output into its parent */
+        void pipelineExecutors(ExecutorVector* execsForFrag);
         bool initCluster();
         bool initMaterializedViews(bool addAll);
         bool updateCatalogDatabaseReference();
 
         void printReport();
 
+        /**
+         * Point every trigger at the ExecutorVectors of its fragments so that
+         * firing it needs no m_executorMap lookups. The pointers are dropped at
+         * the start of each rebuild since m_executorMap is cleared there.
+         */
+        void clearTriggerExecutors();
+        bool resolveTriggerExecutors();
+
+        /** Fire the triggers of a table right away and reset its stream/window state */
+        void runTableTriggers(PersistentTable* table);
+
         /**
          * data migration (helper methods)
          */
         std::string getAttributeTypes(const TupleSchema* tupleSchema) const;
         std::vector<std::string> getAttributeTypesVector(const TupleSchema* tupleSchema) const;
 
-        /**
-		* Keep a list of executors for runtime - intentionally near the top of VoltDBEngine
-		*/
-		struct ExecutorVector {
-			std::vector<AbstractExecutor*> list;
-			int tempTableMemoryInBytes;
-		};
-
-
         std::map<int64_t, boost::shared_ptr<ExecutorVector> > m_executorMap;
 
         voltdb::UndoLog m_undoLog;
@@ -729,6 +735,9 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         bool m_isRecovering;	// are we currently recovering?
 
+        /** ARIES log entry of the last committed transaction, 0 if none */
+        int64_t m_ariesCommittedEntry;
+
         int64_t m_batchFragmentIdsContainer[MAX_BATCH_COUNT];
         /** PAVLO **/
         int32_t m_batchInputDepIdsContainer[MAX_BATCH_COUNT];
@@ -785,6 +794,23 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         bool m_ARIESEnabled ;
 
+        /** Threads applying ARIES log records at recovery, 1 replays serially */
+        int m_ariesRedoThreads;
+
+        /** Trigger fragments take no parameters; shared so firing doesn't build one */
+        const NValueArray m_triggerParams;
+
+        /** Coalesce trigger firings until the end of each fragment batch */
+        bool m_batchTriggers;
+        /** Tables whose triggers are waiting for the end of the batch, in firing order */
+        std::deque<PersistentTable*> m_pendingTriggerTables;
+
+        /** Push tuples through compatible executor chains in new fragments */
+        bool m_pipelineExecutors;
+
+        /** Read/write trackers record blocks instead of rows */
+        bool m_trackingBlockGranularity;
+
 };
 
 inline void VoltDBEngine::resetReusedResultOutputBuffer(const size_t headerSize) {
@@ -801,6 +827,9 @@ inline void VoltDBEngine::resetReusedResultOutputBuffer(const size_t headerSize)
 }
 
 void VoltDBEngine::releaseUndoToken(int64_t undoToken){
+#ifdef ARIES
+  commitAriesTransaction();
+#endif
   if (m_currentUndoQuantum != NULL && m_currentUndoQuantum->isDummy()) {
     return;
   }
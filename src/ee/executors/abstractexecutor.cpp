@@ -143,6 +143,32 @@ bool AbstractExecutor::init(VoltDBEngine *engine, const catalog::Database* catal
     return true;
 }
 
+void AbstractExecutor::setPipelineParent(AbstractExecutor *parent) {
+    assert(parent == NULL || (canPushOutput() && parent->acceptsPushedTuples()));
+    if (m_pipelineParent != NULL)
+        m_pipelineParent->m_pipelined = false;
+    m_pipelineParent = parent;
+    if (parent != NULL)
+        parent->m_pipelined = true;
+}
+
+bool AbstractExecutor::pushBegin(const NValueArray &params, ReadWriteTracker *tracker) {
+    assert(m_pipelined);
+    if (tmp_output_table) {
+        VOLT_TRACE("Clearing output table...");
+        tmp_output_table->deleteAllTuplesNonVirtual(false);
+    }
+    if (m_pipelineParent != NULL && !m_pipelineParent->pushBegin(params, tracker))
+        return false;
+    return p_pushBegin(params, tracker);
+}
+
+bool AbstractExecutor::pushEnd() {
+    if (!p_pushEnd())
+        return false;
+    return m_pipelineParent == NULL || m_pipelineParent->pushEnd();
+}
+
 AbstractExecutor::~AbstractExecutor() {}
 
 }
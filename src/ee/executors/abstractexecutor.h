@@ -87,6 +87,27 @@ class AbstractExecutor {
 
     inline bool forceTupleCount() const { return (this->force_send_tuple_count); }
 
+    /**
+     * Pipelining. An executor that canPushOutput() can hand each output
+     * tuple straight to a parent that acceptsPushedTuples(), instead of
+     * materializing its output table for the parent to scan. The parent is
+     * then driven from this executor's execute() and must not be executed
+     * on its own (see isPipelined()).
+     */
+    virtual bool canPushOutput() const { return false; }
+    virtual bool acceptsPushedTuples() const { return false; }
+    void setPipelineParent(AbstractExecutor *parent);
+    inline AbstractExecutor* getPipelineParent() const { return m_pipelineParent; }
+    /** true if this executor's input is pushed to it by its child */
+    inline bool isPipelined() const { return m_pipelined; }
+
+    /** Opens a pipelined executor, and its own pipeline parent, for a run */
+    bool pushBegin(const NValueArray &params, ReadWriteTracker *tracker);
+    /** Hands one input tuple to a pipelined executor */
+    inline bool pushTuple(TableTuple &tuple) { return p_pushTuple(tuple); }
+    /** Closes a pipelined executor, and then its own pipeline parent */
+    bool pushEnd();
+
     /**
      * Returns the plannode that generated this executor.
      */
@@ -97,6 +118,8 @@ class AbstractExecutor {
         this->abstract_node = abstract_node;
         tmp_output_table = NULL;
         this->force_send_tuple_count = false;
+        m_pipelineParent = NULL;
+        m_pipelined = false;
     }
 
     /** Concrete executor classes implement initialization in p_init() */
@@ -115,6 +138,25 @@ class AbstractExecutor {
      */
     virtual bool needsOutputTableClear() { return true; };
 
+    /**
+     * Executors that acceptsPushedTuples() implement these instead of
+     * reading their input table: p_pushBegin() once per run, p_pushTuple()
+     * for every input tuple and p_pushEnd() after the last one.
+     */
+    virtual bool p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker) { return true; }
+    virtual bool p_pushTuple(TableTuple &tuple) { return false; }
+    virtual bool p_pushEnd() { return true; }
+
+    /**
+     * Sends an output tuple to the pipeline parent if there is one, or
+     * inserts it into output_table otherwise.
+     */
+    inline bool emitTuple(Table *output_table, TableTuple &tuple) {
+        if (m_pipelineParent != NULL)
+            return m_pipelineParent->pushTuple(tuple);
+        return output_table->insertTuple(tuple);
+    }
+
     // execution engine owns the plannode allocation.
     AbstractPlanNode* abstract_node;
     TempTable *tmp_output_table;
@@ -129,6 +171,11 @@ class AbstractExecutor {
     // PAVLO: If this is set to true, then we won't execute the plan
     // node and will force the EE to send back the # of tuples modified
     bool force_send_tuple_count;
+
+    // parent that our output tuples are pushed to, if any
+    AbstractExecutor *m_pipelineParent;
+    // whether our input is pushed to us by our child
+    bool m_pipelined;
 };
 
 /**
@@ -159,7 +206,12 @@ inline bool AbstractExecutor::execute(const NValueArray &params, ReadWriteTracke
         tmp_output_table->deleteAllTuplesNonVirtual(false);
     }
 
-    // run the executor
+    // run the executor, pushing its output through the pipeline
+    if (m_pipelineParent != NULL) {
+        return m_pipelineParent->pushBegin(params, tracker) &&
+               this->p_execute(params, tracker) &&
+               m_pipelineParent->pushEnd();
+    }
     return this->p_execute(params, tracker);
 }
 
@@ -86,14 +86,17 @@
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
 #include "executors/abstractexecutor.h"
+#include "executors/flathashaggregator.h"
 #include "expressions/abstractexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/projectionnode.h"
 #include "storage/table.h"
 #include "storage/tablefactory.h"
 #include "storage/tableiterator.h"
+#include "streaming/WindowTableTemp.h"
 
 
+#include "boost/scoped_ptr.hpp"
 #include "boost/unordered_map.hpp"
 
 #include <algorithm>
@@ -393,7 +396,8 @@ class AggregateExecutor : public AbstractExecutor
 {
 public:
     AggregateExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node) :
-        AbstractExecutor(engine, abstract_node), m_groupByKeySchema(NULL)
+        AbstractExecutor(engine, abstract_node), m_groupByKeySchema(NULL),
+        m_flatInputSchema(NULL), m_window(NULL)
     { };
     ~AggregateExecutor();
 
@@ -410,6 +414,22 @@ protected:
     PassThroughColType m_passThroughColumns;
     Pool m_memoryPool;
     TupleSchema* m_groupByKeySchema;
+
+    /*
+     * Batched hash aggregation for plans it supports (hash aggregates
+     * only). Kept across executions so its tables are reused.
+     */
+    boost::scoped_ptr<FlatHashAggregator> m_flatAggregator;
+    const TupleSchema* m_flatInputSchema;
+
+    /*
+     * An ungrouped aggregate that reads a window directly (a SeqScan
+     * with no predicate hands over the window itself) is registered
+     * with the window, which maintains it as tuples slide through.
+     * These are the window and the slot of each aggregate in it.
+     */
+    WindowTableTemp* m_window;
+    std::vector<int> m_windowAggregates;
 };
 
 /*
@@ -428,12 +448,50 @@ public:
                Table* output_table,
                std::vector<ExpressionType>* agg_types,
                std::vector<int>* groupByCols,
-               std::vector<ValueType>* col_types);
+               std::vector<ValueType>* col_types,
+               FlatHashAggregator* flatAggregator);
     bool nextTuple(TableTuple nextTuple, TableTuple prevTuple);
     bool finalize(TableTuple prevTuple);
 
 };
 
+/*
+ * Set the pass through columns of an output tuple whose aggregate
+ * columns are already filled in, and insert it into the output table.
+ */
+inline bool
+insertAggregateRow(AggregatePlanNode* node, Table* output_table,
+                   Table* input_table, TableTuple& tmptup, TableTuple prev,
+                   PassThroughColType* passThroughColumns)
+{
+    VOLT_DEBUG("Setting passthrough columns for %s", node->debug().c_str());
+    /*
+     * Execute a second pass to set the output columns from the input
+     * columns that are being passed through.  These are the columns
+     * that are not being aggregated on but are still in the SELECT
+     * list. These columns may violate the Single-Value rule for GROUP
+     * BY (not be on the group by column reference list). This is an
+     * intentional optimization to allow values that are not in the
+     * GROUP BY to be passed through.
+     */
+
+    for (PassThroughColType::const_iterator cit = passThroughColumns->begin();
+         cit < passThroughColumns->end();
+         cit++)
+    {
+        VOLT_DEBUG("Setting value for passthrough column %d [sourceOffset=%d]", (*cit).first, (*cit).second);
+        tmptup.setNValue((*cit).first, prev.getNValue((*cit).second));
+    }
+
+    if (!output_table->insertTuple(tmptup)) {
+        VOLT_ERROR("Failed to insert order-by tuple from input table '%s' into"
+                   " output table '%s'",
+                   input_table->name().c_str(), output_table->name().c_str());
+        return false;
+    }
+    return true;
+}
+
 /*
  * Helper method responsible for inserting the results of the
  * aggregation into a new tuple in the output table as well as passing
@@ -474,32 +532,29 @@ helper(AggregatePlanNode* node, Agg** aggs,
             return true;
         }
     }
-    VOLT_DEBUG("Setting passthrough columns for %s", node->debug().c_str());
-    /*
-     * Execute a second pass to set the output columns from the input
-     * columns that are being passed through.  These are the columns
-     * that are not being aggregated on but are still in the SELECT
-     * list. These columns may violate the Single-Value rule for GROUP
-     * BY (not be on the group by column reference list). This is an
-     * intentional optimization to allow values that are not in the
-     * GROUP BY to be passed through.
-     */
+    return insertAggregateRow(node, output_table, input_table, tmptup, prev,
+                              passThroughColumns);
+}
 
-    for (PassThroughColType::const_iterator cit = passThroughColumns->begin();
-         cit < passThroughColumns->end();
-         cit++)
+/*
+ * Same as helper() above, for a group of the FlatHashAggregator.
+ */
+inline bool
+flatHelper(AggregatePlanNode* node, FlatHashAggregator* aggregator, int group,
+           Table* output_table, Table* input_table, TableTuple prev,
+           PassThroughColType* passThroughColumns)
+{
+    TableTuple& tmptup = output_table->tempTuple();
+    std::vector<int> aggregateOutputColumns = node->getAggregateOutputColumns();
+    for (int ii = 0; ii < aggregateOutputColumns.size(); ii++)
     {
-        VOLT_DEBUG("Setting value for passthrough column %d [sourceOffset=%d]", (*cit).first, (*cit).second);
-        tmptup.setNValue((*cit).first, prev.getNValue((*cit).second));
+        const int columnIndex = aggregateOutputColumns[ii];
+        const ValueType columnType = tmptup.getType(columnIndex);
+        tmptup.setNValue(columnIndex,
+                         aggregator->result(group, ii).castAs(columnType));
     }
-
-    if (!output_table->insertTuple(tmptup)) {
-        VOLT_ERROR("Failed to insert order-by tuple from input table '%s' into"
-                   " output table '%s'",
-                   input_table->name().c_str(), output_table->name().c_str());
-        return false;
-    }
-    return true;
+    return insertAggregateRow(node, output_table, input_table, tmptup, prev,
+                              passThroughColumns);
 }
 
 /**
@@ -539,7 +594,8 @@ public:
                       Table* output_table,
                       std::vector<ExpressionType> *agg_types,
                       std::vector<int> *groupByCols,
-                      std::vector<ValueType> *col_types)
+                      std::vector<ValueType> *col_types,
+                      FlatHashAggregator* flatAggregator)
         : m_memoryPool(memoryPool),
           m_groupByKeySchema(groupByKeySchema),
           m_node(node),
@@ -549,8 +605,13 @@ public:
           m_aggTypes(agg_types),
           m_groupByCols(groupByCols),
           m_colTypes(col_types),
+          m_flatAggregator(flatAggregator),
           groupByKeyTuple(groupByKeySchema)
     {
+        if (m_flatAggregator != NULL)
+        {
+            m_flatAggregator->reset();
+        }
         groupByKeyTuple.
             moveNoHeader(static_cast<char*>
                          (memoryPool->
@@ -561,6 +622,12 @@ public:
 
     inline bool nextTuple(TableTuple nextTuple, TableTuple)
     {
+        if (m_flatAggregator != NULL)
+        {
+            m_flatAggregator->advance(nextTuple);
+            return true;
+        }
+
         AggregateList *aggregateList;
 
         // configure a tuple and search for the required group.
@@ -624,6 +691,21 @@ public:
 
     inline bool finalize(TableTuple prevTuple)
     {
+        if (m_flatAggregator != NULL)
+        {
+            m_flatAggregator->flush();
+            TableTuple groupTuple(m_inputTable->schema());
+            for (int group = 0; group < m_flatAggregator->groupCount(); group++)
+            {
+                groupTuple.move(m_flatAggregator->groupTuple(group));
+                if (!flatHelper(m_node, m_flatAggregator, group, m_outputTable,
+                                m_inputTable, groupTuple, m_passThroughColumns))
+                {
+                    return false;
+                }
+            }
+        }
+
         for (HashAggregateMapType::const_iterator iter = m_aggregates.begin();
              iter != m_aggregates.end();
              iter++)
@@ -673,6 +755,7 @@ private:
     std::vector<ExpressionType>* m_aggTypes;
     std::vector<int>* m_groupByCols;
     std::vector<ValueType>* m_colTypes;
+    FlatHashAggregator* m_flatAggregator;
     HashAggregateMapType m_aggregates;
     int m_numAggColumns;
     int m_lastColumnIndex;
@@ -695,7 +778,8 @@ public:
                       Table* output_table,
                       std::vector<ExpressionType>* agg_types,
                       std::vector<int>* groupByCols,
-                      std::vector<ValueType>* col_types) :
+                      std::vector<ValueType>* col_types,
+                      FlatHashAggregator*) :
         m_memoryPool(memoryPool),
         m_groupByKeySchema(groupByKeySchema),
         m_node(node),
@@ -994,6 +1078,44 @@ AggregateExecutor<aggregateType>::p_init(AbstractPlanNode *abstract_node,
                                                    groupByColumnAllowNull,
                                                    true);
         delete[] columnNames;
+
+        if (aggregateType == PLAN_NODE_TYPE_HASHAGGREGATE &&
+            FlatHashAggregator::supports(childSchema, groupByColumns,
+                                         node->getAggregates(),
+                                         node->getAggregateColumns()))
+        {
+            VOLT_DEBUG("Using batched hash aggregation for %s", node->debug().c_str());
+            m_flatAggregator.reset(new FlatHashAggregator(childSchema, groupByColumns,
+                                                          node->getAggregates(),
+                                                          node->getAggregateColumns()));
+            m_flatInputSchema = childSchema;
+        }
+
+        WindowTableTemp* window =
+            dynamic_cast<WindowTableTemp*>(child_node->getOutputTable());
+        if (aggregateType == PLAN_NODE_TYPE_AGGREGATE && window != NULL &&
+            groupByColumns.empty() && m_passThroughColumns.empty())
+        {
+            const std::vector<ExpressionType> aggregates = node->getAggregates();
+            bool supported = true;
+            for (int ii = 0; ii < aggregates.size(); ii++)
+            {
+                supported = supported &&
+                    WindowAggregate::supports(aggregates[ii],
+                                              childSchema->columnType(aggregateColumns[ii]));
+            }
+            if (supported)
+            {
+                VOLT_DEBUG("Reading maintained aggregates of window %s for %s",
+                           window->name().c_str(), node->debug().c_str());
+                m_window = window;
+                for (int ii = 0; ii < aggregates.size(); ii++)
+                {
+                    m_windowAggregates.push_back(
+                        window->registerAggregate(aggregates[ii], aggregateColumns[ii]));
+                }
+            }
+        }
     }
     return true;
 }
@@ -1014,6 +1136,20 @@ bool AggregateExecutor<aggregateType>::p_execute(const NValueArray &params, Read
     assert(input_table);
     VOLT_DEBUG("%s Input Table\n%s", node->debug().c_str(), input_table->debug().c_str());
 
+    if (m_window != NULL && input_table == m_window)
+    {
+        TableTuple& tmptup = output_table->tempTuple();
+        std::vector<int> aggregateOutputColumns = node->getAggregateOutputColumns();
+        for (int ii = 0; ii < aggregateOutputColumns.size(); ii++)
+        {
+            const int columnIndex = aggregateOutputColumns[ii];
+            tmptup.setNValue(columnIndex,
+                             m_window->aggregateResult(m_windowAggregates[ii]).
+                             castAs(tmptup.getType(columnIndex)));
+        }
+        return output_table->insertTuple(tmptup);
+    }
+
     std::vector<ExpressionType> agg_types = node->getAggregates();
     std::vector<ValueType> col_types(node->getAggregateColumns().size());
     for (int i = 0; i < col_types.size(); i++)
@@ -1027,19 +1163,44 @@ bool AggregateExecutor<aggregateType>::p_execute(const NValueArray &params, Read
     std::vector<int> groupByColumns = node->getGroupByColumns();
     TableTuple prev(input_table->schema());
 
+    // the batched path reads columns at the offsets of the schema it was
+    // planned for
+    FlatHashAggregator* flatAggregator = NULL;
+    if (m_flatAggregator &&
+        (input_table->schema() == m_flatInputSchema ||
+         input_table->schema()->equals(m_flatInputSchema)))
+    {
+        flatAggregator = m_flatAggregator.get();
+    }
+
     Aggregator<aggregateType> aggregator(&m_memoryPool, m_groupByKeySchema,
                                          node, &m_passThroughColumns,
                                          input_table, output_table,
                                          &agg_types,
-                                         &groupByColumns, &col_types);
+                                         &groupByColumns, &col_types,
+                                         flatAggregator);
 
     VOLT_TRACE("looping..");
-    for (TableTuple cur(input_table->schema()); it.next(cur);
-         prev.move(cur.address()))
+    if (flatAggregator != NULL)
     {
-        if (!aggregator.nextTuple( cur, prev))
+        // hand whole blocks of input addresses to the batched aggregator
+        char* batch[FlatHashAggregator::BATCH_SIZE];
+        int count;
+        while ((count = it.nextBatch(batch, FlatHashAggregator::BATCH_SIZE)) > 0)
         {
-            return false;
+            flatAggregator->advance(batch, count);
+            prev.move(batch[count - 1]);
+        }
+    }
+    else
+    {
+        for (TableTuple cur(input_table->schema()); it.next(cur);
+             prev.move(cur.address()))
+        {
+            if (!aggregator.nextTuple( cur, prev))
+            {
+                return false;
+            }
         }
     }
     VOLT_TRACE("finalizing..");
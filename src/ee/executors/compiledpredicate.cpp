@@ -0,0 +1,388 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "executors/compiledpredicate.h"
+#include "common/NValue.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
+#include "common/value_defs.h"
+#include "expressions/abstractexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/parametervalueexpression.h"
+#include "expressions/tuplevalueexpression.h"
+
+#include <cassert>
+
+namespace voltdb {
+
+/** One node of the predicate tree; narrows a selection to its matches */
+class CompiledPredicate::Node {
+public:
+    virtual ~Node() {}
+    virtual bool bind() = 0;
+    /** Write the entries of in that match to out and return how many */
+    virtual int select(char * const *tuples, const uint16_t *in, int count,
+                       uint16_t *out) const = 0;
+};
+
+namespace {
+
+// Column readers; integers are widened with their NULL mapped to
+// INT64_NULL, the way castAsBigIntAndGetValue() does it.
+
+template <typename T> struct ReadInteger {
+    typedef int64_t ValueType;
+    static inline int64_t read(const char *data, T null) {
+        const T value = *reinterpret_cast<const T*>(data);
+        return value == null ? INT64_NULL : static_cast<int64_t>(value);
+    }
+};
+
+struct ReadTinyInt {
+    typedef int64_t ValueType;
+    static inline int64_t read(const char *data) { return ReadInteger<int8_t>::read(data, INT8_NULL); }
+};
+
+struct ReadSmallInt {
+    typedef int64_t ValueType;
+    static inline int64_t read(const char *data) { return ReadInteger<int16_t>::read(data, INT16_NULL); }
+};
+
+struct ReadInt {
+    typedef int64_t ValueType;
+    static inline int64_t read(const char *data) { return ReadInteger<int32_t>::read(data, INT32_NULL); }
+};
+
+struct ReadBigInt {
+    typedef int64_t ValueType;
+    static inline int64_t read(const char *data) { return *reinterpret_cast<const int64_t*>(data); }
+};
+
+struct ReadDouble {
+    typedef double ValueType;
+    static inline double read(const char *data) { return *reinterpret_cast<const double*>(data); }
+};
+
+// Comparisons written in terms of == and > only, so that they agree with
+// NValue::compare() (EQUAL, else GREATERTHAN, else LESSTHAN) even for NaN.
+
+struct Eq  { template <typename V> static inline bool cmp(V l, V r) { return l == r; } };
+struct Ne  { template <typename V> static inline bool cmp(V l, V r) { return !(l == r); } };
+struct Lt  { template <typename V> static inline bool cmp(V l, V r) { return !(l == r) && !(l > r); } };
+struct Gt  { template <typename V> static inline bool cmp(V l, V r) { return l > r; } };
+struct Lte { template <typename V> static inline bool cmp(V l, V r) { return !(l > r); } };
+struct Gte { template <typename V> static inline bool cmp(V l, V r) { return l == r || l > r; } };
+
+inline bool bindOperand(const NValue &value, int64_t &operand) {
+    switch (ValuePeeker::peekValueType(value)) {
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        operand = ValuePeeker::peekAsBigInt(value);
+        return true;
+    default:
+        // doubles and decimals switch the comparison to another type
+        return false;
+    }
+}
+
+inline bool bindOperand(const NValue &value, double &operand) {
+    if (ValuePeeker::peekValueType(value) != VALUE_TYPE_DOUBLE) {
+        return false;
+    }
+    operand = ValuePeeker::peekDouble(value);
+    return true;
+}
+
+/** column op operand, where the operand is a constant or a parameter */
+template <typename Reader, typename Cmp>
+class CompareNode : public CompiledPredicate::Node {
+public:
+    CompareNode(uint32_t offset, const AbstractExpression *operand)
+        : m_offset(TUPLE_HEADER_SIZE + offset), m_operandExpression(operand), m_operand() {}
+
+    bool bind() {
+        return bindOperand(m_operandExpression->eval(NULL, NULL), m_operand);
+    }
+
+    int select(char * const *tuples, const uint16_t *in, int count, uint16_t *out) const {
+        const typename Reader::ValueType operand = m_operand;
+        int matches = 0;
+        for (int ii = 0; ii < count; ii++) {
+            const uint16_t position = in[ii];
+            out[matches] = position;
+            matches += Cmp::cmp(Reader::read(tuples[position] + m_offset), operand);
+        }
+        return matches;
+    }
+
+private:
+    const uint32_t m_offset;
+    const AbstractExpression *m_operandExpression;
+    typename Reader::ValueType m_operand;
+};
+
+class AndNode : public CompiledPredicate::Node {
+public:
+    AndNode(CompiledPredicate::Node *left, CompiledPredicate::Node *right)
+        : m_left(left), m_right(right) {}
+    ~AndNode() {
+        delete m_left;
+        delete m_right;
+    }
+
+    bool bind() {
+        return m_left->bind() && m_right->bind();
+    }
+
+    int select(char * const *tuples, const uint16_t *in, int count, uint16_t *out) const {
+        const int matches = m_left->select(tuples, in, count, m_scratch);
+        return m_right->select(tuples, m_scratch, matches, out);
+    }
+
+private:
+    CompiledPredicate::Node *m_left;
+    CompiledPredicate::Node *m_right;
+    mutable uint16_t m_scratch[CompiledPredicate::BATCH_SIZE];
+};
+
+class OrNode : public CompiledPredicate::Node {
+public:
+    OrNode(CompiledPredicate::Node *left, CompiledPredicate::Node *right)
+        : m_left(left), m_right(right) {}
+    ~OrNode() {
+        delete m_left;
+        delete m_right;
+    }
+
+    bool bind() {
+        return m_left->bind() && m_right->bind();
+    }
+
+    int select(char * const *tuples, const uint16_t *in, int count, uint16_t *out) const {
+        const int leftMatches = m_left->select(tuples, in, count, m_leftScratch);
+        const int rightMatches = m_right->select(tuples, in, count, m_rightScratch);
+        // both are ascending subsets of in, so a merge gives their union
+        int ll = 0, rr = 0, matches = 0;
+        while (ll < leftMatches && rr < rightMatches) {
+            const uint16_t left = m_leftScratch[ll];
+            const uint16_t right = m_rightScratch[rr];
+            out[matches++] = left < right ? left : right;
+            ll += left <= right;
+            rr += right <= left;
+        }
+        while (ll < leftMatches) {
+            out[matches++] = m_leftScratch[ll++];
+        }
+        while (rr < rightMatches) {
+            out[matches++] = m_rightScratch[rr++];
+        }
+        return matches;
+    }
+
+private:
+    CompiledPredicate::Node *m_left;
+    CompiledPredicate::Node *m_right;
+    mutable uint16_t m_leftScratch[CompiledPredicate::BATCH_SIZE];
+    mutable uint16_t m_rightScratch[CompiledPredicate::BATCH_SIZE];
+};
+
+template <typename Reader>
+CompiledPredicate::Node* compareNode(ExpressionType type, uint32_t offset,
+                                     const AbstractExpression *operand) {
+    switch (type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+        return new CompareNode<Reader, Eq>(offset, operand);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+        return new CompareNode<Reader, Ne>(offset, operand);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        return new CompareNode<Reader, Lt>(offset, operand);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        return new CompareNode<Reader, Gt>(offset, operand);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        return new CompareNode<Reader, Lte>(offset, operand);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        return new CompareNode<Reader, Gte>(offset, operand);
+    default:
+        return NULL;
+    }
+}
+
+/** The same comparison with its operands swapped */
+ExpressionType reverseComparison(ExpressionType type) {
+    switch (type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+        return type;
+    }
+}
+
+inline bool isOperand(const AbstractExpression *expression) {
+    return dynamic_cast<const ConstantValueExpression*>(expression) != NULL ||
+        dynamic_cast<const ParameterValueExpression*>(expression) != NULL;
+}
+
+inline const TupleValueExpression* asColumn(const AbstractExpression *expression) {
+    const TupleValueExpression *column = dynamic_cast<const TupleValueExpression*>(expression);
+    return column != NULL && column->getTupleIndex() == 0 ? column : NULL;
+}
+
+CompiledPredicate::Node* compileComparison(const AbstractExpression *predicate,
+                                           const TupleSchema *schema) {
+    ExpressionType type = predicate->getExpressionType();
+    const TupleValueExpression *column = asColumn(predicate->getLeft());
+    const AbstractExpression *operand = predicate->getRight();
+    bool reversed = false;
+    if (column == NULL) {
+        column = asColumn(predicate->getRight());
+        operand = predicate->getLeft();
+        reversed = true;
+    }
+    if (column == NULL || operand == NULL || !isOperand(operand)) {
+        return NULL;
+    }
+
+    const int columnId = column->getColumnId();
+    if (columnId < 0 || columnId >= schema->columnCount()) {
+        return NULL;
+    }
+    const uint32_t offset = schema->columnOffset(columnId);
+    const ValueType columnType = schema->columnType(columnId);
+    if (reversed) {
+        // only exact for integers; a reversed double comparison would
+        // order NaN differently from NValue::compare()
+        if (columnType == VALUE_TYPE_DOUBLE) {
+            return NULL;
+        }
+        type = reverseComparison(type);
+    }
+
+    switch (columnType) {
+    case VALUE_TYPE_TINYINT:   return compareNode<ReadTinyInt>(type, offset, operand);
+    case VALUE_TYPE_SMALLINT:  return compareNode<ReadSmallInt>(type, offset, operand);
+    case VALUE_TYPE_INTEGER:   return compareNode<ReadInt>(type, offset, operand);
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP: return compareNode<ReadBigInt>(type, offset, operand);
+    case VALUE_TYPE_DOUBLE:    return compareNode<ReadDouble>(type, offset, operand);
+    default:                   return NULL;
+    }
+}
+
+CompiledPredicate::Node* compileNode(const AbstractExpression *predicate,
+                                     const TupleSchema *schema) {
+    const ExpressionType type = predicate->getExpressionType();
+    switch (type) {
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR: {
+        if (predicate->getLeft() == NULL || predicate->getRight() == NULL) {
+            return NULL;
+        }
+        CompiledPredicate::Node *left = compileNode(predicate->getLeft(), schema);
+        if (left == NULL) {
+            return NULL;
+        }
+        CompiledPredicate::Node *right = compileNode(predicate->getRight(), schema);
+        if (right == NULL) {
+            delete left;
+            return NULL;
+        }
+        if (type == EXPRESSION_TYPE_CONJUNCTION_AND) {
+            return new AndNode(left, right);
+        }
+        return new OrNode(left, right);
+    }
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+        return compileComparison(predicate, schema);
+    default:
+        return NULL;
+    }
+}
+
+}
+
+CompiledPredicate* CompiledPredicate::compile(const AbstractExpression *predicate,
+                                              const TupleSchema *schema) {
+    if (predicate == NULL) {
+        return NULL;
+    }
+    Node *root = compileNode(predicate, schema);
+    return root == NULL ? NULL : new CompiledPredicate(root);
+}
+
+CompiledPredicate::CompiledPredicate(Node *root) : m_root(root) {
+    for (int ii = 0; ii < BATCH_SIZE; ii++) {
+        m_all[ii] = static_cast<uint16_t>(ii);
+    }
+}
+
+CompiledPredicate::~CompiledPredicate() {
+    delete m_root;
+}
+
+bool CompiledPredicate::bind() {
+    return m_root->bind();
+}
+
+int CompiledPredicate::evaluate(char * const *tuples, int count, uint16_t *selection) const {
+    assert(count <= BATCH_SIZE);
+    return m_root->select(tuples, m_all, count, selection);
+}
+
+}
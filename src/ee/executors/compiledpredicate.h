@@ -0,0 +1,113 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTORECOMPILEDPREDICATE_H
+#define HSTORECOMPILEDPREDICATE_H
+
+#include "common/common.h"
+#include "common/TupleSchema.h"
+
+#include <stdint.h>
+
+namespace voltdb {
+
+class AbstractExpression;
+
+/**
+ * Scan predicate specialized at plan time for the common shapes
+ * column-op-constant and column-op-parameter, and AND/OR trees of those,
+ * over fixed-width integer and double columns.
+ *
+ * The predicate is applied to a batch of tuple addresses at a time and
+ * produces a selection vector: the positions in the batch of the tuples
+ * that qualify, in ascending order. Each comparison runs one typed loop
+ * that reads its column straight out of the tuple storage, so there is no
+ * NValue or virtual call per tuple. AND narrows the selection of its left
+ * side with its right side; OR merges the selections of both sides.
+ *
+ * The results are the same as those of AbstractExpression::eval(),
+ * including the ordering of NULL, which compares as the smallest value.
+ */
+class CompiledPredicate {
+public:
+    static const int BATCH_SIZE = 1024;
+
+    /**
+     * Build the specialized form of a predicate over tuples of the given
+     * schema, or return NULL if the predicate has any other shape. The
+     * expression must outlive the returned object.
+     */
+    static CompiledPredicate* compile(const AbstractExpression *predicate,
+                                      const TupleSchema *schema);
+
+    ~CompiledPredicate();
+
+    /**
+     * Read the constant and parameter operands for this execution. Must be
+     * called after the expression's substitute(). Returns false if an
+     * operand has a type the typed comparisons cannot reproduce, in which
+     * case the caller has to evaluate the expression itself.
+     */
+    bool bind();
+
+    /**
+     * Write to selection the positions of the tuples in the batch that
+     * satisfy the predicate and return how many there are. At most
+     * BATCH_SIZE tuples can be passed at a time.
+     */
+    int evaluate(char * const *tuples, int count, uint16_t *selection) const;
+
+    class Node;
+
+private:
+    CompiledPredicate(Node *root);
+
+    Node *m_root;
+    uint16_t m_all[BATCH_SIZE];
+};
+
+}
+
+#endif
@@ -137,7 +137,7 @@ bool DeleteExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
         	// no need of persistency check, m_targetTable is
 			// always persistent for deletes
 
-			LogRecord *logrecord = new LogRecord(computeTimeStamp(),
+			LogRecord logrecord(computeTimeStamp(),
 					LogRecord::T_TRUNCATE,// this is a truncate record
 					LogRecord::T_FORWARD,// the system is running normally
 					-1,// XXX: prevLSN must be fetched from table!
@@ -151,26 +151,9 @@ bool DeleteExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
 					NULL// after image irrelevant
 			);
 
-			size_t logrecordLength = logrecord->getEstimatedLength();
-			char *logrecordBuffer = new char[logrecordLength];
-
-			FallbackSerializeOutput output;
-			output.initializeWithPosition(logrecordBuffer, logrecordLength, 0);
-
-			logrecord->serializeTo(output);
-
-			LogManager* m_logManager = this->m_engine->getLogManager();
-			Logger m_ariesLogger = m_logManager->getAriesLogger();
-			//VOLT_WARN("m_logManager : %p AriesLogger : %p",&m_logManager, &m_ariesLogger);
-			const Logger *logger = m_logManager->getThreadLogger(LOGGERID_MM_ARIES);
-
-			logger->log(LOGLEVEL_INFO, output.data(), output.position());
-
-			delete[] logrecordBuffer;
-			logrecordBuffer = NULL;
-
-			delete logrecord;
-			logrecord = NULL;
+			// serialized straight into the transaction's log buffer
+			const Logger *logger = m_engine->getLogManager()->getThreadLogger(LOGGERID_MM_ARIES);
+			logger->log(LOGLEVEL_INFO, logrecord);
 
         }
 #endif
@@ -203,7 +186,7 @@ bool DeleteExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
         
         // Read/Write Set Tracking
         if (tracker != NULL) {
-            tracker->markTupleWritten(m_targetTable->name(), &m_targetTuple);
+            tracker->markTupleWritten(m_targetTable, &m_targetTuple);
         }
 
 #ifdef ARIES
@@ -234,7 +217,7 @@ bool DeleteExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
 				beforeImage = NULL;
 			}
 
-			LogRecord *logrecord = new LogRecord(computeTimeStamp(),
+			LogRecord logrecord(computeTimeStamp(),
 					LogRecord::T_DELETE,// this is a delete record
 					LogRecord::T_FORWARD,// the system is running normally
 					-1,// XXX: prevLSN must be fetched from table!
@@ -248,27 +231,9 @@ bool DeleteExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
 					NULL// no after image
 			);
 
-			size_t logrecordLength = logrecord->getEstimatedLength();
-			char *logrecordBuffer = new char[logrecordLength];
-
-			FallbackSerializeOutput output;
-			output.initializeWithPosition(logrecordBuffer, logrecordLength, 0);
-
-			logrecord->serializeTo(output);
-
-			LogManager* m_logManager = this->m_engine->getLogManager();
-			Logger m_ariesLogger = m_logManager->getAriesLogger();
-			//VOLT_WARN("m_logManager : %p AriesLogger : %p",&m_logManager, &m_ariesLogger);
-
-			const Logger *logger = m_logManager->getThreadLogger(LOGGERID_MM_ARIES);
-
-			logger->log(LOGLEVEL_INFO, output.data(), output.position());
-
-			delete[] logrecordBuffer;
-			logrecordBuffer = NULL;
-
-			delete logrecord;
-			logrecord = NULL;
+			// serialized straight into the transaction's log buffer
+			const Logger *logger = m_engine->getLogManager()->getThreadLogger(LOGGERID_MM_ARIES);
+			logger->log(LOGLEVEL_INFO, logrecord);
 
 			if (keydata != NULL) {
 				delete[] keydata;
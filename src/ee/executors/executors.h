@@ -86,6 +86,7 @@
 #include "executors/materializeexecutor.h"
 #include "executors/nestloopexecutor.h"
 #include "executors/nestloopindexexecutor.h"
+#include "executors/hashjoinexecutor.h"
 #include "executors/orderbyexecutor.h"
 #include "executors/projectionexecutor.h"
 #include "executors/receiveexecutor.h"
@@ -0,0 +1,449 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "executors/flathashaggregator.h"
+#include "common/SQLException.h"
+#include "common/ValueFactory.hpp"
+#include "common/value_defs.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+
+namespace voltdb {
+
+namespace {
+
+template <typename T> inline bool isNullInteger(T value);
+template <> inline bool isNullInteger<int8_t>(int8_t value) { return value == INT8_NULL; }
+template <> inline bool isNullInteger<int16_t>(int16_t value) { return value == INT16_NULL; }
+template <> inline bool isNullInteger<int32_t>(int32_t value) { return value == INT32_NULL; }
+template <> inline bool isNullInteger<int64_t>(int64_t value) { return value == INT64_NULL; }
+
+template <typename T>
+inline T readColumn(const char *tuple, uint32_t offset) {
+    return *reinterpret_cast<const T*>(tuple + TUPLE_HEADER_SIZE + offset);
+}
+
+inline int64_t readKey(const char *tuple, uint32_t offset, int source) {
+    switch (source) {
+    case 0: return readColumn<int8_t>(tuple, offset);
+    case 1: return readColumn<int16_t>(tuple, offset);
+    case 2: return readColumn<int32_t>(tuple, offset);
+    default: return readColumn<int64_t>(tuple, offset);
+    }
+}
+
+inline uint64_t mixHash(uint64_t hash) {
+    // murmur3 finalizer
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/** Same overflow check and error as NValue::opAddBigInts */
+inline int64_t addBigInts(int64_t lhs, int64_t rhs) {
+    if (((lhs ^ rhs)
+         | (((lhs ^ (~(lhs ^ rhs) & (1L << (sizeof(int64_t) * CHAR_BIT - 1)))) + rhs) ^ rhs)) >= 0) {
+        char message[4096];
+        snprintf(message, 4096, "Adding %jd and %jd will overflow BigInt storage",
+                 (intmax_t)lhs, (intmax_t)rhs);
+        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, message);
+    }
+    return lhs + rhs;
+}
+
+/** Same check and error as NValue::opAddDoubles */
+inline double addDoubles(double lhs, double rhs) {
+    const double result = lhs + rhs;
+    if (std::isinf(result) || std::isnan(result)) {
+        char message[4096];
+        snprintf(message, 4096, "Attempted to add %f with %f caused overflow/underflow or some other error. Result was %f",
+                 lhs, rhs, result);
+        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, message);
+    }
+    return result;
+}
+
+const int INITIAL_SLOTS = 64;
+
+}
+
+FlatHashAggregator::SourceType FlatHashAggregator::sourceTypeFor(ValueType type) {
+    switch (type) {
+    case VALUE_TYPE_TINYINT:   return SOURCE_INT8;
+    case VALUE_TYPE_SMALLINT:  return SOURCE_INT16;
+    case VALUE_TYPE_INTEGER:   return SOURCE_INT32;
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP: return SOURCE_INT64;
+    case VALUE_TYPE_DOUBLE:    return SOURCE_DOUBLE;
+    default:                   return SOURCE_NONE;
+    }
+}
+
+bool FlatHashAggregator::isIntegerKey(ValueType type) {
+    SourceType source = sourceTypeFor(type);
+    return source != SOURCE_NONE && source != SOURCE_DOUBLE;
+}
+
+bool FlatHashAggregator::supports(const TupleSchema *inputSchema,
+                                  const std::vector<int> &groupByColumns,
+                                  const std::vector<ExpressionType> &aggregateTypes,
+                                  const std::vector<int> &aggregateColumns) {
+    if (groupByColumns.size() > MAX_KEY_COLUMNS || aggregateTypes.empty() ||
+        aggregateTypes.size() != aggregateColumns.size()) {
+        return false;
+    }
+    for (int ii = 0; ii < groupByColumns.size(); ii++) {
+        if (!isIntegerKey(inputSchema->columnType(groupByColumns[ii]))) {
+            return false;
+        }
+    }
+    for (int ii = 0; ii < aggregateTypes.size(); ii++) {
+        switch (aggregateTypes[ii]) {
+        case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        case EXPRESSION_TYPE_AGGREGATE_SUM:
+        case EXPRESSION_TYPE_AGGREGATE_MIN:
+        case EXPRESSION_TYPE_AGGREGATE_MAX:
+        case EXPRESSION_TYPE_AGGREGATE_AVG:
+            if (sourceTypeFor(inputSchema->columnType(aggregateColumns[ii])) == SOURCE_NONE) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+FlatHashAggregator::FlatHashAggregator(const TupleSchema *inputSchema,
+                                       const std::vector<int> &groupByColumns,
+                                       const std::vector<ExpressionType> &aggregateTypes,
+                                       const std::vector<int> &aggregateColumns)
+    : m_keyColumnCount(static_cast<int>(groupByColumns.size())),
+      m_aggregates(aggregateTypes.size()),
+      m_slotMask(INITIAL_SLOTS - 1),
+      m_groupCount(0),
+      m_batchSize(0)
+{
+    assert(supports(inputSchema, groupByColumns, aggregateTypes, aggregateColumns));
+    for (int ii = 0; ii < m_keyColumnCount; ii++) {
+        m_keySources[ii] = sourceTypeFor(inputSchema->columnType(groupByColumns[ii]));
+        m_keyOffsets[ii] = inputSchema->columnOffset(groupByColumns[ii]);
+    }
+    for (int ii = 0; ii < m_aggregates.size(); ii++) {
+        Aggregate &aggregate = m_aggregates[ii];
+        aggregate.type = aggregateTypes[ii];
+        if (aggregate.type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+            aggregate.source = SOURCE_NONE;
+            aggregate.offset = 0;
+        } else {
+            aggregate.source = sourceTypeFor(inputSchema->columnType(aggregateColumns[ii]));
+            aggregate.offset = inputSchema->columnOffset(aggregateColumns[ii]);
+        }
+    }
+    m_slots.assign(INITIAL_SLOTS, -1);
+    m_slotHashes.assign(INITIAL_SLOTS, 0);
+}
+
+void FlatHashAggregator::reset() {
+    if (m_groupCount > 0) {
+        std::fill(m_slots.begin(), m_slots.end(), -1);
+    }
+    m_groupCount = 0;
+    m_groupKeys.clear();
+    m_groupTuples.clear();
+    for (int ii = 0; ii < m_aggregates.size(); ii++) {
+        m_aggregates[ii].ints.clear();
+        m_aggregates[ii].doubles.clear();
+        m_aggregates[ii].counts.clear();
+    }
+    m_batchSize = 0;
+}
+
+void FlatHashAggregator::advance(char * const *tuples, int count) {
+    while (count > 0) {
+        const int chunk = std::min(count, BATCH_SIZE - m_batchSize);
+        std::copy(tuples, tuples + chunk, m_batch + m_batchSize);
+        m_batchSize += chunk;
+        tuples += chunk;
+        count -= chunk;
+        if (m_batchSize == BATCH_SIZE) {
+            processBatch();
+        }
+    }
+}
+
+void FlatHashAggregator::processBatch() {
+    // 1. keys and hashes for the whole batch
+    for (int row = 0; row < m_batchSize; row++) {
+        int64_t *key = &m_batchKeys[row * MAX_KEY_COLUMNS];
+        uint64_t hash = 0x9e3779b97f4a7c15ULL;
+        for (int col = 0; col < m_keyColumnCount; col++) {
+            key[col] = readKey(m_batch[row], m_keyOffsets[col], m_keySources[col]);
+            hash = mixHash(hash ^ static_cast<uint64_t>(key[col]));
+        }
+        m_batchHashes[row] = hash;
+    }
+
+    // 2. a group for every row
+    for (int row = 0; row < m_batchSize; row++) {
+        m_batchGroups[row] = findOrInsertGroup(&m_batchKeys[row * MAX_KEY_COLUMNS],
+                                               m_batchHashes[row], m_batch[row]);
+    }
+
+    // 3. one tight loop per aggregate
+    for (int ii = 0; ii < m_aggregates.size(); ii++) {
+        Aggregate &aggregate = m_aggregates[ii];
+        switch (aggregate.source) {
+        case SOURCE_INT8:   advanceIntegers<int8_t>(aggregate); break;
+        case SOURCE_INT16:  advanceIntegers<int16_t>(aggregate); break;
+        case SOURCE_INT32:  advanceIntegers<int32_t>(aggregate); break;
+        case SOURCE_INT64:  advanceIntegers<int64_t>(aggregate); break;
+        case SOURCE_DOUBLE: advanceDoubles(aggregate); break;
+        case SOURCE_NONE:
+            for (int row = 0; row < m_batchSize; row++) {
+                aggregate.counts[m_batchGroups[row]]++;
+            }
+            break;
+        }
+    }
+    m_batchSize = 0;
+}
+
+template <typename T>
+void FlatHashAggregator::advanceIntegers(Aggregate &aggregate) {
+    int64_t *values = &aggregate.ints[0];
+    int64_t *counts = &aggregate.counts[0];
+    const uint32_t offset = aggregate.offset;
+    switch (aggregate.type) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        for (int row = 0; row < m_batchSize; row++) {
+            if (!isNullInteger(readColumn<T>(m_batch[row], offset))) {
+                counts[m_batchGroups[row]]++;
+            }
+        }
+        break;
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+        for (int row = 0; row < m_batchSize; row++) {
+            const T value = readColumn<T>(m_batch[row], offset);
+            if (isNullInteger(value)) {
+                continue;
+            }
+            const int32_t group = m_batchGroups[row];
+            values[group] = counts[group] == 0 ? value : addBigInts(values[group], value);
+            counts[group]++;
+        }
+        break;
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+        for (int row = 0; row < m_batchSize; row++) {
+            const T value = readColumn<T>(m_batch[row], offset);
+            if (isNullInteger(value)) {
+                continue;
+            }
+            const int32_t group = m_batchGroups[row];
+            if (counts[group] == 0 || value < values[group]) {
+                values[group] = value;
+            }
+            counts[group]++;
+        }
+        break;
+    case EXPRESSION_TYPE_AGGREGATE_MAX:
+        for (int row = 0; row < m_batchSize; row++) {
+            const T value = readColumn<T>(m_batch[row], offset);
+            if (isNullInteger(value)) {
+                continue;
+            }
+            const int32_t group = m_batchGroups[row];
+            if (counts[group] == 0 || value > values[group]) {
+                values[group] = value;
+            }
+            counts[group]++;
+        }
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void FlatHashAggregator::advanceDoubles(Aggregate &aggregate) {
+    double *values = &aggregate.doubles[0];
+    int64_t *counts = &aggregate.counts[0];
+    const uint32_t offset = aggregate.offset;
+    for (int row = 0; row < m_batchSize; row++) {
+        const double value = readColumn<double>(m_batch[row], offset);
+        if (value <= DOUBLE_NULL) {
+            continue;
+        }
+        const int32_t group = m_batchGroups[row];
+        if (counts[group] == 0) {
+            values[group] = value;
+        } else {
+            switch (aggregate.type) {
+            case EXPRESSION_TYPE_AGGREGATE_SUM:
+            case EXPRESSION_TYPE_AGGREGATE_AVG:
+                values[group] = addDoubles(values[group], value);
+                break;
+            case EXPRESSION_TYPE_AGGREGATE_MIN:
+                if (value < values[group]) {
+                    values[group] = value;
+                }
+                break;
+            case EXPRESSION_TYPE_AGGREGATE_MAX:
+                if (value > values[group]) {
+                    values[group] = value;
+                }
+                break;
+            default:
+                // COUNT only needs the count
+                break;
+            }
+        }
+        counts[group]++;
+    }
+}
+
+int FlatHashAggregator::findOrInsertGroup(const int64_t *key, uint64_t hash, char *tuple) {
+    uint64_t slot = hash & m_slotMask;
+    while (true) {
+        const int32_t group = m_slots[slot];
+        if (group < 0) {
+            break;
+        }
+        if (m_slotHashes[slot] == hash) {
+            const int64_t *groupKey = &m_groupKeys[group * m_keyColumnCount];
+            bool equal = true;
+            for (int col = 0; col < m_keyColumnCount; col++) {
+                if (groupKey[col] != key[col]) {
+                    equal = false;
+                    break;
+                }
+            }
+            if (equal) {
+                return group;
+            }
+        }
+        slot = (slot + 1) & m_slotMask;
+    }
+
+    const int32_t group = m_groupCount++;
+    m_slots[slot] = group;
+    m_slotHashes[slot] = hash;
+    m_groupKeys.insert(m_groupKeys.end(), key, key + m_keyColumnCount);
+    m_groupTuples.push_back(tuple);
+    addGroupStorage();
+
+    // keep the table at most half full
+    if (static_cast<uint64_t>(m_groupCount) * 2 > m_slotMask + 1) {
+        growSlots();
+    }
+    return group;
+}
+
+void FlatHashAggregator::addGroupStorage() {
+    for (int ii = 0; ii < m_aggregates.size(); ii++) {
+        Aggregate &aggregate = m_aggregates[ii];
+        aggregate.counts.push_back(0);
+        if (aggregate.source == SOURCE_DOUBLE) {
+            aggregate.doubles.push_back(0);
+        } else if (aggregate.source != SOURCE_NONE) {
+            aggregate.ints.push_back(0);
+        }
+    }
+}
+
+void FlatHashAggregator::growSlots() {
+    const uint64_t capacity = (m_slotMask + 1) * 2;
+    std::vector<int32_t> slots(capacity, -1);
+    std::vector<uint64_t> hashes(capacity, 0);
+    const uint64_t mask = capacity - 1;
+    for (uint64_t ii = 0; ii <= m_slotMask; ii++) {
+        if (m_slots[ii] < 0) {
+            continue;
+        }
+        uint64_t slot = m_slotHashes[ii] & mask;
+        while (slots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = m_slots[ii];
+        hashes[slot] = m_slotHashes[ii];
+    }
+    m_slots.swap(slots);
+    m_slotHashes.swap(hashes);
+    m_slotMask = mask;
+}
+
+NValue FlatHashAggregator::result(int group, int aggregateIndex) const {
+    const Aggregate &aggregate = m_aggregates[aggregateIndex];
+    const int64_t count = aggregate.counts[group];
+    switch (aggregate.type) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+        return ValueFactory::getBigIntValue(count);
+    default:
+        break;
+    }
+    if (count == 0) {
+        return ValueFactory::getNullValue();
+    }
+    NValue value = aggregate.source == SOURCE_DOUBLE ?
+        ValueFactory::getDoubleValue(aggregate.doubles[group]) :
+        ValueFactory::getBigIntValue(aggregate.ints[group]);
+    if (aggregate.type == EXPRESSION_TYPE_AGGREGATE_AVG) {
+        return value.op_divide(ValueFactory::getDoubleValue(static_cast<double>(count)));
+    }
+    return value;
+}
+
+}
@@ -0,0 +1,175 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREFLATHASHAGGREGATOR_H
+#define HSTOREFLATHASHAGGREGATOR_H
+
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/tabletuple.h"
+#include "common/TupleSchema.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * Hash aggregation for the common case of GROUP BY on fixed-width integer
+ * columns computing COUNT/SUM/MIN/MAX/AVG over integer or double columns.
+ *
+ * Rows are buffered and processed a batch at a time: first the group keys
+ * and their hashes are computed for the whole batch, then each row is
+ * matched to a group in a flat open-addressing table, and finally every
+ * aggregate runs one type-specialized loop over the batch. Running values
+ * live in per-aggregate arrays indexed by group, so there is no per-row
+ * key tuple, NValue or virtual call.
+ *
+ * The results are the same as those of the Agg classes in
+ * aggregateexecutor.hpp, including NULL handling and overflow errors.
+ */
+class FlatHashAggregator {
+public:
+    static const int BATCH_SIZE = 1024;
+    static const int MAX_KEY_COLUMNS = 4;
+
+    /**
+     * Whether the group by columns and aggregates of a plan can all be
+     * handled here. Any other plan keeps using the generic aggregator.
+     */
+    static bool supports(const TupleSchema *inputSchema,
+                         const std::vector<int> &groupByColumns,
+                         const std::vector<ExpressionType> &aggregateTypes,
+                         const std::vector<int> &aggregateColumns);
+
+    FlatHashAggregator(const TupleSchema *inputSchema,
+                       const std::vector<int> &groupByColumns,
+                       const std::vector<ExpressionType> &aggregateTypes,
+                       const std::vector<int> &aggregateColumns);
+
+    /** Drop all groups, keeping the allocated storage for the next execution */
+    void reset();
+
+    inline void advance(const TableTuple &tuple) {
+        m_batch[m_batchSize++] = tuple.address();
+        if (m_batchSize == BATCH_SIZE) {
+            processBatch();
+        }
+    }
+
+    /** Same as advance() for each of count tuple addresses */
+    void advance(char * const *tuples, int count);
+
+    /** Aggregate any rows still buffered; call before reading results */
+    void flush() {
+        if (m_batchSize > 0) {
+            processBatch();
+        }
+    }
+
+    inline int groupCount() const { return m_groupCount; }
+    /** Address of the first input tuple of the group, for pass through columns */
+    inline char* groupTuple(int group) const { return m_groupTuples[group]; }
+    /** Final value of one aggregate for one group */
+    NValue result(int group, int aggregate) const;
+
+private:
+    enum SourceType {
+        SOURCE_INT8,
+        SOURCE_INT16,
+        SOURCE_INT32,
+        SOURCE_INT64,
+        SOURCE_DOUBLE,
+        SOURCE_NONE
+    };
+
+    struct Aggregate {
+        ExpressionType type;
+        SourceType source;
+        uint32_t offset;
+        // running value for each group; which one is used depends on source
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        // non-null inputs seen by each group
+        std::vector<int64_t> counts;
+    };
+
+    void processBatch();
+    int findOrInsertGroup(const int64_t *key, uint64_t hash, char *tuple);
+    void growSlots();
+    void addGroupStorage();
+
+    template <typename T> void advanceIntegers(Aggregate &aggregate);
+    void advanceDoubles(Aggregate &aggregate);
+
+    static SourceType sourceTypeFor(ValueType type);
+    static bool isIntegerKey(ValueType type);
+
+    int m_keyColumnCount;
+    SourceType m_keySources[MAX_KEY_COLUMNS];
+    uint32_t m_keyOffsets[MAX_KEY_COLUMNS];
+    std::vector<Aggregate> m_aggregates;
+
+    // open-addressing table: group index per slot (-1 when empty) and the
+    // full hash of that group, so most mismatches skip the key compare
+    std::vector<int32_t> m_slots;
+    std::vector<uint64_t> m_slotHashes;
+    uint64_t m_slotMask;
+
+    int m_groupCount;
+    std::vector<int64_t> m_groupKeys;
+    std::vector<char*> m_groupTuples;
+
+    // the current batch
+    int m_batchSize;
+    char *m_batch[BATCH_SIZE];
+    int64_t m_batchKeys[BATCH_SIZE * MAX_KEY_COLUMNS];
+    uint64_t m_batchHashes[BATCH_SIZE];
+    int32_t m_batchGroups[BATCH_SIZE];
+};
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stack>
+#include "hashjoinexecutor.h"
+#include "common/debuglog.h"
+#include "common/common.h"
+#include "common/tabletuple.h"
+#include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
+#include "storage/table.h"
+#include "storage/temptable.h"
+#include "storage/tableiterator.h"
+#include "plannodes/hashjoinnode.h"
+
+namespace voltdb {
+
+bool HashJoinExecutor::p_init(AbstractPlanNode* abstract_node, const catalog::Database* catalog_db, int* tempTableMemoryInBytes) {
+    VOLT_TRACE("init HashJoin Executor");
+
+    // builds the output table and assigns each tuple value expression
+    // in the predicate to the outer (0) or inner (1) tuple
+    if (!NestLoopExecutor::p_init(abstract_node, catalog_db, tempTableMemoryInBytes))
+        return false;
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(abstract_node);
+    assert(node);
+    const TupleSchema *schemas[2] = { node->getInputTables()[0]->schema(),
+                                      node->getInputTables()[1]->schema() };
+
+    // collect "outer.a = inner.b" terms from the ANDed parts of the predicate
+    std::stack<const AbstractExpression*> stack;
+    if (node->getPredicate() != NULL)
+        stack.push(node->getPredicate());
+    while (!stack.empty()) {
+        const AbstractExpression *expr = stack.top();
+        stack.pop();
+        if (expr->getExpressionType() == EXPRESSION_TYPE_CONJUNCTION_AND) {
+            stack.push(expr->getLeft());
+            stack.push(expr->getRight());
+            continue;
+        }
+        if (expr->getExpressionType() != EXPRESSION_TYPE_COMPARE_EQUAL)
+            continue;
+        const TupleValueExpression *left = dynamic_cast<const TupleValueExpression*>(expr->getLeft());
+        const TupleValueExpression *right = dynamic_cast<const TupleValueExpression*>(expr->getRight());
+        if (left == NULL || right == NULL || left->getTupleIndex() == right->getTupleIndex())
+            continue;
+        const TupleValueExpression *sides[2];
+        sides[left->getTupleIndex()] = left;
+        sides[right->getTupleIndex()] = right;
+        ValueType outerType = schemas[0]->columnType(sides[0]->getColumnId());
+        ValueType innerType = schemas[1]->columnType(sides[1]->getColumnId());
+        // equal values must hash equally: NValue hashes differ across types,
+        // and 0.0 and -0.0 compare equal but do not hash the same
+        if (outerType != innerType || outerType == VALUE_TYPE_DOUBLE)
+            continue;
+        m_keyColumns[0].push_back(sides[0]->getColumnId());
+        m_keyColumns[1].push_back(sides[1]->getColumnId());
+    }
+
+    if (m_keyColumns[0].empty()) {
+        VOLT_DEBUG("No hashable equality in the join predicate, joining with nested loops");
+    }
+    return true;
+}
+
+size_t HashJoinExecutor::hashKey(const TableTuple &tuple, const std::vector<int> &columns) {
+    size_t seed = 0;
+    for (int i = 0; i < columns.size(); i++) {
+        tuple.getNValue(columns[i]).hashCombine(seed);
+    }
+    return seed;
+}
+
+bool HashJoinExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tracker) {
+    if (m_keyColumns[0].empty())
+        return NestLoopExecutor::p_execute(params, tracker);
+
+    VOLT_DEBUG("executing HashJoin...");
+
+    HashJoinPlanNode* node = dynamic_cast<HashJoinPlanNode*>(abstract_node);
+    assert(node);
+    assert(node->getInputTables().size() == 2);
+
+    // output table must be a temp table
+    TempTable* output_table = dynamic_cast<TempTable*>(node->getOutputTable());
+    assert(output_table);
+
+    Table* inputs[2] = { node->getInputTables()[0], node->getInputTables()[1] };
+    assert(inputs[0]);
+    assert(inputs[1]);
+
+    AbstractExpression *predicate = node->getPredicate();
+    assert(predicate);
+    predicate->substitute(params);
+
+    // hash the smaller input, probe with the other
+    const int build = inputs[1]->activeTupleCount() <= inputs[0]->activeTupleCount() ? 1 : 0;
+    const int probe = 1 - build;
+    VOLT_TRACE("building on %s, probing with %s",
+               inputs[build]->name().c_str(), inputs[probe]->name().c_str());
+
+    m_hashTable.clear();
+    TableTuple build_tuple(inputs[build]->schema());
+    TableIterator build_iterator(inputs[build]);
+    while (build_iterator.next(build_tuple)) {
+        // NULL keys are hashed like any other value so that the predicate
+        // decides whether they match, exactly as it does for nested loops
+        m_hashTable[hashKey(build_tuple, m_keyColumns[build])].push_back(build_tuple.address());
+    }
+    if (m_hashTable.empty())
+        return true;
+
+    int outer_cols = inputs[0]->columnCount();
+    int inner_cols = inputs[1]->columnCount();
+    TableTuple probe_tuple(inputs[probe]->schema());
+    TableTuple *tuples[2];
+    tuples[build] = &build_tuple;
+    tuples[probe] = &probe_tuple;
+    TableTuple &joined = output_table->tempTuple();
+
+    TableIterator probe_iterator(inputs[probe]);
+    while (probe_iterator.next(probe_tuple)) {
+        HashTable::const_iterator bucket = m_hashTable.find(hashKey(probe_tuple, m_keyColumns[probe]));
+        if (bucket == m_hashTable.end())
+            continue;
+        for (std::vector<char*>::const_iterator it = bucket->second.begin();
+             it != bucket->second.end(); it++) {
+            build_tuple.move(*it);
+            if (!predicate->eval(tuples[0], tuples[1]).isTrue())
+                continue;
+            for (int col_ctr = 0; col_ctr < outer_cols; col_ctr++) {
+                joined.setNValue(col_ctr, tuples[0]->getNValue(col_ctr));
+            }
+            for (int col_ctr = 0; col_ctr < inner_cols; col_ctr++) {
+                joined.setNValue(col_ctr + outer_cols, tuples[1]->getNValue(col_ctr));
+            }
+            output_table->insertTupleNonVirtual(joined);
+        }
+    }
+
+    return (true);
+}
+
+}
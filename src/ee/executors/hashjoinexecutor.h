@@ -0,0 +1,87 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB L.L.C. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREHASHJOINEXECUTOR_H
+#define HSTOREHASHJOINEXECUTOR_H
+
+#include "common/common.h"
+#include "common/valuevector.h"
+#include "executors/nestloopexecutor.h"
+
+#include "boost/unordered_map.hpp"
+#include <vector>
+
+namespace voltdb {
+
+class TableTuple;
+
+/**
+ * Inner join on the equalities between the two inputs found in the join
+ * predicate. The smaller input is hashed on its join columns and the other
+ * one probes it; the whole predicate is still evaluated on every candidate
+ * pair, so hash collisions and any non-equality terms are handled there.
+ * Falls back to the nested loop when the predicate has no usable equality.
+ */
+class HashJoinExecutor : public NestLoopExecutor {
+    public:
+        HashJoinExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) : NestLoopExecutor(engine, abstract_node) { }
+    protected:
+        bool p_init(AbstractPlanNode*, const catalog::Database* catalog_db, int* tempTableMemoryInBytes);
+        bool p_execute(const NValueArray &params, ReadWriteTracker *tracker);
+
+    private:
+        static size_t hashKey(const TableTuple &tuple, const std::vector<int> &columns);
+
+        // join columns of the outer (0) and inner (1) input, pairwise equal
+        std::vector<int> m_keyColumns[2];
+
+        // key hash -> addresses of the build side tuples, in scan order
+        typedef boost::unordered_map<size_t, std::vector<char*> > HashTable;
+        HashTable m_hashTable;
+};
+
+}
+
+#endif
@@ -184,9 +184,6 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
     // count the number of successful inserts
     int modifiedTuples = 0;
 
-    Table* outputTable = m_node->getOutputTable();
-    assert(outputTable);
-
     bool beProcessed = false;
 
 	// Implement insert multiple values. Added by hawk, 10/2/2014
@@ -204,11 +201,43 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
     TableIterator iterator(m_inputTable);
     while (iterator.next(m_tuple)) {
     	beProcessed = true;
+        if (!insertTuple(m_tuple, modifiedTuples)) {
+            return false;
+        }
+	}
+
+    //for multiple insert values
+	}   // ended by hawk
+
+		finish(beProcessed, modifiedTuples);
+		return true;
+	}
+
+	bool InsertExecutor::p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker) {
+		assert(m_node->getInputTables().size() == 1);
+		m_pushedTuples = 0;
+		m_pushedModified = 0;
+		return true;
+	}
+
+	bool InsertExecutor::p_pushTuple(TableTuple &tuple) {
+		m_pushedTuples++;
+		return insertTuple(tuple, m_pushedModified);
+	}
+
+	bool InsertExecutor::p_pushEnd() {
+		finish(m_pushedTuples > 0, m_pushedModified);
+		return true;
+	}
+
+	bool InsertExecutor::insertTuple(TableTuple &tuple, int &modifiedTuples) {
         VOLT_DEBUG("Inserting tuple '%s' into target table '%s'",
-                   m_tuple.debug(m_targetTable->name()).c_str(), m_targetTable->name().c_str());
+                   tuple.debug(m_targetTable->name()).c_str(), m_targetTable->name().c_str());
         VOLT_TRACE("Target Table %s: %s",
                    m_targetTable->name().c_str(), m_targetTable->schema()->debug().c_str());
 
+        Table* outputTable = m_node->getOutputTable();
+        assert(outputTable);
 
 #ifdef ARIES
         if(m_engine->isARIESEnabled()){
@@ -218,7 +247,7 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
 
 			// only log if we are writing to a persistent table.
 			if (table != NULL) {
-				LogRecord *logrecord = new LogRecord(computeTimeStamp(),
+				LogRecord logrecord(computeTimeStamp(),
 						LogRecord::T_INSERT,	// this is an insert record
 						LogRecord::T_FORWARD,// the system is running normally
 						-1,// XXX: prevLSN must be fetched from table!
@@ -229,30 +258,13 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
 						-1,// inserting, all columns affected
 						NULL,// insert, don't care about modified cols
 						NULL,// no before image
-						&m_tuple// after image
+						&tuple// after image
 				);
 
-				size_t logrecordEstLength = logrecord->getEstimatedLength();
-				char *logrecordBuffer = new char[logrecordEstLength];
-
-				FallbackSerializeOutput output;
-				output.initializeWithPosition(logrecordBuffer, logrecordEstLength, 0);
+				// serialized straight into the transaction's log buffer
+				const Logger *logger = m_engine->getLogManager()->getThreadLogger(LOGGERID_MM_ARIES);
+				logger->log(LOGLEVEL_INFO, logrecord);
 
-				logrecord->serializeTo(output);
-
-				LogManager* m_logManager = this->m_engine->getLogManager();
-				Logger m_ariesLogger = m_logManager->getAriesLogger();
-				//VOLT_WARN("m_logManager : %p AriesLogger : %p",&m_logManager, &m_ariesLogger);
-				const Logger *logger = m_logManager->getThreadLogger(LOGGERID_MM_ARIES);
-
-				// output.position() indicates the actual number of bytes written out
-				logger->log(LOGLEVEL_INFO, output.data(), output.position());
-
-				delete[] logrecordBuffer;
-				logrecordBuffer = NULL;
-
-				delete logrecord;
-				logrecord = NULL;
 			}
 
         }
@@ -262,7 +274,7 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
         if (m_partitionColumn != -1) {
 
             // get the value for the partition column
-            NValue value = m_tuple.getNValue(m_partitionColumn);
+            NValue value = tuple.getNValue(m_partitionColumn);
             bool isLocal = m_engine->isLocalSite(value);
 
             // if it doesn't map to this site
@@ -271,13 +283,13 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
                     VOLT_ERROR("Mispartitioned Tuple in single-partition plan.");
                     return false;
                 }
-                continue;
+                return true;
             }
         }
 
         // for insert multiple values, added by hawk, 10/2/2014
 		// try to put the tuple into the target table
-		if (!m_targetTable->insertTuple(m_tuple)) {
+		if (!m_targetTable->insertTuple(tuple)) {
 			VOLT_ERROR("Failed to insert tuple from input table '%s' into"
 				" target table '%s'",
 				m_inputTable->name().c_str(),
@@ -286,7 +298,7 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
 		}
 
 		// try to put the tuple into the output table
-		if (!outputTable->insertTuple(m_tuple)) {
+		if (!outputTable->insertTuple(tuple)) {
 			VOLT_ERROR("Failed to insert tuple from input table '%s' into"
 				" output table '%s'",
 				m_inputTable->name().c_str(),
@@ -296,12 +308,10 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
 
 		// successfully inserted
 		modifiedTuples++;
-
+		return true;
 	}
 
-    //for multiple insert values
-	}   // ended by hawk
-
+	void InsertExecutor::finish(bool beProcessed, int modifiedTuples) {
 		// Check if the target table is persistent, and if hasTriggers flag is true
 		// If it is, then iterate through each one and pass in outputTable
 		VOLT_DEBUG("beProcessed = %d", beProcessed);
@@ -311,81 +321,16 @@ int64_t another_timespecDiffNanoseconds(const timespec& end, const timespec& sta
 			VOLT_DEBUG("persistTarget = %s", persistTarget->name().c_str());
 			VOLT_DEBUG("persistTarget hasTriggers = %d", persistTarget->hasTriggers());
 			VOLT_DEBUG("persistTarget fireTriggers = %d", persistTarget->fireTriggers());
-			if(persistTarget != NULL && persistTarget->hasTriggers() && persistTarget->fireTriggers()) {
-                              
-                                // added by hawk, 2013/12/13, for collect data
-/*
-                                struct timeval start_;
-                                struct timeval delete_start_;
-                                struct timeval end_;
-                                struct timespec start;
-                                struct timespec delete_start;
-                                struct timespec end;
-                        
-                                int error = gettimeofday(&start_, NULL);
-                                assert(error == 0);
-*/
-                                // ended by hawk
-				std::vector<Trigger*>::iterator trig_iter;
-
-				VOLT_DEBUG( "Start firing triggers of table '%s'", persistTarget->name().c_str());
-
-				for(trig_iter = persistTarget->getTriggers()->begin();
-					trig_iter != persistTarget->getTriggers()->end(); trig_iter++) {
-						//if statement to make sure the trigger is an insert... breaking
-						//if((*trig_iter)->getType() == (unsigned char)TRIGGER_INSERT)
-						//(*trig_iter)->fire(m_engine, outputTable);
-					m_engine->fireTrigger(*trig_iter);
-				}
-				VOLT_DEBUG( "End firing triggers of table '%s'", persistTarget->name().c_str());
-
-                                // to ensure this is a stream, by hawk, 2013.11.25
-                                //added by hawk, 2013/12/13, to collect data
-                                /*
-                                error = gettimeofday(&delete_start_, NULL);
-                                assert(error == 0);
-                                */
-                                //ended by hawk
-                                if (persistTarget->isStream() == true)
-				    persistTarget->deleteAllTuples(true);
-
-                                //added by hawk, 2013/12/13, to collect data
-/*
-                                error = gettimeofday(&end_, NULL);
-                                assert(error == 0);
-
-                                TIMEVAL_TO_TIMESPEC(&start_, &start);
-                                TIMEVAL_TO_TIMESPEC(&delete_start_, &delete_start);
-                                TIMEVAL_TO_TIMESPEC(&end_, &end);
-                                
-                                int64_t latency = another_timespecDiffNanoseconds(end, start);
-                                int64_t delete_latency = another_timespecDiffNanoseconds(end, delete_start);
-                                persistTarget->add_latency_data(latency, delete_latency);
-
-                                 VOLT_DEBUG("hawk: latency: %ld with delete latency: %ld ...", latency, delete_latency);
-*/
-                                //ended by hawk
-				WindowTable* windowTarget = dynamic_cast<WindowTable*>(persistTarget);
-				if(windowTarget != NULL)
-				{
-					windowTarget->setFireTriggers(false);
-				}
-
-				//TODO: more hacks for a new windowTable version....
-				WindowTableTemp* windowTargetTemp = dynamic_cast<WindowTableTemp*>(persistTarget);
-				if(windowTargetTemp != NULL)
-				{
-					windowTargetTemp->setFireTriggers(false);
-				}
-			}
-
+			// Fires now, or once at the end of the batch when the engine coalesces
+			// triggers; streams are emptied after their triggers have run
+			if(persistTarget != NULL)
+				m_engine->fireTableTriggers(persistTarget);
 		}
 
 
 		// add to the planfragments count of modified tuples
 		m_engine->m_tuplesModified += modifiedTuples;
 		VOLT_DEBUG("Finished inserting %d tuples", modifiedTuples);
-		return true;
 	}
 
 }
@@ -95,11 +95,27 @@ class InsertExecutor : public OperationExecutor {
             m_engine = engine;
             m_partitionColumn = -1;
             m_multiPartition = false;
+            m_pushedTuples = 0;
+            m_pushedModified = 0;
+        }
+
+        // INSERT ... VALUES with several rows reads more than one input
+        bool acceptsPushedTuples() const {
+            return abstract_node->getChildren().size() == 1;
         }
     protected:
         bool p_init(AbstractPlanNode*, const catalog::Database* catalog_db, int* tempTableMemoryInBytes);
         bool p_execute(const NValueArray &params, ReadWriteTracker *tracker);
 
+        bool p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker);
+        bool p_pushTuple(TableTuple &tuple);
+        bool p_pushEnd();
+
+        /** Inserts one input tuple, counting it if it was inserted here */
+        bool insertTuple(TableTuple &tuple, int &modifiedTuples);
+        /** Fires the target table's triggers and adds up the modified count */
+        void finish(bool beProcessed, int modifiedTuples);
+
         virtual bool needsOutputTableClear() { return true; };
 
         InsertPlanNode* m_node;
@@ -112,6 +128,10 @@ class InsertExecutor : public OperationExecutor {
         bool m_partitionColumnIsString;
         bool m_multiPartition;
 
+        // input tuples and inserts of the current pipelined run
+        int m_pushedTuples;
+        int m_pushedModified;
+
         /** reference to the engine/context to store the number of modified tuples */
         VoltDBEngine* m_engine;
 		
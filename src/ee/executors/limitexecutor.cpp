@@ -126,3 +126,35 @@ LimitExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tracker)
 
     return true;
 }
+
+bool
+LimitExecutor::p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker)
+{
+    LimitPlanNode* node = dynamic_cast<LimitPlanNode*>(abstract_node);
+    assert(node);
+    m_limit = 0;
+    m_offset = 0;
+    node->getLimitAndOffsetByReference(params, m_limit, m_offset);
+    m_seen = 0;
+    m_kept = 0;
+    return true;
+}
+
+bool
+LimitExecutor::p_pushTuple(TableTuple &tuple)
+{
+    // same rows as p_execute(): skip the first offset, keep the next limit
+    if (m_seen++ < m_offset || m_kept >= m_limit)
+    {
+        return true;
+    }
+    Table* output_table = abstract_node->getOutputTable();
+    if (!output_table->insertTuple(tuple))
+    {
+        VOLT_ERROR("Failed to insert pushed tuple into output table '%s'",
+                   output_table->name().c_str());
+        return false;
+    }
+    m_kept++;
+    return true;
+}
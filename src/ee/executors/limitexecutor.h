@@ -69,9 +69,22 @@ namespace voltdb
         ~LimitExecutor() {
         }
 
+        bool acceptsPushedTuples() const { return true; }
+
     protected:
         bool p_init(AbstractPlanNode*, const catalog::Database* catalog_db, int* tempTableMemoryInBytes);
         bool p_execute(const NValueArray &params, ReadWriteTracker *tracker);
+
+        bool p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker);
+        bool p_pushTuple(TableTuple &tuple);
+
+    private:
+        // limit and offset of the current pipelined run, and the number
+        // of tuples seen and kept so far
+        int m_limit;
+        int m_offset;
+        int m_seen;
+        int m_kept;
     };
 
 }
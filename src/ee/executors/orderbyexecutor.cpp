@@ -44,6 +44,7 @@
  */
 
 #include <algorithm>
+#include <climits>
 #include <vector>
 #include "orderbyexecutor.h"
 #include "common/debuglog.h"
@@ -117,6 +118,28 @@ OrderByExecutor::p_init(AbstractPlanNode* abstract_node,
         dynamic_cast<LimitPlanNode*>(node->
                                      getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
 
+    //
+    // Otherwise look for a LIMIT sitting on top of us. The planner puts it
+    // above the projection of the sorted rows, but a projection emits
+    // exactly one row per input row, so the limit still bounds how many of
+    // our rows will ever be looked at.
+    //
+    parent_limit_node = NULL;
+    AbstractPlanNode *parent = node;
+    while (limit_node == NULL && parent->getParents().size() == 1)
+    {
+        parent = parent->getParents()[0];
+        if (parent->getChildren().size() != 1)
+            break;
+        if (parent->getPlanNodeType() == PLAN_NODE_TYPE_LIMIT)
+        {
+            parent_limit_node = dynamic_cast<LimitPlanNode*>(parent);
+            break;
+        }
+        if (parent->getPlanNodeType() != PLAN_NODE_TYPE_PROJECTION)
+            break;
+    }
+
     return true;
 }
 
@@ -178,35 +201,76 @@ OrderByExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tracker)
     // How nice! We can also cut off our scanning with a nested limit!
     //
     int limit = -1;
-    int offset = -1;
+    int offset = 0;
     if (limit_node != NULL)
     {
         limit_node->getLimitAndOffsetByReference(params, limit, offset);
-        if (offset > 0)
-        {
-            VOLT_ERROR("Nested Limit Offset is not yet supported for PlanNode"
-                       " '%s'", node->debug().c_str());
-            return false;
-        }
+    }
+    else if (parent_limit_node != NULL)
+    {
+        // the parent still applies its own offset, so hand it all the rows
+        // up to the end of its limit
+        parent_limit_node->getLimitAndOffsetByReference(params, limit, offset);
+        if (limit >= 0)
+            limit = (offset > INT_MAX - limit) ? -1 : limit + offset;
+        offset = 0;
     }
 
     VOLT_TRACE("Running OrderBy '%s'", abstract_node->debug().c_str());
     VOLT_TRACE("Input Table:\n '%s'", input_table->debug().c_str());
+    TupleComparer comparer(node->getSortColumns(), node->getSortDirections());
     TableIterator iterator(input_table);
     TableTuple tuple(input_table->schema());
     vector<TableTuple> xs;
-    while (iterator.next(tuple))
+    if (limit >= 0)
+    {
+        //
+        // OPTIMIZATION: TOP-N
+        // Only the first limit + offset rows can make it out, so keep them
+        // in a bounded max-heap whose front is the worst row kept so far.
+        // Every other input row is either dropped or replaces the front,
+        // which is O(N log K) instead of sorting the whole input.
+        //
+        size_t bound = static_cast<size_t>(limit) + static_cast<size_t>(offset);
+        if (bound > 0)
+        {
+            xs.reserve(min(bound, static_cast<size_t>(input_table->activeTupleCount())));
+        }
+        while (bound > 0 && iterator.next(tuple))
+        {
+            assert(tuple.isActive());
+            if (xs.size() < bound)
+            {
+                xs.push_back(tuple);
+                push_heap(xs.begin(), xs.end(), comparer);
+            }
+            else if (comparer(tuple, xs.front()))
+            {
+                pop_heap(xs.begin(), xs.end(), comparer);
+                xs.back() = tuple;
+                push_heap(xs.begin(), xs.end(), comparer);
+            }
+        }
+        sort_heap(xs.begin(), xs.end(), comparer);
+    }
+    else
     {
-        assert(tuple.isActive());
-        xs.push_back(tuple);
+        while (iterator.next(tuple))
+        {
+            assert(tuple.isActive());
+            xs.push_back(tuple);
+        }
+        VOLT_TRACE("\n***** Input Table PreSort:\n '%s'",
+                   input_table->debug().c_str());
+        sort(xs.begin(), xs.end(), comparer);
     }
-    VOLT_TRACE("\n***** Input Table PreSort:\n '%s'",
-               input_table->debug().c_str());
-    sort(xs.begin(), xs.end(), TupleComparer(node->getSortColumns(),
-                                             node->getSortDirections()));
 
-    int tuple_ctr = 0;
-    for (vector<TableTuple>::iterator it = xs.begin(); it != xs.end(); it++)
+    vector<TableTuple>::iterator it = xs.begin();
+    if (offset > 0)
+    {
+        it += min(static_cast<size_t>(offset), xs.size());
+    }
+    for (; it != xs.end(); it++)
     {
         VOLT_TRACE("\n***** Input Table PostSort:\n '%s'",
                    input_table->debug().c_str());
@@ -218,12 +282,6 @@ OrderByExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tracker)
                        output_table->name().c_str());
             return false;
         }
-        //
-        // Check whether we have gone past our limit
-        //
-        if (limit >= 0 && ++tuple_ctr >= limit) {
-            break;
-        }
     }
     VOLT_TRACE("Result of OrderBy:\n '%s'", output_table->debug().c_str());
 
@@ -62,7 +62,8 @@ namespace voltdb {
     class OrderByExecutor : public AbstractExecutor {
     public:
         OrderByExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
-            : AbstractExecutor(engine, abstract_node), limit_node(NULL)
+            : AbstractExecutor(engine, abstract_node), limit_node(NULL),
+              parent_limit_node(NULL)
             { }
         ~OrderByExecutor();
 
@@ -73,6 +74,8 @@ namespace voltdb {
 
     private:
         LimitPlanNode *limit_node;
+        /** LIMIT applied to our output further up the plan, if any */
+        LimitPlanNode *parent_limit_node;
     };
 
 }
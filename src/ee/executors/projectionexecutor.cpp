@@ -156,20 +156,8 @@ bool ProjectionExecutor::p_execute(const NValueArray &params, ReadWriteTracker *
 
     VOLT_TRACE("INPUT TABLE: %s\n", input_table->debug().c_str());
 
-    //
-    // Since we have the input params, we need to call substitute to change any
-    // nodes in our expression tree to be ready for the projection operations in
-    // execute
-    //
-    assert (num_of_columns == (int)node->getOutputColumnNames().size());
-    if (all_tuple_array == NULL && all_param_array == NULL) {
-        for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
-            assert(expression_array[ctr]);
-            expression_array[ctr]->substitute(params);
-            VOLT_TRACE("predicate[%d]: %s", ctr,
-                       expression_array[ctr]->debug(true).c_str());
-        }
-    }
+    if (!p_pushBegin(params, tracker))
+        return false;
 
     //
     // Now loop through all the tuples and push them through our output
@@ -179,46 +167,8 @@ bool ProjectionExecutor::p_execute(const NValueArray &params, ReadWriteTracker *
     TableIterator iterator(input_table);
     assert (tuple.sizeInValues() == input_table->columnCount());
     while (iterator.next(tuple)) {
-        //
-        // Project (or replace) values from input tuple
-        //
-        TableTuple &temp_tuple = output_table->tempTuple();
-        if (all_tuple_array != NULL) {
-            VOLT_TRACE("sweet, all tuples");
-            for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
-                try {
-                    temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
-                } catch (SerializableEEException &e) {
-                    VOLT_ERROR("[Type0] Failed to project column #%02d: %s", ctr, e.message().c_str());
-                    throw e;
-                }
-            } // FOR
-        } else if (all_param_array != NULL) {
-            VOLT_TRACE("sweet, all params");
-            for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
-                try {
-                    temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
-                } catch (SerializableEEException &e) {
-                    VOLT_ERROR("[Type1] Failed to project column #%02d: %s", ctr, e.message().c_str());
-                    throw e;
-                }   
-            } // FOR
-        } else {
-            for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
-                try {
-                    temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
-                } catch (SerializableEEException &e) {
-                    VOLT_ERROR("[Type2] Failed to project column #%02d: %s", ctr, e.message().c_str());
-                    throw e;
-                }
-            } // FOR
-        }
-        output_table->insertTupleNonVirtual(temp_tuple);
-        /*if (!output_table->insertTupleNonVirtual(temp_tuple)) {
-            // TODO: DEBUG
-            VOLT_ERROR("Failed to insert projection tuple from input table '%s' into output table '%s'", input_table->name().c_str(), output_table->name().c_str());
-            return (false);
-        }*/
+        if (!p_pushTuple(tuple))
+            return false;
     }
 
     //VOLT_TRACE("PROJECTED TABLE: %s\n", output_table->debug().c_str());
@@ -230,6 +180,71 @@ bool ProjectionExecutor::p_execute(const NValueArray &params, ReadWriteTracker *
     return (true);
 }
 
+bool ProjectionExecutor::p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker) {
+    //
+    // Since we have the input params, we need to call substitute to change any
+    // nodes in our expression tree to be ready for the projection operations in
+    // execute
+    //
+    assert (num_of_columns == (int)dynamic_cast<ProjectionPlanNode*>(abstract_node)->getOutputColumnNames().size());
+    if (all_tuple_array == NULL && all_param_array == NULL) {
+        for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
+            assert(expression_array[ctr]);
+            expression_array[ctr]->substitute(params);
+            VOLT_TRACE("predicate[%d]: %s", ctr,
+                       expression_array[ctr]->debug(true).c_str());
+        }
+    }
+    m_params = &params;
+    return true;
+}
+
+bool ProjectionExecutor::p_pushTuple(TableTuple &tuple) {
+    //
+    // Project (or replace) values from input tuple
+    //
+    TableTuple &temp_tuple = output_table->tempTuple();
+    if (all_tuple_array != NULL) {
+        VOLT_TRACE("sweet, all tuples");
+        for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
+            try {
+                temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
+            } catch (SerializableEEException &e) {
+                VOLT_ERROR("[Type0] Failed to project column #%02d: %s", ctr, e.message().c_str());
+                throw e;
+            }
+        } // FOR
+    } else if (all_param_array != NULL) {
+        VOLT_TRACE("sweet, all params");
+        for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
+            try {
+                temp_tuple.setNValue(ctr, (*m_params)[all_param_array[ctr]]);
+            } catch (SerializableEEException &e) {
+                VOLT_ERROR("[Type1] Failed to project column #%02d: %s", ctr, e.message().c_str());
+                throw e;
+            }
+        } // FOR
+    } else {
+        for (int ctr = num_of_columns - 1; ctr >= 0; --ctr) {
+            try {
+                temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
+            } catch (SerializableEEException &e) {
+                VOLT_ERROR("[Type2] Failed to project column #%02d: %s", ctr, e.message().c_str());
+                throw e;
+            }
+        } // FOR
+    }
+    if (m_pipelineParent != NULL)
+        return m_pipelineParent->pushTuple(temp_tuple);
+    output_table->insertTupleNonVirtual(temp_tuple);
+    /*if (!output_table->insertTupleNonVirtual(temp_tuple)) {
+        // TODO: DEBUG
+        VOLT_ERROR("Failed to insert projection tuple from input table '%s' into output table '%s'", input_table->name().c_str(), output_table->name().c_str());
+        return (false);
+    }*/
+    return true;
+}
+
 ProjectionExecutor::~ProjectionExecutor() {
 }
 
@@ -66,12 +66,19 @@ class ProjectionExecutor : public AbstractExecutor {
     public:
         ProjectionExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) : AbstractExecutor(engine, abstract_node) {
             output_table = NULL;
+            m_params = NULL;
         }
         ~ProjectionExecutor();
+
+        bool canPushOutput() const { return true; }
+        bool acceptsPushedTuples() const { return true; }
     protected:
         bool p_init(AbstractPlanNode*, const catalog::Database* catalog_db, int* tempTableMemoryInBytes);
         bool p_execute(const NValueArray &params, ReadWriteTracker *tracker);
 
+        bool p_pushBegin(const NValueArray &params, ReadWriteTracker *tracker);
+        bool p_pushTuple(TableTuple &tuple);
+
     private:
         TempTable* output_table;
         Table* input_table;
@@ -83,6 +90,8 @@ class ProjectionExecutor : public AbstractExecutor {
         boost::shared_array<bool> needs_substitute_ptr;
         bool *needs_substitute;
         TableTuple tuple;
+        // parameters of the current run, for all_param_array
+        const NValueArray *m_params;
 
         boost::shared_array<AbstractExpression*> expression_array_ptr;
         AbstractExpression** expression_array;
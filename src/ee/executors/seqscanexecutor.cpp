@@ -50,6 +50,7 @@
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
 #include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "plannodes/seqscannode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/limitnode.h"
@@ -85,6 +86,23 @@ bool SeqScanExecutor::p_init(AbstractPlanNode *abstract_node,
         //
         assert(projection_node->getOutputTable());
         node->setOutputTable(projection_node->getOutputTable());
+
+        //
+        // A projection that only picks columns of the input tuple can
+        // copy them directly instead of evaluating each expression
+        //
+        m_projectionColumns.clear();
+        const std::vector<AbstractExpression*> &expressions =
+            projection_node->getOutputColumnExpressions();
+        for (int ctr = 0; ctr < (int)expressions.size(); ctr++) {
+            TupleValueExpression *column =
+                dynamic_cast<TupleValueExpression*>(expressions[ctr]);
+            if (column == NULL || column->getTupleIndex() != 0) {
+                m_projectionColumns.clear();
+                break;
+            }
+            m_projectionColumns.push_back(column->getColumnId());
+        }
     //
     // FULL TABLE SCHEMA
     //
@@ -113,6 +131,17 @@ bool SeqScanExecutor::p_init(AbstractPlanNode *abstract_node,
                     tempTableMemoryInBytes));
         }
     }
+
+    //
+    // OPTIMIZATION: COMPILED PREDICATE
+    //
+    // Simple predicates over fixed-width columns are evaluated a batch
+    // of tuples at a time with typed comparisons. Anything else keeps
+    // using eval() for every tuple.
+    //
+    m_compiledPredicate.reset(
+        CompiledPredicate::compile(node->getPredicate(),
+                                   node->getTargetTable()->schema()));
     return true;
 }
 
@@ -203,62 +232,80 @@ bool SeqScanExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tra
         }
 
         int tuple_ctr = 0;
-        while (iterator.next(tuple))
+        if (m_compiledPredicate.get() != NULL && m_compiledPredicate->bind())
         {
-            // Read/Write Set Tracking
-            if (tracker != NULL) {
-                tracker->markTupleRead(target_table->name(), &tuple);
-            }
-            
-            target_table->updateTupleAccessCount();
-            VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
-                       tuple.debug(target_table->name()).c_str(), tuple_ctr,
-                       (int)target_table->activeTupleCount());
             //
-            // For each tuple we need to evaluate it against our predicate
+            // Gather a batch of tuples, select the ones that satisfy the
+            // predicate, then walk the batch in order so that the read set
+            // and the limit behave exactly as in the loop below
             //
-            if (predicate == NULL || predicate->eval(&tuple, NULL).isTrue())
+            char *batch[CompiledPredicate::BATCH_SIZE];
+            uint16_t selection[CompiledPredicate::BATCH_SIZE];
+            bool done = false;
+            while (!done)
             {
-                //
-                // Nested Projection
-                // Project (or replace) values from input tuple
-                //
-                if (projection_node != NULL)
+                int batch_size =
+                    iterator.nextBatch(batch, CompiledPredicate::BATCH_SIZE);
+                if (batch_size == 0) {
+                    break;
+                }
+                int selected =
+                    m_compiledPredicate->evaluate(batch, batch_size, selection);
+                int next_selected = 0;
+                for (int ctr = 0; ctr < batch_size; ctr++)
                 {
-                    TableTuple &temp_tuple = output_table->tempTuple();
-                    for (int ctr = 0; ctr < num_of_columns; ctr++)
-                    {
-                        NValue value =
-                            projection_node->
-                          getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
-                        temp_tuple.setNValue(ctr, value);
+                    tuple.move(batch[ctr]);
+                    // Read/Write Set Tracking
+                    if (tracker != NULL) {
+                        tracker->markTupleRead(target_table, &tuple);
                     }
-                    if (!output_table->insertTuple(temp_tuple))
+                    target_table->updateTupleAccessCount();
+
+                    if (next_selected < selected &&
+                        selection[next_selected] == ctr)
                     {
-                        VOLT_ERROR("Failed to insert tuple from table '%s' into"
-                                   " output table '%s'",
-                                   target_table->name().c_str(),
-                                   output_table->name().c_str());
-                        return false;
+                        ++next_selected;
+                        if (!insertOutputTuple(tuple, target_table,
+                                               output_table, projection_node)) {
+                            return false;
+                        }
+                        ++tuple_ctr;
+                        // Check whether we have gone past our limit
+                        if (limit >= 0 && tuple_ctr >= limit) {
+                            done = true;
+                            break;
+                        }
                     }
                 }
-                else
+            }
+        }
+        else
+        {
+            while (iterator.next(tuple))
+            {
+                // Read/Write Set Tracking
+                if (tracker != NULL) {
+                    tracker->markTupleRead(target_table, &tuple);
+                }
+
+                target_table->updateTupleAccessCount();
+                VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
+                           tuple.debug(target_table->name()).c_str(), tuple_ctr,
+                           (int)target_table->activeTupleCount());
+                //
+                // For each tuple we need to evaluate it against our predicate
+                //
+                if (predicate == NULL || predicate->eval(&tuple, NULL).isTrue())
                 {
-                    //
-                    // Insert the tuple into our output table
-                    //
-                    if (!output_table->insertTuple(tuple)) {
-                        VOLT_ERROR("Failed to insert tuple from table '%s' into"
-                                   " output table '%s'",
-                                   target_table->name().c_str(),
-                                   output_table->name().c_str());
+                    if (!insertOutputTuple(tuple, target_table,
+                                           output_table, projection_node)) {
                         return false;
                     }
-                }
-                ++tuple_ctr;
-                // Check whether we have gone past our limit
-                if (limit >= 0 && tuple_ctr >= limit) {
-                    break;
+                    ++tuple_ctr;
+                    // Check whether we have gone past our limit
+                    if (limit >= 0 && tuple_ctr >= limit) {
+                        break;
+                    }
                 }
             }
         }
@@ -268,3 +315,57 @@ bool SeqScanExecutor::p_execute(const NValueArray &params, ReadWriteTracker *tra
 
     return true;
 }
+
+bool SeqScanExecutor::insertOutputTuple(TableTuple &tuple, Table *target_table,
+                                        Table *output_table,
+                                        ProjectionPlanNode *projection_node) {
+    //
+    // Nested Projection
+    // Project (or replace) values from input tuple
+    //
+    if (projection_node != NULL)
+    {
+        TableTuple &temp_tuple = output_table->tempTuple();
+        int num_of_columns = (int)output_table->columnCount();
+        if (!m_projectionColumns.empty())
+        {
+            for (int ctr = 0; ctr < num_of_columns; ctr++)
+            {
+                temp_tuple.setNValue(ctr,
+                                     tuple.getNValue(m_projectionColumns[ctr]));
+            }
+        }
+        else
+        {
+            for (int ctr = 0; ctr < num_of_columns; ctr++)
+            {
+                NValue value =
+                    projection_node->
+                  getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
+                temp_tuple.setNValue(ctr, value);
+            }
+        }
+        if (!emitTuple(output_table, temp_tuple))
+        {
+            VOLT_ERROR("Failed to insert tuple from table '%s' into"
+                       " output table '%s'",
+                       target_table->name().c_str(),
+                       output_table->name().c_str());
+            return false;
+        }
+    }
+    else
+    {
+        //
+        // Insert the tuple into our output table, or push it to our parent
+        //
+        if (!emitTuple(output_table, tuple)) {
+            VOLT_ERROR("Failed to insert tuple from table '%s' into"
+                       " output table '%s'",
+                       target_table->name().c_str(),
+                       output_table->name().c_str());
+            return false;
+        }
+    }
+    return true;
+}
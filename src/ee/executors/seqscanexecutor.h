@@ -49,22 +49,45 @@
 #include "common/common.h"
 #include "common/valuevector.h"
 #include "executors/abstractexecutor.h"
+#include "executors/compiledpredicate.h"
+#include "plannodes/seqscannode.h"
+
+#include <vector>
+#include "boost/scoped_ptr.hpp"
 
 namespace voltdb
 {
     class UndoLog;
     class ReadWriteSet;
+    class ProjectionPlanNode;
+    class TableTuple;
 
     class SeqScanExecutor : public AbstractExecutor {
     public:
         SeqScanExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
             : AbstractExecutor(engine, abstract_node)
         {}
+
+        // only a scan that copies into its own temp table has output to push
+        bool canPushOutput() const {
+            return static_cast<SeqScanPlanNode*>(abstract_node)->needsOutputTableClear();
+        }
     protected:
         bool p_init(AbstractPlanNode* abstract_node,
                     const catalog::Database* catalog_db, int* tempTableMemoryInBytes);
         bool p_execute(const NValueArray& params, ReadWriteTracker *tracker);
         bool needsOutputTableClear();
+
+    private:
+        bool insertOutputTuple(TableTuple &tuple, Table *target_table,
+                               Table *output_table,
+                               ProjectionPlanNode *projection_node);
+
+        // predicate specialized for batch evaluation, if it has a simple shape
+        boost::scoped_ptr<CompiledPredicate> m_compiledPredicate;
+        // input column of each output column, when the inline projection
+        // only picks columns; empty otherwise
+        std::vector<int> m_projectionColumns;
     };
 }
 
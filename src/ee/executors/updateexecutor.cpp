@@ -198,7 +198,7 @@ bool UpdateExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
         
         // Read/Write Set Tracking
         if (tracker != NULL) {
-            tracker->markTupleWritten(m_targetTable->name(), &m_targetTuple);
+            tracker->markTupleWritten(m_targetTable, &m_targetTuple);
         }
 
         // Loop through INPUT_COL_IDX->TARGET_COL_IDX mapping and only update
@@ -284,7 +284,7 @@ bool UpdateExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
 				// Next, let the input tuple be the diff after image
 				afterImage = &m_inputTuple;
 
-				LogRecord *logrecord = new LogRecord(computeTimeStamp(),
+				LogRecord logrecord(computeTimeStamp(),
 						LogRecord::T_UPDATE,// this is an update record
 						LogRecord::T_FORWARD,// the system is running normally
 						-1,// XXX: prevLSN must be fetched from table!
@@ -298,26 +298,9 @@ bool UpdateExecutor::p_execute(const NValueArray &params, ReadWriteTracker *trac
 						afterImage
 				);
 
-				size_t logrecordLength = logrecord->getEstimatedLength();
-				char *logrecordBuffer = new char[logrecordLength];
-
-				FallbackSerializeOutput output;
-				output.initializeWithPosition(logrecordBuffer, logrecordLength, 0);
-
-				logrecord->serializeTo(output);
-
-				LogManager* m_logManager = this->m_engine->getLogManager();
-				Logger m_ariesLogger = m_logManager->getAriesLogger();
-				//VOLT_WARN("m_logManager : %p AriesLogger : %p",&m_logManager, &m_ariesLogger);
-				const Logger *logger = m_logManager->getThreadLogger(LOGGERID_MM_ARIES);
-
-				logger->log(LOGLEVEL_INFO, output.data(), output.position());
-
-				delete[] logrecordBuffer;
-				logrecordBuffer = NULL;
-
-				delete logrecord;
-				logrecord = NULL;
+				// serialized straight into the transaction's log buffer
+				const Logger *logger = m_engine->getLogManager()->getThreadLogger(LOGGERID_MM_ARIES);
+				logger->log(LOGLEVEL_INFO, logrecord);
 
 				if (keydata != NULL) {
 					delete[] keydata;
@@ -311,8 +311,8 @@ namespace voltdb {
 
 					// Read/Write Set Tracking
 					if (tracker != NULL) {
-						//tracker->markTupleWritten(m_targetTable->name(), &m_targetTuple);
-						tracker->markTupleWritten(m_targetTable->name(), &tuple);
+						//tracker->markTupleWritten(m_targetTable, &m_targetTuple);
+						tracker->markTupleWritten(m_targetTable, &tuple);
 					}
                                         
                                         TableTuple &tempTuple = ((PersistentTable*)m_targetTable)->getTempTupleInlined(tuple);
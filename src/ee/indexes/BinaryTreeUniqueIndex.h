@@ -48,7 +48,10 @@
 
 //#include <map>
 #include "stx/btree_map.h"
+#include <algorithm>
 #include <iostream>
+#include <utility>
+#include <vector>
 #include "common/debuglog.h"
 #include "common/tabletuple.h"
 #include "indexes/tableindex.h"
@@ -66,6 +69,15 @@ class BinaryTreeUniqueIndex : public TableIndex
 
     //typedef std::map<KeyType, const void*, KeyComparator> MapType;
     typedef stx::btree_map<KeyType, const void*, KeyComparator> MapType;
+    typedef std::pair<KeyType, const void*> Entry;
+
+    struct EntryComparator {
+        EntryComparator(const KeyComparator &comparator) : m_comparator(comparator) {}
+        bool operator()(const Entry &lhs, const Entry &rhs) const {
+            return m_comparator(lhs.first, rhs.first);
+        }
+        KeyComparator m_comparator;
+    };
 
 public:
 
@@ -77,6 +89,36 @@ public:
         return addEntryPrivate(tuple, m_tmp1);
     }
 
+    /**
+     * The keys are sorted first, so duplicates are found before anything
+     * is added and the tree is filled from left to right.
+     */
+    bool addEntries(const std::vector<char*> &tuples)
+    {
+        std::vector<Entry> entries;
+        entries.reserve(tuples.size());
+        TableTuple tuple(m_tupleSchema);
+        for (std::vector<char*>::const_iterator i = tuples.begin(); i != tuples.end(); ++i) {
+            tuple.move(*i);
+            m_tmp1.setFromTuple(&tuple, column_indices_, m_keySchema);
+            entries.push_back(Entry(m_tmp1, *i));
+        }
+        std::sort(entries.begin(), entries.end(), EntryComparator(KeyComparator(m_keySchema)));
+
+        const bool empty = m_entries.empty();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if ((i > 0 && m_eq(entries[i - 1].first, entries[i].first)) ||
+                (!empty && m_entries.find(entries[i].first) != m_entries.end())) {
+                return false;
+            }
+        }
+        for (typename std::vector<Entry>::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+            m_entries.insert(*i);
+        }
+        m_inserts += static_cast<int>(entries.size());
+        return true;
+    }
+
     bool deleteEntry(const TableTuple* tuple)
     {
         m_tmp1.setFromTuple(tuple, column_indices_, m_keySchema);
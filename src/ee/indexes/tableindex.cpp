@@ -75,6 +75,23 @@ TableIndex::~TableIndex()
     voltdb::TupleSchema::freeTupleSchema(m_keySchema);
 }
 
+bool TableIndex::addEntries(const std::vector<char*> &tuples)
+{
+    TableTuple tuple(m_tupleSchema);
+    for (size_t i = 0; i < tuples.size(); ++i) {
+        tuple.move(tuples[i]);
+        if (!addEntry(&tuple)) {
+            // take back what this batch has added so far
+            while (i-- > 0) {
+                tuple.move(tuples[i]);
+                deleteEntry(&tuple);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 IndexStats* TableIndex::getIndexStats() {
     return &m_stats;
 }
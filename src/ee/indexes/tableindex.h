@@ -131,6 +131,13 @@ public:
      */
     virtual bool addEntry(const TableTuple *tuple) = 0;
 
+    /**
+     * adds the entries for a batch of tuples at once, as at the end of a
+     * bulk load. Either all of them are added or, if a unique index would
+     * get a duplicate key, none of them.
+     */
+    virtual bool addEntries(const std::vector<char*> &tuples);
+
     /**
      * removes the index entry linked to given value (and tuple
      * pointer, if it's non-unique index).
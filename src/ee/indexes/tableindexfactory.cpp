@@ -143,13 +143,69 @@ namespace voltdb {
             }
         }
         
-        if (/*(type == BALANCED_TREE_INDEX) &&*/ (unique)) {
-            if (type == HASH_TABLE_INDEX) {
-                VOLT_INFO("Producing a tree index for %s: "
-                          "hash index not currently supported for this index key.\n",
-                          scheme.name.c_str());
+        // mixed-type and string keys are copied into a GenericKey. Strings too long to
+        // inline only take a pointer's width in the key, so they hash off the tuple's StringRef
+        if ((type == HASH_TABLE_INDEX) && (unique)) {
+            if (keySize <= 4) {
+                return new HashTableUniqueIndex<GenericKey<4>, GenericHasher<4>, GenericEqualityChecker<4> >(schemeCopy);
+            } else if (keySize <= 8) {
+                return new HashTableUniqueIndex<GenericKey<8>, GenericHasher<8>, GenericEqualityChecker<8> >(schemeCopy);
+            } else if (keySize <= 12) {
+                return new HashTableUniqueIndex<GenericKey<12>, GenericHasher<12>, GenericEqualityChecker<12> >(schemeCopy);
+            } else if (keySize <= 16) {
+                return new HashTableUniqueIndex<GenericKey<16>, GenericHasher<16>, GenericEqualityChecker<16> >(schemeCopy);
+            } else if (keySize <= 24) {
+                return new HashTableUniqueIndex<GenericKey<24>, GenericHasher<24>, GenericEqualityChecker<24> >(schemeCopy);
+            } else if (keySize <= 32) {
+                return new HashTableUniqueIndex<GenericKey<32>, GenericHasher<32>, GenericEqualityChecker<32> >(schemeCopy);
+            } else if (keySize <= 48) {
+                return new HashTableUniqueIndex<GenericKey<48>, GenericHasher<48>, GenericEqualityChecker<48> >(schemeCopy);
+            } else if (keySize <= 64) {
+                return new HashTableUniqueIndex<GenericKey<64>, GenericHasher<64>, GenericEqualityChecker<64> >(schemeCopy);
+            } else if (keySize <= 96) {
+                return new HashTableUniqueIndex<GenericKey<96>, GenericHasher<96>, GenericEqualityChecker<96> >(schemeCopy);
+            } else if (keySize <= 128) {
+                return new HashTableUniqueIndex<GenericKey<128>, GenericHasher<128>, GenericEqualityChecker<128> >(schemeCopy);
+            } else if (keySize <= 256) {
+                return new HashTableUniqueIndex<GenericKey<256>, GenericHasher<256>, GenericEqualityChecker<256> >(schemeCopy);
+            } else if (keySize <= 512) {
+                return new HashTableUniqueIndex<GenericKey<512>, GenericHasher<512>, GenericEqualityChecker<512> >(schemeCopy);
+            } else {
+                throwFatalException( "We currently only support hash index on unique keys of up to 512 bytes..." );
             }
-            
+        }
+        
+        if ((type == HASH_TABLE_INDEX) && (!unique)) {
+            if (keySize <= 4) {
+                return new HashTableMultiMapIndex<GenericKey<4>, GenericHasher<4>, GenericEqualityChecker<4> >(schemeCopy);
+            } else if (keySize <= 8) {
+                return new HashTableMultiMapIndex<GenericKey<8>, GenericHasher<8>, GenericEqualityChecker<8> >(schemeCopy);
+            } else if (keySize <= 12) {
+                return new HashTableMultiMapIndex<GenericKey<12>, GenericHasher<12>, GenericEqualityChecker<12> >(schemeCopy);
+            } else if (keySize <= 16) {
+                return new HashTableMultiMapIndex<GenericKey<16>, GenericHasher<16>, GenericEqualityChecker<16> >(schemeCopy);
+            } else if (keySize <= 24) {
+                return new HashTableMultiMapIndex<GenericKey<24>, GenericHasher<24>, GenericEqualityChecker<24> >(schemeCopy);
+            } else if (keySize <= 32) {
+                return new HashTableMultiMapIndex<GenericKey<32>, GenericHasher<32>, GenericEqualityChecker<32> >(schemeCopy);
+            } else if (keySize <= 48) {
+                return new HashTableMultiMapIndex<GenericKey<48>, GenericHasher<48>, GenericEqualityChecker<48> >(schemeCopy);
+            } else if (keySize <= 64) {
+                return new HashTableMultiMapIndex<GenericKey<64>, GenericHasher<64>, GenericEqualityChecker<64> >(schemeCopy);
+            } else if (keySize <= 96) {
+                return new HashTableMultiMapIndex<GenericKey<96>, GenericHasher<96>, GenericEqualityChecker<96> >(schemeCopy);
+            } else if (keySize <= 128) {
+                return new HashTableMultiMapIndex<GenericKey<128>, GenericHasher<128>, GenericEqualityChecker<128> >(schemeCopy);
+            } else if (keySize <= 256) {
+                return new HashTableMultiMapIndex<GenericKey<256>, GenericHasher<256>, GenericEqualityChecker<256> >(schemeCopy);
+            } else if (keySize <= 512) {
+                return new HashTableMultiMapIndex<GenericKey<512>, GenericHasher<512>, GenericEqualityChecker<512> >(schemeCopy);
+            } else {
+                throwFatalException( "We currently only support hash index on non-unique keys of up to 512 bytes..." );
+            }
+        }
+        
+        if (/*(type == BALANCED_TREE_INDEX) &&*/ (unique)) {
             if (keySize <= 4) {
                 return new BinaryTreeUniqueIndex<GenericKey<4>, GenericComparator<4>, GenericEqualityChecker<4> >(schemeCopy);
             } else if (keySize <= 8) {
@@ -182,12 +238,6 @@ namespace voltdb {
         }
         
         if (/*(type == BALANCED_TREE_INDEX) &&*/ (!unique)) {
-            if (type == HASH_TABLE_INDEX) {
-                VOLT_INFO("Producing a tree index for %s: "
-                          "hash index not currently supported for this index key.\n",
-                          scheme.name.c_str());
-            }
-            
             if (keySize <= 4) {
                 return new BinaryTreeMultiMapIndex<GenericKey<4>, GenericComparator<4>, GenericEqualityChecker<4> >(schemeCopy);
             } else if (keySize <= 8) {
@@ -219,30 +269,6 @@ namespace voltdb {
             }
         }
         
-        /*if ((type == HASH_TABLE_INDEX) && (unique)) {
-         switch (colCount) {
-         case 1: return new HashTableUniqueIndex<GenericKey<1>, GenericHasher<1>, GenericEqualityChecker<1> >(schemeCopy);
-         case 2: return new HashTableUniqueIndex<GenericKey<2>, GenericHasher<2>, GenericEqualityChecker<2> >(schemeCopy);
-         case 3: return new HashTableUniqueIndex<GenericKey<3>, GenericHasher<3>, GenericEqualityChecker<3> >(schemeCopy);
-         case 4: return new HashTableUniqueIndex<GenericKey<4>, GenericHasher<4>, GenericEqualityChecker<4> >(schemeCopy);
-         case 5: return new HashTableUniqueIndex<GenericKey<5>, GenericHasher<5>, GenericEqualityChecker<5> >(schemeCopy);
-         case 6: return new HashTableUniqueIndex<GenericKey<6>, GenericHasher<6>, GenericEqualityChecker<6> >(schemeCopy);
-         default: throwFatalException( "We currently only support up to 6 column generic hash indexes..." );
-         }
-         }
-         
-         if ((type == HASH_TABLE_INDEX) && (!unique)) {
-         switch (colCount) {
-         case 1: return new HashTableMultiMapIndex<GenericKey<1>, GenericHasher<1>, GenericEqualityChecker<1> >(schemeCopy);
-         case 2: return new HashTableMultiMapIndex<GenericKey<2>, GenericHasher<2>, GenericEqualityChecker<2> >(schemeCopy);
-         case 3: return new HashTableMultiMapIndex<GenericKey<3>, GenericHasher<3>, GenericEqualityChecker<3> >(schemeCopy);
-         case 4: return new HashTableMultiMapIndex<GenericKey<4>, GenericHasher<4>, GenericEqualityChecker<4> >(schemeCopy);
-         case 5: return new HashTableMultiMapIndex<GenericKey<5>, GenericHasher<5>, GenericEqualityChecker<5> >(schemeCopy);
-         case 6: return new HashTableMultiMapIndex<GenericKey<6>, GenericHasher<6>, GenericEqualityChecker<6> >(schemeCopy);
-         default: throwFatalException( "We currently only support up to 6 column generic hash indexes..." );
-         }
-         }*/
-        
         throwFatalException("Unsupported index scheme..." );
         return NULL;
     }
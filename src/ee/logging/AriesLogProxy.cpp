@@ -42,7 +42,11 @@
  */
 
 #include "AriesLogProxy.h"
+#include "Logrecord.h"
+#include "common/serializeio.h"
+#include "common/FatalException.hpp"
 #include "execution/VoltDBEngine.h"
+#include <cstring>
 #include <string>
 
 using std::ios;
@@ -67,13 +71,19 @@ void AriesLogProxy::init(VoltDBEngine *engine, string logfileName) {
 	this->logFileName = logfileName;
 	// XXX originally true
 	jniLogging = false;
+	logWriter = NULL;
+
+	txnBufferCapacity = TXN_BUFFER_SIZE;
+	txnBuffer = new char[txnBufferCapacity];
+	txnBufferUsed = 0;
+	txnId = -1;
+	lastEntry = 0;
 
 	if (!jniLogging) {
-		// append + binary mode
-		logFile = fopen(logfileName.c_str(), "ab+");
-		logFileFD = fileno(logFile);
+		// appends from its own thread, group-committing transactions
+		logWriter = new AriesLogWriter(logfileName);
 
-		if(logFile != NULL){
+		if(logWriter->isOpen()){
 			VOLT_DEBUG("AriesLogProxy : opened logfile %s ", logFileName.c_str());
 		}
 		else{
@@ -88,16 +98,16 @@ void AriesLogProxy::init(VoltDBEngine *engine, string logfileName) {
 }
 
 AriesLogProxy::~AriesLogProxy() {
-	if(logFile != NULL){
-		int ret = fclose(logFile);
-
-		if(ret == 0){
-			VOLT_DEBUG("AriesLogProxy : closed logfile %s", logFileName.c_str());
-		}
-		else{
-			VOLT_ERROR("AriesLogProxy : could not close logfile %s", logFileName.c_str());
+	if(logWriter != NULL){
+		// drains and syncs whatever is still queued; a failed writer was
+		// already reported when it failed, so it is not thrown from here
+		if (txnBufferUsed > 0) {
+			logWriter->append(txnBuffer, txnBufferUsed);
 		}
+		delete logWriter;
+		VOLT_DEBUG("AriesLogProxy : closed logfile %s", logFileName.c_str());
 	}
+	delete[] txnBuffer;
 }
 
 AriesLogProxy* AriesLogProxy::getAriesLogProxy(VoltDBEngine *engine) {
@@ -175,41 +185,127 @@ void AriesLogProxy::log(LoggerId loggerId, LogLevel level, const char *statement
 }
 
 void AriesLogProxy::logBinaryOutput(const char *data, size_t size) {
-	if (jniLogging) {
-		VOLT_DEBUG("AriesLogProxy : logToEngineBuffer : %lu", size);
-		logToEngineBuffer(data, size);
-	} else {
-		VOLT_DEBUG("AriesLogProxy : logLocally : %lu", size);
-		logLocally(data, size);
+	VOLT_DEBUG("AriesLogProxy : logBinaryOutput : %lu", size);
+	if (size >= TXN_BUFFER_HIGH_WATER && !jniLogging && logWriter != NULL) {
+		// bulk loaded tables go straight to the writer, after the records
+		// that precede them
+		queueTransaction();
+		lastEntry = logWriter->append(data, size);
+		checkWriter(lastEntry >= 0);
+		return;
 	}
+	memcpy(reserve(size), data, size);
+	txnBufferUsed += size;
 }
 
-void AriesLogProxy::logLocally(const char *data, size_t size) {
-	size_t s_ret = -1;
-	int ret = -1;
+void AriesLogProxy::logRecord(LogRecord &record) {
+	// transactions that run without undo logging are never released, so
+	// the first record of the next transaction closes their entry
+	if (record.getTransactionId() != txnId) {
+		queueTransaction();
+		txnId = record.getTransactionId();
+	}
+
+	size_t estimatedLength = record.getEstimatedLength();
+	char *position = reserve(estimatedLength);
 
-	s_ret = fwrite (data , sizeof(char), size, logFile);
-	if(s_ret != size){
-		VOLT_ERROR("logLocally failed : badbit set");
+	FallbackSerializeOutput output;
+	output.initializeWithPosition(position, estimatedLength, 0);
+	record.serializeTo(output);
+
+	if (output.data() != position) {
+		// outgrew the estimate and moved to the fallback buffer
+		memcpy(reserve(output.position()), output.data(), output.position());
 	}
+	txnBufferUsed += output.position();
+}
 
-	ret = fflush(logFile);
-	if(ret == 0){
-	 	VOLT_DEBUG("logLocally : flushed : file pos %ld", ftell(logFile));
+/**
+ * Hand the running transaction's records to the writer as one entry,
+ * without waiting for them to reach the disk. Returns the entry to pass
+ * to waitForSync() before the transaction is reported as committed.
+ */
+int64_t AriesLogProxy::commitTransaction() {
+	queueTransaction();
+	return lastEntry;
+}
+
+/**
+ * Block until the given entry, and every entry before it, is on disk.
+ * Only touches the writer, so any thread may wait; false if the writer
+ * failed first.
+ */
+bool AriesLogProxy::waitForSync(int64_t entry) {
+	if (logWriter == NULL || entry <= 0) {
+		return true;
 	}
-	else{
-	 	VOLT_ERROR("logLocally : flushed : file pos %ld", ftell(logFile));
+	return logWriter->waitForSync(entry);
+}
+
+/**
+ * Hand the running transaction's records to the writer as one entry,
+ * without waiting for them to reach the disk.
+ */
+void AriesLogProxy::queueTransaction() {
+	if (txnBufferUsed == 0) {
+		return;
+	}
+	if (jniLogging) {
+		VOLT_DEBUG("AriesLogProxy : logToEngineBuffer : %lu", txnBufferUsed);
+		logToEngineBuffer(txnBuffer, txnBufferUsed);
+	} else if (logWriter != NULL) {
+		VOLT_DEBUG("AriesLogProxy : commitTransaction : %lu", txnBufferUsed);
+		lastEntry = logWriter->append(txnBuffer, txnBufferUsed);
+		checkWriter(lastEntry >= 0);
 	}
+	txnBufferUsed = 0;
+}
 
-	// SYNC changes
-	ret = fsync(logFileFD);
-	if(ret == 0){
-		VOLT_DEBUG("logLocally : synced file");
+/**
+ * Block until every committed transaction is on disk.
+ */
+void AriesLogProxy::flush() {
+	queueTransaction();
+	if (logWriter != NULL) {
+		checkWriter(logWriter->flush());
 	}
-	else{
-		VOLT_ERROR("logLocally : could not sync file ");
+}
+
+/**
+ * A transaction whose records did not reach the log must not be reported
+ * as committed.
+ */
+void AriesLogProxy::checkWriter(bool ok) {
+	if (!ok) {
+		throwFatalException("AriesLogProxy : cannot write logfile %s : %s",
+				logFileName.c_str(), strerror(logWriter->error()));
 	}
+}
 
+/**
+ * Make room for size more bytes at the end of the transaction buffer.
+ */
+char* AriesLogProxy::reserve(size_t size) {
+	if (txnBufferUsed + size > txnBufferCapacity) {
+		// a huge transaction (e.g. a bulk load) is written out in pieces
+		// instead of growing the buffer without bound; every record is
+		// length prefixed, so replay does not care where the cut is
+		if (txnBufferUsed + size > TXN_BUFFER_HIGH_WATER) {
+			queueTransaction();
+		}
+		if (txnBufferUsed + size > txnBufferCapacity) {
+			size_t capacity = txnBufferCapacity;
+			while (capacity < txnBufferUsed + size) {
+				capacity *= 2;
+			}
+			char *buffer = new char[capacity];
+			memcpy(buffer, txnBuffer, txnBufferUsed);
+			delete[] txnBuffer;
+			txnBuffer = buffer;
+			txnBufferCapacity = capacity;
+		}
+	}
+	return txnBuffer + txnBufferUsed;
 }
 
 void AriesLogProxy::logToEngineBuffer(const char *data, size_t size) {
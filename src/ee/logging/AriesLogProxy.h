@@ -47,6 +47,7 @@
 
 #include "logging/LogDefs.h"
 #include "logging/LogProxy.h"
+#include "logging/AriesLogWriter.h"
 
 #include <iostream>
 #include <cstdio>
@@ -54,10 +55,18 @@
 
 namespace voltdb {
 class VoltDBEngine;
+class LogRecord;
 
 /**
  * A log proxy implementation geared toward Aries. Implements an
  * extra function to log binary output to files.
+ *
+ * Records of the running transaction are serialized into a reusable
+ * buffer and handed to an AriesLogWriter as one entry when the
+ * transaction ends. Commit does not wait for the disk: the execution
+ * thread goes on with the next transaction while the writer syncs, and
+ * whoever releases the results waits for the entry with waitForSync(),
+ * so one sync covers every transaction committed in the meantime.
  */
 class AriesLogProxy : public LogProxy {
 public:
@@ -66,23 +75,41 @@ public:
 	void log(LoggerId loggerId, LogLevel level, const char *statement) const;
 	static AriesLogProxy* getAriesLogProxy(VoltDBEngine* engine);
 	void logBinaryOutput(const char *data, size_t size);
+	void logRecord(LogRecord &record);
+	int64_t commitTransaction();
+	bool waitForSync(int64_t entry);
+	void flush();
 	//void setEngine(VoltDBEngine*);
 
 	std::string getLogFileName();
 	static std::string defaultLogfileName;
 
+	/** Initial size of the transaction buffer */
+	static const size_t TXN_BUFFER_SIZE = 1024 * 1024;
+	/** A transaction larger than this is handed to the writer in pieces */
+	static const size_t TXN_BUFFER_HIGH_WATER = 16 * 1024 * 1024;
+
 private:
 	AriesLogProxy(VoltDBEngine*);
 	AriesLogProxy(VoltDBEngine*, std::string logfileName);
 
 	void init(VoltDBEngine*, std::string logfileName);
 
-	void logLocally(const char *data, size_t size);
 	void logToEngineBuffer(const char *data, size_t size);
+	void queueTransaction();
+	void checkWriter(bool ok);
+	char* reserve(size_t size);
 
 	std::string logFileName;
-	FILE* logFile;
-	int logFileFD; // fd equivalent for fsync
+	AriesLogWriter* logWriter;
+
+	// serialized records of the running transaction
+	char* txnBuffer;
+	size_t txnBufferCapacity;
+	size_t txnBufferUsed;
+	int64_t txnId;
+	// number of the last entry handed to the writer
+	int64_t lastEntry;
 
 	bool jniLogging;
 	VoltDBEngine* engine;
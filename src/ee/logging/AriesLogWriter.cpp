@@ -0,0 +1,227 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AriesLogWriter.h"
+#include "common/debuglog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::string;
+
+using namespace voltdb;
+
+AriesLogWriter::AriesLogWriter(const string &fileName) :
+		m_fd(-1), m_threadStarted(false), m_appendedEntries(0),
+		m_syncedEntries(0), m_syncCount(0), m_error(0), m_stopping(false) {
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_cond_init(&m_workAvailable, NULL);
+	pthread_cond_init(&m_synced, NULL);
+
+	m_fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (m_fd < 0) {
+		m_error = errno;
+		VOLT_ERROR("AriesLogWriter : cannot open logfile %s : %s",
+				fileName.c_str(), strerror(m_error));
+		return;
+	}
+
+	m_error = pthread_create(&m_thread, NULL, AriesLogWriter::run, this);
+	if (m_error != 0) {
+		VOLT_ERROR("AriesLogWriter : cannot start writer thread for %s", fileName.c_str());
+		close(m_fd);
+		m_fd = -1;
+		return;
+	}
+	m_threadStarted = true;
+	VOLT_DEBUG("AriesLogWriter : opened logfile %s ", fileName.c_str());
+}
+
+AriesLogWriter::~AriesLogWriter() {
+	if (m_threadStarted) {
+		// the writer drains whatever is still pending before it exits
+		pthread_mutex_lock(&m_mutex);
+		m_stopping = true;
+		pthread_cond_signal(&m_workAvailable);
+		pthread_mutex_unlock(&m_mutex);
+		pthread_join(m_thread, NULL);
+	}
+	if (m_fd >= 0 && close(m_fd) != 0) {
+		VOLT_ERROR("AriesLogWriter : could not close logfile : %s", strerror(errno));
+	}
+
+	pthread_cond_destroy(&m_synced);
+	pthread_cond_destroy(&m_workAvailable);
+	pthread_mutex_destroy(&m_mutex);
+}
+
+int64_t AriesLogWriter::append(const char *data, size_t size) {
+	if (!m_threadStarted) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&m_mutex);
+	// back pressure: let the writer catch up rather than buffer without bound
+	while (m_error == 0 && !m_pending.empty() &&
+			m_pending.size() + size > MAX_PENDING_BYTES) {
+		pthread_cond_wait(&m_synced, &m_mutex);
+	}
+	if (m_error != 0) {
+		pthread_mutex_unlock(&m_mutex);
+		return -1;
+	}
+	if (size > 0) {
+		m_pending.insert(m_pending.end(), data, data + size);
+		m_appendedEntries++;
+		pthread_cond_signal(&m_workAvailable);
+	}
+	int64_t entry = m_appendedEntries;
+	pthread_mutex_unlock(&m_mutex);
+	return entry;
+}
+
+bool AriesLogWriter::waitForSync(int64_t entry) {
+	pthread_mutex_lock(&m_mutex);
+	while (m_syncedEntries < entry && m_error == 0) {
+		pthread_cond_wait(&m_synced, &m_mutex);
+	}
+	bool synced = m_syncedEntries >= entry;
+	pthread_mutex_unlock(&m_mutex);
+	return synced;
+}
+
+bool AriesLogWriter::flush() {
+	if (!m_threadStarted) {
+		return false;
+	}
+	pthread_mutex_lock(&m_mutex);
+	int64_t target = m_appendedEntries;
+	pthread_mutex_unlock(&m_mutex);
+	return waitForSync(target);
+}
+
+int AriesLogWriter::error() {
+	pthread_mutex_lock(&m_mutex);
+	int error = m_error;
+	pthread_mutex_unlock(&m_mutex);
+	return error;
+}
+
+int64_t AriesLogWriter::syncedEntries() {
+	pthread_mutex_lock(&m_mutex);
+	int64_t entries = m_syncedEntries;
+	pthread_mutex_unlock(&m_mutex);
+	return entries;
+}
+
+int64_t AriesLogWriter::syncCount() {
+	pthread_mutex_lock(&m_mutex);
+	int64_t count = m_syncCount;
+	pthread_mutex_unlock(&m_mutex);
+	return count;
+}
+
+void* AriesLogWriter::run(void *writer) {
+	static_cast<AriesLogWriter*>(writer)->writeLoop();
+	return NULL;
+}
+
+void AriesLogWriter::writeLoop() {
+	pthread_mutex_lock(&m_mutex);
+	while (true) {
+		while (m_pending.empty() && !m_stopping) {
+			pthread_cond_wait(&m_workAvailable, &m_mutex);
+		}
+		if (m_pending.empty()) {
+			break;
+		}
+
+		// take everything queued so far as one batch
+		m_pending.swap(m_writing);
+		int64_t batchEntries = m_appendedEntries;
+		pthread_mutex_unlock(&m_mutex);
+
+		int error = 0;
+		if (!writeFully(&m_writing[0], m_writing.size())) {
+			error = errno;
+			VOLT_ERROR("AriesLogWriter : write failed : %s", strerror(error));
+		} else if (fdatasync(m_fd) != 0) {
+			error = errno;
+			VOLT_ERROR("AriesLogWriter : could not sync file : %s", strerror(error));
+		} else {
+			VOLT_DEBUG("AriesLogWriter : synced %lu bytes", m_writing.size());
+		}
+		m_writing.clear();
+
+		pthread_mutex_lock(&m_mutex);
+		if (error == 0) {
+			m_syncedEntries = batchEntries;
+			m_syncCount++;
+		} else {
+			// the batch is not durable, and anything after it would follow
+			// a hole in the log, so drop it and refuse further appends
+			m_error = error;
+			m_pending.clear();
+		}
+		pthread_cond_broadcast(&m_synced);
+	}
+	pthread_mutex_unlock(&m_mutex);
+}
+
+bool AriesLogWriter::writeFully(const char *data, size_t size) {
+	while (size > 0) {
+		ssize_t written = write(m_fd, data, size);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += written;
+		size -= static_cast<size_t>(written);
+	}
+	return true;
+}
@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ARIESLOGWRITER_H_
+#define ARIESLOGWRITER_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * Appends ARIES log entries to a file from a dedicated writer thread.
+ * Callers hand over whole transactions; everything handed over while the
+ * previous batch was being written goes out with a single write() and
+ * fdatasync(), so the sync cost is shared by all transactions in a batch.
+ * A failed write or sync is sticky: nothing queued after it reaches the
+ * file, and every later call reports the failure.
+ */
+class AriesLogWriter {
+public:
+	/** Upper bound on bytes waiting for the writer before append() blocks */
+	static const size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+	AriesLogWriter(const std::string &fileName);
+	~AriesLogWriter();
+
+	inline bool isOpen() const {
+		return m_fd >= 0;
+	}
+
+	/**
+	 * Queue one log entry; returns before it reaches the disk. Returns the
+	 * entry's number for waitForSync(), or -1 if the writer has failed.
+	 */
+	int64_t append(const char *data, size_t size);
+
+	/** Block until the given entry has been synced; false if the writer failed first */
+	bool waitForSync(int64_t entry);
+
+	/** Block until every entry appended so far has been synced; false on failure */
+	bool flush();
+
+	/** errno of the write or sync that failed, 0 if none has */
+	int error();
+
+	/** Number of entries that have been synced */
+	int64_t syncedEntries();
+
+	/** Number of write + fdatasync rounds so far */
+	int64_t syncCount();
+
+private:
+	static void* run(void *writer);
+	void writeLoop();
+	bool writeFully(const char *data, size_t size);
+
+	int m_fd;
+	pthread_t m_thread;
+	bool m_threadStarted;
+
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_workAvailable;
+	pthread_cond_t m_synced;
+
+	// entries waiting for the writer, swapped with the batch being written
+	std::vector<char> m_pending;
+	std::vector<char> m_writing;
+
+	int64_t m_appendedEntries;
+	int64_t m_syncedEntries;
+	int64_t m_syncCount;
+	int m_error;
+	bool m_stopping;
+};
+
+}
+
+#endif /* ARIESLOGWRITER_H_ */
@@ -0,0 +1,235 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AriesRedoPipeline.h"
+#include "common/debuglog.h"
+#include "common/FatalException.hpp"
+#include "common/SerializableEEException.h"
+
+using std::deque;
+using std::string;
+
+using namespace voltdb;
+
+AriesRedoPipeline::AriesRedoPipeline(int lanes) :
+		m_nextLane(0), m_failed(false) {
+	pthread_mutex_init(&m_failureMutex, NULL);
+
+	for (int i = 0; i < lanes; i++) {
+		Lane *lane = new Lane();
+		lane->pipeline = this;
+		lane->threadStarted = false;
+		lane->busy = false;
+		lane->stopping = false;
+		lane->applied = 0;
+		pthread_mutex_init(&lane->mutex, NULL);
+		pthread_cond_init(&lane->workAvailable, NULL);
+		pthread_cond_init(&lane->drained, NULL);
+		m_lanes.push_back(lane);
+
+		if (pthread_create(&lane->thread, NULL, AriesRedoPipeline::run, lane) != 0) {
+			// the lane still works, its tasks are applied by the dispatching thread
+			VOLT_ERROR("AriesRedoPipeline : cannot start redo thread %d", i);
+		} else {
+			lane->threadStarted = true;
+		}
+	}
+}
+
+AriesRedoPipeline::~AriesRedoPipeline() {
+	for (std::vector<Lane*>::iterator iter = m_lanes.begin(); iter != m_lanes.end(); ++iter) {
+		Lane *lane = *iter;
+		if (lane->threadStarted) {
+			// the lane drains whatever is still queued before it exits
+			pthread_mutex_lock(&lane->mutex);
+			lane->stopping = true;
+			pthread_cond_signal(&lane->workAvailable);
+			pthread_mutex_unlock(&lane->mutex);
+			pthread_join(lane->thread, NULL);
+		}
+		pthread_cond_destroy(&lane->drained);
+		pthread_cond_destroy(&lane->workAvailable);
+		pthread_mutex_destroy(&lane->mutex);
+		delete lane;
+	}
+	pthread_mutex_destroy(&m_failureMutex);
+}
+
+int AriesRedoPipeline::laneFor(const void *key) {
+	std::map<const void*, int>::iterator pos = m_laneForKey.find(key);
+	if (pos != m_laneForKey.end()) {
+		return pos->second;
+	}
+	int lane = m_nextLane;
+	m_nextLane = (m_nextLane + 1) % laneCount();
+	m_laneForKey[key] = lane;
+	return lane;
+}
+
+bool AriesRedoPipeline::dispatch(int laneId, AriesRedoTask *task) {
+	Lane *lane = m_lanes[laneId];
+	if (!lane->threadStarted) {
+		if (apply(task)) {
+			pthread_mutex_lock(&lane->mutex);
+			lane->applied++;
+			pthread_mutex_unlock(&lane->mutex);
+		}
+		return !failed();
+	}
+
+	pthread_mutex_lock(&lane->mutex);
+	// back pressure: let the lane catch up rather than queue without bound
+	while (lane->queue.size() >= MAX_QUEUED_TASKS) {
+		pthread_cond_wait(&lane->drained, &lane->mutex);
+	}
+	lane->queue.push_back(task);
+	pthread_cond_signal(&lane->workAvailable);
+	pthread_mutex_unlock(&lane->mutex);
+	return !failed();
+}
+
+bool AriesRedoPipeline::barrier() {
+	for (std::vector<Lane*>::iterator iter = m_lanes.begin(); iter != m_lanes.end(); ++iter) {
+		Lane *lane = *iter;
+		pthread_mutex_lock(&lane->mutex);
+		while (!lane->queue.empty() || lane->busy) {
+			pthread_cond_wait(&lane->drained, &lane->mutex);
+		}
+		pthread_mutex_unlock(&lane->mutex);
+	}
+	return !failed();
+}
+
+bool AriesRedoPipeline::failed() {
+	pthread_mutex_lock(&m_failureMutex);
+	bool failed = m_failed;
+	pthread_mutex_unlock(&m_failureMutex);
+	return failed;
+}
+
+string AriesRedoPipeline::failure() {
+	pthread_mutex_lock(&m_failureMutex);
+	string reason = m_failure;
+	pthread_mutex_unlock(&m_failureMutex);
+	return reason;
+}
+
+int64_t AriesRedoPipeline::appliedTasks() {
+	int64_t applied = 0;
+	for (std::vector<Lane*>::iterator iter = m_lanes.begin(); iter != m_lanes.end(); ++iter) {
+		pthread_mutex_lock(&(*iter)->mutex);
+		applied += (*iter)->applied;
+		pthread_mutex_unlock(&(*iter)->mutex);
+	}
+	return applied;
+}
+
+void* AriesRedoPipeline::run(void *lane) {
+	Lane *self = static_cast<Lane*>(lane);
+	self->pipeline->applyLoop(self);
+	return NULL;
+}
+
+void AriesRedoPipeline::applyLoop(Lane *lane) {
+	deque<AriesRedoTask*> batch;
+
+	pthread_mutex_lock(&lane->mutex);
+	while (true) {
+		while (lane->queue.empty() && !lane->stopping) {
+			pthread_cond_wait(&lane->workAvailable, &lane->mutex);
+		}
+		if (lane->queue.empty()) {
+			break;
+		}
+
+		// take everything queued so far, the dispatcher can refill meanwhile
+		lane->queue.swap(batch);
+		lane->busy = true;
+		pthread_cond_broadcast(&lane->drained);
+		pthread_mutex_unlock(&lane->mutex);
+
+		int64_t applied = 0;
+		while (!batch.empty()) {
+			if (apply(batch.front())) {
+				applied++;
+			}
+			batch.pop_front();
+		}
+
+		pthread_mutex_lock(&lane->mutex);
+		lane->applied += applied;
+		lane->busy = false;
+		pthread_cond_broadcast(&lane->drained);
+	}
+	pthread_mutex_unlock(&lane->mutex);
+}
+
+bool AriesRedoPipeline::apply(AriesRedoTask *task) {
+	bool applied = false;
+	// once anything has failed the rest of the redo is pointless
+	if (!failed()) {
+		try {
+			task->apply();
+			applied = true;
+		} catch (SerializableEEException &e) {
+			fail(e.message());
+		} catch (FatalException &e) {
+			fail(e.m_reason);
+		} catch (...) {
+			fail("unknown exception");
+		}
+	}
+	delete task;
+	return applied;
+}
+
+void AriesRedoPipeline::fail(const string &reason) {
+	VOLT_ERROR("AriesRedoPipeline : redo failed : %s", reason.c_str());
+	pthread_mutex_lock(&m_failureMutex);
+	if (!m_failed) {
+		m_failed = true;
+		m_failure = reason;
+	}
+	pthread_mutex_unlock(&m_failureMutex);
+}
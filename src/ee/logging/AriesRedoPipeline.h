@@ -0,0 +1,137 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ARIESREDOPIPELINE_H_
+#define ARIESREDOPIPELINE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * One piece of redo work, applied on the lane it was dispatched to.
+ */
+class AriesRedoTask {
+public:
+	virtual ~AriesRedoTask() {}
+	virtual void apply() = 0;
+};
+
+/**
+ * Applies ARIES redo work on a fixed number of lanes, each drained in
+ * dispatch order by a thread of its own. The replaying thread parses the
+ * log and sends all the work for a table down the same lane, so every
+ * table sees its records in log order while different tables are redone
+ * at the same time. barrier() waits for all lanes to go idle, for work
+ * that has to see every earlier record applied.
+ */
+class AriesRedoPipeline {
+public:
+	/** Tasks a lane may have waiting before dispatch() blocks */
+	static const size_t MAX_QUEUED_TASKS = 4096;
+
+	AriesRedoPipeline(int lanes);
+	~AriesRedoPipeline();
+
+	inline int laneCount() const {
+		return static_cast<int>(m_lanes.size());
+	}
+
+	/** Lane for the given key, handed out round robin on first use */
+	int laneFor(const void *key);
+
+	/**
+	 * Queue a task on a lane, which then owns it. Returns false, and
+	 * deletes the task unapplied, once any task has failed.
+	 */
+	bool dispatch(int lane, AriesRedoTask *task);
+
+	/** Block until every task dispatched so far has been applied */
+	bool barrier();
+
+	/** Whether any task has failed */
+	bool failed();
+
+	/** Why the first failed task failed, empty while none has */
+	std::string failure();
+
+	/** Number of tasks applied so far */
+	int64_t appliedTasks();
+
+private:
+	struct Lane {
+		AriesRedoPipeline *pipeline;
+		pthread_t thread;
+		bool threadStarted;
+		pthread_mutex_t mutex;
+		pthread_cond_t workAvailable;
+		pthread_cond_t drained;
+		std::deque<AriesRedoTask*> queue;
+		bool busy;
+		bool stopping;
+		int64_t applied;
+	};
+
+	static void* run(void *lane);
+	void applyLoop(Lane *lane);
+	bool apply(AriesRedoTask *task);
+	void fail(const std::string &reason);
+
+	std::vector<Lane*> m_lanes;
+	std::map<const void*, int> m_laneForKey;
+	int m_nextLane;
+
+	pthread_mutex_t m_failureMutex;
+	bool m_failed;
+	std::string m_failure;
+};
+
+}
+
+#endif /* ARIESREDOPIPELINE_H_ */
@@ -0,0 +1,129 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AriesReplayLog.h"
+#include "common/debuglog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+
+using namespace voltdb;
+
+pthread_mutex_t AriesReplayLog::s_mutex = PTHREAD_MUTEX_INITIALIZER;
+std::map<const char*, size_t> AriesReplayLog::s_mappings;
+
+char* AriesReplayLog::map(const string &fileName, int64_t *length) {
+	*length = 0;
+
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		VOLT_WARN("Did not find aries log file at : %s", fileName.c_str());
+		return NULL;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		VOLT_WARN("Log file is empty : %s", fileName.c_str());
+		close(fd);
+		return NULL;
+	}
+
+	size_t size = static_cast<size_t>(info.st_size);
+	void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps the file open
+	close(fd);
+	if (data == MAP_FAILED) {
+		VOLT_ERROR("Could not map aries log file %s : %s", fileName.c_str(), strerror(errno));
+		return NULL;
+	}
+	madvise(data, size, MADV_SEQUENTIAL);
+
+	pthread_mutex_lock(&s_mutex);
+	s_mappings[static_cast<const char*>(data)] = size;
+	pthread_mutex_unlock(&s_mutex);
+
+	*length = static_cast<int64_t>(size);
+	return static_cast<char*>(data);
+}
+
+void AriesReplayLog::unmap(char *data) {
+	pthread_mutex_lock(&s_mutex);
+	std::map<const char*, size_t>::iterator mapping = s_mappings.find(data);
+	size_t size = 0;
+	if (mapping != s_mappings.end()) {
+		size = mapping->second;
+		s_mappings.erase(mapping);
+	}
+	pthread_mutex_unlock(&s_mutex);
+
+	if (size > 0 && munmap(data, size) != 0) {
+		VOLT_ERROR("Could not unmap aries log : %s", strerror(errno));
+	}
+}
+
+const char* AriesReplayLog::release(const char *data, const char *from, const char *to) {
+	pthread_mutex_lock(&s_mutex);
+	bool mapped = (s_mappings.find(data) != s_mappings.end());
+	pthread_mutex_unlock(&s_mutex);
+	if (!mapped) {
+		return from;
+	}
+
+	// only whole pages can go, the one holding "to" is still in use
+	const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t start = static_cast<size_t>(from - data) / pageSize * pageSize;
+	size_t end = static_cast<size_t>(to - data) / pageSize * pageSize;
+	if (end <= start) {
+		return from;
+	}
+	// clean, file backed pages: touching them again just reads them back
+	madvise(const_cast<char*>(data) + start, end - start, MADV_DONTNEED);
+	return data + end;
+}
@@ -0,0 +1,90 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2011 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University 
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ARIESREPLAYLOG_H_
+#define ARIESREPLAYLOG_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+
+namespace voltdb {
+
+/**
+ * Read-only mapping of an ARIES log for replay. Replay walks the log
+ * front to back, so pages are faulted in with read-ahead as it goes and
+ * handed back once replayed: memory use stays bounded however big the
+ * log has grown, and the log never has to fit in memory.
+ */
+class AriesReplayLog {
+public:
+	/** Replayed pages are returned in steps of this many bytes */
+	static const size_t RELEASE_BYTES = 64 * 1024 * 1024;
+
+	/**
+	 * Map the given log file. Returns NULL, with a length of zero, if
+	 * the file does not exist or is empty.
+	 */
+	static char* map(const std::string &fileName, int64_t *length);
+
+	/** Unmap a log returned by map() */
+	static void unmap(char *data);
+
+	/**
+	 * Hand back the pages of [from, to) in the log starting at data.
+	 * Returns where the next release should start. Buffers that did
+	 * not come from map() are left alone.
+	 */
+	static const char* release(const char *data, const char *from, const char *to);
+
+private:
+	static pthread_mutex_t s_mutex;
+	// length of every live mapping, by start address
+	static std::map<const char*, size_t> s_mappings;
+};
+
+}
+
+#endif /* ARIESREPLAYLOG_H_ */
@@ -109,9 +109,11 @@ public:
     void setAriesProxyEngine(VoltDBEngine*);
 
     /**
-     * Frees the log proxy
+     * Frees the log proxy, and the ARIES proxy along with any records it
+     * still has queued
      */
     ~LogManager() {
+        delete m_ariesLogger.m_logProxy;
         delete m_proxy;
     }
 
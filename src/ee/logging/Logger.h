@@ -123,7 +123,59 @@ public:
 		ariesProxy->logBinaryOutput(data, len);
 	}
 
+	/**
+	 * For Aries logging only: add a record to the running transaction
+	 */
+	inline void log(const voltdb::LogLevel level, LogRecord &record) const {
+		assert (level != voltdb::LOGLEVEL_OFF && level != voltdb::LOGLEVEL_ALL); //: "Should never log as ALL or OFF";
+
+		AriesLogProxy* ariesProxy = getAriesProxy();
+		if (ariesProxy != NULL) {
+			ariesProxy->logRecord(record);
+		}
+	}
+
+	/**
+	 * For Aries logging only: the running transaction is done, queue its
+	 * records for the log writer. Returns the entry to wait for.
+	 */
+	inline int64_t commitTransaction() const {
+		AriesLogProxy* ariesProxy = getAriesProxy();
+		if (ariesProxy != NULL) {
+			return ariesProxy->commitTransaction();
+		}
+		return 0;
+	}
+
+	/**
+	 * For Aries logging only: wait until the given entry is on disk
+	 */
+	inline bool waitForSync(int64_t entry) const {
+		AriesLogProxy* ariesProxy = getAriesProxy();
+		if (ariesProxy != NULL) {
+			return ariesProxy->waitForSync(entry);
+		}
+		return true;
+	}
+
+	/**
+	 * For Aries logging only: wait until every queued record is on disk
+	 */
+	inline void flush() const {
+		AriesLogProxy* ariesProxy = getAriesProxy();
+		if (ariesProxy != NULL) {
+			ariesProxy->flush();
+		}
+	}
+
 private:
+	inline AriesLogProxy* getAriesProxy() const {
+		if (m_id != LOGGERID_MM_ARIES) {
+			return NULL;
+		}
+		return const_cast<AriesLogProxy*>(dynamic_cast<const AriesLogProxy*>(m_logProxy));
+	}
+
     /**
      * Currently active log level containing a cached value of the log level of some logger elsewhere
      */
@@ -132,6 +132,10 @@ public:
 		return type;
 	}
 
+	inline int64_t getTransactionId() {
+		return xid;
+	}
+
 	inline TableTuple* getTupleAfterImage() {
 		if (isValid) {
 			return afterImage;
@@ -86,6 +86,7 @@
 #include "plannodes/materializenode.h"
 #include "plannodes/nestloopnode.h"
 #include "plannodes/nestloopindexnode.h"
+#include "plannodes/hashjoinnode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/orderbynode.h"
 #include "plannodes/receivenode.h"
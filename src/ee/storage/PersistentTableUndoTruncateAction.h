@@ -0,0 +1,70 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERSISTENTTABLEUNDOTRUNCATEACTION_H_
+#define PERSISTENTTABLEUNDOTRUNCATEACTION_H_
+
+#include <vector>
+#include "common/UndoAction.h"
+#include "storage/persistenttable.h"
+
+namespace voltdb {
+
+/*
+ * Holds on to the blocks of a table that was emptied with
+ * PersistentTable::truncateBlocks(), or the head blocks that a window
+ * expired with PersistentTable::truncateHeadBlocks(), until the
+ * transaction is done.
+ */
+class PersistentTableUndoTruncateAction: public voltdb::UndoAction {
+public:
+    inline PersistentTableUndoTruncateAction(voltdb::PersistentTable *table)
+        : m_table(table), m_headBlocks(false), m_tupleCount(0), m_usedTuples(0),
+          m_nonInlinedMemorySize(0)
+    {
+    }
+
+    virtual ~PersistentTableUndoTruncateAction();
+
+    /*
+     * Undo whatever this undo action was created to undo. In this case give
+     * the blocks and their tuples back to the table.
+     */
+    void undo();
+
+    /*
+     * Release any resources held by the undo action. It will not need to be undone in the future.
+     * In this case free the strings of the truncated tuples and the blocks themselves.
+     */
+    void release();
+
+private:
+    friend class PersistentTable;
+
+    PersistentTable *m_table;
+    /* the blocks go back in front of the table's blocks rather than replacing them */
+    bool m_headBlocks;
+    std::vector<char*> m_blocks;
+    std::vector<char*> m_holeFreeTuples;
+    uint32_t m_tupleCount;
+    uint32_t m_usedTuples;
+    int64_t m_nonInlinedMemorySize;
+};
+
+}
+
+#endif /* PERSISTENTTABLEUNDOTRUNCATEACTION_H_ */
@@ -23,6 +23,7 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include "common/debuglog.h"
 #include "common/FatalException.hpp"
 #include "common/ValueFactory.hpp"
@@ -33,77 +34,179 @@ using namespace std;
 
 namespace voltdb {
 
-ReadWriteTracker::ReadWriteTracker(int64_t txnId) :
-        txnId(txnId) {
+bool RowSet::intersects(const RowSet &other) const {
+    size_t chunks = std::min(m_chunks.size(), other.m_chunks.size());
+    for (size_t ii = 0; ii < chunks; ii++) {
+        if (m_chunks[ii] == NULL || other.m_chunks[ii] == NULL) {
+            continue;
+        }
+        for (size_t jj = 0; jj < CHUNK_WORDS; jj++) {
+            if (m_chunks[ii][jj] & other.m_chunks[ii][jj]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RowSet::offsets(std::vector<uint32_t> &offsets) const {
+    for (size_t ii = 0; ii < m_chunks.size(); ii++) {
+        if (m_chunks[ii] == NULL) {
+            continue;
+        }
+        for (size_t jj = 0; jj < CHUNK_WORDS; jj++) {
+            uint64_t word = m_chunks[ii][jj];
+            while (word != 0) {
+                offsets.push_back(static_cast<uint32_t>(
+                    (ii << CHUNK_SHIFT) + jj * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+void RowSet::clear() {
+    for (size_t ii = 0; ii < m_chunks.size(); ii++) {
+        delete[] m_chunks[ii];
+    }
+    m_chunks.clear();
+}
+
+// -------------------------------------------------------------------------
+
+ReadWriteTracker::ReadWriteTracker(int64_t txnId, bool blockGranularity) :
+        txnId(txnId), blockGranularity(blockGranularity) {
     
     // Let's get it on!
 }
 
 ReadWriteTracker::~ReadWriteTracker() {
-    boost::unordered_map<std::string, RowOffsets*>::const_iterator iter;
-    
-    iter = this->reads.begin();
-    while (iter != this->reads.end()) {
-        delete iter->second;
-        iter++;
-    } // WHILE
-    
-    iter = this->writes.begin();
-    while (iter != this->writes.end()) {
-        delete iter->second;
-        iter++;
-    } // WHILE
+    this->clear();
 }
 
-void ReadWriteTracker::insertTuple(boost::unordered_map<std::string, RowOffsets*> *map, const std::string tableName, TableTuple *tuple) {
-    RowOffsets *offsets = NULL;
-    boost::unordered_map<std::string, RowOffsets*>::const_iterator iter = map->find(tableName);
-    if (iter != map->end()) {
-        offsets = iter->second;
-    } else {
-        offsets = new RowOffsets();
-        map->insert(std::make_pair(tableName, offsets));
+TrackedTable* ReadWriteTracker::addTable(const Table *table) {
+    int32_t id = table->relativeIndex();
+    if (id >= 0) {
+        if (id >= (int32_t)this->tables.size()) {
+            this->tables.resize(id + 1, NULL);
+        }
+        this->tables[id] = new TrackedTable(table);
+        return this->tables[id];
     }
-    
-    uint32_t tupleId = tuple->getTupleID();
-    offsets->insert(tupleId);
-    VOLT_INFO("*** TXN #%ld -> %s / %d", this->txnId, tableName.c_str(), tupleId);
+    for (int ii = 0; ii < this->otherTables.size(); ii++) {
+        if (this->otherTables[ii]->table == table) {
+            return this->otherTables[ii];
+        }
+    }
+    this->otherTables.push_back(new TrackedTable(table));
+    return this->otherTables.back();
 }
 
-void ReadWriteTracker::markTupleRead(const std::string tableName, TableTuple *tuple) {
-    this->insertTuple(&this->reads, tableName, tuple);
+const TrackedTable* ReadWriteTracker::findTable(const Table *table) const {
+    int32_t id = table->relativeIndex();
+    if (id >= 0) {
+        return id < (int32_t)this->tables.size() ? this->tables[id] : NULL;
+    }
+    for (int ii = 0; ii < this->otherTables.size(); ii++) {
+        if (this->otherTables[ii]->table == table) {
+            return this->otherTables[ii];
+        }
+    }
+    return NULL;
 }
 
-void ReadWriteTracker::markTupleWritten(const std::string tableName, TableTuple *tuple) {
-    this->insertTuple(&this->writes, tableName, tuple);
+uint32_t ReadWriteTracker::rowOffset(TrackedTable *tracked, const char *address) {
+    const Table *table = tracked->table;
+    const size_t blockLength = table->m_tuplesPerBlock * table->m_tupleLength;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        // the last block that starts at or before the address
+        std::vector<std::pair<const char*, uint32_t> >::const_iterator iter =
+            std::upper_bound(tracked->blocks.begin(), tracked->blocks.end(),
+                             std::make_pair(address, UINT32_MAX));
+        if (iter != tracked->blocks.begin()) {
+            --iter;
+            // a window frees its head blocks and moves the rest to the front
+            if (address < iter->first + blockLength && iter->second < table->m_data.size() &&
+                table->m_data[iter->second] == iter->first) {
+                if (this->blockGranularity) {
+                    return iter->second;
+                }
+                return iter->second * table->m_tuplesPerBlock +
+                    static_cast<uint32_t>((address - iter->first) / table->m_tupleLength);
+            }
+        }
+
+        // the table has allocated (or released) blocks since we last looked
+        tracked->blocks.clear();
+        for (uint32_t ii = 0; ii < table->m_data.size(); ii++) {
+            if (table->m_data[ii] != NULL) {
+                tracked->blocks.push_back(std::make_pair(table->m_data[ii], ii));
+            }
+        }
+        std::sort(tracked->blocks.begin(), tracked->blocks.end());
+    }
+    throwFatalException("Tuple %p is not stored in table '%s'",
+                        address, table->name().c_str());
 }
 
-std::vector<std::string> ReadWriteTracker::getTableNames(boost::unordered_map<std::string, RowOffsets*> *map) const {
+bool ReadWriteTracker::conflictsWith(const ReadWriteTracker &other) const {
+    assert(this->blockGranularity == other.blockGranularity);
+    for (int pass = 0; pass < 2; pass++) {
+        const std::vector<TrackedTable*> &mine = pass == 0 ? this->tables : this->otherTables;
+        for (int ii = 0; ii < mine.size(); ii++) {
+            if (mine[ii] == NULL) {
+                continue;
+            }
+            const TrackedTable *theirs = other.findTable(mine[ii]->table);
+            if (theirs == NULL) {
+                continue;
+            }
+            if (mine[ii]->writes.intersects(theirs->writes) ||
+                mine[ii]->writes.intersects(theirs->reads) ||
+                mine[ii]->reads.intersects(theirs->writes)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> ReadWriteTracker::getTableNames(bool writes) const {
     std::vector<std::string> tableNames;
-    tableNames.reserve(map->size());
-    boost::unordered_map<std::string, RowOffsets*>::const_iterator iter = map->begin();
-    while (iter != map->end()) {
-        tableNames.push_back(iter->first);
-        iter++;
+    for (int pass = 0; pass < 2; pass++) {
+        const std::vector<TrackedTable*> &tracked = pass == 0 ? this->tables : this->otherTables;
+        for (int ii = 0; ii < tracked.size(); ii++) {
+            if (tracked[ii] != NULL &&
+                !(writes ? tracked[ii]->writes : tracked[ii]->reads).empty()) {
+                tableNames.push_back(tracked[ii]->name);
+            }
+        } // FOR
     } // FOR
     return (tableNames);
 }
 
 std::vector<std::string> ReadWriteTracker::getTablesRead() {
-    return this->getTableNames(&this->reads);
+    return this->getTableNames(false);
 }    
 std::vector<std::string> ReadWriteTracker::getTablesWritten() {
-    return this->getTableNames(&this->writes);
+    return this->getTableNames(true);
 }
 
 void ReadWriteTracker::clear() {
-    this->reads.clear();
-    this->writes.clear();
+    for (int ii = 0; ii < this->tables.size(); ii++) {
+        delete this->tables[ii];
+    }
+    for (int ii = 0; ii < this->otherTables.size(); ii++) {
+        delete this->otherTables[ii];
+    }
+    this->tables.clear();
+    this->otherTables.clear();
 }
 
 // -------------------------------------------------------------------------
 
-ReadWriteTrackerManager::ReadWriteTrackerManager(ExecutorContext *ctx) : executorContext(ctx) {
+ReadWriteTrackerManager::ReadWriteTrackerManager(ExecutorContext *ctx) :
+        executorContext(ctx), blockGranularity(false) {
     CatalogId databaseId = 1;
     this->resultSchema = TupleSchema::createTrackerTupleSchema();
     
@@ -131,7 +234,7 @@ ReadWriteTrackerManager::~ReadWriteTrackerManager() {
 }
 
 ReadWriteTracker* ReadWriteTrackerManager::enableTracking(int64_t txnId) {
-    ReadWriteTracker *tracker = new ReadWriteTracker(txnId);
+    ReadWriteTracker *tracker = new ReadWriteTracker(txnId, this->blockGranularity);
     trackers[txnId] = tracker;
     return (tracker);
 }
@@ -153,32 +256,51 @@ void ReadWriteTrackerManager::removeTracker(int64_t txnId) {
     }
 }
 
-void ReadWriteTrackerManager::getTuples(boost::unordered_map<std::string, RowOffsets*> *map) const {
+bool ReadWriteTrackerManager::conflicts(int64_t txnId0, int64_t txnId1) {
+    ReadWriteTracker *tracker0 = this->getTracker(txnId0);
+    ReadWriteTracker *tracker1 = this->getTracker(txnId1);
+    if (tracker0 == NULL || tracker1 == NULL) {
+        return (false);
+    }
+    return (tracker0->conflictsWith(*tracker1));
+}
+
+void ReadWriteTrackerManager::getTuples(ReadWriteTracker *tracker, bool writes) const {
     this->resultTable->deleteAllTuples(false);
     TableTuple tuple = this->resultTable->tempTuple();
-    boost::unordered_map<std::string, RowOffsets*>::const_iterator iter = map->begin();
-    while (iter != map->end()) {
-        RowOffsets::const_iterator tupleIter = iter->second->begin();
-        while (tupleIter != iter->second->end()) {
-            int idx = 0;
-            tuple.setNValue(idx++, ValueFactory::getStringValue(iter->first)); // TABLE_NAME
-            tuple.setNValue(idx++, ValueFactory::getIntegerValue(*tupleIter)); // TUPLE_ID
-            this->resultTable->insertTuple(tuple);
-            tupleIter++;
-        } // WHILE
-        iter++;
-    } // WHILE
+    std::vector<uint32_t> offsets;
+    for (int pass = 0; pass < 2; pass++) {
+        const std::vector<TrackedTable*> &tracked = pass == 0 ? tracker->tables : tracker->otherTables;
+        for (int ii = 0; ii < tracked.size(); ii++) {
+            if (tracked[ii] == NULL) {
+                continue;
+            }
+            offsets.clear();
+            (writes ? tracked[ii]->writes : tracked[ii]->reads).offsets(offsets);
+            if (offsets.empty()) {
+                continue;
+            }
+            NValue tableName = ValueFactory::getStringValue(tracked[ii]->name);
+            for (int jj = 0; jj < offsets.size(); jj++) {
+                int idx = 0;
+                tuple.setNValue(idx++, tableName); // TABLE_NAME
+                tuple.setNValue(idx++, ValueFactory::getIntegerValue(offsets[jj])); // TUPLE_ID
+                this->resultTable->insertTuple(tuple);
+            } // FOR
+            tableName.free();
+        } // FOR
+    } // FOR
     return;
 }
 
 Table* ReadWriteTrackerManager::getTuplesRead(ReadWriteTracker *tracker) {
-    this->getTuples(&tracker->reads);
+    this->getTuples(tracker, false);
     return (this->resultTable);
 }
 
 Table* ReadWriteTrackerManager::getTuplesWritten(ReadWriteTracker *tracker) {
-    this->getTuples(&tracker->writes);
+    this->getTuples(tracker, true);
     return (this->resultTable);
 }
 
-}
\ No newline at end of file
+}
@@ -27,34 +27,106 @@
 #define HSTORE_READWRITETRACKER_H
 
 #include <string>
-#include "boost/unordered_set.hpp"
+#include <utility>
+#include <vector>
 #include "boost/unordered_map.hpp"
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
 #include "storage/table.h"
 
-typedef boost::unordered_set<uint32_t> RowOffsets;
-
 namespace voltdb {
     
 class ExecutorContext;
 class TableTuple;
 class TupleSchema;
 class Table;
-    
+
+/**
+ * Set of row offsets (or block numbers) within one table, one bit each.
+ * The bits are kept in fixed-size chunks that are only allocated once a
+ * member falls into them, so a few rows spread over a large table cost a
+ * chunk each rather than a bitmap of the whole table.
+ */
+class RowSet {
+    public:
+        RowSet() {}
+        ~RowSet() { clear(); }
+
+        inline void insert(uint32_t offset) {
+            size_t chunk = offset >> CHUNK_SHIFT;
+            if (chunk >= m_chunks.size()) {
+                m_chunks.resize(chunk + 1, NULL);
+            }
+            if (m_chunks[chunk] == NULL) {
+                m_chunks[chunk] = new uint64_t[CHUNK_WORDS]();
+            }
+            m_chunks[chunk][(offset & CHUNK_MASK) >> 6] |= (uint64_t)1 << (offset & 63);
+        }
+        inline bool contains(uint32_t offset) const {
+            size_t chunk = offset >> CHUNK_SHIFT;
+            return chunk < m_chunks.size() && m_chunks[chunk] != NULL &&
+                (m_chunks[chunk][(offset & CHUNK_MASK) >> 6] >> (offset & 63)) & 1;
+        }
+        /** Chunks are only allocated by insert() */
+        inline bool empty() const { return m_chunks.empty(); }
+        bool intersects(const RowSet &other) const;
+        /** Appends the members to offsets in ascending order */
+        void offsets(std::vector<uint32_t> &offsets) const;
+        void clear();
+
+    private:
+        RowSet(const RowSet&);
+        RowSet& operator=(const RowSet&);
+
+        // 4096 rows (or blocks) per chunk
+        static const uint32_t CHUNK_SHIFT = 12;
+        static const uint32_t CHUNK_MASK = (1 << CHUNK_SHIFT) - 1;
+        static const size_t CHUNK_WORDS = (1 << CHUNK_SHIFT) / 64;
+
+        // NULL where no member has been inserted
+        std::vector<uint64_t*> m_chunks;
+};
+
 /**
- * Read/Write Tuple Tracker for a single transaction
+ * What one transaction read and wrote in one table
  */
+struct TrackedTable {
+    TrackedTable(const Table *table) : table(table), name(table->name()) {}
+
+    const Table *table;
+    std::string name;
+    RowSet reads;
+    RowSet writes;
+    // (block address, block number) of the table's blocks, sorted by address
+    std::vector<std::pair<const char*, uint32_t> > blocks;
+};
+    
 class ReadWriteTracker {
     
     friend class ReadWriteTrackerManager;
     
     public:
-        ReadWriteTracker(int64_t txnId);
+        /**
+         * With blockGranularity the tracker records the blocks that were
+         * touched instead of the individual rows.
+         */
+        ReadWriteTracker(int64_t txnId, bool blockGranularity = false);
         ~ReadWriteTracker();
         
-        void markTupleRead(const std::string tableName, TableTuple *tuple);
-        void markTupleWritten(const std::string tableName, TableTuple *tuple);
+        inline void markTupleRead(const Table *table, TableTuple *tuple) {
+            TrackedTable *tracked = trackedTable(table);
+            tracked->reads.insert(rowOffset(tracked, tuple->address()));
+        }
+        inline void markTupleWritten(const Table *table, TableTuple *tuple) {
+            TrackedTable *tracked = trackedTable(table);
+            tracked->writes.insert(rowOffset(tracked, tuple->address()));
+        }
+
+        /**
+         * Did either transaction write a row (or block) that the other one
+         * read or wrote? Both trackers must use the same granularity.
+         */
+        bool conflictsWith(const ReadWriteTracker &other) const;
         
         void clear();
         
@@ -62,20 +134,29 @@ class ReadWriteTracker {
         std::vector<std::string> getTablesWritten();
         
     private:
-        void insertTuple(boost::unordered_map<std::string, RowOffsets*> *map, const std::string tableName, TableTuple *tuple);
-        std::vector<std::string> getTableNames(boost::unordered_map<std::string, RowOffsets*> *map) const;
+        inline TrackedTable* trackedTable(const Table *table) {
+            int32_t id = table->relativeIndex();
+            if (id >= 0 && id < (int32_t)tables.size() && tables[id] != NULL) {
+                return tables[id];
+            }
+            return addTable(table);
+        }
+        TrackedTable* addTable(const Table *table);
+        const TrackedTable* findTable(const Table *table) const;
+        /** Offset of the row at address in its table, or its block number */
+        uint32_t rowOffset(TrackedTable *tracked, const char *address);
+        std::vector<std::string> getTableNames(bool writes) const;
         
         int64_t txnId;
+        bool blockGranularity;
         
-        // TableName -> RowOffsets
-        boost::unordered_map<std::string, RowOffsets*> reads;
-        boost::unordered_map<std::string, RowOffsets*> writes;
+        // indexed by the catalog relative index of the table
+        std::vector<TrackedTable*> tables;
+        // tables that are not in the catalog
+        std::vector<TrackedTable*> otherTables;
         
 }; // CLASS
 
-/**
- * ReadWriteTracker Manager 
- */
 class ReadWriteTrackerManager {
     public:
         ReadWriteTrackerManager(ExecutorContext *ctx);
@@ -84,16 +165,30 @@ class ReadWriteTrackerManager {
         ReadWriteTracker* enableTracking(int64_t txnId);
         ReadWriteTracker* getTracker(int64_t txnId);
         void removeTracker(int64_t txnId);
+
+        /**
+         * Did the two transactions touch the same row (or block) with at
+         * least one of them writing it? False unless both are tracked.
+         */
+        bool conflicts(int64_t txnId0, int64_t txnId1);
+
+        /** Track blocks instead of rows in the trackers created from now on */
+        void setBlockGranularity(bool blockGranularity) { this->blockGranularity = blockGranularity; }
         
+        /**
+         * TUPLE_ID holds the offset of the row in its table, or the block
+         * number with block granularity
+         */
         Table* getTuplesRead(ReadWriteTracker *tracker);
         Table* getTuplesWritten(ReadWriteTracker *tracker);
         
     private:
-        void getTuples(boost::unordered_map<std::string, RowOffsets*> *map) const;
+        void getTuples(ReadWriteTracker *tracker, bool writes) const;
         
         ExecutorContext *executorContext;
         TupleSchema *resultSchema;
         Table *resultTable;
+        bool blockGranularity;
         boost::unordered_map<int64_t, ReadWriteTracker*> trackers;
 }; // CLASS
 
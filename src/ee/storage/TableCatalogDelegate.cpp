@@ -349,6 +349,8 @@ TableCatalogDelegate::init(ExecutorContext *executorContext,
     }
     
 
+    m_table->setRelativeIndex(table_id);
+
     // get the stream flag
     bool isStream = catalogTable.isStream();
     m_table->setIsStream(isStream);
@@ -98,6 +98,7 @@
 #include "storage/PersistentTableUndoInsertAction.h"
 #include "storage/PersistentTableUndoDeleteAction.h"
 #include "storage/PersistentTableUndoUpdateAction.h"
+#include "storage/PersistentTableUndoTruncateAction.h"
 #include "storage/ConstraintFailureException.h"
 #include "storage/MaterializedViewMetadata.h"
 #include "storage/CopyOnWriteContext.h"
@@ -106,6 +107,7 @@
 #include "boost/timer.hpp"
 #include "anticache/EvictedTable.h"
 #include "anticache/AntiCacheDB.h"
+#include "anticache/AntiCacheReader.h"
 #include "anticache/EvictionIterator.h"
 #include "anticache/UnknownBlockAccessException.h"
 #endif
@@ -127,7 +129,7 @@ PersistentTable::PersistentTable(ExecutorContext *ctx, bool exportEnabled) :
     Table(TABLE_BLOCKSIZE,ctx->isMMAPEnabled()), m_executorContext(ctx), m_uniqueIndexes(NULL), m_uniqueIndexCount(0), m_allowNulls(NULL),
     m_indexes(NULL), m_indexCount(0), m_pkeyIndex(NULL), m_wrapper(NULL),
     m_tsSeqNo(0), stats_(this), stream_stats_(this), m_exportEnabled(exportEnabled),
-    m_COWContext(NULL)
+    m_COWContext(NULL), m_bulkLoadStart(0)
 {
 
     #ifdef ANTICACHE
@@ -137,6 +139,7 @@ PersistentTable::PersistentTable(ExecutorContext *ctx, bool exportEnabled) :
     m_newestTupleID = 0;
     m_oldestTupleID = 0;
     m_numTuplesInEvictionChain = 0;
+    m_clockHand = 0;
     m_blockMerge = true;
     #endif
 
@@ -157,7 +160,7 @@ PersistentTable::PersistentTable(ExecutorContext *ctx, const std::string name, b
     Table(TABLE_BLOCKSIZE,ctx->isMMAPEnabled()), m_executorContext(ctx), m_uniqueIndexes(NULL), m_uniqueIndexCount(0), m_allowNulls(NULL),
     m_indexes(NULL), m_indexCount(0), m_pkeyIndex(NULL), m_wrapper(NULL),
     m_tsSeqNo(0), stats_(this), stream_stats_(this), m_exportEnabled(exportEnabled),
-    m_COWContext(NULL)
+    m_COWContext(NULL), m_bulkLoadStart(0)
 {
 
     #ifdef ANTICACHE
@@ -167,6 +170,7 @@ PersistentTable::PersistentTable(ExecutorContext *ctx, const std::string name, b
     m_newestTupleID = 0;
     m_oldestTupleID = 0;
     m_numTuplesInEvictionChain = 0;
+    m_clockHand = 0;
     m_blockMerge = true;
     #endif
 
@@ -423,6 +427,13 @@ bool PersistentTable::evictBlockToDisk(const long block_size, int num_blocks) {
     return true;
 }
 
+void PersistentTable::requestEvictedBlock(int16_t block_id) {
+    if (m_unevictedBlockIDs.find(block_id) != m_unevictedBlockIDs.end()) {
+        return; // this block has already been read
+    }
+    m_executorContext->getAntiCacheReader()->request(name(), block_id);
+}
+
 bool PersistentTable::readEvictedBlock(int16_t block_id, int32_t tuple_offset) {
     
     std::map<int16_t,int16_t>::iterator it;
@@ -435,36 +446,11 @@ bool PersistentTable::readEvictedBlock(int16_t block_id, int32_t tuple_offset) {
         return true; 
     }  
     
-    AntiCacheDB* antiCacheDB = m_executorContext->getAntiCacheDB(); 
-    
-    try
-    {
-        AntiCacheBlock value = antiCacheDB->readBlock(this->name(), block_id);
-        
-        // allocate the memory for this block
-        char* unevicted_tuples = new char[value.getSize()]; 
-        memcpy(unevicted_tuples, value.getData(), value.getSize()); 
-        m_unevictedBlocks.push_back(unevicted_tuples);
-        m_mergeTupleOffset.push_back(tuple_offset); 
-        
-	/*
-        // Update eviction stats
-        m_bytesEvicted -= value.getSize(); 
-        m_bytesRead += value.getSize();
-        
-        // update block eviction stats
-        m_blocksEvicted -= 1;
-        m_blocksRead += 1;
-	*/
-        m_unevictedBlockIDs.insert(std::pair<int16_t,int16_t>(block_id, 0)); 
-    }
-    catch(UnknownBlockAccessException e)
-    {
-        throw e; 
-        
-        VOLT_INFO("UnknownBlockAccessException caught.");   
-        return false;
-    }
+    // Wait for the reader's threads to bring the block in and leave it
+    // for the next mergeUnevictedTuples(). Throws UnknownBlockAccessException
+    // if the block can't be read.
+    m_executorContext->getAntiCacheReader()->stage(name(), block_id, tuple_offset);
+    m_unevictedBlockIDs.insert(std::pair<int16_t,int16_t>(block_id, 0)); 
     
     VOLT_INFO("blocks read: %d", m_blocksRead);
     return true;
@@ -475,6 +461,9 @@ bool PersistentTable::readEvictedBlock(int16_t block_id, int32_t tuple_offset) {
  */
 bool PersistentTable::mergeUnevictedTuples() 
 {        
+    // pick up the blocks the reader has staged for this table
+    m_executorContext->getAntiCacheReader()->takeStaged(name(), m_unevictedBlocks, m_mergeTupleOffset);
+
     int num_blocks = static_cast<int> (m_unevictedBlocks.size());
     int32_t num_tuples_in_block = -1;
     int tuplesRead = 0;
@@ -614,6 +603,16 @@ uint32_t PersistentTable::getOldestTupleID()
     return m_oldestTupleID;
 }
 
+void PersistentTable::setClockHand(uint32_t id)
+{
+    m_clockHand = id;
+}
+
+uint32_t PersistentTable::getClockHand()
+{
+    return m_clockHand;
+}
+
 #endif
 
 
@@ -621,6 +620,11 @@ uint32_t PersistentTable::getOldestTupleID()
 // OPERATIONS
 // ------------------------------------------------------------------
 void PersistentTable::deleteAllTuples(bool freeAllocatedStrings) {
+    if (canTruncateBlocks()) {
+        truncateBlocks();
+        return;
+    }
+
     // nothing interesting
     voltdb::TableIterator ti(this);
     voltdb::TableTuple tuple(m_schema);
@@ -629,6 +633,320 @@ void PersistentTable::deleteAllTuples(bool freeAllocatedStrings) {
     }
 }
 
+bool PersistentTable::canTruncateBlocks() const {
+    if (!m_isStream || m_indexCount != 0 || !m_views.empty() || m_exportEnabled) {
+        return false;
+    }
+    return canReleaseBlocks();
+}
+
+/*
+ * Whether the blocks can be taken away from the table wholesale, as
+ * nothing else holds on to them.
+ */
+bool PersistentTable::canReleaseBlocks() const {
+#ifdef MEMCHECK_NOFREELIST
+    return false;
+#else
+    if (m_COWContext.get() != NULL || m_recoveryContext.get() != NULL) {
+        return false;
+    }
+    // MMAP storage hands out blocks from its own memory manager
+    if (m_data_manager != NULL) {
+        return false;
+    }
+#ifdef ANTICACHE
+    if (m_evictedTable != NULL) {
+        return false;
+    }
+#endif
+    return true;
+#endif
+}
+
+bool PersistentTable::canTruncateHeadBlocks() const {
+    if (!m_views.empty() || m_exportEnabled) {
+        return false;
+    }
+    return canReleaseBlocks();
+}
+
+/*
+ * Drop every tuple of the table by handing its blocks over to an undo
+ * action. New tuples are appended to fresh blocks in arrival order. The
+ * old blocks are freed when the transaction commits or given back to the
+ * table if it rolls back.
+ */
+void PersistentTable::truncateBlocks() {
+    if (m_data.empty()) {
+        return;
+    }
+    VOLT_DEBUG("Truncating %d tuples in %d blocks of table '%s'",
+               (int)m_tupleCount, (int)m_data.size(), name().c_str());
+
+    voltdb::UndoQuantum *undoQuantum = m_executorContext->getCurrentUndoQuantum();
+    assert(undoQuantum);
+    voltdb::Pool *pool = undoQuantum->getDataPool();
+    assert(pool);
+    voltdb::PersistentTableUndoTruncateAction *ptuta =
+      new (pool->allocate(sizeof(voltdb::PersistentTableUndoTruncateAction)))
+      voltdb::PersistentTableUndoTruncateAction(this);
+
+    ptuta->m_blocks.swap(m_data);
+#ifndef MEMCHECK_NOFREELIST
+    ptuta->m_holeFreeTuples.swap(m_holeFreeTuples);
+#endif
+    ptuta->m_tupleCount = m_tupleCount;
+    ptuta->m_usedTuples = m_usedTuples;
+    ptuta->m_nonInlinedMemorySize = m_nonInlinedMemorySize;
+
+    m_tupleCount = 0;
+    m_usedTuples = 0;
+    m_allocatedTuples = 0;
+    m_nonInlinedMemorySize = 0;
+
+    undoQuantum->registerUndoAction(ptuta);
+}
+
+void PersistentTable::truncateHeadBlocks(uint32_t blockCount) {
+    const uint32_t slots = blockCount * m_tuplesPerBlock;
+    assert(blockCount > 0 && slots <= m_usedTuples);
+    VOLT_DEBUG("Truncating %d head blocks of %d in table '%s'",
+               (int)blockCount, (int)m_data.size(), name().c_str());
+
+    voltdb::UndoQuantum *undoQuantum = m_executorContext->getCurrentUndoQuantum();
+    assert(undoQuantum);
+    voltdb::Pool *pool = undoQuantum->getDataPool();
+    assert(pool);
+    voltdb::PersistentTableUndoTruncateAction *ptuta =
+      new (pool->allocate(sizeof(voltdb::PersistentTableUndoTruncateAction)))
+      voltdb::PersistentTableUndoTruncateAction(this);
+    ptuta->m_headBlocks = true;
+
+    // the free list may point into the blocks
+    dropFreeSlots();
+    TableTuple tuple(m_schema);
+    for (uint32_t i = 0; i < slots; ++i) {
+        tuple.move(dataPtrForTuple((int) i));
+        if (tuple.isActive()) {
+            deleteFromAllIndexes(&tuple);
+            ++ptuta->m_tupleCount;
+            if (m_schema->getUninlinedObjectColumnCount() != 0) {
+                ptuta->m_nonInlinedMemorySize += tuple.getNonInlinedMemorySize();
+            }
+        }
+    }
+    ptuta->m_blocks.assign(m_data.begin(), m_data.begin() + blockCount);
+    ptuta->m_usedTuples = slots;
+
+    m_data.erase(m_data.begin(), m_data.begin() + blockCount);
+    m_tupleCount -= ptuta->m_tupleCount;
+    m_usedTuples -= slots;
+    m_allocatedTuples -= slots;
+    m_nonInlinedMemorySize -= ptuta->m_nonInlinedMemorySize;
+
+    undoQuantum->registerUndoAction(ptuta);
+}
+
+void PersistentTable::dropFreeSlots() {
+#ifndef MEMCHECK_NOFREELIST
+    m_holeFreeTuples.clear();
+#endif
+}
+
+void PersistentTable::truncateBlocksForUndo(PersistentTableUndoTruncateAction *action) {
+    if (action->m_headBlocks) {
+        // Whatever happened to the table since then has been rolled back,
+        // so the blocks behind these start where they did back then.
+        m_data.insert(m_data.begin(), action->m_blocks.begin(), action->m_blocks.end());
+        action->m_blocks.clear();
+        TableTuple tuple(m_schema);
+        for (uint32_t i = 0; i < action->m_usedTuples; ++i) {
+            tuple.move(dataPtrForTuple((int) i));
+            if (tuple.isActive()) {
+                insertIntoAllIndexes(&tuple);
+            }
+        }
+        m_tupleCount += action->m_tupleCount;
+        m_usedTuples += action->m_usedTuples;
+        m_allocatedTuples += action->m_usedTuples;
+        m_nonInlinedMemorySize += action->m_nonInlinedMemorySize;
+        return;
+    }
+
+    // Every tuple inserted after the truncate has been rolled back already,
+    // so the blocks allocated since then are empty.
+    assert(m_tupleCount == 0);
+    for (std::vector<char*>::iterator iter = m_data.begin(); iter != m_data.end(); ++iter) {
+        delete[] *iter;
+    }
+    m_data.clear();
+    m_data.swap(action->m_blocks);
+#ifndef MEMCHECK_NOFREELIST
+    m_holeFreeTuples.swap(action->m_holeFreeTuples);
+#endif
+    m_tupleCount = action->m_tupleCount;
+    m_usedTuples = action->m_usedTuples;
+    m_allocatedTuples = (uint32_t)m_data.size() * m_tuplesPerBlock;
+    m_nonInlinedMemorySize = action->m_nonInlinedMemorySize;
+}
+
+/*
+ * Index entries and strings are released tuple by tuple, without having
+ * to look the tuples up, and the storage a block at a time. The tuples
+ * are deleted one by one only when something else holds on to the blocks.
+ */
+void PersistentTable::dropAllTuples() {
+    const bool releaseBlocks = canReleaseBlocks();
+    if (!releaseBlocks || m_indexCount != 0 || m_schema->getUninlinedObjectColumnCount() != 0) {
+        voltdb::TableIterator ti(this);
+        voltdb::TableTuple tuple(m_schema);
+        while (ti.next(tuple)) {
+            deleteFromAllIndexes(&tuple);
+            tuple.freeObjectColumns();
+            if (!releaseBlocks) {
+                deleteTupleStorage(tuple);
+            }
+        }
+    }
+    m_nonInlinedMemorySize = 0;
+    if (!releaseBlocks) {
+        return;
+    }
+
+    VOLT_DEBUG("Dropping %d tuples in %d blocks of table '%s'",
+               (int)m_tupleCount, (int)m_data.size(), name().c_str());
+    for (std::vector<char*>::iterator iter = m_data.begin(); iter != m_data.end(); ++iter) {
+        delete[] *iter;
+    }
+    m_data.clear();
+#ifndef MEMCHECK_NOFREELIST
+    m_holeFreeTuples.clear();
+#endif
+    m_tupleCount = 0;
+    m_usedTuples = 0;
+    m_allocatedTuples = 0;
+}
+
+void PersistentTable::beginBulkLoad() {
+    m_bulkLoadStart = m_usedTuples;
+}
+
+bool PersistentTable::appendTupleForBulkLoad(TableTuple &source) {
+    if (!checkNulls(source)) {
+        return false;
+    }
+    // always append, so the loaded tuples are the slots from m_bulkLoadStart on
+    if (m_usedTuples >= m_allocatedTuples) {
+        allocateNextBlock();
+    }
+    m_tmpTarget1.move(dataPtrForTuple((int) m_usedTuples));
+    ++m_usedTuples;
+    ++m_tupleCount;
+
+    m_tmpTarget1.copy(source);
+    m_tmpTarget1.setDeletedFalse();
+    m_tmpTarget1.setEvictedFalse();
+    if (m_COWContext.get() != NULL) {
+        m_COWContext->markTupleDirty(m_tmpTarget1, true);
+    } else {
+        m_tmpTarget1.setDirtyFalse();
+    }
+    if (m_schema->getUninlinedObjectColumnCount() != 0) {
+        m_nonInlinedMemorySize += m_tmpTarget1.getNonInlinedMemorySize();
+    }
+    return true;
+}
+
+/*
+ * Every index gets the whole batch at once, so the keys can be sorted
+ * before they go in. Views, export and the anti-cache see the tuples
+ * only once the load is known to be good.
+ */
+bool PersistentTable::finishBulkLoad() {
+    std::vector<char*> tuples;
+    tuples.reserve(m_usedTuples - m_bulkLoadStart);
+    for (uint32_t i = m_bulkLoadStart; i < m_usedTuples; ++i) {
+        tuples.push_back(dataPtrForTuple((int) i));
+    }
+
+    TableTuple tuple(m_schema);
+    for (int i = 0; i < m_indexCount; ++i) {
+        if (!m_indexes[i]->addEntries(tuples)) {
+            VOLT_ERROR("Bulk load of %d tuples into table '%s' has duplicate keys for index '%s'",
+                       (int)tuples.size(), name().c_str(), m_indexes[i]->getName().c_str());
+            while (i-- > 0) {
+                for (std::vector<char*>::iterator iter = tuples.begin(); iter != tuples.end(); ++iter) {
+                    tuple.move(*iter);
+                    m_indexes[i]->deleteEntry(&tuple);
+                }
+            }
+            abortBulkLoad();
+            return false;
+        }
+    }
+
+    for (std::vector<char*>::iterator iter = tuples.begin(); iter != tuples.end(); ++iter) {
+        tuple.move(*iter);
+        for (int i = 0; i < m_views.size(); i++) {
+            m_views[i]->processTupleInsert(tuple);
+        }
+        if (m_exportEnabled) {
+            appendToELBuffer(tuple, m_tsSeqNo++, TupleStreamWrapper::INSERT);
+        }
+#ifdef ANTICACHE
+        m_executorContext->getAntiCacheEvictionManager()->updateTuple(this, &tuple, true);
+#endif
+    }
+    return true;
+}
+
+void PersistentTable::abortBulkLoad() {
+    TableTuple tuple(m_schema);
+    for (uint32_t i = m_bulkLoadStart; i < m_usedTuples; ++i) {
+        tuple.move(dataPtrForTuple((int) i));
+        if (m_schema->getUninlinedObjectColumnCount() != 0) {
+            m_nonInlinedMemorySize -= tuple.getNonInlinedMemorySize();
+            tuple.freeObjectColumns();
+        }
+        tuple.setDeletedTrue();
+    }
+    VOLT_DEBUG("Dropping %d bulk loaded tuples of table '%s'",
+               (int)(m_usedTuples - m_bulkLoadStart), name().c_str());
+    m_tupleCount -= m_usedTuples - m_bulkLoadStart;
+    m_usedTuples = m_bulkLoadStart;
+
+#ifndef MEMCHECK_NOFREELIST
+    // free the blocks the load allocated
+    while (!m_data.empty() && m_allocatedTuples - m_tuplesPerBlock >= m_usedTuples) {
+        delete[] m_data.back();
+        m_data.pop_back();
+        m_allocatedTuples -= m_tuplesPerBlock;
+    }
+#endif
+}
+
+void PersistentTable::releaseTruncatedBlocks(PersistentTableUndoTruncateAction *action) {
+    /*
+     * Before deleting the blocks free any allocated strings.
+     * Persistent tables are responsible for managing the life of
+     * strings stored in the table.
+     */
+    if (m_schema->getUninlinedObjectColumnCount() != 0) {
+        TableTuple tuple(m_schema);
+        for (uint32_t i = 0; i < action->m_usedTuples; ++i) {
+            tuple.move(action->m_blocks[i / m_tuplesPerBlock] + ((i % m_tuplesPerBlock) * m_tupleLength));
+            if (tuple.isActive()) {
+                tuple.freeObjectColumns();
+            }
+        }
+    }
+    for (std::vector<char*>::iterator iter = action->m_blocks.begin(); iter != action->m_blocks.end(); ++iter) {
+        delete[] *iter;
+    }
+    action->m_blocks.clear();
+}
+
 void setSearchKeyFromTuple(TableTuple &source) {
     keyTuple.setNValue(0, source.getNValue(1));
     keyTuple.setNValue(1, source.getNValue(2));
@@ -1123,7 +1441,18 @@ voltdb::TableTuple PersistentTable::lookupTuple(TableTuple tuple) {
         // try secondary indexes
         for (int i = m_indexCount - 1; i >= 0;--i) {
             if (m_indexes[i]->moveToTuple(&tuple)) {
-                return m_indexes[i]->nextValueAtKey();
+                if (m_indexes[i]->isUniqueIndex()) {
+                    return m_indexes[i]->nextValueAtKey();
+                }
+                // a non-unique key may be shared by other tuples, so
+                // compare the whole tuple against every entry at the key
+                TableTuple indexTuple = m_indexes[i]->nextValueAtKey();
+                while (!indexTuple.isNullTuple()) {
+                    if (indexTuple.equalsNoSchemaCheck(tuple)) {
+                        return indexTuple;
+                    }
+                    indexTuple = m_indexes[i]->nextValueAtKey();
+                }
             }
         }
 
@@ -113,6 +113,7 @@ namespace voltdb {
 	class ExecutorContext;
 	class MaterializedViewMetadata;
 	class RecoveryProtoMsg;
+	class PersistentTableUndoTruncateAction;
 
 #ifdef ANTICACHE
 	class EvictedTable;
@@ -203,6 +204,32 @@ namespace voltdb {
     bool deleteTuple(TableTuple &tuple, bool freeAllocatedStrings);
     void deleteTupleForUndo(voltdb::TableTuple &tupleCopy, size_t elMark);
 
+    /*
+     * Drop every tuple without undo, for data that has been moved out of
+     * the engine (VoltDBEngine::extractTable).
+     */
+    void dropAllTuples();
+
+    /*
+     * Bulk loading (VoltDBEngine::loadTableFromFile). Tuples are appended
+     * after the last used slot without touching the indexes, views or
+     * export, and finishBulkLoad() then adds them to every index at once.
+     * If that fails, or abortBulkLoad() is called, the table is truncated
+     * back to where the load began. No undo actions are registered.
+     */
+    void beginBulkLoad();
+    /* takes over the strings of the source tuple rather than copying them */
+    bool appendTupleForBulkLoad(TableTuple &source);
+    bool finishBulkLoad();
+    void abortBulkLoad();
+
+    /*
+     * Give the blocks handed over to the undo action by truncateBlocks()
+     * back to the table, or free them once the transaction is done.
+     */
+    void truncateBlocksForUndo(PersistentTableUndoTruncateAction *action);
+    void releaseTruncatedBlocks(PersistentTableUndoTruncateAction *action);
+
     /*
      * Lookup the address of the tuple that is identical to the specified tuple.
      * Does a primary key lookup or table scan if necessary.
@@ -311,6 +338,8 @@ namespace voltdb {
     void setEvictedTable(voltdb::Table *evictedTable);
     voltdb::Table* getEvictedTable(); 
     bool evictBlockToDisk(const long block_size, int num_blocks);
+    /** start reading the block in the background, readEvictedBlock() then waits for it */
+    void requestEvictedBlock(int16_t block_id);
     bool readEvictedBlock(int16_t block_id, int32_t tuple_offset);
     bool mergeUnevictedTuples();
     
@@ -321,6 +350,10 @@ namespace voltdb {
     uint32_t getOldestTupleID();
     void setNumTuplesInEvictionChain(int num_tuples);
     int getNumTuplesInEvictionChain(); 
+
+    // needed for CLOCK eviction
+    void setClockHand(uint32_t id);
+    uint32_t getClockHand();
     #endif
     
     void setEntryToNewAddressForAllIndexes(const TableTuple *tuple, const void* address);
@@ -336,6 +369,32 @@ namespace voltdb {
 
 protected:
     virtual void allocateNextBlock();
+
+    /*
+     * A stream is emptied after every batch of triggers has consumed it.
+     * When nothing references individual tuples (no indexes, views,
+     * export, snapshot or anti-cache) the whole set of blocks can be
+     * dropped at once instead of deleting the tuples one by one.
+     */
+    bool canTruncateBlocks() const;
+    bool canReleaseBlocks() const;
+    void truncateBlocks();
+
+    /*
+     * A window deletes its tuples in the order it inserted them. When a
+     * slide has expired every tuple in the first blockCount blocks, those
+     * blocks are handed over to an undo action the same way, and only the
+     * index entries are removed tuple by tuple. The remaining blocks move
+     * to the front of m_data, which changes the tuple IDs (not the
+     * addresses) of the tuples still in the table.
+     */
+    bool canTruncateHeadBlocks() const;
+    void truncateHeadBlocks(uint32_t blockCount);
+    /*
+     * Forget the slots of deleted tuples so that new tuples are appended
+     * behind the newest ones instead of filling holes at the head.
+     */
+    void dropFreeSlots();
     
     size_t allocatedBlockCount() const {
         return m_data.size();
@@ -413,6 +472,7 @@ protected:
     uint32_t m_newestTupleID; 
     
     int m_numTuplesInEvictionChain;
+    uint32_t m_clockHand;
     bool m_blockMerge;
     
     #endif
@@ -438,6 +498,9 @@ protected:
     // Snapshot stuff
     boost::scoped_ptr<CopyOnWriteContext> m_COWContext;
 
+    // first slot filled by the bulk load in progress
+    uint32_t m_bulkLoadStart;
+
     //Recovery stuff
     boost::scoped_ptr<RecoveryContext> m_recoveryContext;
 
@@ -103,6 +103,7 @@ Table::Table(int tableAllocationTargetSize) :
     m_columnHeaderSize(-1),
     m_columnNames(NULL),
     m_databaseId(-1),
+    m_relativeIndex(-1),
     m_name(""),
     m_ownsTupleSchema(true),
     m_tableAllocationTargetSize(tableAllocationTargetSize),
@@ -142,6 +143,7 @@ Table::Table(int tableAllocationTargetSize, bool enableMMAP) :
     m_columnHeaderSize(-1),
     m_columnNames(NULL),
     m_databaseId(-1),
+    m_relativeIndex(-1),
     m_name(""),
     m_ownsTupleSchema(true),
     m_tableAllocationTargetSize(tableAllocationTargetSize),
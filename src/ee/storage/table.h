@@ -141,6 +141,7 @@ class Table {
     friend class StatsSource;
     friend class EvictionIterator; 
     friend class WindowIterator;
+    friend class ReadWriteTracker;
 
   private:
     // no default constructor, no copy
@@ -277,6 +278,9 @@ public:
     // ------------------------------------------------------------------
     CatalogId databaseId() const;
     const std::string& name() const;
+    /** Index of the table in the catalog, or -1 for tables not in it */
+    int32_t relativeIndex() const { return m_relativeIndex; }
+    void setRelativeIndex(int32_t relativeIndex) { m_relativeIndex = relativeIndex; }
 
     virtual std::string tableType() const = 0;
     virtual std::string debug();
@@ -474,6 +478,7 @@ protected:
 
     // GENERAL INFORMATION
     CatalogId m_databaseId;
+    int32_t m_relativeIndex;
     std::string m_name;
 
     /* If this table owns the TupleSchema it is responsible for deleting it in the destructor */
@@ -588,7 +588,6 @@ Table* TableFactory::getWindowTable(
 		pTable->m_indexes = new TableIndex*[indexes.size()];
 		pTable->m_partitionColumn = partitionColumn;
 		pTable->addAllTriggers(triggers);
-		pTable->initWin();
 
 		if(triggers != NULL)
 			pTable->m_hasTriggers = true;
@@ -599,6 +598,8 @@ Table* TableFactory::getWindowTable(
 		for (int i = 0; i < indexes.size(); ++i) {
 			pTable->m_indexes[i] = TableIndexFactory::getInstance(indexes[i]);
 		}
+		// windows may add their own internal indexes on top of the catalog ones
+		pTable->initWin();
 		initConstraints(pTable);
 
     }
@@ -678,11 +679,12 @@ Table* TableFactory::getWindowTable(
 		pTable->m_indexCount = 1 + (int)indexes.size();
 		pTable->m_indexes = new TableIndex*[1 + indexes.size()];
 		pTable->m_indexes[0] = pTable->m_pkeyIndex;
-		pTable->initWin();
 
 		for (int i = 0; i < indexes.size(); ++i) {
 			pTable->m_indexes[i + 1] = TableIndexFactory::getInstance(indexes[i]);
 		}
+		// windows may add their own internal indexes on top of the catalog ones
+		pTable->initWin();
 		initConstraints(pTable);
 
     }
@@ -103,6 +103,8 @@ TimeWindow::TimeWindow(ExecutorContext *ctx, bool exportEnabled, int windowSize,
     m_activeWindowID = 0;
     m_currentEndWindowID = -1;
     m_ctx = ctx;
+    m_weIndex = NULL;
+    m_wsStageIndex = NULL;
 }
 
 TimeWindow::~TimeWindow()
@@ -112,8 +114,16 @@ TimeWindow::~TimeWindow()
 void TimeWindow::initWin()
 {
     setColumnIndices();
-    //TODO:  Look into improving performance by using index on WS_COLUMN
-    m_stageTable = TableFactory::getPersistentTable(this->databaseId(), m_ctx, this->name() + "_stage", const_cast<TupleSchema*>(this->schema()), this->columnNames(), -1, false, false);
+    TupleSchema *schema = const_cast<TupleSchema*>(this->schema());
+    // Tuples are kept ordered by their window IDs so that each slide only
+    // touches the tuples that leave or enter the window
+    m_weIndex = addWindowIndex(windowIndexScheme(this->name() + "_wend", schema, m_weColumn));
+
+    std::vector<TableIndexScheme> stageIndexes;
+    stageIndexes.push_back(windowIndexScheme(this->name() + "_stage_wstart", schema, m_wsColumn));
+    m_stageTable = TableFactory::getPersistentTable(this->databaseId(), m_ctx, this->name() + "_stage", schema, this->columnNames(), stageIndexes, -1, false, false);
+    m_wsStageIndex = m_stageTable->index(this->name() + "_stage_wstart");
+    assert(m_wsStageIndex != NULL);
 }
 
 void TimeWindow::initTimeWindowTuple(TableTuple &source, int32_t startWinID, int32_t endWinID)
@@ -228,43 +238,64 @@ void TimeWindow::windowEnds()
     TableTuple copy_tuple(m_schema);    
     //Allocate space for temporaly tuple
     copy_tuple.move(new char[copy_tuple.tupleLength()]);
-    //Remove expired tuple from window
-    TableIterator active_iter(static_cast<Table*>(this));
-    while(active_iter.hasNext())
+    //Collect the addresses first as deleting from the table updates the index being walked
+    std::vector<char*> tupleAddresses;
+
+    //Remove expired tuple from window, only the ones ending with the closed window
+    //Whole blocks of them at the head go at once, index entries included
+    expireHeadBlocks(m_weColumn, m_activeWindowID - 1);
+    TableTuple &searchTuple = tempTuple();
+    searchTuple.setNValue(m_weColumn, ValueFactory::getIntegerValue(m_activeWindowID - 1));
+    if (m_weIndex->moveToTuple(&searchTuple))
     {
-        active_iter.next(tuple);
-        VOLT_DEBUG("Checking for is ending with Window:  %s ending with Window ID: %d", tuple.debug("").c_str(), m_activeWindowID - 1);
-        if (TimeWindow::getWE(tuple) == (m_activeWindowID - 1))
+        TableTuple indexTuple = m_weIndex->nextValueAtKey();
+        while (!indexTuple.isNullTuple())
         {
-            VOLT_DEBUG("Delete expired tuple");
-            if (! (PersistentTable::deleteTuple(tuple, true)))
-            {
-                VOLT_DEBUG("Failed to delete expired tuple from this active window table");
-                return;
-            }
+            tupleAddresses.push_back(indexTuple.address());
+            indexTuple = m_weIndex->nextValueAtKey();
         }
     }
-    //Move tuple from stage to this window
-    TableIterator stage_iter(static_cast<Table*>(m_stageTable));
-    while(stage_iter.hasNext())
+    VOLT_DEBUG("Expiring %d tuples ending with Window ID: %d", (int)tupleAddresses.size(), m_activeWindowID - 1);
+    for (std::vector<char*>::iterator it = tupleAddresses.begin(); it != tupleAddresses.end(); ++it)
+    {
+        tuple.move(*it);
+        VOLT_DEBUG("Delete expired tuple %s", tuple.debug("").c_str());
+        if (! (deleteWindowTuple(tuple, true)))
+        {
+            VOLT_DEBUG("Failed to delete expired tuple from this active window table");
+            return;
+        }
+    }
+    keepArrivalOrder();
+
+    //Move tuple from stage to this window, the stage index is ordered on WSTART
+    tupleAddresses.clear();
+    m_wsStageIndex->moveToEnd(true);
+    TableTuple stageTuple = m_wsStageIndex->nextValue();
+    while (!stageTuple.isNullTuple() && TimeWindow::getWS(stageTuple) <= m_activeWindowID)
     {
-        stage_iter.next(tuple);
-        VOLT_DEBUG("Checking for is in Window:  %s is in Window ID %d?", tuple.debug("").c_str(), m_activeWindowID);
-        if ((TimeWindow::getWS(tuple) <= m_activeWindowID) && (m_activeWindowID <= TimeWindow::getWE(tuple)))
+        VOLT_DEBUG("Checking for is in Window:  %s is in Window ID %d?", stageTuple.debug("").c_str(), m_activeWindowID);
+        if (m_activeWindowID <= TimeWindow::getWE(stageTuple))
+        {
+            tupleAddresses.push_back(stageTuple.address());
+        }
+        stageTuple = m_wsStageIndex->nextValue();
+    }
+    for (std::vector<char*>::iterator it = tupleAddresses.begin(); it != tupleAddresses.end(); ++it)
+    {
+        tuple.move(*it);
+        VOLT_DEBUG("Copying tuple");
+        copy_tuple.copyForPersistentInsert(tuple);
+        VOLT_DEBUG("Move tuple from stage to this active window");
+        if (!(insertWindowTuple(copy_tuple)))
+        {
+            VOLT_DEBUG("Failed to insert tuple into this active window table");
+            return;
+        }
+        if (!(m_stageTable->deleteTuple(tuple, true)))
         {
-            VOLT_DEBUG("Copying tuple");
-            copy_tuple.copyForPersistentInsert(tuple);
-            VOLT_DEBUG("Move tuple from stage to this active window");
-            if (!(PersistentTable::insertTuple(copy_tuple)))
-            {
-                VOLT_DEBUG("Failed to insert tuple into this active window table");
-                return;
-            }
-            if (!(m_stageTable->deleteTuple(tuple, true)))
-            {
-                VOLT_DEBUG("Failed to remove moved tuple from stage table");
-                return;
-            }
+            VOLT_DEBUG("Failed to remove moved tuple from stage table");
+            return;
         }
     }
     m_activeWindowID++;
@@ -316,7 +347,7 @@ bool TimeWindow::insertTuple(TableTuple &source)
 bool TimeWindow::deleteTuple(TableTuple &tuple, bool deleteAllocatedStrings)
 {
     VOLT_DEBUG("TimeWindow DELETE TUPLE");
-    return PersistentTable::deleteTuple(tuple, deleteAllocatedStrings);
+    return deleteWindowTuple(tuple, deleteAllocatedStrings);
 }
 
 void TimeWindow::deleteAllTuples(bool deleteAllocatedStrings)
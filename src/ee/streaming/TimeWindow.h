@@ -138,6 +138,12 @@ class TimeWindow : public WindowTableTemp {
     /** Saving the executor context for later initialize the staging table */
     ExecutorContext* m_ctx;
 
+    /** Index on WEND of this window, used to find the tuples expiring at a slide */
+    TableIndex* m_weIndex;
+
+    /** Index on WSTART of the stage table, used to find the tuples entering the window at a slide */
+    TableIndex* m_wsStageIndex;
+
 
   public:
     ~TimeWindow();
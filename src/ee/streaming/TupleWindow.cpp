@@ -135,14 +135,25 @@ void TupleWindow::initWin() {
 					NValue::getTupleStorageSize(voltdb::VALUE_TYPE_INTEGER));
 			columnAllowNull.push_back(false);
 		}
-		//TODO:  Create unique index on keyValue column
 		voltdb::TupleSchema *keyTableSchema =
 				voltdb::TupleSchema::createTupleSchema(columnTypes,
 						columnLengths, columnAllowNull, true);
 
+		// Unique hash index on the group key so that the per-key window
+		// state is found in O(1) instead of scanning the whole key table.
+		// The key table stays a PersistentTable so that its updates are
+		// still covered by the transaction's undo log.
+		std::vector<int32_t> keyColumnIndices;
+		keyColumnIndices.push_back(0);
+		std::vector<voltdb::ValueType> keyColumnTypes;
+		keyColumnTypes.push_back(voltdb::VALUE_TYPE_INTEGER);
+		TableIndexScheme keyIndexScheme(this->name() + "_groupkey_pkey",
+				HASH_TABLE_INDEX, keyColumnIndices, keyColumnTypes, true, true,
+				keyTableSchema);
+
 		m_keyTable = TableFactory::getPersistentTable(this->databaseId(), m_ctx,
 				this->name() + "_groupkey", keyTableSchema, keyTableColumnNames,
-				-1, false, false);
+				keyIndexScheme, -1, false, false);
 	}
 	setColumnIndices();
 }
@@ -214,47 +225,45 @@ TableTuple TupleWindow::getKeyData(int32_t keyValue) {
 		throw("This is not a group window");
 	}
 	VOLT_DEBUG("Searching for key %d", keyValue);
-	//TODO:  Replace this with Index lookup
-	TableTuple tuple(m_keyTable->schema());
-	TableIterator key_iter(static_cast<Table*>(m_keyTable));
-	while (key_iter.hasNext()) {
-		key_iter.next(tuple);
-		if (TupleWindow::getGK(tuple) == keyValue) {
-			VOLT_DEBUG("\tFound key data");
-			m_tupleCount = TupleWindow::getTC(tuple);
-			m_activeWindowID = TupleWindow::getAW(tuple);
-			m_currentEndWindowID = TupleWindow::getCE(tuple);
-			VOLT_DEBUG("Key Tuple %s", tuple.debug("m_KeyTable").c_str());
-			return tuple;
-		}
+	TableTuple tuple = lookupKeyTuple(keyValue);
+	if (!tuple.isNullTuple()) {
+		VOLT_DEBUG("\tFound key data");
+		m_tupleCount = TupleWindow::getTC(tuple);
+		m_activeWindowID = TupleWindow::getAW(tuple);
+		m_currentEndWindowID = TupleWindow::getCE(tuple);
+		VOLT_DEBUG("Key Tuple %s", tuple.debug("m_KeyTable").c_str());
+		return tuple;
 	}
 	m_tupleCount = 0;
 	m_activeWindowID = -1;
 	m_currentEndWindowID = -1;
-	//Allocate space for new tuple
-	tuple.move(new char[tuple.tupleLength()]);
-	initKeyTableTuple(tuple, keyValue, m_tupleCount, m_activeWindowID,
+	TableTuple &newTuple = m_keyTable->tempTuple();
+	initKeyTableTuple(newTuple, keyValue, m_tupleCount, m_activeWindowID,
 			m_currentEndWindowID);
-	if (!(m_keyTable->insertTuple(tuple))) {
+	if (!(m_keyTable->insertTuple(newTuple))) {
 		VOLT_INFO("Failed to insert new tuple into table '%s'",
 				m_keyTable->name().c_str());
-		return tuple;
+		return newTuple;
 	}
-	//FIXME:  The 'tuple' from insert is not the same as the one that got inserted.
-	// It cannot be use for the update process, so now try to scan for the inserted tuple from the table.
-	TableIterator key_iter2(static_cast<Table*>(m_keyTable));
-	while (key_iter2.hasNext()) {
-		key_iter2.next(tuple);
-		if (TupleWindow::getGK(tuple) == keyValue) {
-			VOLT_DEBUG("Key Tuple %s", tuple.debug("m_KeyTable").c_str());
-			VOLT_DEBUG("Exit getKeyData");
-			return tuple;
-		}
-	}
-	VOLT_DEBUG("Can't find the inserted tuple");
+	// The tuple passed to insertTuple() is only a copy, so fetch the stored
+	// one back through the group key index for the later update.
+	tuple = lookupKeyTuple(keyValue);
+	VOLT_DEBUG("Key Tuple %s", tuple.debug("m_KeyTable").c_str());
+	VOLT_DEBUG("Exit getKeyData");
 	return tuple;
 }
 
+TableTuple TupleWindow::lookupKeyTuple(int32_t keyValue) {
+	TableIndex *keyIndex = m_keyTable->primaryKeyIndex();
+	assert(keyIndex != NULL);
+	TableTuple &searchTuple = m_keyTable->tempTuple();
+	searchTuple.setNValue(m_gkColumn, ValueFactory::getIntegerValue(keyValue));
+	if (keyIndex->moveToTuple(&searchTuple)) {
+		return keyIndex->nextValueAtKey();
+	}
+	return TableTuple(m_keyTable->schema());
+}
+
 void TupleWindow::saveKeyData(TableTuple &source) {
 	VOLT_DEBUG("Enter saveKeyData");
 	VOLT_DEBUG("Current Key Tuple %s", source.debug("m_KeyTable").c_str());
@@ -338,6 +347,11 @@ void TupleWindow::windowEnds(int32_t keyValue) {
 	//Allocate space for temporaly tuple
 	copy_tuple.move(new char[copy_tuple.tupleLength()]);
 	//Remove expired tuple from window
+	if (m_groupByIndex == GROUP_BY_NONE) {
+		// a group only expires its own tuples, so only an ungrouped window
+		// empties whole blocks from the head
+		expireHeadBlocks(m_weColumn, m_activeWindowID);
+	}
 	TableIterator active_iter(static_cast<Table*>(this));
 	while (active_iter.hasNext()) {
 		active_iter.next(tuple);
@@ -354,13 +368,16 @@ void TupleWindow::windowEnds(int32_t keyValue) {
 				tuple.debug("").c_str(), m_activeWindowID);
 		if (TupleWindow::getWE(tuple) == m_activeWindowID) {
 			VOLT_DEBUG("Delete expired tuple");
-			if (!(PersistentTable::deleteTuple(tuple, true))) {
+			if (!(deleteWindowTuple(tuple, true))) {
 				VOLT_INFO("Failed to delete expired tuple from table '%s'",
 						this->name().c_str());
 				return;
 			}
 		}
 	}
+	if (m_groupByIndex == GROUP_BY_NONE) {
+		keepArrivalOrder();
+	}
 	//Move tuple from stage to this window
 	TableIterator stage_iter(static_cast<Table*>(m_stageTable));
 	while (stage_iter.hasNext()) {
@@ -380,7 +397,7 @@ void TupleWindow::windowEnds(int32_t keyValue) {
 			VOLT_DEBUG("Copying tuple");
 			copy_tuple.copyForPersistentInsert(tuple);
 			VOLT_DEBUG("Move tuple from stage to this active window");
-			if (!(PersistentTable::insertTuple(copy_tuple))) {
+			if (!(insertWindowTuple(copy_tuple))) {
 				VOLT_INFO("Failed to insert tuple into table %s",
 						this->name().c_str());
 				return;
@@ -409,6 +426,13 @@ int64_t TupleWindow::getStageActiveTupleCount() {
 	return m_stageTable->activeTupleCount();
 }
 
+int64_t TupleWindow::getKeyActiveTupleCount() {
+	if (m_groupByIndex == GROUP_BY_NONE) {
+		return 0;
+	}
+	return m_keyTable->activeTupleCount();
+}
+
 bool TupleWindow::insertTupleGroupByNone(TableTuple& source) {
 	bool windowEndsOccurred = false;
 	m_tupleCount++;
@@ -434,7 +458,7 @@ bool TupleWindow::insertTupleGroupByNone(TableTuple& source) {
 	if (windowEndsOccurred) {
 		// Put tuple in main
 		initTupleWindowTuple(source, m_activeWindowID, m_currentEndWindowID);
-		if (!(PersistentTable::insertTuple(source))) {
+		if (!(insertWindowTuple(source))) {
 			VOLT_INFO("Failed to insert tuple into table '%s'",
 					this->name().c_str());
 			return false;
@@ -483,7 +507,7 @@ bool TupleWindow::insertTupleGroupByIndex(TableTuple& source, int keyValue) {
 	if (windowEndsOccurred) {
 		// Put tuple in main
 		initTupleWindowTuple(source, m_activeWindowID, m_currentEndWindowID);
-		if (!(PersistentTable::insertTuple(source))) {
+		if (!(insertWindowTuple(source))) {
 			VOLT_INFO("Failed to insert tuple into table '%s'",
 					this->name().c_str());
 			return false;
@@ -524,7 +548,7 @@ bool TupleWindow::insertTuple(TableTuple &source) {
 
 bool TupleWindow::deleteTuple(TableTuple &tuple, bool deleteAllocatedStrings) {
 	VOLT_DEBUG("TupleWindow DELETE TUPLE");
-	return PersistentTable::deleteTuple(tuple, deleteAllocatedStrings);
+	return deleteWindowTuple(tuple, deleteAllocatedStrings);
 }
 
 void TupleWindow::deleteAllTuples(bool deleteAllocatedStrings) {
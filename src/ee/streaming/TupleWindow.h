@@ -167,6 +167,9 @@ private:
 	/** Get the window's data for a given key, the tuple return is always a tuple from the m_keyTable */
 	TableTuple getKeyData(int32_t keyValue);
 
+	/** Find the m_keyTable tuple for a given key through the group key index, returns a null tuple if the key is new */
+	TableTuple lookupKeyTuple(int32_t keyValue);
+
 	/** Update the window's data for a given key */
 	void saveKeyData(TableTuple &source);
 
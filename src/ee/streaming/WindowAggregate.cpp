@@ -0,0 +1,222 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "streaming/WindowAggregate.h"
+#include "streaming/WindowTableTemp.h"
+#include "common/SQLException.h"
+#include "common/tabletuple.h"
+#include "common/ValueFactory.hpp"
+
+namespace voltdb {
+
+WindowAggregate::WindowAggregate(ExpressionType type, int column) :
+	m_type(type), m_column(column), m_count(0)
+{
+	m_sum.setNull();
+}
+
+bool WindowAggregate::supports(ExpressionType type, ValueType columnType)
+{
+	switch (type) {
+	case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+	case EXPRESSION_TYPE_AGGREGATE_COUNT:
+		return true;
+	case EXPRESSION_TYPE_AGGREGATE_SUM:
+	case EXPRESSION_TYPE_AGGREGATE_AVG:
+		// exact types only: a DOUBLE sum drifts once values are subtracted
+		// again, and would no longer match a rescan of the window
+		switch (columnType) {
+		case VALUE_TYPE_TINYINT:
+		case VALUE_TYPE_SMALLINT:
+		case VALUE_TYPE_INTEGER:
+		case VALUE_TYPE_BIGINT:
+		case VALUE_TYPE_DECIMAL:
+			return true;
+		default:
+			return false;
+		}
+	case EXPRESSION_TYPE_AGGREGATE_MIN:
+	case EXPRESSION_TYPE_AGGREGATE_MAX:
+		// strings would point at tuple storage that is freed on expiry
+		return isNumeric(columnType) || columnType == VALUE_TYPE_DECIMAL ||
+				columnType == VALUE_TYPE_TIMESTAMP;
+	default:
+		return false;
+	}
+}
+
+bool WindowAggregate::insert(const TableTuple &tuple)
+{
+	if (m_type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+		m_count++;
+		return true;
+	}
+	return apply(tuple.getNValue(m_column), true);
+}
+
+bool WindowAggregate::remove(const TableTuple &tuple)
+{
+	if (m_type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+		m_count--;
+		return true;
+	}
+	return apply(tuple.getNValue(m_column), false);
+}
+
+bool WindowAggregate::apply(const NValue &value, bool inserted)
+{
+	if (value.isNull()) {
+		return true;
+	}
+	try {
+		switch (m_type) {
+		case EXPRESSION_TYPE_AGGREGATE_COUNT:
+			break;
+		case EXPRESSION_TYPE_AGGREGATE_SUM:
+		case EXPRESSION_TYPE_AGGREGATE_AVG:
+			if (inserted) {
+				m_sum = (m_count == 0) ? value : m_sum.op_add(value);
+			} else if (m_count == 1) {
+				m_sum.setNull();
+			} else {
+				m_sum = m_sum.op_subtract(value);
+			}
+			break;
+		case EXPRESSION_TYPE_AGGREGATE_MIN:
+		case EXPRESSION_TYPE_AGGREGATE_MAX:
+			if (inserted) {
+				m_values[value]++;
+			} else {
+				std::map<NValue, int64_t, NValue::ltNValue>::iterator it = m_values.find(value);
+				if (it == m_values.end()) {
+					return false;
+				}
+				if (--(it->second) == 0) {
+					m_values.erase(it);
+				}
+			}
+			break;
+		default:
+			return false;
+		}
+	} catch (SQLException &e) {
+		// a running SUM can overflow part way through a slide even if the
+		// final value fits; let the caller recompute from the window
+		return false;
+	}
+	m_count += inserted ? 1 : -1;
+	return true;
+}
+
+void WindowAggregate::clear()
+{
+	m_count = 0;
+	m_sum.setNull();
+	m_values.clear();
+}
+
+NValue WindowAggregate::result() const
+{
+	switch (m_type) {
+	case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+	case EXPRESSION_TYPE_AGGREGATE_COUNT:
+		return ValueFactory::getBigIntValue(m_count);
+	default:
+		break;
+	}
+	if (m_count == 0) {
+		return ValueFactory::getNullValue();
+	}
+	switch (m_type) {
+	case EXPRESSION_TYPE_AGGREGATE_SUM:
+		return m_sum;
+	case EXPRESSION_TYPE_AGGREGATE_AVG:
+		return m_sum.op_divide(ValueFactory::getDoubleValue(static_cast<double>(m_count)));
+	case EXPRESSION_TYPE_AGGREGATE_MIN:
+		return m_values.begin()->first;
+	case EXPRESSION_TYPE_AGGREGATE_MAX:
+		return m_values.rbegin()->first;
+	default:
+		return ValueFactory::getNullValue();
+	}
+}
+
+void WindowAggregateUndoAction::undo()
+{
+	m_window->invalidateAggregates();
+}
+
+void WindowAggregateUndoAction::release()
+{
+}
+
+}
@@ -0,0 +1,144 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * This file contains original code and/or modifications of original code.
+ * Any modifications made by VoltDB Inc. are licensed under the following
+ * terms and conditions:
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Copyright (C) 2008 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Copyright (C) 2017 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Author: S-Store Team (sstore.cs.brown.edu)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HSTOREWINDOWAGGREGATE_H
+#define HSTOREWINDOWAGGREGATE_H
+
+#include "common/types.h"
+#include "common/NValue.hpp"
+#include "common/UndoAction.h"
+
+#include <map>
+
+namespace voltdb {
+
+class TableTuple;
+class WindowTableTemp;
+
+/**
+ * A single aggregate (SUM, COUNT, COUNT(*), AVG, MIN or MAX over one column)
+ * kept up to date as tuples enter and leave a window, so reading it never
+ * rescans the window. SUM, COUNT and AVG are maintained from the insert and
+ * delete deltas, so SUM and AVG are limited to exact column types. MIN and
+ * MAX keep a count per distinct value in an ordered map, because windows do
+ * not always expire their oldest tuple first (grouped tuple windows, time
+ * windows expiring a batch in index order).
+ */
+class WindowAggregate {
+public:
+	WindowAggregate(ExpressionType type, int column);
+
+	/** Whether an aggregate of this type over a column of this type can be maintained */
+	static bool supports(ExpressionType type, ValueType columnType);
+
+	ExpressionType type() const { return m_type; }
+	int column() const { return m_column; }
+
+	/** Apply a tuple entering the window. Returns false if the running value overflowed */
+	bool insert(const TableTuple &tuple);
+	/** Apply a tuple leaving the window. Returns false if the running value overflowed */
+	bool remove(const TableTuple &tuple);
+	void clear();
+
+	/** The value an AggregateExecutor would compute over the current window contents */
+	NValue result() const;
+
+private:
+	bool apply(const NValue &value, bool inserted);
+
+	const ExpressionType m_type;
+	const int m_column;
+	int64_t m_count;
+	NValue m_sum;
+	std::map<NValue, int64_t, NValue::ltNValue> m_values;
+};
+
+/**
+ * Registered on the undo quantum of the first transaction that changes a
+ * window's aggregates. Undone tuple inserts and deletes bypass the window
+ * (see PersistentTable::insertTupleForUndo), so rolling back just marks the
+ * aggregates stale and the next read rebuilds them.
+ */
+class WindowAggregateUndoAction : public UndoAction {
+public:
+	WindowAggregateUndoAction(WindowTableTemp *window) : m_window(window) {}
+
+	void undo();
+	void release();
+
+private:
+	WindowTableTemp *m_window;
+};
+
+}
+
+#endif
@@ -76,6 +76,11 @@
 #include <list>
 
 #include "boost/scoped_ptr.hpp"
+#include "common/executorcontext.hpp"
+#include "common/SQLException.h"
+#include "common/UndoQuantum.h"
+#include "indexes/tableindexfactory.h"
+#include "storage/tableiterator.h"
 #include "streaming/WindowTableTemp.h"
 #include "streaming/WindowIterator.h"
 
@@ -97,10 +102,203 @@ WindowTableTemp::WindowTableTemp(ExecutorContext *ctx, bool exportEnabled, int w
 	this->m_newestWindowTupleID = 0;
 	this->m_oldestTupleID = 0;
 	this->m_firstTuple = true;
+	this->m_aggregatesValid = true;
+	this->m_aggregateUndoToken = INT64_MIN;
 }
 
 WindowTableTemp::~WindowTableTemp()
 {
+	for (int i = 0; i < m_aggregates.size(); i++) {
+		delete m_aggregates[i];
+	}
+}
+
+TableIndexScheme WindowTableTemp::windowIndexScheme(const std::string &name, TupleSchema *schema, int columnIndex)
+{
+	std::vector<int32_t> columnIndices;
+	columnIndices.push_back(columnIndex);
+	std::vector<ValueType> columnTypes;
+	columnTypes.push_back(schema->columnType(columnIndex));
+	return TableIndexScheme(name, BALANCED_TREE_INDEX, columnIndices, columnTypes, false, true, schema);
+}
+
+TableIndex* WindowTableTemp::addWindowIndex(const TableIndexScheme &scheme)
+{
+	assert(m_tupleCount == 0);
+	TableIndex *index = TableIndexFactory::getInstance(scheme);
+	TableIndex **indexes = new TableIndex*[m_indexCount + 1];
+	for (int i = 0; i < m_indexCount; ++i) {
+		indexes[i] = m_indexes[i];
+	}
+	indexes[m_indexCount++] = index;
+	if (m_indexes) delete[] m_indexes;
+	m_indexes = indexes;
+	return index;
+}
+
+int WindowTableTemp::registerAggregate(ExpressionType type, int column)
+{
+	for (int i = 0; i < m_aggregates.size(); i++) {
+		if (m_aggregates[i]->type() == type &&
+				(type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR || m_aggregates[i]->column() == column)) {
+			return i;
+		}
+	}
+	m_aggregates.push_back(new WindowAggregate(type, column));
+	// the window may already hold tuples the new aggregate has not seen
+	m_aggregatesValid = false;
+	return static_cast<int>(m_aggregates.size()) - 1;
+}
+
+NValue WindowTableTemp::aggregateResult(int slot)
+{
+	assert(slot >= 0 && slot < m_aggregates.size());
+	if (!m_aggregatesValid) {
+		rebuildAggregates();
+	}
+	return m_aggregates[slot]->result();
+}
+
+void WindowTableTemp::invalidateAggregates()
+{
+	m_aggregatesValid = false;
+	m_aggregateUndoToken = INT64_MIN;
+}
+
+void WindowTableTemp::rebuildAggregates()
+{
+	VOLT_DEBUG("Rebuilding %d aggregates of window '%s'", (int)m_aggregates.size(), name().c_str());
+	for (int i = 0; i < m_aggregates.size(); i++) {
+		m_aggregates[i]->clear();
+	}
+	TableIterator iter(this);
+	TableTuple tuple(m_schema);
+	while (iter.next(tuple)) {
+		for (int i = 0; i < m_aggregates.size(); i++) {
+			if (!m_aggregates[i]->insert(tuple)) {
+				// let the overflow surface the way a full aggregation would
+				m_aggregates[i]->clear();
+				throw SQLException(SQLException::data_exception_numeric_value_out_of_range,
+						"Aggregate over window overflowed");
+			}
+		}
+	}
+	m_aggregatesValid = true;
+}
+
+void WindowTableTemp::registerAggregateUndo()
+{
+	UndoQuantum *undoQuantum = m_executorContext->getCurrentUndoQuantum();
+	assert(undoQuantum);
+	if (undoQuantum->isDummy() || undoQuantum->getUndoToken() == m_aggregateUndoToken) {
+		return;
+	}
+	m_aggregateUndoToken = undoQuantum->getUndoToken();
+	Pool *pool = undoQuantum->getDataPool();
+	undoQuantum->registerUndoAction(
+			new (pool->allocate(sizeof(WindowAggregateUndoAction))) WindowAggregateUndoAction(this));
+}
+
+bool WindowTableTemp::insertWindowTuple(TableTuple &source)
+{
+	if (!PersistentTable::insertTuple(source)) {
+		return false;
+	}
+	if (!m_aggregates.empty()) {
+		registerAggregateUndo();
+		for (int i = 0; m_aggregatesValid && i < m_aggregates.size(); i++) {
+			if (!m_aggregates[i]->insert(source)) {
+				m_aggregatesValid = false;
+			}
+		}
+	}
+	return true;
+}
+
+void WindowTableTemp::removeFromAggregates(TableTuple &tuple)
+{
+	for (int i = 0; m_aggregatesValid && i < m_aggregates.size(); i++) {
+		if (!m_aggregates[i]->remove(tuple)) {
+			m_aggregatesValid = false;
+		}
+	}
+}
+
+bool WindowTableTemp::deleteWindowTuple(TableTuple &tuple, bool deleteAllocatedStrings)
+{
+	// the values have to be read before the tuple's storage is released
+	if (!m_aggregates.empty()) {
+		registerAggregateUndo();
+		removeFromAggregates(tuple);
+	}
+	return PersistentTable::deleteTuple(tuple, deleteAllocatedStrings);
+}
+
+int WindowTableTemp::expireHeadBlocks(int weColumn, int32_t windowID)
+{
+	// staged tuples are flagged as deleted but still own their slots
+	if (m_numStagedTuples != 0 || !canTruncateHeadBlocks()) {
+		return 0;
+	}
+	TableTuple tuple(m_schema);
+	uint32_t blocks = 0;
+	int expired = 0;
+	bool expiring = true;
+	// the block still being filled is left to the caller
+	while (expiring && (blocks + 1) * m_tuplesPerBlock <= m_usedTuples) {
+		int inBlock = 0;
+		const uint32_t end = (blocks + 1) * m_tuplesPerBlock;
+		for (uint32_t i = blocks * m_tuplesPerBlock; expiring && i < end; i++) {
+			tuple.move(dataPtrForTuple((int) i));
+			if (tuple.isActive()) {
+				expiring = tuple.getNValue(weColumn).getInteger() == windowID;
+				inBlock++;
+			}
+		}
+		if (expiring) {
+			blocks++;
+			expired += inBlock;
+		}
+	}
+	if (blocks == 0) {
+		return 0;
+	}
+	VOLT_DEBUG("Expiring %d tuples in %d head blocks of window '%s'", expired, (int)blocks, name().c_str());
+
+	if (!m_aggregates.empty()) {
+		registerAggregateUndo();
+		for (uint32_t i = 0; i < blocks * m_tuplesPerBlock; i++) {
+			tuple.move(dataPtrForTuple((int) i));
+			if (tuple.isActive()) {
+				removeFromAggregates(tuple);
+			}
+		}
+	}
+	truncateHeadBlocks(blocks);
+	return expired;
+}
+
+void WindowTableTemp::keepArrivalOrder()
+{
+	// without the truncation the dropped slots would never be reused
+	if (m_numStagedTuples == 0 && canTruncateHeadBlocks()) {
+		dropFreeSlots();
+	}
+}
+
+bool WindowTableTemp::updateTuple(TableTuple &source, TableTuple &target, bool updatesIndexes)
+{
+	if (!m_aggregates.empty()) {
+		registerAggregateUndo();
+		m_aggregatesValid = false;
+	}
+	return PersistentTable::updateTuple(source, target, updatesIndexes);
+}
+
+void WindowTableTemp::processLoadedTuple(bool allowExport, TableTuple &tuple)
+{
+	PersistentTable::processLoadedTuple(allowExport, tuple);
+	m_aggregatesValid = false;
 }
 
 void WindowTableTemp::markTupleForStaging(TableTuple &source)
@@ -160,7 +358,7 @@ bool WindowTableTemp::removeOldestTuple()
 	//to a non-deleted state so that the delete command will work.  This is horrible and needs to be fixed.
 	markTupleForWindow(tuple);
 
-	return PersistentTable::deleteTuple(tuple, true);
+	return deleteWindowTuple(tuple, true);
 }
 
 void WindowTableTemp::setNewestTupleID(uint32_t id)
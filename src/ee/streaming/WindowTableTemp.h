@@ -74,6 +74,10 @@
 #define HSTOREWINDOWTABLETEMP_H
 
 #include "storage/persistenttable.h"
+#include "indexes/tableindex.h"
+#include "streaming/WindowAggregate.h"
+
+#include <vector>
 
 namespace voltdb {
 
@@ -147,8 +151,46 @@ class WindowTableTemp : public PersistentTable {
 
 	virtual void initWin() {}//every window type must have an initialize function
 
+	// ------------------------------------------------------------------
+	// INCREMENTAL AGGREGATES
+	// ------------------------------------------------------------------
+	/** Start maintaining an aggregate over the active tuples of this window.
+	 *  Returns the slot to read it from; equal aggregates share a slot. */
+	int registerAggregate(ExpressionType type, int column);
+	/** Current value of a registered aggregate, rebuilding stale ones first */
+	NValue aggregateResult(int slot);
+	int aggregateCount() const { return static_cast<int>(m_aggregates.size()); }
+	/** Drop the maintained values; the next read recomputes them from the window */
+	void invalidateAggregates();
+
+	/** Updates and bulk loads change the window in place, so they invalidate its aggregates */
+	bool updateTuple(TableTuple &source, TableTuple &target, bool updatesIndexes);
+	void processLoadedTuple(bool allowExport, TableTuple &tuple);
+
+	/** Build a non-unique tree index on an INTEGER column of the given table's schema */
+	static TableIndexScheme windowIndexScheme(const std::string &name, TupleSchema *schema, int columnIndex);
+
 
   protected:
+	/** Add an index that is internal to the window (not from the catalog).
+	 *  Must be called before any tuple is inserted. */
+	TableIndex* addWindowIndex(const TableIndexScheme &scheme);
+
+	/** Insert into / delete from the active window (not the stage), keeping
+	 *  registered aggregates up to date. Windows must move tuples in and out
+	 *  of themselves through these rather than PersistentTable directly. */
+	bool insertWindowTuple(TableTuple &source);
+	bool deleteWindowTuple(TableTuple &tuple, bool deleteAllocatedStrings);
+
+	/** Expire, as a single step, the leading blocks in which every active
+	 *  tuple ends with windowID, and return the number of tuples expired.
+	 *  The caller still deletes the other expiring tuples one by one. Only
+	 *  for windows in which every tuple expires in turn. */
+	int expireHeadBlocks(int weColumn, int32_t windowID);
+	/** Once a slide's tuples are gone, append the next tuples behind the
+	 *  newest ones so that the following blocks empty out in order too */
+	void keepArrivalOrder();
+
 	int m_windowSize;
 	int m_slideSize;
 	int m_numStagedTuples;
@@ -157,6 +199,14 @@ class WindowTableTemp : public PersistentTable {
 	uint32_t m_newestTupleID;
 	bool m_firstTuple;
 
+  private:
+	void registerAggregateUndo();
+	void removeFromAggregates(TableTuple &tuple);
+	void rebuildAggregates();
+
+	std::vector<WindowAggregate*> m_aggregates;
+	bool m_aggregatesValid;
+	int64_t m_aggregateUndoToken;
 };
 }
 
@@ -50,6 +50,7 @@
 #include "common/tabletuple.h"
 #include "storage/table.h"
 #include "storage/tablefactory.h"
+#include <cstdlib>
 #include <vector>
 #include <string>
 
@@ -63,6 +64,18 @@ vector<string> TriggerStats::generateTriggerStatsColumnNames() {
     vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
     columnNames.push_back("TRIGGER_NAME");
     columnNames.push_back("EXECUTION_LATENCY");
+    columnNames.push_back("FIRINGS");
+    columnNames.push_back("FIRING_P50");
+    columnNames.push_back("FIRING_P99");
+    columnNames.push_back("FIRING_P999");
+    columnNames.push_back("FIRING_MAX");
+    columnNames.push_back("FRAGMENT_EXECUTIONS");
+    columnNames.push_back("FRAGMENT_P50");
+    columnNames.push_back("FRAGMENT_P99");
+    columnNames.push_back("FRAGMENT_P999");
+    columnNames.push_back("FRAGMENT_MAX");
+    columnNames.push_back("SLOWEST_FRAGMENT_ID");
+    columnNames.push_back("SLOWEST_FRAGMENT_P99");
     
     return columnNames;
 }
@@ -75,6 +88,11 @@ void TriggerStats::populateTriggerStatsSchema(
     StatsSource::populateBaseSchema(types, columnLengths, allowNull);
     types.push_back(VALUE_TYPE_VARCHAR); columnLengths.push_back(4096); allowNull.push_back(false);
     types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);
+    // count, p50, p99, p999 and max, for firings and then for all fragments,
+    // followed by the id and p99 of the slowest fragment
+    for (int ii = 0; ii < 12; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);
+    }
 }
 
 Table*
@@ -158,6 +176,52 @@ void TriggerStats::updateStatsTuple(TableTuple *tuple) {
                       getBigIntValue(latency));
     
     VOLT_DEBUG("updateStatsTuple - latency - %ld", latency);
+
+    updateHistogramColumns(tuple, "FIRING", "FIRINGS", m_trigger->firingLatency());
+
+    // the fragment columns summarize every plan fragment of the trigger;
+    // the slowest one by p99 is reported on its own
+    const vector<const catalog::PlanFragment*> &frags = *m_trigger->getFragments();
+    LatencyHistogram fragments;
+    int64_t slowestId = -1;
+    int64_t slowestP99 = 0;
+    for (size_t ii = 0; ii < frags.size(); ii++) {
+        const LatencyHistogram &histogram = m_trigger->fragmentLatency(ii);
+        if (histogram.count() == 0)
+            continue;
+        fragments.merge(histogram);
+        if (slowestId == -1 || histogram.percentile(0.99) > slowestP99) {
+            slowestId = atol(frags[ii]->name().c_str());
+            slowestP99 = histogram.percentile(0.99);
+        }
+    }
+    updateHistogramColumns(tuple, "FRAGMENT", "FRAGMENT_EXECUTIONS", fragments);
+    tuple->setNValue(StatsSource::m_columnName2Index["SLOWEST_FRAGMENT_ID"],
+                     ValueFactory::getBigIntValue(slowestId));
+    tuple->setNValue(StatsSource::m_columnName2Index["SLOWEST_FRAGMENT_P99"],
+                     ValueFactory::getBigIntValue(slowestP99));
+
+    if (interval()) {
+        m_trigger->firingLatency().reset();
+        for (size_t ii = 0; ii < frags.size(); ii++) {
+            m_trigger->fragmentLatency(ii).reset();
+        }
+    }
+}
+
+void TriggerStats::updateHistogramColumns(TableTuple *tuple, const std::string &prefix,
+                                          const std::string &countColumn,
+                                          const LatencyHistogram &histogram) {
+    tuple->setNValue(StatsSource::m_columnName2Index[countColumn],
+                     ValueFactory::getBigIntValue(histogram.count()));
+    tuple->setNValue(StatsSource::m_columnName2Index[prefix + "_P50"],
+                     ValueFactory::getBigIntValue(histogram.percentile(0.5)));
+    tuple->setNValue(StatsSource::m_columnName2Index[prefix + "_P99"],
+                     ValueFactory::getBigIntValue(histogram.percentile(0.99)));
+    tuple->setNValue(StatsSource::m_columnName2Index[prefix + "_P999"],
+                     ValueFactory::getBigIntValue(histogram.percentile(0.999)));
+    tuple->setNValue(StatsSource::m_columnName2Index[prefix + "_MAX"],
+                     ValueFactory::getBigIntValue(histogram.max()));
 }
 
 /**
@@ -47,6 +47,7 @@
 
 #include "stats/StatsSource.h"
 #include "common/ids.h"
+#include "common/LatencyHistogram.hpp"
 #include <vector>
 #include <string>
 
@@ -124,6 +125,13 @@ protected:
     virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths, std::vector<bool> &allowNull);
 
 private:
+    /**
+     * Fill the count, percentile and max columns of one latency histogram.
+     */
+    void updateHistogramColumns(voltdb::TableTuple *tuple, const std::string &prefix,
+                                const std::string &countColumn,
+                                const voltdb::LatencyHistogram &histogram);
+
     /**
      * Table whose stats are being collected.
      */
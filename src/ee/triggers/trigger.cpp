@@ -114,6 +114,7 @@ Trigger::Trigger(const int32_t id, const string &name, const catalog::CatalogMap
 		}
 	}
 	VOLT_DEBUG("m_frag size %d", int(m_frags->size()));
+	m_fragmentLatencies.resize(m_frags->size());
 	VOLT_DEBUG("END TRIGGER CONSTRUCTOR");
 }
 
@@ -218,4 +219,17 @@ vector<const catalog::PlanFragment*>* Trigger::getFragments() {
 	return m_frags;
 }
 
+void Trigger::setExecutorVectors(const vector<ExecutorVector*> &executorVectors) {
+	assert(executorVectors.size() == m_frags->size());
+	m_executorVectors = executorVectors;
+}
+
+const vector<ExecutorVector*>& Trigger::getExecutorVectors() const {
+	return m_executorVectors;
+}
+
+void Trigger::clearExecutorVectors() {
+	m_executorVectors.clear();
+}
+
 }
@@ -86,10 +86,13 @@
 #include "catalog/planfragment.h"
 //#include "execution/VoltDBEngine.h"
 #include "common/executorcontext.hpp"
+#include "common/LatencyHistogram.hpp"
 #include "triggers/TriggerStats.h"
 
 namespace voltdb {
 
+struct ExecutorVector;
+
 /**
  * Represents a trigger that is attached to a table.
  */
@@ -105,10 +108,16 @@ class Trigger {
     int32_t m_id;
     std::string m_name;
     vector<const catalog::PlanFragment*>* m_frags;
+    // executors of m_frags, in the same order; resolved by the engine
+    vector<ExecutorVector*> m_executorVectors;
     unsigned char m_type; //0=insert, 1=update, 2=delete
     bool m_forEach;
     Table *m_sourceTable;
     int64_t m_latency;
+    // wall time of whole firings, and of the runs of each plan fragment
+    // within them, indexed like m_frags
+    LatencyHistogram m_firingLatency;
+    vector<LatencyHistogram> m_fragmentLatencies;
 
   public:
     // no default constructor, no copy
@@ -129,10 +138,25 @@ class Trigger {
 
     vector<const catalog::PlanFragment*>* getFragments();
 
+    void setExecutorVectors(const vector<ExecutorVector*> &executorVectors);
+    const vector<ExecutorVector*>& getExecutorVectors() const;
+    void clearExecutorVectors();
+
 	int32_t id() const;
 	std::string name() const;
 	int64_t latency() const;
 
+	inline void recordFiringLatency(int64_t nanos) {
+		m_latency = nanos;
+		m_firingLatency.record(nanos);
+	}
+	inline void recordFragmentLatency(size_t fragment, int64_t nanos) {
+		m_fragmentLatencies[fragment].record(nanos);
+	}
+	inline LatencyHistogram& firingLatency() { return m_firingLatency; }
+	/** Latencies of the fragment at the given position of getFragments() */
+	inline LatencyHistogram& fragmentLatency(size_t fragment) { return m_fragmentLatencies[fragment]; }
+
 	// STATS
 	voltdb::TriggerStats stats_;
 	voltdb::TriggerStats* getTriggerStats();
@@ -58,6 +58,7 @@
 #include "common/SegvException.hpp"
 #include "common/RecoveryProtoMessage.h"
 #include "common/TheHashinator.h"
+#include "common/SharedMemoryRing.h"
 #include "execution/IPCTopend.h"
 #include "execution/VoltDBEngine.h"
 
@@ -66,11 +67,14 @@
 #include <iostream>
 #include <string>
 #include <dlfcn.h>
+#include <fcntl.h>
 
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 
@@ -166,6 +170,17 @@ typedef struct {
     char data[0];
 }__attribute__((packed)) save_table_to_disk_cmd;
 
+/*
+ * Header for a request to move the connection onto shared memory rings.
+ * The file holds the ring from java followed by the ring to java.
+ */
+typedef struct {
+    struct ipc_command cmd;
+    int64_t ringCapacity;
+    int16_t pathLength;
+    char path[0];
+}__attribute__((packed)) shared_memory_cmd;
+
 struct undo_token {
     struct ipc_command cmd;
     int64_t token;
@@ -259,7 +274,8 @@ static VoltDBIPC *currentVolt = NULL;
 // defined in voltdbjni.cpp
 extern void deserializeParameterSetCommon(int, voltdb::ReferenceSerializeInput&, voltdb::GenericValueArray<voltdb::NValue>&, Pool *stringPool);
 
-VoltDBIPC::VoltDBIPC(int fd) : m_fd(fd) {
+VoltDBIPC::VoltDBIPC(int fd) : m_fd(fd), m_sharedMemory(NULL), m_sharedMemorySize(0),
+    m_fromJava(NULL), m_toJava(NULL) {
     currentVolt = this;
     m_engine = NULL;
     m_counter = 0;
@@ -273,6 +289,36 @@ VoltDBIPC::~VoltDBIPC() {
     delete m_engine;
     delete [] m_reusedResultBuffer;
     delete [] m_exceptionBuffer;
+    delete m_fromJava;
+    delete m_toJava;
+    if (m_sharedMemory != NULL) {
+        munmap(m_sharedMemory, m_sharedMemorySize);
+    }
+}
+
+void VoltDBIPC::writeOrDie(unsigned char *data, ssize_t sz) {
+    if (m_toJava == NULL) {
+        ::writeOrDie(m_fd, data, sz);
+    } else if (!m_toJava->write(reinterpret_cast<char*>(data), sz)) {
+        printf("\n\nIPC write to shared memory failed. Exiting\n\n");
+        fflush(stdout);
+        exit(-1);
+    }
+}
+
+bool VoltDBIPC::readFully(char *data, size_t sz) {
+    if (m_fromJava != NULL) {
+        return m_fromJava->read(data, sz);
+    }
+    size_t bytesread = 0;
+    while (bytesread < sz) {
+        ssize_t b = read(m_fd, data + bytesread, sz - bytesread);
+        if (b <= 0) {
+            return false;
+        }
+        bytesread += b;
+    }
+    return true;
 }
 
 bool VoltDBIPC::execute(struct ipc_command *cmd) {
@@ -354,6 +400,11 @@ bool VoltDBIPC::execute(struct ipc_command *cmd) {
           hashinate(cmd);
           result = kErrorCode_None;
           break;
+      case 24:
+          // answers over the socket before switching to the rings
+          useSharedMemory(cmd);
+          result = kErrorCode_None;
+          break;
       default:
         result = stub(cmd);
     }
@@ -366,9 +417,9 @@ bool VoltDBIPC::execute(struct ipc_command *cmd) {
             char msg[5];
             msg[0] = result;
             *reinterpret_cast<int32_t*>(&msg[1]) = 0;//exception length 0
-            writeOrDie(m_fd, (unsigned char*)msg, sizeof(int8_t) + sizeof(int32_t));
+            writeOrDie((unsigned char*)msg, sizeof(int8_t) + sizeof(int32_t));
         } else {
-            writeOrDie(m_fd, (unsigned char*)&result, sizeof(int8_t));
+            writeOrDie((unsigned char*)&result, sizeof(int8_t));
         }
     }
     return m_terminate;
@@ -605,7 +656,7 @@ void VoltDBIPC::executeQueryPlanFragmentsAndGetResults(struct ipc_command *cmd)
         const int32_t size = m_engine->getResultsSize();
         char *resultBuffer = m_engine->getReusedResultBuffer();
         resultBuffer[0] = kErrorCode_Success;
-        writeOrDie(m_fd, (unsigned char*)resultBuffer, size);
+        writeOrDie((unsigned char*)resultBuffer, size);
     } else {
         sendException(kErrorCode_Error);
     }
@@ -661,14 +712,14 @@ void VoltDBIPC::executePlanFragmentAndGetResults(struct ipc_command *cmd) {
         const int32_t size = m_engine->getResultsSize();
         char *resultBuffer = m_engine->getReusedResultBuffer();
         resultBuffer[0] = kErrorCode_Success;
-        writeOrDie(m_fd, (unsigned char*)resultBuffer, size);
+        writeOrDie((unsigned char*)resultBuffer, size);
     } else {
         sendException(kErrorCode_Error);
     }
 }
 
 void VoltDBIPC::sendException(int8_t errorCode) {
-    writeOrDie(m_fd, (unsigned char*)&errorCode, sizeof(int8_t));
+    writeOrDie((unsigned char*)&errorCode, sizeof(int8_t));
 
     const void* exceptionData =
       m_engine->getExceptionOutputSerializer()->data();
@@ -678,7 +729,7 @@ void VoltDBIPC::sendException(int8_t errorCode) {
     fflush(stdout);
 
     const std::size_t expectedSize = exceptionLength + sizeof(int32_t);
-    writeOrDie(m_fd, (unsigned char*)exceptionData, expectedSize);
+    writeOrDie((unsigned char*)exceptionData, expectedSize);
 }
 
 void VoltDBIPC::executeCustomPlanFragmentAndGetResults(struct ipc_command *cmd) {
@@ -709,11 +760,11 @@ void VoltDBIPC::executeCustomPlanFragmentAndGetResults(struct ipc_command *cmd)
     // write the results array back across the wire
     const int8_t successResult = kErrorCode_Success;
     if (errors == 0) {
-        writeOrDie(m_fd, (unsigned char*)&successResult, sizeof(int8_t));
+        writeOrDie((unsigned char*)&successResult, sizeof(int8_t));
         const int32_t size = m_engine->getResultsSize();
 
         // write the dependency tables back across the wire
-        writeOrDie(m_fd, (unsigned char*)(m_engine->getReusedResultBuffer()), size);
+        writeOrDie((unsigned char*)(m_engine->getReusedResultBuffer()), size);
     } else {
         sendException(kErrorCode_Error);
     }
@@ -781,14 +832,13 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
     // tell java to send the dependency over the socket
     message[0] = static_cast<int8_t>(kErrorCode_RetrieveDependency);
     *reinterpret_cast<int32_t*>(&message[1]) = htonl(dependencyId);
-    writeOrDie(m_fd, (unsigned char*)message, sizeof(int8_t) + sizeof(int32_t));
+    writeOrDie((unsigned char*)message, sizeof(int8_t) + sizeof(int32_t));
 
     // read java's response code
     int8_t responseCode;
-    ssize_t bytes = read(m_fd, &responseCode, sizeof(int8_t));
-    if (bytes != sizeof(int8_t)) {
-        printf("Error - blocking read failed. %jd read %jd attempted",
-                (intmax_t)bytes, (intmax_t)sizeof(int8_t));
+    if (!readFully(reinterpret_cast<char*>(&responseCode), sizeof(int8_t))) {
+        printf("Error - blocking read failed. %jd attempted",
+                (intmax_t)sizeof(int8_t));
         fflush(stdout);
         assert(false);
         exit(-1);
@@ -807,34 +857,20 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
 
     // start reading the dependency. its length is first
     int32_t dependencyLength;
-    bytes = read(m_fd, &dependencyLength, sizeof(int32_t));
-    if (bytes != sizeof(int32_t)) {
-        printf("Error - blocking read failed. %jd read %jd attempted",
-                (intmax_t)bytes, (intmax_t)sizeof(int32_t));
+    if (!readFully(reinterpret_cast<char*>(&dependencyLength), sizeof(int32_t))) {
+        printf("Error - blocking read failed. %jd attempted",
+                (intmax_t)sizeof(int32_t));
         fflush(stdout);
         assert(false);
         exit(-1);
     }
 
-    bytes = 0;
     dependencyLength = ntohl(dependencyLength);
     *dependencySz = (size_t)dependencyLength;
     char *dependencyData = new char[dependencyLength];
-    while (bytes != dependencyLength) {
-        ssize_t oldBytes = bytes;
-        bytes += read(m_fd, dependencyData + bytes, dependencyLength - bytes);
-        if (oldBytes == bytes) {
-            break;
-        }
-        if (oldBytes > bytes) {
-            bytes++;
-            break;
-        }
-    }
-
-    if (bytes != dependencyLength) {
-        printf("Error - blocking read failed. %jd read %jd attempted",
-                (intmax_t)bytes, (intmax_t)dependencyLength);
+    if (!readFully(dependencyData, dependencyLength)) {
+        printf("Error - blocking read failed. %jd attempted",
+                (intmax_t)dependencyLength);
         fflush(stdout);
         assert(false);
         exit(-1);
@@ -842,6 +878,53 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
     return dependencyData;
 }
 
+/**
+ * Move the connection onto a pair of rings in the file java created.
+ * The answer still goes over the socket, which from then on only
+ * carries the doorbell bytes that wake a parked reader or writer.
+ */
+void VoltDBIPC::useSharedMemory(struct ipc_command *cmd) {
+    shared_memory_cmd *sm = (shared_memory_cmd*) cmd;
+    size_t capacity = static_cast<size_t>(ntohll(sm->ringCapacity));
+    std::string path(sm->path, ntohs(sm->pathLength));
+    size_t size = 2 * (SharedMemoryRing::CONTROL_BYTES + capacity);
+
+    int8_t result = kErrorCode_Error;
+    int fd = open(path.c_str(), O_RDWR);
+    struct stat st;
+    if (m_sharedMemory != NULL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        printf("Invalid shared memory request for %s\n", path.c_str());
+    } else if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(size)) {
+        printf("Failed to open shared memory file %s\n", path.c_str());
+    } else {
+        void *region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (region == MAP_FAILED) {
+            printf("Failed to map shared memory file %s\n", path.c_str());
+        } else {
+            m_sharedMemory = static_cast<char*>(region);
+            m_sharedMemorySize = size;
+            result = kErrorCode_Success;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    fflush(stdout);
+
+    if (result == kErrorCode_Error) {
+        // java keeps using the socket
+        char msg[5];
+        msg[0] = result;
+        *reinterpret_cast<int32_t*>(&msg[1]) = 0;//exception length 0
+        writeOrDie((unsigned char*)msg, sizeof(int8_t) + sizeof(int32_t));
+        return;
+    }
+    writeOrDie((unsigned char*)&result, sizeof(int8_t));
+    m_fromJava = new SharedMemoryRing(m_sharedMemory, capacity, m_fd);
+    m_toJava = new SharedMemoryRing(m_sharedMemory + SharedMemoryRing::CONTROL_BYTES + capacity,
+                                    capacity, m_fd);
+}
+
 void VoltDBIPC::crashVoltDB(voltdb::FatalException e) {
     const char *reasonBytes = e.m_reason.c_str();
     int32_t reasonLength = static_cast<int32_t>(strlen(reasonBytes));
@@ -898,7 +981,7 @@ void VoltDBIPC::crashVoltDB(voltdb::FatalException e) {
         position += traceLength;
     }
 
-    writeOrDie(m_fd,  (unsigned char*)m_reusedResultBuffer, 5 + messageLength);
+    writeOrDie( (unsigned char*)m_reusedResultBuffer, 5 + messageLength);
     exit(-1);
 }
 
@@ -932,12 +1015,12 @@ void VoltDBIPC::getStats(struct ipc_command *cmd) {
         // write the results array back across the wire
         const int8_t successResult = kErrorCode_Success;
         if (result == 1) {
-            writeOrDie(m_fd, (unsigned char*)&successResult, sizeof(int8_t));
+            writeOrDie((unsigned char*)&successResult, sizeof(int8_t));
 
             // write the dependency tables back across the wire
             // the result set includes the total serialization size
             const int32_t size = m_engine->getResultsSize();
-            writeOrDie(m_fd, (unsigned char*)(m_engine->getReusedResultBuffer()), size);
+            writeOrDie((unsigned char*)(m_engine->getReusedResultBuffer()), size);
         } else {
             sendException(kErrorCode_Error);
         }
@@ -975,7 +1058,7 @@ void VoltDBIPC::tableStreamSerializeMore(struct ipc_command *cmd) {
         char msg[3];
         msg[0] = kErrorCode_Error;
         *reinterpret_cast<int16_t*>(&msg[1]) = 0;//exception length 0
-        writeOrDie(m_fd, (unsigned char*)msg, sizeof(int8_t) + sizeof(int16_t));
+        writeOrDie((unsigned char*)msg, sizeof(int8_t) + sizeof(int16_t));
     }
 
     try {
@@ -992,7 +1075,7 @@ void VoltDBIPC::tableStreamSerializeMore(struct ipc_command *cmd) {
             serialized = 0;
         }
         const ssize_t toWrite = serialized + 5;
-        writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, toWrite);
+        writeOrDie((unsigned char*)m_reusedResultBuffer, toWrite);
     } catch (FatalException e) {
         crashVoltDB(e);
     }
@@ -1014,7 +1097,7 @@ void VoltDBIPC::tableHashCode( struct ipc_command *cmd) {
     char response[9];
     response[0] = kErrorCode_Success;
     *reinterpret_cast<int64_t*>(&response[1]) = htonll(tableHashCode);
-    writeOrDie(m_fd, (unsigned char*)response, 9);
+    writeOrDie((unsigned char*)response, 9);
 }
 
 void VoltDBIPC::exportAction(struct ipc_command *cmd) {
@@ -1032,10 +1115,10 @@ void VoltDBIPC::exportAction(struct ipc_command *cmd) {
 
     // write offset across bigendian.
     result = htonll(result);
-    writeOrDie(m_fd, (unsigned char*)&result, sizeof(result));
+    writeOrDie((unsigned char*)&result, sizeof(result));
 
     // write the poll data. It is at least 4 bytes of length prefix.
-    writeOrDie(m_fd, (unsigned char*)(m_engine->getReusedResultBuffer()), buflength);
+    writeOrDie((unsigned char*)(m_engine->getReusedResultBuffer()), buflength);
 }
 
 void VoltDBIPC::hashinate(struct ipc_command* cmd)
@@ -1064,7 +1147,7 @@ void VoltDBIPC::hashinate(struct ipc_command* cmd)
     char response[5];
     response[0] = kErrorCode_Success;
     *reinterpret_cast<int32_t*>(&response[1]) = htonl(retval);
-    writeOrDie(m_fd, (unsigned char*)response, 5);
+    writeOrDie((unsigned char*)response, 5);
 }
 
 void VoltDBIPC::signalHandler(int signum, siginfo_t *info, void *context) {
@@ -1169,19 +1252,11 @@ int main(int argc, char **argv) {
     VoltDBIPC *voltipc = new VoltDBIPC(fd);
     int more = 1;
     while (more) {
-        size_t bytesread = 0;
-
         // read the header
-        while (bytesread < 4) {
-            std::size_t b = read(fd, data + bytesread, 4 - bytesread);
-            if (b == 0) {
-                printf("client eof\n");
-                goto done;
-            } else if (b == -1) {
-                printf("client error\n");
-                goto done;
-            }
-            bytesread += b;
+        size_t bytesread = 4;
+        if (!voltipc->readFully(data, 4)) {
+            printf("client eof\n");
+            goto done;
         }
 
         // read the message body in to the same data buffer
@@ -1196,16 +1271,12 @@ int main(int argc, char **argv) {
             data = newdata;
         }
 
-        while (bytesread < msg_size) {
-            std::size_t b = read(fd, data + bytesread, msg_size - bytesread);
-            if (b == 0) {
+        if (msg_size > 4) {
+            if (!voltipc->readFully(data + 4, msg_size - 4)) {
                 printf("client eof\n");
                 goto done;
-            } else if (b == -1) {
-                printf("client error\n");
-                goto done;
             }
-            bytesread += b;
+            bytesread = msg_size;
         }
 
         // dispatch the request
@@ -25,6 +25,7 @@
 #include "logging/LogProxy.h"
 #include "execution/VoltDBEngine.h"
 #include "common/FatalException.hpp"
+#include "common/SharedMemoryRing.h"
 
 class VoltDBIPC {
 public:
@@ -61,6 +62,13 @@ public:
 
     bool execute(struct ipc_command *cmd);
 
+    /**
+     * Blocking read of the next sz bytes from Java, off the socket or the
+     * shared memory ring once the connection has moved there.
+     * Returns false if Java has hung up.
+     */
+    bool readFully(char *data, size_t sz);
+
     /**
      * Log a statement on behalf of the IPC log proxy at the specified log level
      * @param LoggerId ID of the logger that received this statement
@@ -119,6 +127,11 @@ private:
 
     void hashinate(struct ipc_command* cmd);
 
+    void useSharedMemory(struct ipc_command *cmd);
+
+    /** Blocking write of all of data to Java, exits if Java is gone */
+    void writeOrDie(unsigned char *data, ssize_t sz);
+
     void sendException( int8_t errorCode);
 
     int8_t activateTableStream(struct ipc_command *cmd);
@@ -130,6 +143,12 @@ private:
     void setupSigHandler(void) const;
 
     int m_fd;
+
+    // rings shared with java, NULL while everything goes over the socket
+    char *m_sharedMemory;
+    size_t m_sharedMemorySize;
+    voltdb::SharedMemoryRing *m_fromJava;
+    voltdb::SharedMemoryRing *m_toJava;
     char *m_reusedResultBuffer;
     char *m_exceptionBuffer;
     bool m_terminate;
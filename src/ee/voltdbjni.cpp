@@ -667,25 +667,23 @@ Java_org_voltdb_jni_ExecutionEngine_nativeExecuteCustomPlanFragment (
 }
 
 /**
- * Executes multiple plan fragments with the given parameter sets and gets the results.
+ * Executes a batch of plan fragments described entirely by the parameter
+ * buffer registered with nativeSetBuffers: the fragment count, then all
+ * fragment ids, input dependency ids and output dependency ids, then one
+ * parameter set per fragment. VARCHAR and VARBINARY parameters point into
+ * the buffer rather than being copied into the string pool, and the
+ * results go to the registered result buffer.
  * @param pointer the VoltDBEngine pointer
- * @param plan_fragment_ids ID of the plan fragment to be executed.
- * @param outputBuffer buffer to be filled with the tables.
- * @param outputCapacity maximum number of bytes to write to buffer.
  * @return error code
 */
-SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecuteQueryPlanFragmentsAndGetResults
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecutePlanFragmentBatch
 (JNIEnv *env,
         jobject obj,
         jlong engine_ptr,
-        jlongArray plan_fragment_ids,
-        jint num_fragments,
-        jintArray input_depIds,
-        jintArray output_depIds,
         jlong txnId,
         jlong lastCommittedTxnId,
         jlong undoToken) {
-    //VOLT_DEBUG("nativeExecuteQueryPlanFragmentAndGetResults() start");
+    //VOLT_DEBUG("nativeExecutePlanFragmentBatch() start");
 
     // setup
     VoltDBEngine *engine = castToEngine(engine_ptr);
@@ -695,27 +693,28 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecu
         updateJNILogProxy(engine); //JNIEnv pointer can change between calls, must be updated
         engine->resetReusedResultOutputBuffer();
         engine->setUndoToken(undoToken);
-        static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
         Pool *stringPool = engine->getStringPool();
+        ReferenceSerializeInput serialize_in(engine->getParameterBuffer(), engine->getParameterBufferCapacity());
 
         // fragment info
-        int batch_size = num_fragments;
-        assert (batch_size <= MAX_BATCH_COUNT);
-        jlong* fragment_ids_buffer = engine->getBatchFragmentIdsContainer();
-        env->GetLongArrayRegion(plan_fragment_ids, 0, batch_size, fragment_ids_buffer);
-
-        /** PAVLO **/
-        // input dep ids
-        jint* input_depIds_buffer = engine->getBatchInputDepIdsContainer();
-        env->GetIntArrayRegion(input_depIds, 0, batch_size, input_depIds_buffer);
-        
-        // output dep ids
-        jint* output_depIds_buffer = engine->getBatchOutputDepIdsContainer();
-        env->GetIntArrayRegion(output_depIds, 0, batch_size, output_depIds_buffer);
-        /** PAVLO **/
+        int batch_size = serialize_in.readInt();
+        if (batch_size < 0 || batch_size > MAX_BATCH_COUNT) {
+            throwFatalException("invalid batch size: %d", batch_size);
+        }
+        int64_t* fragment_ids_buffer = engine->getBatchFragmentIdsContainer();
+        for (int i = 0; i < batch_size; ++i) {
+            fragment_ids_buffer[i] = serialize_in.readLong();
+        }
+        int32_t* input_depIds_buffer = engine->getBatchInputDepIdsContainer();
+        for (int i = 0; i < batch_size; ++i) {
+            input_depIds_buffer[i] = serialize_in.readInt();
+        }
+        int32_t* output_depIds_buffer = engine->getBatchOutputDepIdsContainer();
+        for (int i = 0; i < batch_size; ++i) {
+            output_depIds_buffer[i] = serialize_in.readInt();
+        }
 
-        // all fragments' parameters are in this buffer
-        ReferenceSerializeInput serialize_in(engine->getParameterBuffer(), engine->getParameterBufferCapacity());
+        // all fragments' parameters follow
         NValueArray &params = engine->getParameterContainer();
 
         // count failures
@@ -727,7 +726,9 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecu
                 throwFatalException("parameter count is negative: %d", cnt);
             }
             assert (cnt < MAX_PARAM_COUNT);
-            deserializeParameterSetCommon(cnt, serialize_in, params, stringPool);
+            for (int j = 0; j < cnt; ++j) {
+                params[j] = NValue::deserializeReferencingInput(serialize_in, stringPool);
+            }
 
             engine->setUsedParamcnt(cnt);
             // success is 0 and error is 1.
@@ -1331,6 +1332,54 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_utils_ThreadUtils_getNumCores
     return static_cast<jint>(NUM_PROCS);
 }
 
+// ----------------------------------------------------------------------------
+// EXECUTION OPTIONS
+// ----------------------------------------------------------------------------
+
+/**
+ * Toggle coalescing of stream trigger firings until the end of each fragment batch.
+ * @param pointer the VoltDBEngine pointer
+ * @param value whether to batch trigger firings
+ * @return error code
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeSetBatchTriggers(
+        JNIEnv *env,
+        jobject obj,
+        jlong engine_ptr,
+        jboolean value) {
+
+    VOLT_DEBUG("nativeSetBatchTriggers() start");
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+    }
+    static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    engine->setBatchTriggers(value == JNI_TRUE);
+    return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
+}
+
+/**
+ * Toggle pipelining of executors for the plan fragments loaded afterwards.
+ * @param pointer the VoltDBEngine pointer
+ * @param value whether to pipeline executors
+ * @return error code
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeSetPipelineExecutors(
+        JNIEnv *env,
+        jobject obj,
+        jlong engine_ptr,
+        jboolean value) {
+
+    VOLT_DEBUG("nativeSetPipelineExecutors() start");
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+    }
+    static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    engine->setPipelineExecutors(value == JNI_TRUE);
+    return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 // READ/WRITE TRACKING
 // ----------------------------------------------------------------------------
@@ -1445,6 +1494,58 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeTrack
     return retval;
 }
 
+/**
+ * Check whether two txns touched the same rows, with at least one of them
+ * writing. Txns that are not tracked never conflict.
+ * @param pointer the VoltDBEngine pointer
+ * @param txnId0 the first transaction
+ * @param txnId1 the second transaction
+ * @return true if they conflict
+ */
+SHAREDLIB_JNIEXPORT jboolean JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeTrackingConflicts(
+        JNIEnv *env,
+        jobject obj,
+        jlong engine_ptr,
+        jlong txnId0,
+        jlong txnId1) {
+
+    VOLT_DEBUG("nativeTrackingConflicts() start");
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return false;
+    }
+    Topend *topend = static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    try {
+        return engine->trackingConflicts(static_cast<int64_t>(txnId0),
+                                         static_cast<int64_t>(txnId1));
+    } catch (FatalException e) {
+        topend->crashVoltDB(e);
+    }
+    return false;
+}
+
+/**
+ * Track blocks instead of rows for the txns that start tracking afterwards.
+ * @param pointer the VoltDBEngine pointer
+ * @param value whether to track blocks
+ * @return error code
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeSetTrackingBlockGranularity(
+        JNIEnv *env,
+        jobject obj,
+        jlong engine_ptr,
+        jboolean value) {
+
+    VOLT_DEBUG("nativeSetTrackingBlockGranularity() start");
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
+    }
+    static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    engine->setTrackingBlockGranularity(value == JNI_TRUE);
+    return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 // ANTI-CACHING
 // ----------------------------------------------------------------------------
@@ -1618,6 +1719,7 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeMMAPI
  * Enables the ARIES feature in the EE.
  * @param pointer the VoltDBEngine pointer
  * @param dbDir the directory where EE should store ARIES log files
+ * @param redoThreads the number of threads redoing log records at recovery
  * @return error code
  */
 SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeARIESInitialize (
@@ -1625,7 +1727,8 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeARIES
         jobject obj,
         jlong engine_ptr,
         jstring dbDir,
-        jstring logFile) {
+        jstring logFile,
+        jint redoThreads) {
     VOLT_DEBUG("nativeARIESInitialize() start");
     VoltDBEngine *engine = castToEngine(engine_ptr);
     Topend *topend = static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
@@ -1641,7 +1744,7 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeARIES
         std::string logFileString(logFileChars);
         env->ReleaseStringUTFChars(logFile, logFileChars);
 
-        engine->ARIESInitialize(dbDirString, logFileString);
+        engine->ARIESInitialize(dbDirString, logFileString, redoThreads);
     } catch (FatalException e) {
         topend->crashVoltDB(e);
     }
@@ -1717,6 +1820,37 @@ VoltDBEngine *engine = castToEngine(engine_ptr);
 char *replayLogData = reinterpret_cast<char*>((replay_ptr));
 engine->freePointerToReplayLog(replayLogData);
 }
+
+/*
+* Class: org_voltdb_jni_ExecutionEngine
+* Method: nativeGetAriesCommittedEntry
+* Signature: (J)J
+*/
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetAriesCommittedEntry
+  (JNIEnv *env, jobject obj, jlong engine_ptr) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return -1;
+    }
+    return engine->getAriesCommittedEntry();
+}
+
+/*
+* Class: org_voltdb_jni_ExecutionEngine
+* Method: nativeWaitForAriesSync
+* Signature: (JJ)Z
+*
+* Called from the thread that releases committed responses, not the one
+* executing transactions, so it leaves the Topend's JNIEnv alone.
+*/
+SHAREDLIB_JNIEXPORT jboolean JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeWaitForAriesSync
+  (JNIEnv *env, jobject obj, jlong engine_ptr, jlong entry) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    if (engine == NULL) {
+        return false;
+    }
+    return engine->waitForAriesSync(static_cast<int64_t>(entry));
+}
 #endif
 
 
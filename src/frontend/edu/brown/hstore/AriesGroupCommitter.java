@@ -0,0 +1,121 @@
+/***************************************************************************
+ *  Copyright (C) 2017 by S-Store Project                                  *
+ *  Brown University                                                       *
+ *  Massachusetts Institute of Technology                                  *
+ *  Portland State University                                              *
+ *                                                                         *
+ *  Author:  The S-Store Team (sstore.cs.brown.edu)                        *
+ *                                                                         *
+ *                                                                         *
+ *  Permission is hereby granted, free of charge, to any person obtaining  *
+ *  a copy of this software and associated documentation files (the        *
+ *  "Software"), to deal in the Software without restriction, including    *
+ *  without limitation the rights to use, copy, modify, merge, publish,    *
+ *  distribute, sublicense, and/or sell copies of the Software, and to     *
+ *  permit persons to whom the Software is furnished to do so, subject to  *
+ *  the following conditions:                                              *
+ *                                                                         *
+ *  The above copyright notice and this permission notice shall be         *
+ *  included in all copies or substantial portions of the Software.        *
+ *                                                                         *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        *
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     *
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. *
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR      *
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  *
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR  *
+ *  OTHER DEALINGS IN THE SOFTWARE.                                        *
+ ***************************************************************************/
+
+package edu.brown.hstore;
+
+import java.util.concurrent.LinkedBlockingQueue;
+
+import org.apache.log4j.Logger;
+import org.voltdb.ClientResponseImpl;
+import org.voltdb.exceptions.ServerFaultException;
+import org.voltdb.jni.ExecutionEngine;
+
+import com.google.protobuf.RpcCallback;
+
+import edu.brown.hstore.txns.LocalTransaction;
+import edu.brown.hstore.util.AbstractProcessingRunnable;
+import edu.brown.logging.LoggerUtil;
+import edu.brown.logging.LoggerUtil.LoggerBoolean;
+
+/**
+ * Holds the ClientResponses of the single-partition txns that committed at
+ * one partition until the EE's ARIES log writer has synced their log entries.
+ * The PartitionExecutor goes on with the next txn right after the commit, so
+ * the writer's next sync covers every txn committed in the meantime, and a
+ * single wait here releases all of their responses.
+ */
+public final class AriesGroupCommitter extends AbstractProcessingRunnable<Object[]> {
+    private static final Logger LOG = Logger.getLogger(AriesGroupCommitter.class);
+    private static final LoggerBoolean debug = new LoggerBoolean();
+    static {
+        LoggerUtil.attachObserver(LOG, debug);
+    }
+
+    private final int partitionId;
+    private final ExecutionEngine ee;
+
+    /**
+     * @param hstore_site
+     * @param partitionId
+     * @param ee the partition's engine; only its ARIES log writer is used here
+     */
+    public AriesGroupCommitter(HStoreSite hstore_site, int partitionId, ExecutionEngine ee) {
+        super(hstore_site,
+              String.format("%03d-%s", partitionId, HStoreConstants.THREAD_NAME_ARIES),
+              new LinkedBlockingQueue<Object[]>(),
+              hstore_site.getHStoreConf().site.status_exec_info);
+        this.partitionId = partitionId;
+        this.ee = ee;
+    }
+
+    /**
+     * Queue the response of a txn that just committed at our partition. It is
+     * sent once the txn's log entry is on disk. Must be called from the
+     * partition's thread, right after the commit.
+     * @param ts
+     * @param cresponse
+     */
+    public void queue(LocalTransaction ts, ClientResponseImpl cresponse) {
+        this.queue.add(new Object[]{
+                            this.ee.getAriesCommittedEntry(),
+                            cresponse,
+                            ts.getClientCallback(),
+                            ts.getInitiateTime(),
+                            ts.getRestartCounter(),
+                            ts.getBatchId()
+        });
+    }
+
+    @Override
+    protected void processingCallback(Object data[]) {
+        long entry = (Long)data[0];
+        ClientResponseImpl cresponse = (ClientResponseImpl)data[1];
+        @SuppressWarnings("unchecked")
+        RpcCallback<ClientResponseImpl> clientCallback = (RpcCallback<ClientResponseImpl>)data[2];
+        long initiateTime = (Long)data[3];
+        int restartCounter = (Integer)data[4];
+        long batchId = (Long)data[5];
+
+        // entries are synced in order, so for every response queued behind
+        // this one that was committed before the sync, this returns right away
+        if (this.ee.waitForAriesSync(entry) == false) {
+            String msg = String.format("Failed to write the ARIES log at partition %d", this.partitionId);
+            throw new ServerFaultException(msg, cresponse.getTransactionId());
+        }
+        if (debug.val)
+            LOG.debug(String.format("Releasing ClientResponse for txn #%d at partition %d [entry=%d]",
+                      cresponse.getTransactionId(), this.partitionId, entry));
+        try {
+            this.hstore_site.responseSend(cresponse, clientCallback, batchId, initiateTime, restartCounter);
+        } catch (Throwable ex) {
+            if (this.isShuttingDown() == false) throw new RuntimeException(ex);
+            this.shutdown();
+        }
+    }
+}
@@ -50,6 +50,7 @@ public abstract class HStoreConstants {
     public static final String THREAD_NAME_QUEUE_INIT = "queueinit";
     public static final String THREAD_NAME_QUEUE_RESTART = "queuerestart";
     public static final String THREAD_NAME_COMMANDLOGGER = "cmdlg";
+    public static final String THREAD_NAME_ARIES = "aries";
     public static final String THREAD_NAME_ANTICACHE = "anticache";
     public static final String THREAD_NAME_LOGGING = "logging";
     public static final String THREAD_NAME_MAPREDUCE = "mr";
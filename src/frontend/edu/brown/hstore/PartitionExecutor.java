@@ -151,6 +151,7 @@ import com.google.protobuf.RpcCallback;
 import edu.brown.catalog.CatalogUtil;
 import edu.brown.catalog.PlanFragmentIdGenerator;
 import edu.brown.catalog.special.CountedStatement;
+import edu.brown.hstore.HStoreThreadManager.ThreadGroupType;
 import edu.brown.hstore.Hstoreservice.QueryEstimate;
 import edu.brown.hstore.Hstoreservice.Status;
 import edu.brown.hstore.Hstoreservice.TransactionPrefetchResult;
@@ -731,6 +732,8 @@ public class PartitionExecutor implements Runnable, Configurable, Shutdownable {
 
     private final SystemProcedureContext m_systemProcedureContext = new SystemProcedureContext();
     private AriesLog m_ariesLog ;
+    /** Holds committed responses until their ARIES log entries are synced */
+    private AriesGroupCommitter m_ariesCommitter;
 
     public SystemProcedureExecutionContext getSystemProcedureExecutionContext(){
 	return m_systemProcedureContext;
@@ -855,9 +858,20 @@ public class PartitionExecutor implements Runnable, Configurable, Shutdownable {
                 if (hstore_conf.site.aries) {
                     File dbFile = getARIESDir(this);
                     File logFile = getARIESFile(this);
-                    eeTemp.ARIESInitialize(dbFile, logFile);
+                    eeTemp.ARIESInitialize(dbFile, logFile, hstore_conf.site.aries_redo_threads);
                 }                            
                 
+                if (hstore_conf.site.exec_batch_triggers) {
+                    eeTemp.setBatchTriggers(true);
+                }
+                // only applies to the plan fragments loaded after it
+                if (hstore_conf.site.exec_pipeline_executors) {
+                    eeTemp.setPipelineExecutors(true);
+                }
+                if (hstore_conf.site.exec_readwrite_tracking_blocks) {
+                    eeTemp.setTrackingBlockGranularity(true);
+                }
+                
                 // Important: This has to be called *after* we initialize the anti-cache
                 //            and the storage information!
                 eeTemp.loadCatalog(catalogContext.catalog.serialize());
@@ -1194,6 +1208,13 @@ public class PartitionExecutor implements Runnable, Configurable, Shutdownable {
         if(m_ariesLog != null){
             doPartitionRecovery(Long.MIN_VALUE);
         }
+        if (hstore_conf.site.aries && this.ee instanceof ExecutionEngineJNI) {
+            this.m_ariesCommitter = new AriesGroupCommitter(this.hstore_site, this.partitionId, this.ee);
+            Thread t = new Thread(this.hstore_site.getThreadManager().getThreadGroup(ThreadGroupType.PROCESSING),
+                                  this.m_ariesCommitter);
+            t.setDaemon(true);
+            t.start();
+        }
         
         // *********************************** DEBUG ***********************************
         if (hstore_conf.site.exec_validate_work) {
@@ -4785,7 +4806,13 @@ public class PartitionExecutor implements Runnable, Configurable, Shutdownable {
             if (hstore_conf.site.commandlog_enable) ts.markLogEnabled();
             
             if (hstore_conf.site.exec_profiling) this.profiler.network_time.start();
-            this.hstore_site.responseSend(ts, cresponse);
+            if (this.m_ariesCommitter != null && status == Status.OK && ts.isSysProc() == false) {
+                // The commit only queued the txn's ARIES log entry, so we can move on
+                // to the next txn while the entry is synced along with the others
+                this.m_ariesCommitter.queue(ts, cresponse);
+            } else {
+                this.hstore_site.responseSend(ts, cresponse);
+            }
             if (hstore_conf.site.exec_profiling) this.profiler.network_time.stopIfStarted();
             this.hstore_site.queueDeleteTransaction(ts.getTransactionId(), status);
         } 
@@ -5521,6 +5548,7 @@ public class PartitionExecutor implements Runnable, Configurable, Shutdownable {
         
         // Knock out this ma
         if (this.m_snapshotter != null) this.m_snapshotter.shutdown();
+        if (this.m_ariesCommitter != null) this.m_ariesCommitter.shutdown();
         
         // Make sure we shutdown our threadpool
         // this.thread_pool.shutdownNow();
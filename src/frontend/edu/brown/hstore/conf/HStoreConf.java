@@ -300,6 +300,15 @@ public final class HStoreConf {
         )
         public int exec_ee_log_level;
         
+        @ConfigProperty(
+            description="When the ExecutionEngine runs as a separate IPC process, pass requests and " +
+                        "results through a pair of shared memory rings instead of the local socket. " +
+                        "The socket is then only used to wake up a side that is waiting on the other.",
+            defaultBoolean=false,
+            experimental=true
+        )
+        public boolean exec_ipc_shared_memory;
+        
         @ConfigProperty(
             description="Enable execution site profiling. This will keep track of how busy each " +
                         "PartitionExecutor thread is during execution (i.e., the percentage of " +
@@ -517,6 +526,36 @@ public final class HStoreConf {
         )
         public boolean exec_readwrite_tracking;
 
+        @ConfigProperty(
+            description="Track which blocks of a table a transaction reads and writes instead of " +
+                        "the individual tuples. The sets are much smaller for large scans, but two " +
+                        "transactions that touch different tuples in the same block will conflict. " +
+                        "See ${site.exec_readwrite_tracking}.",
+            defaultBoolean=false,
+            experimental=true
+        )
+        public boolean exec_readwrite_tracking_blocks;
+
+        @ConfigProperty(
+            description="Coalesce the trigger firings of streams until the end of each batch of " +
+                        "plan fragments, so that every stream fires once over all the tuples the batch " +
+                        "inserted into it instead of once per insert statement. Windows always fire " +
+                        "right away. Only supported by the JNI ExecutionEngine.",
+            defaultBoolean=false,
+            experimental=true
+        )
+        public boolean exec_batch_triggers;
+
+        @ConfigProperty(
+            description="Let the executors of a plan fragment push their output tuples straight into " +
+                        "their parent where both support it (scans, projections, limits and inserts), " +
+                        "instead of materializing every intermediate result in a temp table. " +
+                        "Only supported by the JNI ExecutionEngine.",
+            defaultBoolean=false,
+            experimental=true
+        )
+        public boolean exec_pipeline_executors;
+
         // ----------------------------------------------------------------------------
         // Speculative Execution Options
         // ----------------------------------------------------------------------------
@@ -706,6 +745,15 @@ public final class HStoreConf {
         )
         public boolean anticache_reversible_lru;
         
+        @ConfigProperty(
+            description="Use CLOCK eviction instead of the anti-cache's LRU tracker. " +
+                        "Accessing a tuple only sets a bit in its header instead of relinking it " +
+                        "in the LRU chain, and eviction sweeps those bits to pick its victims.",
+            defaultBoolean=false,
+            experimental=true
+        )
+        public boolean anticache_clock;
+        
         @ConfigProperty(
             description="Enable the anti-cache profiling.",
             defaultBoolean=false,
@@ -854,6 +902,15 @@ public final class HStoreConf {
                 experimental=true
         )
         public boolean aries_reset;
+
+        @ConfigProperty(
+                description="Number of threads that redo ARIES log records for different tables " +
+                            "at the same time during recovery. Setting this to one replays the log " +
+                            "serially. This is only used if ${site.aries} is enabled. ",
+                defaultInt=4,
+                experimental=true
+        )
+        public int aries_redo_threads;
         
         // ----------------------------------------------------------------------------
         //  Logical Recovery Options
@@ -63,7 +63,18 @@ public class OptimisticConflictChecker extends AbstractConflictChecker {
             String.format("Uninitialized distributed transaction handle [%s]", ts0);
         assert(ts1.isInitialized()) :
             String.format("Uninitialized speculative transaction handle [%s]", ts1);
-        
+
+        // Let the EE compare the two trackers directly instead of
+        // serializing both of their sets up to us
+        if (this.ee != null) {
+            try {
+                return (this.ee.trackingConflicts(ts0.getTransactionId(), ts1.getTransactionId()));
+            } catch (Exception ex) {
+                String msg = String.format("Failed to compare read/write tracking sets of %s and %s", ts0, ts1);
+                throw new RuntimeException(msg, ex);
+            }
+        }
+
         // Get the READ/WRITE tracking sets from the EE
         VoltTable tsTracking0[] = this.getReadWriteSets(ts0);
         if (trace.val)
@@ -40,7 +40,7 @@ public class PlanOptimizer {
     /**
      * The list of PlanNodeTypes that we do not want to try to optimize
      */
-    private static final PlanNodeType TO_IGNORE[] = { PlanNodeType.AGGREGATE, PlanNodeType.NESTLOOP, };
+    private static final PlanNodeType TO_IGNORE[] = { PlanNodeType.AGGREGATE, PlanNodeType.NESTLOOP, PlanNodeType.HASHJOIN, };
     private static final String BROKEN_SQL[] = {
             // "FROM CUSTOMER, FLIGHT, RESERVATION", // Airline DeleteReservation.GetCustomerReservation
             // "SELECT imb_ib_id, ib_bid", // AuctionMark NewBid.getMaxBidId
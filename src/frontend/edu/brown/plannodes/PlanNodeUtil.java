@@ -236,7 +236,8 @@ public abstract class PlanNodeUtil {
             // JOINS
             // ---------------------------------------------------
             case NESTLOOP:
-            case NESTLOOPINDEX: {
+            case NESTLOOPINDEX:
+            case HASHJOIN: {
                 AbstractJoinPlanNode cast_node = (AbstractJoinPlanNode) node;
                 if (cast_node.getPredicate() != null)
                     exps.add(cast_node.getPredicate());
@@ -326,7 +327,8 @@ public abstract class PlanNodeUtil {
                     }
                     // JOINS
                     case NESTLOOP:
-                    case NESTLOOPINDEX: {
+                    case NESTLOOPINDEX:
+                    case HASHJOIN: {
                         AbstractJoinPlanNode cast_node = (AbstractJoinPlanNode) node;
                         exps.add(cast_node.getPredicate());
                         break;
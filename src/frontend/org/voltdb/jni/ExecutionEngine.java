@@ -491,6 +491,21 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
     public abstract long readAriesLogForReplay(long[] size);
 
     public abstract void freePointerToReplayLog(long ariesReplayPointer);
+
+    /**
+     * The ARIES log entry of the last transaction committed at this partition.
+     * Its response may only be released once waitForAriesSync() returns for it.
+     */
+    public abstract long getAriesCommittedEntry();
+
+    /**
+     * Block until the given ARIES log entry, and every one before it, is on disk.
+     * Unlike the other calls, this one may be made from a thread other than the
+     * one executing transactions.
+     * @param entry
+     * @return false if the log could not be written
+     */
+    public abstract boolean waitForAriesSync(long entry);
     
     /*
      * Declare the native interface. Structurally, in Java, it would be cleaner to
@@ -595,15 +610,13 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             int outputDepId, int inputDepId, long txnId, long lastCommittedTxnId, long undoToken);
 
     /**
-     * Executes multiple plan fragments with the given parameter sets and gets the results.
+     * Executes multiple plan fragments and gets the results. The parameter buffer
+     * holds the fragment count, then the plan fragment ids, input dependency ids and
+     * output dependency ids, then one ParameterSet per fragment.
      * @param pointer the VoltDBEngine pointer
-     * @param planFragmentIds ID of the plan fragment to be executed.
      * @return error code
      */
-    protected native int nativeExecuteQueryPlanFragmentsAndGetResults(long pointer,
-            long[] planFragmentIds, int numFragments,
-            int[] input_depIds,
-            int[] outputDepIds,
+    protected native int nativeExecutePlanFragmentBatch(long pointer,
             long txnId, long lastCommittedTxnId, long undoToken);
 
     /**
@@ -812,6 +825,76 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     protected native int nativeTrackingWriteSet(long pointer, long txnId) throws EEException;
 
+    /**
+     * Check whether two txns touched the same tuples at this partition,
+     * with at least one of them writing. Txns that are not tracked never conflict.
+     * @param txnId0
+     * @param txnId1
+     * @throws EEException
+     */
+    public abstract boolean trackingConflicts(Long txnId0, Long txnId1) throws EEException;
+
+    /**
+     * Check whether two txns conflict in the EE.
+     * @param pointer
+     * @param txnId0
+     * @param txnId1
+     * @return
+     */
+    protected native boolean nativeTrackingConflicts(long pointer, long txnId0, long txnId1);
+
+    /**
+     * Track the blocks that txns touch instead of individual tuples.
+     * Only applies to the txns that enable tracking afterwards.
+     * @param value
+     * @throws EEException
+     */
+    public abstract void setTrackingBlockGranularity(boolean value) throws EEException;
+
+    /**
+     * Toggle block granularity of read/write set tracking in the EE.
+     * @param pointer
+     * @param value
+     * @return
+     */
+    protected native int nativeSetTrackingBlockGranularity(long pointer, boolean value);
+
+    // ----------------------------------------------------------------------------
+    // EXECUTION OPTIONS
+    // ----------------------------------------------------------------------------
+
+    /**
+     * Coalesce the trigger firings of streams until the end of each batch of
+     * plan fragments instead of firing them after every insert statement.
+     * @param value
+     * @throws EEException
+     */
+    public abstract void setBatchTriggers(boolean value) throws EEException;
+
+    /**
+     * Toggle coalescing of stream trigger firings in the EE.
+     * @param pointer
+     * @param value
+     * @return
+     */
+    protected native int nativeSetBatchTriggers(long pointer, boolean value);
+
+    /**
+     * Let the plan fragments loaded from now on push tuples from an executor
+     * straight into its parent instead of materializing them in between.
+     * Has to be called before the catalog is loaded.
+     * @param value
+     * @throws EEException
+     */
+    public abstract void setPipelineExecutors(boolean value) throws EEException;
+
+    /**
+     * Toggle pipelining of executors in the EE.
+     * @param pointer
+     * @param value
+     * @return
+     */
+    protected native int nativeSetPipelineExecutors(long pointer, boolean value);
     
     // ----------------------------------------------------------------------------
     // ANTI-CACHING
@@ -911,13 +994,13 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
     // ARIES
     // ----------------------------------------------------------------------------
 
-    public abstract void ARIESInitialize(File dbDir, File logFile) throws EEException;
+    public abstract void ARIESInitialize(File dbDir, File logFile, int redoThreads) throws EEException;
 
     /**
      * Enables the ARIES  feature in the EE. The given database directory path
      * must be a unique location for this partition where the EE can store ARIES logs
      */
-    protected native int nativeARIESInitialize(long pointer, String dbDir, String logFile);
+    protected native int nativeARIESInitialize(long pointer, String dbDir, String logFile, int redoThreads);
         
     protected native void nativeDoAriesRecoveryPhase(long pointer, long replayPointer, long replayLogSize, long replayTxnId);
 
@@ -927,6 +1010,10 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
 
     protected native long nativeReadAriesLogForReplay(long pointer, long[] size);
 
+    protected native long nativeGetAriesCommittedEntry(long pointer);
+
+    protected native boolean nativeWaitForAriesSync(long pointer, long entry);
+
     protected native void nativeFreePointerToReplayLog(long pointer, long ariesReplayPointer);
 
     // ----------------------------------------------------------------------------
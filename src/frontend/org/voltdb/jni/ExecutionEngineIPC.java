@@ -55,6 +55,7 @@ import java.io.UnsupportedEncodingException;
 import java.net.InetSocketAddress;
 import java.net.Socket;
 import java.nio.ByteBuffer;
+import java.nio.channels.ByteChannel;
 import java.nio.channels.SocketChannel;
 import java.util.ArrayList;
 import java.util.Collections;
@@ -160,7 +161,8 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         ExportAction(20),
         RecoveryMessage(21),
         TableHashCode(22),
-        Hashinate(23);
+        Hashinate(23),
+        SharedMemory(24);
         Commands(final int id) {
             m_id = id;
         }
@@ -180,6 +182,9 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     private class Connection {
         private Socket m_socket = null;
         private SocketChannel m_socketChannel = null;
+        // the socket, or the shared memory rings once the EE has mapped them
+        private ByteChannel m_channel = null;
+        private final ByteBuffer m_statusByte = ByteBuffer.allocate(1);
         private Process m_eeProcess;
         private String m_eePID = null;
         private Thread m_stdoutParser = null;
@@ -351,6 +356,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                 m_socketChannel.configureBlocking(true);
                 m_socket = m_socketChannel.socket();
                 m_socket.setTcpNoDelay(true);
+                m_channel = m_socketChannel;
             } catch (final Exception e) {
                 System.out.println(e.getMessage());
                 System.out
@@ -371,6 +377,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                     throw new RuntimeException(e);
                 }
                 m_socketChannel = null;
+                m_channel = null;
                 m_socket = null;
             }
             if (m_eeProcess != null) {
@@ -407,7 +414,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             m_dataNetwork.limit(4 + amt);
             m_dataNetwork.rewind();
             while (m_dataNetwork.hasRemaining()) {
-                m_socketChannel.write(m_dataNetwork);
+                m_channel.write(m_dataNetwork);
             }
         }
 
@@ -436,6 +443,17 @@ public class ExecutionEngineIPC extends ExecutionEngine {
          */
         static final int kErrorCode_CrashVoltDB = 104;
 
+        /** Blocking read of one unsigned byte, or -1 at the end of the stream */
+        int readByte() throws IOException {
+            m_statusByte.clear();
+            while (m_statusByte.hasRemaining()) {
+                if (m_channel.read(m_statusByte) == -1) {
+                    return -1;
+                }
+            }
+            return m_statusByte.get(0) & 0xff;
+        }
+
         /**
          * Read a single byte indicating a return code. This method has evolved
          * to include providing dependency tables necessary for the completion of previous
@@ -452,11 +470,11 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             int status = kErrorCode_RetrieveDependency;
 
             while (true) {
-                status = m_socket.getInputStream().read();
+                status = readByte();
                 if (status == kErrorCode_RetrieveDependency) {
                     final ByteBuffer dependencyIdBuffer = ByteBuffer.allocate(4);
                     while (dependencyIdBuffer.hasRemaining()) {
-                        final int read = m_socketChannel.read(dependencyIdBuffer);
+                        final int read = m_channel.read(dependencyIdBuffer);
                         if (read == -1) {
                             throw new IOException("Unable to read enough bytes for dependencyId in order to " +
                             " satisfy IPC backend request for a dependency table");
@@ -469,7 +487,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                 if (status == kErrorCode_CrashVoltDB) {
                     ByteBuffer lengthBuffer = ByteBuffer.allocate(4);
                     while (lengthBuffer.hasRemaining()) {
-                        final int read = m_socket.getChannel().read(lengthBuffer);
+                        final int read = m_channel.read(lengthBuffer);
                         if (read == -1) {
                             throw new EOFException();
                         }
@@ -477,7 +495,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                     lengthBuffer.flip();
                     ByteBuffer messageBuffer = ByteBuffer.allocate(lengthBuffer.getInt());
                     while (messageBuffer.hasRemaining()) {
-                        final int read = m_socket.getChannel().read(messageBuffer);
+                        final int read = m_channel.read(messageBuffer);
                         if (read == -1) {
                             throw new EOFException();
                         }
@@ -535,7 +553,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
 
             //resultTablesLengthBytes.order(ByteOrder.LITTLE_ENDIAN);
             while (resultTablesLengthBytes.hasRemaining()) {
-                int read = m_socketChannel.read(resultTablesLengthBytes);
+                int read = m_channel.read(resultTablesLengthBytes);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -547,7 +565,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                     .allocate(resultTablesLength);
             //resultTablesBuffer.order(ByteOrder.LITTLE_ENDIAN);
             while (resultTablesBuffer.hasRemaining()) {
-                int read = m_socketChannel.read(resultTablesBuffer);
+                int read = m_channel.read(resultTablesBuffer);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -578,7 +596,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             final ByteBuffer resultSetSizeBuff = ByteBuffer.allocate(4);
             resultSetSizeBuff.rewind();
             while (resultSetSizeBuff.hasRemaining()) {
-                int read = m_socketChannel.read(resultSetSizeBuff);
+                int read = m_channel.read(resultSetSizeBuff);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -591,7 +609,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             final ByteBuffer depsBuff = ByteBuffer.allocate(resultsSize);
             depsBuff.clear().rewind();
             while (depsBuff.hasRemaining()) {
-                int read = m_socketChannel.read(depsBuff);
+                int read = m_channel.read(depsBuff);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -620,7 +638,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         public void throwException(final int errorCode) throws IOException {
             final ByteBuffer lengthBuffer = ByteBuffer.allocate(4);
             while (lengthBuffer.hasRemaining()) {
-                int read = m_socketChannel.read(lengthBuffer);
+                int read = m_channel.read(lengthBuffer);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -633,7 +651,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                 final ByteBuffer exceptionBuffer = ByteBuffer.allocate(exceptionLength + 4);
                 exceptionBuffer.putInt(exceptionLength);
                 while(exceptionBuffer.hasRemaining()) {
-                    int read = m_socketChannel.read(exceptionBuffer);
+                    int read = m_channel.read(exceptionBuffer);
                     if (read == -1) {
                         throw new EOFException();
                     }
@@ -653,6 +671,9 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     private final String m_hostname;
     // private final FastSerializer m_fser;
     private final Connection m_connection;
+
+    /** Bytes in each direction when the connection runs over shared memory */
+    private static final int SHARED_MEMORY_RING_CAPACITY = 16 * 1024 * 1024;
     private final BBContainer m_dataNetworkOrigin;
     private final ByteBuffer m_dataNetwork;
     private ByteBuffer m_data;
@@ -683,9 +704,53 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         m_dataNetwork.position(4);
         m_data = m_dataNetwork.slice();
 
+        if (site != null && site.getHStoreConf().site.exec_ipc_shared_memory) {
+            useSharedMemory();
+        }
         initialize(m_clusterIndex, m_siteId, m_partitionId, m_hostId, m_hostname);
     }
 
+    /**
+     * Ask the EE to move the connection onto a pair of shared memory rings,
+     * keeping the socket for wakeups only. The EE maps the file before it
+     * answers, so it can be unlinked right after. Any failure leaves the
+     * connection on the socket.
+     */
+    private void useSharedMemory() {
+        final File dir = new File("/dev/shm");
+        File file = null;
+        try {
+            file = File.createTempFile("ee-ipc-" + m_siteId + "-", ".ring",
+                                       dir.isDirectory() ? dir : null);
+            final SharedMemoryChannel channel =
+                new SharedMemoryChannel(file, SHARED_MEMORY_RING_CAPACITY, m_connection.m_socketChannel);
+            final byte[] path = file.getAbsolutePath().getBytes("UTF-8");
+
+            m_data.clear();
+            m_data.putInt(Commands.SharedMemory.m_id);
+            m_data.putLong(SHARED_MEMORY_RING_CAPACITY);
+            m_data.putShort((short)path.length);
+            m_data.put(path);
+            m_data.flip();
+            m_connection.write();
+            final int result = m_connection.readStatusByte();
+            if (result != ExecutionEngine.ERRORCODE_SUCCESS) {
+                // consumes the rest of the error reply and throws
+                m_connection.throwException(result);
+            }
+            m_connection.m_channel = channel;
+            System.out.println("IPC connection for site " + m_siteId + " is using shared memory.");
+        } catch (final EEException e) {
+            System.out.println("EE refused shared memory IPC, staying on the socket.");
+        } catch (final IOException e) {
+            System.out.println("Failed to set up shared memory IPC: " + e.getMessage());
+        } finally {
+            if (file != null) {
+                file.delete();
+            }
+        }
+    }
+
     /** Utility method to generate an EEXception that can be overriden by derived classes**/
     @Override
     protected void throwExceptionForError(final int errorCode) {
@@ -1136,7 +1201,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             if (result == ExecutionEngine.ERRORCODE_SUCCESS) {
                 final ByteBuffer messageLengthBuffer = ByteBuffer.allocate(4);
                 while (messageLengthBuffer.hasRemaining()) {
-                    int read = m_connection.m_socketChannel.read(messageLengthBuffer);
+                    int read = m_connection.m_channel.read(messageLengthBuffer);
                     if (read == -1) {
                         throw new EOFException();
                     }
@@ -1144,7 +1209,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
                 messageLengthBuffer.rewind();
                 final ByteBuffer messageBuffer = ByteBuffer.allocate(messageLengthBuffer.getInt());
                 while (messageBuffer.hasRemaining()) {
-                    int read = m_connection.m_socketChannel.read(messageBuffer);
+                    int read = m_connection.m_channel.read(messageBuffer);
                     if (read == -1) {
                         throw new EOFException();
                     }
@@ -1259,7 +1324,12 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     private void sendDependencyTable(final int dependencyId) throws IOException{
         final byte[] dependencyBytes = nextDependencyAsBytes(dependencyId);
         if (dependencyBytes == null) {
-            m_connection.m_socket.getOutputStream().write(Connection.kErrorCode_DependencyNotFound);
+            final ByteBuffer notFound = ByteBuffer.allocate(1);
+            notFound.put((byte)Connection.kErrorCode_DependencyNotFound);
+            notFound.flip();
+            while (notFound.hasRemaining()) {
+                m_connection.m_channel.write(notFound);
+            }
             return;
         }
         // 1 for response code + 4 for dependency length prefix + dependencyBytes.length
@@ -1274,7 +1344,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         // finally, write dependency table itself
         message.put(dependencyBytes);
         message.rewind();
-        if (m_connection.m_socketChannel.write(message) != message.capacity()) {
+        if (m_connection.m_channel.write(message) != message.capacity()) {
             throw new IOException("Unable to send dependency table to client. Attempted blocking write of " +
                     message.capacity() + " but not all of it was written");
         }
@@ -1327,7 +1397,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
 
             ByteBuffer lengthBuffer = ByteBuffer.allocate(4);
             while (lengthBuffer.hasRemaining()) {
-                int read = m_connection.m_socketChannel.read(lengthBuffer);
+                int read = m_connection.m_channel.read(lengthBuffer);
                 if (read == -1) {
                     throw new EOFException();
                 }
@@ -1343,7 +1413,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             }
             view.limit(view.position() + length);
             while (view.hasRemaining()) {
-                m_connection.m_socketChannel.read(view);
+                m_connection.m_channel.read(view);
             }
         } catch (final IOException e) {
             System.out.println("Exception: " + e.getMessage());
@@ -1373,7 +1443,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             ByteBuffer data = null;
             ByteBuffer results = ByteBuffer.allocate(8);
             while (results.remaining() > 0)
-                m_connection.m_socketChannel.read(results);
+                m_connection.m_channel.read(results);
             results.flip();
             long result_offset = results.getLong();
             if (result_offset < 0) {
@@ -1385,13 +1455,13 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             else {
                 results = ByteBuffer.allocate(4);
                 while (results.remaining() > 0)
-                    m_connection.m_socketChannel.read(results);
+                    m_connection.m_channel.read(results);
                 results.flip();
                 int result_sz = results.getInt();
                 data = ByteBuffer.allocate(result_sz + 4);
                 data.putInt(result_sz);
                 while (data.remaining() > 0)
-                    m_connection.m_socketChannel.read(data);
+                    m_connection.m_channel.read(data);
                 data.flip();
 
                 ExportProtoMessage reply = null;
@@ -1439,7 +1509,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             m_connection.readStatusByte();
             ByteBuffer hashCode = ByteBuffer.allocate(8);
             while (hashCode.hasRemaining()) {
-                int read = m_connection.m_socketChannel.read(hashCode);
+                int read = m_connection.m_channel.read(hashCode);
                 if (read <= 0) {
                     throw new EOFException();
                 }
@@ -1476,7 +1546,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
             m_connection.readStatusByte();
             ByteBuffer part = ByteBuffer.allocate(4);
             while (part.hasRemaining()) {
-                int read = m_connection.m_socketChannel.read(part);
+                int read = m_connection.m_channel.read(part);
                 if (read <= 0) {
                     throw new EOFException();
                 }
@@ -1489,6 +1559,16 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         }
     }
 
+    @Override
+    public void setBatchTriggers(boolean value) throws EEException {
+        throw new NotImplementedException("Trigger batching is disabled for IPC ExecutionEngine");
+    }
+
+    @Override
+    public void setPipelineExecutors(boolean value) throws EEException {
+        throw new NotImplementedException("Executor pipelining is disabled for IPC ExecutionEngine");
+    }
+
     @Override
     public void trackingEnable(Long txnId) throws EEException {
         throw new NotImplementedException("Read/Write Set Tracking is disabled for IPC ExecutionEngine");
@@ -1505,6 +1585,14 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     public VoltTable trackingWriteSet(Long txnId) throws EEException {
         throw new NotImplementedException("Read/Write Set Tracking is disabled for IPC ExecutionEngine");
     }
+    @Override
+    public boolean trackingConflicts(Long txnId0, Long txnId1) throws EEException {
+        throw new NotImplementedException("Read/Write Set Tracking is disabled for IPC ExecutionEngine");
+    }
+    @Override
+    public void setTrackingBlockGranularity(boolean value) throws EEException {
+        throw new NotImplementedException("Read/Write Set Tracking is disabled for IPC ExecutionEngine");
+    }
     
     @Override
     public void antiCacheInitialize(File dbFilePath, long blockSize) throws EEException {
@@ -1533,7 +1621,7 @@ public class ExecutionEngineIPC extends ExecutionEngine {
     
     // ARIES 
     @Override
-    public void ARIESInitialize(File dbDir, File logFile) throws EEException {
+    public void ARIESInitialize(File dbDir, File logFile, int redoThreads) throws EEException {
         throw new NotImplementedException("ARIES recovery is disabled for IPC ExecutionEngine");
     }
     
@@ -1563,6 +1651,16 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         throw new NotImplementedException("ARIES recovery is disabled for IPC ExecutionEngine");
     }
 
+    @Override
+    public long getAriesCommittedEntry() {
+        throw new NotImplementedException("ARIES logging is disabled for IPC ExecutionEngine");
+    }
+
+    @Override
+    public boolean waitForAriesSync(long entry) {
+        throw new NotImplementedException("ARIES logging is disabled for IPC ExecutionEngine");
+    }
+
     @Override
     public long extractTable(Table extractTable, String destinationShim, String destinationFile, boolean caching) {
         throw new NotImplementedException("ExtractTable is disabled for IPC ExecutionEngine");
@@ -359,7 +359,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
     /**
      * @param undoToken Token identifying undo quantum for generated undo info
-     * Wrapper for {@link #nativeExecuteQueryPlanFragmentsAndGetResults(long, int[], int, long, long, long)}.
+     * Wrapper for {@link #nativeExecutePlanFragmentBatch(long, long, long, long)}.
      */
     @Override
     public DependencySet executeQueryPlanFragmentsAndGetDependencySet(
@@ -388,9 +388,19 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             this.trackingResetCacheEntry(txnId);
         }
 
-        // serialize the param sets
+        // serialize the fragments and their param sets
         fsForParameterSet.clear();
         try {
+            fsForParameterSet.writeInt(batchSize);
+            for (int i = 0; i < batchSize; ++i) {
+                fsForParameterSet.writeLong(planFragmentIds[i]);
+            }
+            for (int i = 0; i < batchSize; ++i) {
+                fsForParameterSet.writeInt(input_depIds[i]);
+            }
+            for (int i = 0; i < batchSize; ++i) {
+                fsForParameterSet.writeInt(output_depIds[i]);
+            }
             for (int i = 0; i < batchSize; ++i) {
                 assert(parameterSets[i] != null) :
                     String.format("Null ParameterSet at offset %d for txn #%d\n" +
@@ -410,10 +420,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
         // Execute the plan, passing a raw pointer to the byte buffers for input and output
         deserializer.clear();
-        final int errorCode = nativeExecuteQueryPlanFragmentsAndGetResults(this.pointer,
-                planFragmentIds, batchSize,
-                input_depIds,
-                output_depIds,
+        final int errorCode = nativeExecutePlanFragmentBatch(this.pointer,
                 txnId, lastCommittedTxnId, undoToken);
         checkErrorCode(errorCode);
 
@@ -440,7 +447,7 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                 assert(numDependencies == 1) :
                     "Unexpected multiple output dependencies from PlanFragment #" + planFragmentIds[i];
                 
-                // PAVLO: Since we can't pass the dependency ids using nativeExecuteQueryPlanFragmentsAndGetResults(),
+                // PAVLO: Since we can't pass the dependency ids using nativeExecutePlanFragmentBatch(),
                 // the results will come back without a dependency id. So we have to just assume
                 // that the frags were executed in the order that we passed to the EE and that we
                 // can just use the list of output_depIds that we have 
@@ -686,6 +693,28 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return nativeHashinate(this.pointer, partitionCount);
     }
     
+    // ----------------------------------------------------------------------------
+    // EXECUTION OPTIONS
+    // ----------------------------------------------------------------------------
+
+    @Override
+    public void setBatchTriggers(boolean value) throws EEException {
+        if (debug.val)
+            LOG.debug(String.format("%s batching of stream triggers at partition %d",
+                      (value ? "Enabling" : "Disabling"), this.executor.getPartitionId()));
+        final int errorCode = nativeSetBatchTriggers(this.pointer, value);
+        checkErrorCode(errorCode);
+    }
+
+    @Override
+    public void setPipelineExecutors(boolean value) throws EEException {
+        if (debug.val)
+            LOG.debug(String.format("%s pipelining of executors at partition %d",
+                      (value ? "Enabling" : "Disabling"), this.executor.getPartitionId()));
+        final int errorCode = nativeSetPipelineExecutors(this.pointer, value);
+        checkErrorCode(errorCode);
+    }
+
     // ----------------------------------------------------------------------------
     // READ/WRITE SET TRACKING
     // ----------------------------------------------------------------------------
@@ -769,6 +798,23 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         }
     }
     
+    @Override
+    public boolean trackingConflicts(Long txnId0, Long txnId1) throws EEException {
+        if (debug.val)
+            LOG.debug(String.format("Checking read/write sets of txn #%d and txn #%d for conflicts at partition %d",
+                      txnId0, txnId1, this.executor.getPartitionId()));
+        return (nativeTrackingConflicts(this.pointer, txnId0.longValue(), txnId1.longValue()));
+    }
+
+    @Override
+    public void setTrackingBlockGranularity(boolean value) throws EEException {
+        if (debug.val)
+            LOG.debug(String.format("%s block granularity of read/write set tracking at partition %d",
+                      (value ? "Enabling" : "Disabling"), this.executor.getPartitionId()));
+        final int errorCode = nativeSetTrackingBlockGranularity(this.pointer, value);
+        checkErrorCode(errorCode);
+    }
+    
     private final void trackingRemoveCacheEntry(Long txnId) {
         if (this.trackingCache != null) {
             this.trackingCache.remove(txnId);
@@ -876,12 +922,12 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     
     @Override
-    public void ARIESInitialize(File dbDir, File logFile) throws EEException {
+    public void ARIESInitialize(File dbDir, File logFile, int redoThreads) throws EEException {
         
         LOG.debug("Initializing ARIES feature at partition " + this.executor.getPartitionId());
         LOG.debug(String.format("Partition #%d ARIES Directory: %s",
                  this.executor.getPartitionId(), dbDir.getAbsolutePath()));
-        final int errorCode = nativeARIESInitialize(this.pointer, dbDir.getAbsolutePath(), logFile.getAbsolutePath());
+        final int errorCode = nativeARIESInitialize(this.pointer, dbDir.getAbsolutePath(), logFile.getAbsolutePath(), redoThreads);
         checkErrorCode(errorCode);
         m_anticache = true;
     }
@@ -923,6 +969,16 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return nativeReadAriesLogForReplay(pointer, size);
     }
 
+    @Override
+    public long getAriesCommittedEntry() {
+        return nativeGetAriesCommittedEntry(pointer);
+    }
+
+    @Override
+    public boolean waitForAriesSync(long entry) {
+        return nativeWaitForAriesSync(pointer, entry);
+    }
+
     public long extractTable(Table extractTable, String destinationShim, String destinationFile, boolean caching) {
         if (debug.val) LOG.debug("Extract table");
         deserializer.clear();
@@ -218,6 +218,16 @@ public class MockExecutionEngine extends ExecutionEngine {
         return 0;
     }
 
+    @Override
+    public void setBatchTriggers(boolean value) throws EEException {
+        // TODO Auto-generated method stub
+    }
+
+    @Override
+    public void setPipelineExecutors(boolean value) throws EEException {
+        // TODO Auto-generated method stub
+    }
+
     @Override
     public void trackingEnable(Long txnId) throws EEException {
         // TODO Auto-generated method stub
@@ -236,6 +246,15 @@ public class MockExecutionEngine extends ExecutionEngine {
         // TODO Auto-generated method stub
         return null;
     }
+    @Override
+    public boolean trackingConflicts(Long txnId0, Long txnId1) throws EEException {
+        // TODO Auto-generated method stub
+        return false;
+    }
+    @Override
+    public void setTrackingBlockGranularity(boolean value) throws EEException {
+        // TODO Auto-generated method stub
+    }
     
     @Override
     public void antiCacheInitialize(File dbFilePath, long blockSize) throws EEException {
@@ -262,7 +281,7 @@ public class MockExecutionEngine extends ExecutionEngine {
     }
     
     @Override
-    public void ARIESInitialize(File dbDir, File logFile) throws EEException {
+    public void ARIESInitialize(File dbDir, File logFile, int redoThreads) throws EEException {
      // TODO Auto-generated method stub        
     }
 
@@ -293,6 +312,18 @@ public class MockExecutionEngine extends ExecutionEngine {
         return 0;
     }
 
+    @Override
+    public long getAriesCommittedEntry() {
+        // TODO Auto-generated method stub
+        return 0;
+    }
+
+    @Override
+    public boolean waitForAriesSync(long entry) {
+        // TODO Auto-generated method stub
+        return true;
+    }
+
     @Override
     public long extractTable(Table extractTable, String destinationShim, String destinationFile, boolean caching) {
         // TODO Auto-generated method stub
@@ -0,0 +1,240 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/***************************************************************************
+ *  Copyright (C) 2017 by S-Store Project                                  *
+ *  Brown University                                                       *
+ *  Massachusetts Institute of Technology                                  *
+ *  Portland State University                                              *
+ *                                                                         *
+ *  Author:  The S-Store Team (sstore.cs.brown.edu)                        *
+ *                                                                         *
+ *                                                                         *
+ *  Permission is hereby granted, free of charge, to any person obtaining  *
+ *  a copy of this software and associated documentation files (the        *
+ *  "Software"), to deal in the Software without restriction, including    *
+ *  without limitation the rights to use, copy, modify, merge, publish,    *
+ *  distribute, sublicense, and/or sell copies of the Software, and to     *
+ *  permit persons to whom the Software is furnished to do so, subject to  *
+ *  the following conditions:                                              *
+ *                                                                         *
+ *  The above copyright notice and this permission notice shall be         *
+ *  included in all copies or substantial portions of the Software.        *
+ *                                                                         *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        *
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     *
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. *
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR      *
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,  *
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR  *
+ *  OTHER DEALINGS IN THE SOFTWARE.                                        *
+ ***************************************************************************/
+
+package org.voltdb.jni;
+
+import java.io.EOFException;
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.lang.reflect.Field;
+import java.nio.ByteBuffer;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.ByteChannel;
+import java.nio.channels.FileChannel;
+import java.nio.channels.SocketChannel;
+
+import sun.misc.Unsafe;
+
+/**
+ * Java end of the shared memory rings between ExecutionEngineIPC and the
+ * voltdbipc process, carrying the same byte stream as the socket would.
+ * One ring goes to the EE and one comes back. A side that has to wait
+ * spins briefly, then parks in a blocking read on the socket, which from
+ * then on only carries one byte doorbells. The other side rings only when
+ * it sees the waiter parked.
+ *
+ * The layout must match src/ee/common/SharedMemoryRing.h: each ring is
+ * CONTROL_BYTES of control words followed by its data, and the ring to
+ * the EE comes first in the file.
+ */
+class SharedMemoryChannel implements ByteChannel {
+    static final int CONTROL_BYTES = 192;
+    private static final int HEAD = 0;
+    private static final int TAIL = 64;
+    private static final int CONSUMER_PARKED = 128;
+    private static final int PRODUCER_PARKED = 132;
+
+    /** How many times a waiter polls the ring before it parks */
+    private static final int SPIN_LIMIT = 10000;
+
+    private static final Unsafe unsafe = getUnsafe();
+
+    private final MappedByteBuffer m_mapped;
+    private final long m_address;
+    private final int m_capacity;
+    private final SocketChannel m_doorbell;
+    private final ByteBuffer m_doorbellByte = ByteBuffer.allocateDirect(1);
+
+    // offsets of the two rings in the file
+    private final int m_toEE;
+    private final int m_fromEE;
+
+    /**
+     * Create and map the file for a pair of rings of the given capacity,
+     * which must be a power of two.
+     */
+    SharedMemoryChannel(File file, int capacity, SocketChannel doorbell) throws IOException {
+        assert(Integer.bitCount(capacity) == 1);
+        m_capacity = capacity;
+        m_doorbell = doorbell;
+        m_toEE = 0;
+        m_fromEE = CONTROL_BYTES + capacity;
+
+        final RandomAccessFile raf = new RandomAccessFile(file, "rw");
+        try {
+            // a fresh file reads as zeros, so the control words start cleared
+            raf.setLength(2L * (CONTROL_BYTES + capacity));
+            m_mapped = raf.getChannel().map(FileChannel.MapMode.READ_WRITE, 0, raf.length());
+        } finally {
+            raf.close();
+        }
+        m_address = ((sun.nio.ch.DirectBuffer)m_mapped).address();
+    }
+
+    @Override
+    public int read(ByteBuffer dst) throws IOException {
+        if (!dst.hasRemaining()) {
+            return 0;
+        }
+        final long control = m_address + m_fromEE;
+        if (!hasData(control) && !waitFor(control + CONSUMER_PARKED, control, true)) {
+            return -1;
+        }
+        final long head = unsafe.getLongVolatile(null, control + HEAD);
+        final long available = unsafe.getLongVolatile(null, control + TAIL) - head;
+        final int offset = (int)(head & (m_capacity - 1));
+        final int chunk = (int)Math.min(dst.remaining(), Math.min(available, m_capacity - offset));
+
+        final ByteBuffer src = m_mapped.duplicate();
+        src.limit(m_fromEE + CONTROL_BYTES + offset + chunk);
+        src.position(m_fromEE + CONTROL_BYTES + offset);
+        dst.put(src);
+
+        // done with the bytes before handing their space back
+        unsafe.putLongVolatile(null, control + HEAD, head + chunk);
+        notify(control + PRODUCER_PARKED);
+        return chunk;
+    }
+
+    @Override
+    public int write(ByteBuffer src) throws IOException {
+        final int total = src.remaining();
+        final long control = m_address + m_toEE;
+        while (src.hasRemaining()) {
+            if (!hasSpace(control) && !waitFor(control + PRODUCER_PARKED, control, false)) {
+                throw new EOFException("EE hung up");
+            }
+            // only this side moves the tail, only the EE the head
+            final long tail = unsafe.getLongVolatile(null, control + TAIL);
+            final long space = m_capacity - (tail - unsafe.getLongVolatile(null, control + HEAD));
+            final int offset = (int)(tail & (m_capacity - 1));
+            final int chunk = (int)Math.min(src.remaining(), Math.min(space, m_capacity - offset));
+
+            final ByteBuffer dst = m_mapped.duplicate();
+            dst.position(m_toEE + CONTROL_BYTES + offset);
+            final ByteBuffer slice = src.duplicate();
+            slice.limit(slice.position() + chunk);
+            dst.put(slice);
+            src.position(src.position() + chunk);
+
+            // the volatile store publishes the bytes before the tail that covers them
+            unsafe.putLongVolatile(null, control + TAIL, tail + chunk);
+            notify(control + CONSUMER_PARKED);
+        }
+        return total;
+    }
+
+    @Override
+    public boolean isOpen() {
+        return m_doorbell.isOpen();
+    }
+
+    @Override
+    public void close() throws IOException {
+        m_doorbell.close();
+    }
+
+    private boolean hasData(long control) {
+        return unsafe.getLongVolatile(null, control + TAIL) != unsafe.getLongVolatile(null, control + HEAD);
+    }
+
+    private boolean hasSpace(long control) {
+        return unsafe.getLongVolatile(null, control + TAIL) - unsafe.getLongVolatile(null, control + HEAD) < m_capacity;
+    }
+
+    private boolean ready(long control, boolean forData) {
+        return forData ? hasData(control) : hasSpace(control);
+    }
+
+    /**
+     * Spin for a while, then park; the same handshake as
+     * SharedMemoryRing::waitFor. Returns false if the EE hung up.
+     */
+    private boolean waitFor(long parked, long control, boolean forData) throws IOException {
+        for (int spins = 0; spins < SPIN_LIMIT; spins++) {
+            if (ready(control, forData)) {
+                return true;
+            }
+        }
+
+        while (true) {
+            unsafe.putIntVolatile(null, parked, 1);
+            if (ready(control, forData) && unsafe.compareAndSwapInt(null, parked, 1, 0)) {
+                return true;
+            }
+
+            // the EE cleared the flag and its doorbell byte is on the way
+            m_doorbellByte.clear();
+            if (m_doorbell.read(m_doorbellByte) != 1) {
+                return false;
+            }
+            if (ready(control, forData)) {
+                return true;
+            }
+        }
+    }
+
+    private void notify(long parked) throws IOException {
+        if (unsafe.getIntVolatile(null, parked) == 0 || !unsafe.compareAndSwapInt(null, parked, 1, 0)) {
+            return;
+        }
+        m_doorbellByte.clear();
+        while (m_doorbellByte.hasRemaining()) {
+            m_doorbell.write(m_doorbellByte);
+        }
+    }
+
+    private static Unsafe getUnsafe() {
+        try {
+            final Field field = Unsafe.class.getDeclaredField("theUnsafe");
+            field.setAccessible(true);
+            return (Unsafe)field.get(null);
+        } catch (final Exception e) {
+            throw new RuntimeException("Shared memory IPC needs sun.misc.Unsafe", e);
+        }
+    }
+}
@@ -56,11 +56,14 @@ import org.voltdb.catalog.Database;
 import org.voltdb.catalog.Table;
 import org.voltdb.expressions.AbstractExpression;
 import org.voltdb.expressions.ExpressionUtil;
+import org.voltdb.expressions.TupleValueExpression;
 import org.voltdb.plannodes.AbstractPlanNode;
+import org.voltdb.plannodes.HashJoinPlanNode;
 import org.voltdb.plannodes.IndexScanPlanNode;
 import org.voltdb.plannodes.NestLoopIndexPlanNode;
 import org.voltdb.plannodes.NestLoopPlanNode;
 import org.voltdb.plannodes.ReceivePlanNode;
+import org.voltdb.types.ExpressionType;
 import org.voltdb.types.JoinType;
 
 /**
@@ -322,7 +325,13 @@ public class SelectSubPlanAssembler extends SubPlanAssembler {
             retval = nlijNode;
         }
         else {
-            NestLoopPlanNode nljNode = new NestLoopPlanNode(m_context, PlanAssembler.getNextPlanNodeId());
+            // without an index on the inner table, an equality between the
+            // two sides lets the EE hash one input instead of rescanning it
+            NestLoopPlanNode nljNode;
+            if (hasEquiJoinClause(joinClauses))
+                nljNode = new HashJoinPlanNode(m_context, PlanAssembler.getNextPlanNodeId());
+            else
+                nljNode = new NestLoopPlanNode(m_context, PlanAssembler.getNextPlanNodeId());
             if ((joinClauses != null) && (joinClauses.size() > 0))
                 nljNode.setPredicate(ExpressionUtil.combine(joinClauses));
             nljNode.setJoinType(JoinType.LEFT);
@@ -347,6 +356,32 @@ public class SelectSubPlanAssembler extends SubPlanAssembler {
         return retval;
     }
 
+    /**
+     * Whether any of the join clauses (or their ANDed parts) is an equality
+     * between columns of two different tables.
+     */
+    private static boolean hasEquiJoinClause(List<AbstractExpression> joinClauses) {
+        if (joinClauses == null)
+            return false;
+        ArrayDeque<AbstractExpression> pending = new ArrayDeque<AbstractExpression>(joinClauses);
+        while (!pending.isEmpty()) {
+            AbstractExpression expr = pending.pop();
+            if (expr.getExpressionType() == ExpressionType.CONJUNCTION_AND) {
+                pending.push(expr.getLeft());
+                pending.push(expr.getRight());
+            }
+            else if (expr.getExpressionType() == ExpressionType.COMPARE_EQUAL &&
+                     expr.getLeft() instanceof TupleValueExpression &&
+                     expr.getRight() instanceof TupleValueExpression) {
+                String left = ((TupleValueExpression) expr.getLeft()).getTableName();
+                String right = ((TupleValueExpression) expr.getRight()).getTableName();
+                if (left != null && !left.equals(right))
+                    return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * For each table in the list, compute the set of all valid access paths that will get
      * tuples that match the right predicate (assuming there is a predicate).
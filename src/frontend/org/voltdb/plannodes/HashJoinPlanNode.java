@@ -0,0 +1,42 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB L.L.C.
+ *
+ * VoltDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VoltDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package org.voltdb.plannodes;
+
+import org.voltdb.planner.PlannerContext;
+import org.voltdb.types.PlanNodeType;
+
+/**
+ * A NestLoopPlanNode whose predicate contains at least one equality between
+ * a column of each input. The EE builds a hash table on the smaller input
+ * keyed on those columns and probes it with the other, instead of scanning
+ * the inner table once per outer tuple.
+ */
+public class HashJoinPlanNode extends NestLoopPlanNode {
+    /**
+     * @param id
+     */
+    public HashJoinPlanNode(PlannerContext context, Integer id) {
+        super(context, id);
+    }
+
+    @Override
+    public PlanNodeType getPlanNodeType() {
+        return PlanNodeType.HASHJOIN;
+    }
+
+}
@@ -0,0 +1,205 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "harness.h"
+
+#include "anticache/AntiCacheBlockCodec.h"
+#include "anticache/AntiCacheDB.h"
+
+using namespace std;
+using namespace voltdb;
+using stupidunit::ChTempDir;
+
+#define BLOCK_SIZE 524288
+
+/**
+ * AntiCacheBlockCodec Tests
+ */
+class AntiCacheBlockCodecTest : public Test {
+public:
+    AntiCacheBlockCodecTest() {
+        srand(1);
+    };
+
+protected:
+    /** Rows that look like evicted stream history: a counter, a few distinct values and padding */
+    string history(int rows) {
+        string data;
+        char row[64];
+        for (int i = 0; i < rows; i++) {
+            int length = snprintf(row, sizeof(row), "%08d|sensor-%02d|%c|reading|", i, i % 16, 'A' + i % 3);
+            data.append(row, length);
+            data.append(16, '\0');
+        }
+        return data;
+    }
+
+    string noise(size_t length) {
+        string data(length, '\0');
+        for (size_t i = 0; i < length; i++) {
+            data[i] = static_cast<char>(rand() & 0xff);
+        }
+        return data;
+    }
+
+    /** Encode and decode, returning the encoded size */
+    size_t roundTrip(const AntiCacheBlockCodec *codec, const string &data) {
+        size_t encodedLength;
+        char *encoded = AntiCacheBlockCodec::encode(codec, data.data(), data.size(), encodedLength);
+        size_t decodedLength = 0;
+        char *decoded = AntiCacheBlockCodec::decode(encoded, encodedLength, decodedLength);
+        EXPECT_TRUE(decoded != NULL);
+        if (decoded != NULL) {
+            EXPECT_EQ(data.size(), decodedLength);
+            EXPECT_EQ(data, string(decoded, decodedLength));
+        }
+        delete [] decoded;
+        delete [] encoded;
+        return encodedLength;
+    }
+};
+
+TEST_F(AntiCacheBlockCodecTest, CompressesRepetitiveBlocks) {
+    const AntiCacheBlockCodec *lz = AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ);
+    string data = history(10000);
+    size_t encodedLength = roundTrip(lz, data);
+    EXPECT_TRUE(encodedLength * 3 < data.size());
+
+    // a run of one byte comes out as a chain of the longest back references,
+    // 264 bytes for every 3
+    string zeros(BLOCK_SIZE, '\0');
+    encodedLength = roundTrip(lz, zeros);
+    EXPECT_TRUE(encodedLength * 50 < zeros.size());
+}
+
+TEST_F(AntiCacheBlockCodecTest, RoundTripsAnything) {
+    const AntiCacheBlockCodec *lz = AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ);
+    roundTrip(lz, "");
+    roundTrip(lz, "a");
+    roundTrip(lz, "abc");
+    roundTrip(lz, "abcabcabcabcabcabc");
+    for (size_t length = 1; length < 300; length += 7) {
+        roundTrip(lz, noise(length));
+        roundTrip(lz, history(static_cast<int>(length)));
+    }
+    // mostly repeats with some noise between them
+    string mixed;
+    for (int i = 0; i < 200; i++) {
+        mixed += history(3) + noise(i % 40);
+    }
+    roundTrip(lz, mixed);
+}
+
+TEST_F(AntiCacheBlockCodecTest, StoresIncompressibleBlocksAsTheyAre) {
+    const AntiCacheBlockCodec *lz = AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ);
+    string data = noise(4096);
+    size_t encodedLength;
+    char *encoded = AntiCacheBlockCodec::encode(lz, data.data(), data.size(), encodedLength);
+    EXPECT_EQ(AntiCacheBlockCodec::CODEC_NONE, encoded[0]);
+    EXPECT_EQ(data.size() + AntiCacheBlockCodec::HEADER_SIZE, encodedLength);
+    delete [] encoded;
+
+    roundTrip(AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_NONE), history(100));
+}
+
+TEST_F(AntiCacheBlockCodecTest, RejectsCorruptBlocks) {
+    const AntiCacheBlockCodec *lz = AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ);
+    string data = history(500);
+    size_t encodedLength;
+    char *encoded = AntiCacheBlockCodec::encode(lz, data.data(), data.size(), encodedLength);
+    ASSERT_EQ(AntiCacheBlockCodec::CODEC_LZ, encoded[0]);
+
+    size_t decodedLength;
+    // cut short
+    EXPECT_TRUE(AntiCacheBlockCodec::decode(encoded, encodedLength / 2, decodedLength) == NULL);
+    EXPECT_TRUE(AntiCacheBlockCodec::decode(encoded, 3, decodedLength) == NULL);
+    // larger than the payload can decompress to
+    uint32_t length;
+    memcpy(&length, encoded + 1, sizeof(length));
+    uint32_t huge = 0xffffffff;
+    memcpy(encoded + 1, &huge, sizeof(huge));
+    EXPECT_TRUE(AntiCacheBlockCodec::decode(encoded, encodedLength, decodedLength) == NULL);
+    memcpy(encoded + 1, &length, sizeof(length));
+    // unknown codec
+    encoded[0] = 42;
+    EXPECT_TRUE(AntiCacheBlockCodec::decode(encoded, encodedLength, decodedLength) == NULL);
+    // a back reference before the start of the block
+    encoded[0] = AntiCacheBlockCodec::CODEC_LZ;
+    encoded[AntiCacheBlockCodec::HEADER_SIZE] = static_cast<char>(0xff);
+    EXPECT_TRUE(AntiCacheBlockCodec::decode(encoded, encodedLength, decodedLength) == NULL);
+    delete [] encoded;
+}
+
+TEST_F(AntiCacheBlockCodecTest, AntiCacheDBDecompressesOnRead) {
+    ChTempDir tempdir;
+    AntiCacheDB anticache(NULL, ".", BLOCK_SIZE);
+    string data = history(5000);
+    int16_t blockId = anticache.nextBlockId();
+    anticache.writeBlock("FAKE", blockId, 5000, data.data(), static_cast<long>(data.size()));
+
+    AntiCacheBlock block = anticache.readBlock("FAKE", blockId);
+    EXPECT_EQ(static_cast<long>(data.size()), block.getSize());
+    EXPECT_EQ(data, string(block.getData(), block.getSize()));
+}
+
+TEST_F(AntiCacheBlockCodecTest, AntiCacheDBReadsBlocksLargerThanBlockSize) {
+    // evictions pick their own block size, which may exceed the one the
+    // AntiCacheDB was started with
+    ChTempDir tempdir;
+    AntiCacheDB anticache(NULL, ".", BLOCK_SIZE / 4);
+    string blocks[2] = { history(BLOCK_SIZE / 40), noise(BLOCK_SIZE) };
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(blocks[i].size() > BLOCK_SIZE / 4);
+        int16_t blockId = anticache.nextBlockId();
+        anticache.writeBlock("FAKE", blockId, 1, blocks[i].data(), static_cast<long>(blocks[i].size()));
+
+        AntiCacheBlock block = anticache.readBlock("FAKE", blockId);
+        EXPECT_EQ(static_cast<long>(blocks[i].size()), block.getSize());
+        EXPECT_EQ(blocks[i], string(block.getData(), block.getSize()));
+    }
+}
+
+TEST_F(AntiCacheBlockCodecTest, LongestMatchesFitTheBound) {
+    const AntiCacheBlockCodec *lz = AntiCacheBlockCodec::forId(AntiCacheBlockCodec::CODEC_LZ);
+    string zeros(BLOCK_SIZE * 2, '\0');
+    size_t encodedLength;
+    char *encoded = AntiCacheBlockCodec::encode(lz, zeros.data(), zeros.size(), encodedLength);
+    ASSERT_EQ(AntiCacheBlockCodec::CODEC_LZ, encoded[0]);
+    EXPECT_TRUE(lz->maxUncompressedLength(encodedLength - AntiCacheBlockCodec::HEADER_SIZE) >= zeros.size());
+    size_t decodedLength;
+    char *decoded = AntiCacheBlockCodec::decode(encoded, encodedLength, decodedLength);
+    EXPECT_TRUE(decoded != NULL);
+    EXPECT_EQ(zeros.size(), decodedLength);
+    delete [] decoded;
+    delete [] encoded;
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
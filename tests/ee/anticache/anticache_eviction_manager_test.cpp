@@ -46,6 +46,8 @@
 #include "boost/scoped_ptr.hpp"
 
 #include "anticache/AntiCacheDB.h"
+#include "anticache/AntiCacheEvictionManager.h"
+#include "anticache/EvictionIterator.h"
 
 using namespace std;
 using namespace voltdb;
@@ -60,6 +62,7 @@ public:
         m_tuplesInserted = 0;
         m_tuplesUpdated = 0;
         m_tuplesDeleted = 0;
+        m_table = NULL;
 
         m_engine = new voltdb::VoltDBEngine();
         m_engine->initialize(1,1, 0, 0, "");
@@ -138,11 +141,21 @@ public:
         m_table->setEvictedTable(evicted_table);
     }
     
+    /** Access a tuple the way a query would, without changing it */
+    void touchTuple(int key)
+    {
+        TableTuple tuple = m_table->tempTuple();
+        tuple.setNValue(0, ValueFactory::getIntegerValue(key));
+        tuple = m_table->lookupTuple(tuple);
+        ASSERT_FALSE(tuple.isNullTuple());
+        m_engine->getExecutorContext()->getAntiCacheEvictionManager()->updateTuple(m_table, &tuple, false);
+    }
+    
     void cleanupTable()
     {
-        delete m_table->getEvictedTable();
+        // the table owns its EvictedTable
         delete m_table;
-    
+        m_table = NULL;
     }
     
     voltdb::VoltDBEngine *m_engine;
@@ -185,6 +198,8 @@ TEST_F(AntiCacheEvictionManagerTest, GetTupleID)
     cleanupTable(); 
 }
 
+#ifndef ANTICACHE_CLOCK
+
 TEST_F(AntiCacheEvictionManagerTest, NewestTupleID)
 {
     int inserted_tuple_id, newest_tuple_id; 
@@ -326,6 +341,8 @@ TEST_F(AntiCacheEvictionManagerTest, DeleteMultipleTuples)
     cleanupTable();
 }
 
+#endif
+
 TEST_F(AntiCacheEvictionManagerTest, UpdateIndexPerformance)
 {
     int num_tuples = 100000;
@@ -440,6 +457,119 @@ TEST_F(AntiCacheEvictionManagerTest, UpdateIndexPerformance)
 //   
 // }
 
+#ifdef ANTICACHE_CLOCK
+
+TEST_F(AntiCacheEvictionManagerTest, ClockMarksAccessedTuples)
+{
+    initTable(true);
+    
+    TableTuple tuple = m_table->tempTuple();
+    for(int i = 0; i < 10; i++)
+    {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(m_tuplesInserted++));
+        tuple.setNValue(1, ValueFactory::getIntegerValue(rand()));
+        m_table->insertTuple(tuple);
+    }
+    
+    // inserting only sets the bit, nothing is linked into a chain
+    ASSERT_EQ(0, m_table->getNumTuplesInEvictionChain());
+    TableIterator itr(m_table);
+    while(itr.next(tuple))
+    {
+        ASSERT_TRUE(tuple.isAccessed());
+    }
+    
+    cleanupTable();
+}
+
+TEST_F(AntiCacheEvictionManagerTest, ClockSecondChance)
+{
+    int num_tuples = 10;
+    
+    initTable(true);
+    
+    TableTuple tuple = m_table->tempTuple();
+    for(int i = 0; i < num_tuples; i++)
+    {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(m_tuplesInserted++));
+        tuple.setNValue(1, ValueFactory::getIntegerValue(rand()));
+        m_table->insertTuple(tuple);
+    }
+    
+    // every tuple was just inserted, so the hand clears a full turn of bits
+    // before it settles on the first slot
+    EvictionIterator first_itr(m_table);
+    ASSERT_TRUE(first_itr.next(tuple));
+    ASSERT_EQ(0, ValuePeeker::peekAsInteger(tuple.getNValue(0)));
+    for(int i = 0; i < num_tuples; i += 2)
+    {
+        touchTuple(i);
+    }
+    
+    // the touched tuples are skipped once, the rest come up in slot order
+    EvictionIterator second_itr(m_table);
+    for(int i = 1; i < num_tuples; i += 2)
+    {
+        ASSERT_TRUE(second_itr.hasNext());
+        ASSERT_TRUE(second_itr.next(tuple));
+        ASSERT_EQ(i, ValuePeeker::peekAsInteger(tuple.getNValue(0)));
+    }
+    
+    cleanupTable();
+}
+
+TEST_F(AntiCacheEvictionManagerTest, ClockEvictBlock)
+{
+    int num_tuples = 100;
+    
+    ChTempDir tempdir;
+    initTable(true);
+    
+    TableTuple tuple = m_table->tempTuple();
+    
+    // persistenttable.cpp stops filling a block once less than 2500 bytes are left
+    long block_size = 2500 + 20 * tuple.tupleLength();
+    m_engine->antiCacheInitialize(".", block_size);
+    AntiCacheEvictionManager* eviction_manager = m_engine->getExecutorContext()->getAntiCacheEvictionManager();
+    
+    for(int i = 0; i < num_tuples; i++)
+    {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(m_tuplesInserted++));
+        tuple.setNValue(1, ValueFactory::getIntegerValue(rand()));
+        m_table->insertTuple(tuple);
+    }
+    
+    eviction_manager->evictBlock(m_table, block_size, 1);
+    int block_tuples = m_table->getTuplesEvicted();
+    ASSERT_TRUE(block_tuples > 0);
+    ASSERT_TRUE(3 * block_tuples <= num_tuples);
+    
+    // touch the block that would be evicted next
+    for(int i = block_tuples; i < 2 * block_tuples; i++)
+    {
+        touchTuple(i);
+    }
+    eviction_manager->evictBlock(m_table, block_size, 1);
+    ASSERT_EQ(2 * block_tuples, m_table->getTuplesEvicted());
+    
+    std::set<int> resident;
+    TableIterator itr(m_table);
+    while(itr.next(tuple))
+    {
+        resident.insert(ValuePeeker::peekAsInteger(tuple.getNValue(0)));
+    }
+    ASSERT_EQ(num_tuples - 2 * block_tuples, (int)resident.size());
+    for(int i = 0; i < num_tuples; i++)
+    {
+        bool evicted = (i < block_tuples) || (i >= 2 * block_tuples && i < 3 * block_tuples);
+        ASSERT_EQ(!evicted, resident.find(i) != resident.end());
+    }
+    
+    cleanupTable();
+}
+
+#endif
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,209 @@
+/* Copyright (C) 2012 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include "harness.h"
+
+#include "anticache/AntiCacheDB.h"
+#include "anticache/AntiCacheReader.h"
+#include "anticache/UnknownBlockAccessException.h"
+
+using namespace std;
+using namespace voltdb;
+using stupidunit::ChTempDir;
+
+#define BLOCK_SIZE 524288
+
+/**
+ * AntiCacheReader Tests
+ */
+class AntiCacheReaderTest : public Test {
+public:
+    AntiCacheReaderTest() {
+        m_anticache = new AntiCacheDB(NULL, ".", BLOCK_SIZE);
+    }
+
+    ~AntiCacheReaderTest() {
+        delete m_anticache;
+    }
+
+protected:
+    /** Evict a block whose contents are its table's name and its id */
+    int16_t writeBlock(const string &tableName) {
+        int16_t blockId = m_anticache->nextBlockId();
+        string payload = contents(tableName, blockId);
+        m_anticache->writeBlock(tableName, blockId, 1, payload.data(), static_cast<long>(payload.size()));
+        return blockId;
+    }
+
+    string contents(const string &tableName, int16_t blockId) {
+        return tableName + "#" + string(blockId, '*');
+    }
+
+    /** Check what takeStaged() hands over and free it */
+    void expectStaged(AntiCacheReader &reader, const string &tableName,
+                      const vector<int16_t> &blockIds, const vector<int32_t> &tupleOffsets) {
+        vector<char*> blocks;
+        vector<int32_t> offsets;
+        reader.takeStaged(tableName, blocks, offsets);
+        ASSERT_EQ(blockIds.size(), blocks.size());
+        ASSERT_EQ(blockIds.size(), offsets.size());
+        for (size_t i = 0; i < blocks.size(); i++) {
+            string expected = contents(tableName, blockIds[i]);
+            EXPECT_EQ(expected, string(blocks[i], expected.size()));
+            EXPECT_EQ(tupleOffsets[i], offsets[i]);
+            delete [] blocks[i];
+        }
+    }
+
+    ChTempDir m_tempdir;
+    AntiCacheDB *m_anticache;
+};
+
+TEST_F(AntiCacheReaderTest, ReadsRequestedBlocks) {
+    AntiCacheReader reader(m_anticache, 3, 0);
+    vector<int16_t> blockIds;
+    vector<int32_t> tupleOffsets;
+    for (int i = 0; i < 10; i++) {
+        blockIds.push_back(writeBlock("FAKE"));
+        tupleOffsets.push_back(i * 3);
+    }
+
+    // everything is in flight before the first wait
+    for (size_t i = 0; i < blockIds.size(); i++) {
+        reader.request("FAKE", blockIds[i]);
+    }
+    for (size_t i = 0; i < blockIds.size(); i++) {
+        reader.stage("FAKE", blockIds[i], tupleOffsets[i]);
+    }
+    expectStaged(reader, "FAKE", blockIds, tupleOffsets);
+
+    // nothing is left over for the next merge
+    expectStaged(reader, "FAKE", vector<int16_t>(), vector<int32_t>());
+}
+
+TEST_F(AntiCacheReaderTest, StagesWithoutRequest) {
+    AntiCacheReader reader(m_anticache, 1, 0);
+    vector<int16_t> blockIds(1, writeBlock("FAKE"));
+    reader.stage("FAKE", blockIds[0], 7);
+    expectStaged(reader, "FAKE", blockIds, vector<int32_t>(1, 7));
+}
+
+TEST_F(AntiCacheReaderTest, ReadsAheadInTheSameTable) {
+    int16_t first = writeBlock("FAKE");
+    int16_t other = writeBlock("OTHER");
+    int16_t second = writeBlock("FAKE");
+    int16_t third = writeBlock("FAKE");
+    int16_t fourth = writeBlock("FAKE");
+
+    vector<int16_t> next = m_anticache->blocksEvictedAfter("FAKE", first, 2);
+    ASSERT_EQ(2, next.size());
+    EXPECT_EQ(second, next[0]);
+    EXPECT_EQ(third, next[1]);
+
+    AntiCacheReader reader(m_anticache, 2, 2);
+    reader.request("FAKE", first);
+    reader.stage("FAKE", first, 0);
+    // the blocks read ahead are there when they are asked for
+    reader.stage("FAKE", second, 1);
+    reader.stage("FAKE", third, 2);
+    vector<int16_t> blockIds;
+    blockIds.push_back(first);
+    blockIds.push_back(second);
+    blockIds.push_back(third);
+    vector<int32_t> tupleOffsets;
+    tupleOffsets.push_back(0);
+    tupleOffsets.push_back(1);
+    tupleOffsets.push_back(2);
+    expectStaged(reader, "FAKE", blockIds, tupleOffsets);
+    expectStaged(reader, "OTHER", vector<int16_t>(), vector<int32_t>());
+
+    // blocks that are back in are no longer read ahead
+    next = m_anticache->blocksEvictedAfter("FAKE", first, 2);
+    ASSERT_EQ(1, next.size());
+    EXPECT_EQ(fourth, next[0]);
+    EXPECT_EQ(0, m_anticache->blocksEvictedAfter("OTHER", other, 2).size());
+}
+
+TEST_F(AntiCacheReaderTest, BoundsReadAhead) {
+    const int count = static_cast<int>(AntiCacheReader::MAX_READ_AHEAD_BLOCKS) + 8;
+    vector<int16_t> blockIds;
+    for (int i = 0; i <= count; i++) {
+        blockIds.push_back(writeBlock("FAKE"));
+    }
+
+    AntiCacheReader reader(m_anticache, 1, count);
+    reader.request("FAKE", blockIds[0]);
+    EXPECT_TRUE(reader.readAheadBlocks() <= AntiCacheReader::MAX_READ_AHEAD_BLOCKS);
+
+    // blocks pushed out of the read-ahead are still there to be read
+    for (size_t i = 0; i < blockIds.size(); i++) {
+        reader.stage("FAKE", blockIds[i], 0);
+    }
+    EXPECT_EQ(0, reader.readAheadBlocks());
+    expectStaged(reader, "FAKE", blockIds, vector<int32_t>(blockIds.size(), 0));
+}
+
+TEST_F(AntiCacheReaderTest, StagesPerTable) {
+    AntiCacheReader reader(m_anticache, 2, 1);
+    vector<int16_t> fake(1, writeBlock("FAKE"));
+    vector<int16_t> other(1, writeBlock("OTHER"));
+    reader.request("FAKE", fake[0]);
+    reader.request("OTHER", other[0]);
+    reader.stage("OTHER", other[0], 4);
+    reader.stage("FAKE", fake[0], 5);
+    expectStaged(reader, "OTHER", other, vector<int32_t>(1, 4));
+    expectStaged(reader, "FAKE", fake, vector<int32_t>(1, 5));
+}
+
+TEST_F(AntiCacheReaderTest, UnknownBlock) {
+    AntiCacheReader reader(m_anticache, 1, 0);
+    reader.request("FAKE", 1234);
+    bool thrown = false;
+    try {
+        reader.stage("FAKE", 1234, 0);
+    } catch (UnknownBlockAccessException &e) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    expectStaged(reader, "FAKE", vector<int16_t>(), vector<int32_t>());
+}
+
+TEST_F(AntiCacheReaderTest, ReadsWithoutThreads) {
+    // as if no thread could be started
+    AntiCacheReader reader(m_anticache, 0, 1);
+    vector<int16_t> blockIds;
+    blockIds.push_back(writeBlock("FAKE"));
+    blockIds.push_back(writeBlock("FAKE"));
+    reader.request("FAKE", blockIds[0]);
+    reader.stage("FAKE", blockIds[0], 0);
+    reader.stage("FAKE", blockIds[1], 0);
+    expectStaged(reader, "FAKE", blockIds, vector<int32_t>(2, 0));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
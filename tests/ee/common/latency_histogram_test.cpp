@@ -0,0 +1,111 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/LatencyHistogram.hpp"
+#include <stdint.h>
+
+using voltdb::LatencyHistogram;
+
+class LatencyHistogramTest : public Test {
+public:
+    LatencyHistogramTest() {}
+};
+
+TEST_F(LatencyHistogramTest, Empty) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.count());
+    EXPECT_EQ(0, histogram.percentile(0.5));
+    EXPECT_EQ(0, histogram.max());
+}
+
+TEST_F(LatencyHistogramTest, BucketsCoverEveryValue) {
+    // each value falls inside the bounds of its bucket, and buckets are ordered
+    int last = -1;
+    for (int64_t value = 0; value < (1LL << 20); value += 7) {
+        int bucket = LatencyHistogram::bucketFor(value);
+        ASSERT_TRUE(bucket >= last);
+        ASSERT_TRUE(bucket < LatencyHistogram::NUM_BUCKETS);
+        ASSERT_TRUE(value <= LatencyHistogram::bucketUpperBound(bucket));
+        if (bucket > 0) {
+            ASSERT_TRUE(value > LatencyHistogram::bucketUpperBound(bucket - 1));
+        }
+        last = bucket;
+    }
+    EXPECT_EQ(LatencyHistogram::NUM_BUCKETS - 1, LatencyHistogram::bucketFor(INT64_MAX));
+}
+
+TEST_F(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (int64_t value = 1; value <= 1000; value++) {
+        histogram.record(value * 1000);
+    }
+    EXPECT_EQ(1000, histogram.count());
+    EXPECT_EQ(1000000, histogram.max());
+
+    // log-scale buckets are accurate to within one sub-bucket (1/8)
+    int64_t p50 = histogram.percentile(0.5);
+    EXPECT_TRUE(p50 >= 500000 && p50 <= 500000 + 500000 / 8);
+    int64_t p99 = histogram.percentile(0.99);
+    EXPECT_TRUE(p99 >= 990000 && p99 <= 1000000);
+    EXPECT_EQ(1000000, histogram.percentile(0.999));
+    EXPECT_EQ(1000000, histogram.percentile(1.0));
+}
+
+TEST_F(LatencyHistogramTest, NearestRank) {
+    // values below 8 have a bucket each, so percentiles are exact
+    LatencyHistogram histogram;
+    histogram.record(1);
+    histogram.record(2);
+    histogram.record(3);
+    // ceil(0.5 * 3) = 2nd sample
+    EXPECT_EQ(2, histogram.percentile(0.5));
+    EXPECT_EQ(1, histogram.percentile(0.2));
+    EXPECT_EQ(3, histogram.percentile(0.67));
+    EXPECT_EQ(3, histogram.percentile(0.99));
+}
+
+TEST_F(LatencyHistogramTest, MergeAndReset) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.record(10);
+    second.record(5000);
+    second.record(-3);
+    first.merge(second);
+    EXPECT_EQ(3, first.count());
+    EXPECT_EQ(5000, first.max());
+    EXPECT_EQ(5010, first.total());
+
+    first.reset();
+    EXPECT_EQ(0, first.count());
+    EXPECT_EQ(0, first.percentile(0.99));
+}
+
+TEST_F(LatencyHistogramTest, MonotonicClock) {
+    int64_t start = LatencyHistogram::now();
+    int64_t end = LatencyHistogram::now();
+    EXPECT_TRUE(end >= start);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -25,6 +25,8 @@
 #include "common/ValueFactory.hpp"
 #include "common/ValuePeeker.hpp"
 #include "common/serializeio.h"
+#include "common/Pool.hpp"
+#include "common/StringRef.h"
 
 #include <cfloat>
 #include <limits>
@@ -1940,6 +1942,64 @@ TEST_F(NValueTest, SerializeToExport)
     out.position(0);
 }
 
+TEST_F(NValueTest, DeserializeReferencingInput)
+{
+    Pool pool;
+    std::string shortString("short");
+    std::string longString(200, 'x');
+    NValue values[4] = {
+        ValueFactory::getStringValue(shortString),
+        ValueFactory::getStringValue(longString),
+        ValueFactory::getIntegerValue(42),
+        NValue::getNullValue(VALUE_TYPE_VARCHAR)
+    };
+
+    // laid out like a ParameterSet from Java
+    char buf[1024];
+    ReferenceSerializeOutput out(buf, sizeof(buf));
+    for (int ii = 0; ii < 4; ii++) {
+        out.writeByte(static_cast<int8_t>(ValuePeeker::peekValueType(values[ii])));
+        values[ii].serializeTo(out);
+    }
+    size_t length = out.position();
+    char original[1024];
+    ::memcpy(original, buf, length);
+
+    ReferenceSerializeInput in(buf, length);
+    NValue referenced[4];
+    for (int ii = 0; ii < 4; ii++) {
+        referenced[ii] = NValue::deserializeReferencingInput(in, &pool);
+        EXPECT_EQ(0, values[ii].compare(referenced[ii]));
+    }
+    EXPECT_TRUE(referenced[3].isNull());
+
+    // the strings are not copied...
+    for (int ii = 0; ii < 2; ii++) {
+        char *object = static_cast<char*>(ValuePeeker::peekObjectValue(referenced[ii]));
+        EXPECT_TRUE(object > buf && object < buf + length);
+    }
+
+    // ...and read back the same through tuple storage and serialization
+    StringRef *storage;
+    referenced[1].serializeToTupleStorage(&storage, false, 1000);
+    NValue stored = NValue::deserializeFromTupleStorage(&storage, VALUE_TYPE_VARCHAR, false);
+    EXPECT_EQ(200, ValuePeeker::peekObjectLength(stored));
+    EXPECT_EQ(0, values[1].compare(stored));
+
+    char again[1024];
+    ReferenceSerializeOutput againOut(again, sizeof(again));
+    for (int ii = 0; ii < 4; ii++) {
+        againOut.writeByte(static_cast<int8_t>(ValuePeeker::peekValueType(referenced[ii])));
+        referenced[ii].serializeTo(againOut);
+    }
+    ASSERT_EQ(length, againOut.position());
+    EXPECT_EQ(0, ::memcmp(original, again, length));
+
+    for (int ii = 0; ii < 2; ii++) {
+        values[ii].free();
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,183 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/SharedMemoryRing.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using voltdb::SharedMemoryRing;
+
+static const size_t CAPACITY = 64 * 1024;
+
+static char patternByte(size_t offset) {
+    return static_cast<char>((offset * 31 + offset / 997) % 253);
+}
+
+/** Both ends of a ring, as two processes would see it */
+class SharedMemoryRingTest : public Test {
+public:
+    SharedMemoryRingTest() {
+        m_regionSize = 2 * (SharedMemoryRing::CONTROL_BYTES + CAPACITY);
+        m_region = static_cast<char*>(mmap(NULL, m_regionSize, PROT_READ | PROT_WRITE,
+                                           MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+        SharedMemoryRing::initialize(m_region);
+        SharedMemoryRing::initialize(m_region + SharedMemoryRing::CONTROL_BYTES + CAPACITY);
+        socketpair(AF_UNIX, SOCK_STREAM, 0, m_doorbell);
+    }
+
+    ~SharedMemoryRingTest() {
+        close(m_doorbell[0]);
+        close(m_doorbell[1]);
+        munmap(m_region, m_regionSize);
+    }
+
+    /** The ring one side writes and the other reads */
+    char* ring(int which) {
+        return m_region + which * (SharedMemoryRing::CONTROL_BYTES + CAPACITY);
+    }
+
+    char *m_region;
+    size_t m_regionSize;
+    int m_doorbell[2];
+};
+
+struct Producer {
+    SharedMemoryRing *ring;
+    size_t total;
+    bool ok;
+};
+
+/** Writes total pattern bytes in chunks of varying size, some larger than the ring */
+static void* produce(void *arg) {
+    Producer *producer = static_cast<Producer*>(arg);
+    std::vector<char> chunk;
+    size_t written = 0;
+    size_t size = 1;
+    producer->ok = true;
+    while (written < producer->total && producer->ok) {
+        size = (size * 7 + 13) % (3 * CAPACITY);
+        size_t amount = std::min(size + 1, producer->total - written);
+        chunk.resize(amount);
+        for (size_t ii = 0; ii < amount; ii++) {
+            chunk[ii] = patternByte(written + ii);
+        }
+        producer->ok = producer->ring->write(&chunk[0], amount);
+        written += amount;
+    }
+    return NULL;
+}
+
+TEST_F(SharedMemoryRingTest, StreamsThroughSmallRing) {
+    SharedMemoryRing writer(ring(0), CAPACITY, m_doorbell[0]);
+    SharedMemoryRing reader(ring(0), CAPACITY, m_doorbell[1]);
+    EXPECT_EQ(CAPACITY, reader.capacity());
+
+    Producer producer = { &writer, 8 * 1024 * 1024 + 5, false };
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, produce, &producer));
+
+    std::vector<char> chunk(CAPACITY * 2);
+    size_t read = 0;
+    size_t size = 3;
+    bool matches = true;
+    while (read < producer.total) {
+        size = (size * 5 + 11) % chunk.size();
+        size_t amount = std::min(size + 1, producer.total - read);
+        ASSERT_TRUE(reader.read(&chunk[0], amount));
+        for (size_t ii = 0; ii < amount; ii++) {
+            matches = matches && chunk[ii] == patternByte(read + ii);
+        }
+        read += amount;
+    }
+    pthread_join(thread, NULL);
+    EXPECT_TRUE(producer.ok);
+    EXPECT_TRUE(matches);
+}
+
+struct Echo {
+    SharedMemoryRing *requests;
+    SharedMemoryRing *responses;
+    int rounds;
+};
+
+/** Answers every 4 byte request with the request plus one */
+static void* echo(void *arg) {
+    Echo *server = static_cast<Echo*>(arg);
+    for (int ii = 0; ii < server->rounds; ii++) {
+        int32_t value;
+        if (!server->requests->read(reinterpret_cast<char*>(&value), sizeof(value))) {
+            break;
+        }
+        value++;
+        if (!server->responses->write(reinterpret_cast<char*>(&value), sizeof(value))) {
+            break;
+        }
+        if (ii % 1000 == 0) {
+            // long enough for the other side to park
+            usleep(2000);
+        }
+    }
+    return NULL;
+}
+
+TEST_F(SharedMemoryRingTest, RequestResponse) {
+    SharedMemoryRing clientRequests(ring(0), CAPACITY, m_doorbell[0]);
+    SharedMemoryRing clientResponses(ring(1), CAPACITY, m_doorbell[0]);
+    SharedMemoryRing serverRequests(ring(0), CAPACITY, m_doorbell[1]);
+    SharedMemoryRing serverResponses(ring(1), CAPACITY, m_doorbell[1]);
+
+    Echo server = { &serverRequests, &serverResponses, 20000 };
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, echo, &server));
+
+    for (int32_t ii = 0; ii < server.rounds; ii++) {
+        ASSERT_TRUE(clientRequests.write(reinterpret_cast<char*>(&ii), sizeof(ii)));
+        int32_t answer = -1;
+        ASSERT_TRUE(clientResponses.read(reinterpret_cast<char*>(&answer), sizeof(answer)));
+        ASSERT_EQ(ii + 1, answer);
+    }
+    pthread_join(thread, NULL);
+}
+
+TEST_F(SharedMemoryRingTest, HangupEndsRead) {
+    SharedMemoryRing writer(ring(0), CAPACITY, m_doorbell[0]);
+    SharedMemoryRing reader(ring(0), CAPACITY, m_doorbell[1]);
+
+    // what is already in the ring can still be read
+    char byte = 'x';
+    ASSERT_TRUE(writer.write(&byte, 1));
+    close(m_doorbell[0]);
+    m_doorbell[0] = -1;
+    char received = 0;
+    EXPECT_TRUE(reader.read(&received, 1));
+    EXPECT_EQ('x', received);
+    EXPECT_FALSE(reader.read(&received, 1));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
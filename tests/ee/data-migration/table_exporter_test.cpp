@@ -0,0 +1,423 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "data-migration/attribute.h"
+#include "data-migration/postgres.h"
+#include "data-migration/tableExporter.h"
+#include "data-migration/typeAttributeMap.h"
+#include "execution/VoltDBEngine.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_COLUMNS 7
+
+ValueType COLUMN_TYPES[NUM_OF_COLUMNS] = { VALUE_TYPE_TINYINT,
+                                           VALUE_TYPE_SMALLINT,
+                                           VALUE_TYPE_INTEGER,
+                                           VALUE_TYPE_BIGINT,
+                                           VALUE_TYPE_DOUBLE,
+                                           VALUE_TYPE_TIMESTAMP,
+                                           VALUE_TYPE_VARCHAR };
+
+class TableExporterTest : public Test {
+public:
+    TableExporterTest() : m_table(NULL) {
+        char path[] = "/tmp/table_exporter_testXXXXXX";
+        int fd = mkstemp(path);
+        close(fd);
+        m_path = path;
+    }
+
+    ~TableExporterTest() {
+        if (m_table != NULL) {
+            // the temp table holds the strings fill() allocated
+            m_table->deleteAllTuples(true);
+            delete m_table;
+        }
+        unlink(m_path.c_str());
+        unlink((m_path + ".expected").c_str());
+    }
+
+protected:
+    TupleSchema* createSchema(int columns = NUM_OF_COLUMNS) {
+        std::vector<ValueType> columnTypes;
+        std::vector<int32_t> columnLengths;
+        std::vector<bool> columnAllowNull;
+        for (int i = 0; i < columns; i++) {
+            columnTypes.push_back(COLUMN_TYPES[i]);
+            columnLengths.push_back(COLUMN_TYPES[i] == VALUE_TYPE_VARCHAR ?
+                                    300 : NValue::getTupleStorageSize(COLUMN_TYPES[i]));
+            // the first column is the only one that can't be NULL
+            columnAllowNull.push_back(i != 0);
+        }
+        return TupleSchema::createTupleSchema(columnTypes, columnLengths, columnAllowNull, true);
+    }
+
+    std::string* columnNames() {
+        std::string *names = new std::string[NUM_OF_COLUMNS];
+        for (int i = 0; i < NUM_OF_COLUMNS; i++) {
+            std::ostringstream name;
+            name << "C" << i;
+            names[i] = name.str();
+        }
+        return names;
+    }
+
+    /**
+     * Every fifth row has NULLs in all the nullable columns. Persistent
+     * tables copy the strings they are given, temp tables keep them.
+     */
+    void fill(Table *table, int rows, bool copiesStrings) {
+        TableTuple &tuple = table->tempTuple();
+        for (int row = 0; row < rows; row++) {
+            if (row % 5 == 3) {
+                tuple.setNValue(0, ValueFactory::getTinyIntValue(static_cast<int8_t>(row % 100)));
+                for (int i = 1; i < table->columnCount(); i++) {
+                    tuple.setNValue(i, NValue::getNullValue(COLUMN_TYPES[i]));
+                }
+            } else {
+                tuple.setNValue(0, ValueFactory::getTinyIntValue(static_cast<int8_t>(row % 100 - 50)));
+                tuple.setNValue(1, ValueFactory::getSmallIntValue(static_cast<int16_t>(row - 1000)));
+                tuple.setNValue(2, ValueFactory::getIntegerValue(row * 7919));
+                tuple.setNValue(3, ValueFactory::getBigIntValue(static_cast<int64_t>(row) << 33));
+                tuple.setNValue(4, ValueFactory::getDoubleValue(row / 8.0 - 3.25));
+                tuple.setNValue(5, ValueFactory::getTimestampValue(1400000000000000LL + row));
+                if (table->columnCount() == 6) {
+                    table->insertTuple(tuple);
+                    continue;
+                }
+                // short strings and ones long enough to need a long length prefix
+                std::string text(row % 7 == 0 ? 200 + row % 50 : row % 13, static_cast<char>('a' + row % 26));
+                NValue string = ValueFactory::getStringValue(text);
+                tuple.setNValue(6, string);
+                table->insertTuple(tuple);
+                if (copiesStrings) {
+                    string.free();
+                }
+                continue;
+            }
+            table->insertTuple(tuple);
+        }
+    }
+
+    void createTable(int rows, int columns = NUM_OF_COLUMNS) {
+        std::string *names = columnNames();
+        m_table = TableFactory::getTempTable(1000, "EXPORTED", createSchema(columns), names, NULL);
+        delete[] names;
+        fill(m_table, rows, false);
+    }
+
+    std::string exportTable(const std::string &shim) {
+        TableExporter::Format format;
+        EXPECT_TRUE(TableExporter::formatForShim(shim, format));
+        TableExporter exporter(m_table->schema(), format);
+        EXPECT_TRUE(exporter.open(m_path));
+        TableTuple tuple(m_table->schema());
+        TableIterator iterator(m_table);
+        while (iterator.next(tuple)) {
+            exporter.append(tuple);
+        }
+        EXPECT_TRUE(exporter.close());
+        EXPECT_EQ(m_table->activeTupleCount(), exporter.rowCount());
+        return readFile(m_path);
+    }
+
+    /** Write the table value by value through the Attribute classes */
+    std::string exportWithAttributes(const std::string &shim) {
+        const TupleSchema *schema = m_table->schema();
+        const int columns = schema->columnCount();
+        std::vector<std::string> types;
+        for (int i = 0; i < columns; i++) {
+            types.push_back(getTypeName(schema->columnType(i)) + (schema->columnAllowNull(i) ? " null" : ""));
+        }
+        std::vector<boost::shared_ptr<Attribute> > attributes;
+        TypeAttributeMap mapTypes;
+        mapTypes.getAttributesFromTypesVector(attributes, types);
+
+        const std::string path = m_path + ".expected";
+        FILE *fp = NULL;
+        std::ofstream csv;
+        if (shim == "csv") {
+            csv.open(path.c_str());
+        } else {
+            fp = fopen(path.c_str(), "w");
+        }
+        if (shim == "psql") {
+            Postgres::writeHeader(fp);
+        }
+        TableTuple tuple(schema);
+        TableIterator iterator(m_table);
+        while (iterator.next(tuple)) {
+            if (shim == "psql") {
+                Postgres::writeColNumber(fp, static_cast<uint16_t>(columns));
+            }
+            for (int i = 0; i < columns; i++) {
+                attributes[i]->readSstore(tuple.getNValue(i));
+                if (shim == "psql") {
+                    attributes[i]->postgresWriteBinary(fp);
+                } else if (shim == "scidb") {
+                    attributes[i]->scidbWriteBinary(fp);
+                } else {
+                    attributes[i]->writeCsv(csv);
+                    if (i + 1 < columns) {
+                        csv << "|";
+                    } else {
+                        csv << std::endl;
+                    }
+                }
+            }
+        }
+        if (shim == "psql") {
+            Postgres::writeFileTrailer(fp);
+        }
+        if (fp != NULL) {
+            fclose(fp);
+        } else {
+            csv.close();
+        }
+        return readFile(path);
+    }
+
+    static std::string readFile(const std::string &path) {
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    template<typename T> static T read(const std::string &data, size_t &position) {
+        T value;
+        ::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    TempTable *m_table;
+    std::string m_path;
+};
+
+TEST_F(TableExporterTest, PsqlMatchesAttributes) {
+    createTable(1000);
+    std::string expected = exportWithAttributes("psql");
+    ASSERT_TRUE(expected.size() > 0);
+    EXPECT_TRUE(expected == exportTable("psql"));
+}
+
+TEST_F(TableExporterTest, ScidbMatchesAttributes) {
+    // GenericAttribute<char*> writes a byte past the end of its strings, so leave them out
+    createTable(1000, NUM_OF_COLUMNS - 1);
+    std::string expected = exportWithAttributes("scidb");
+    ASSERT_TRUE(expected.size() > 0);
+    EXPECT_TRUE(expected == exportTable("scidb"));
+}
+
+TEST_F(TableExporterTest, ScidbStrings) {
+    createTable(4);
+    std::string data = exportTable("scidb");
+
+    // skip the fixed width columns of each row and check its string
+    size_t position = 0;
+    for (int row = 0; row < 4; row++) {
+        position += 1 + 1 + 2 + 1 + 4 + 1 + 8 + 1 + 8 + 1 + 8;
+        if (row == 3) {
+            EXPECT_EQ(0, read<int8_t>(data, position));
+            EXPECT_EQ(0, read<uint32_t>(data, position));
+            continue;
+        }
+        std::string text(row == 0 ? 200 : row, static_cast<char>('a' + row));
+        EXPECT_EQ(-1, read<int8_t>(data, position));
+        ASSERT_EQ(text.length() + 1, read<uint32_t>(data, position));
+        EXPECT_TRUE(data.compare(position, text.length(), text) == 0);
+        position += text.length();
+        EXPECT_EQ('\0', read<char>(data, position));
+    }
+    EXPECT_EQ(data.size(), position);
+}
+
+TEST_F(TableExporterTest, CsvMatchesAttributes) {
+    createTable(1000);
+    std::string expected = exportWithAttributes("csv");
+    ASSERT_TRUE(expected.size() > 0);
+    EXPECT_TRUE(expected == exportTable("csv"));
+}
+
+TEST_F(TableExporterTest, Columnar) {
+    // enough rows for two full blocks and a partial one
+    const int rows = TableExporter::ROWS_PER_BLOCK * 2 + 100;
+    createTable(rows);
+    std::string data = exportTable("columnar");
+
+    size_t position = 0;
+    ASSERT_TRUE(data.compare(0, 8, "SSTORECF") == 0);
+    position += 8;
+    ASSERT_EQ(NUM_OF_COLUMNS, read<int16_t>(data, position));
+    for (int i = 0; i < NUM_OF_COLUMNS; i++) {
+        EXPECT_EQ(COLUMN_TYPES[i], read<int8_t>(data, position));
+        EXPECT_EQ(i != 0 ? 1 : 0, read<int8_t>(data, position));
+    }
+
+    // decode every block and compare it with the table, row by row
+    TableTuple tuple(m_table->schema());
+    TableIterator iterator(m_table);
+    std::vector<TableTuple> blockTuples;
+    int blocks = 0;
+    int total = 0;
+    int32_t blockRows;
+    while ((blockRows = read<int32_t>(data, position)) > 0) {
+        blocks++;
+        total += blockRows;
+        blockTuples.clear();
+        for (int row = 0; row < blockRows; row++) {
+            ASSERT_TRUE(iterator.next(tuple));
+            blockTuples.push_back(tuple);
+        }
+        for (int i = 0; i < NUM_OF_COLUMNS; i++) {
+            const char *nulls = data.data() + position;
+            position += (blockRows + 7) / 8;
+            for (int row = 0; row < blockRows; row++) {
+                ASSERT_EQ(blockTuples[row].getNValue(i).isNull(), ((nulls[row / 8] >> (row % 8)) & 1) == 1);
+            }
+            if (COLUMN_TYPES[i] == VALUE_TYPE_VARCHAR) {
+                size_t offsets = position;
+                position += (blockRows + 1) * sizeof(int32_t);
+                size_t bytes = position;
+                for (int row = 0; row < blockRows; row++) {
+                    int32_t start = read<int32_t>(data, offsets);
+                    int32_t end = read<int32_t>(data, offsets);
+                    offsets -= sizeof(int32_t);
+                    const NValue value = blockTuples[row].getNValue(i);
+                    if (value.isNull()) {
+                        ASSERT_EQ(start, end);
+                    } else {
+                        ASSERT_EQ(ValuePeeker::peekObjectLength(value), end - start);
+                        ASSERT_EQ(0, ::memcmp(ValuePeeker::peekObjectValue(value), data.data() + bytes + start, end - start));
+                    }
+                }
+                position = bytes + read<int32_t>(data, offsets);
+                continue;
+            }
+            const int32_t width = NValue::getTupleStorageSize(COLUMN_TYPES[i]);
+            for (int row = 0; row < blockRows; row++) {
+                // fixed width values are exactly what the tuple holds, NULLs included
+                const char *stored = blockTuples[row].address() + TUPLE_HEADER_SIZE + m_table->schema()->columnOffset(i);
+                ASSERT_EQ(0, ::memcmp(stored, data.data() + position, width));
+                position += width;
+            }
+        }
+    }
+    EXPECT_EQ(3, blocks);
+    EXPECT_EQ(rows, total);
+    EXPECT_FALSE(iterator.next(tuple));
+    EXPECT_EQ(data.size(), position);
+}
+
+TEST_F(TableExporterTest, BlockWriterLargeWrites) {
+    // writes bigger than a block and small values that straddle block boundaries
+    std::vector<char> big(BlockWriter::BLOCK_SIZE + BlockWriter::BLOCK_SIZE / 2);
+    for (size_t i = 0; i < big.size(); i++) {
+        big[i] = static_cast<char>(i * 31);
+    }
+    BlockWriter writer;
+    ASSERT_TRUE(writer.open(m_path));
+    for (int round = 0; round < 3; round++) {
+        writer.write(&big[0], big.size());
+        writer.writeBigEndian<int32_t>(round);
+    }
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(3 * (big.size() + sizeof(int32_t)), writer.bytesWritten());
+
+    std::string data = readFile(m_path);
+    ASSERT_EQ(3 * (big.size() + sizeof(int32_t)), data.size());
+    size_t position = 0;
+    for (int round = 0; round < 3; round++) {
+        ASSERT_EQ(0, ::memcmp(&big[0], data.data() + position, big.size()));
+        position += big.size();
+        int32_t value = read<int32_t>(data, position);
+        endianness::fromBigEndianToHost<int32_t>(value);
+        EXPECT_EQ(round, value);
+    }
+}
+
+TEST_F(TableExporterTest, UnknownShim) {
+    TableExporter::Format format;
+    EXPECT_FALSE(TableExporter::formatForShim("accumulo", format));
+}
+
+TEST_F(TableExporterTest, DropAllTuples) {
+    VoltDBEngine engine;
+    engine.initialize(1, 1, 0, 0, "");
+    engine.setUndoToken(0);
+    engine.getExecutorContext()->setupForPlanFragments(engine.getCurrentUndoQuantum(), 0, 0);
+
+    std::string *names = columnNames();
+    PersistentTable *table = dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(1000, engine.getExecutorContext(), "MOVED",
+                                         createSchema(), names, -1, false, false));
+    delete[] names;
+    fill(table, 5000, true);
+    ASSERT_EQ(5000, table->activeTupleCount());
+    engine.releaseUndoToken(0);
+
+    table->dropAllTuples();
+    EXPECT_EQ(0, table->activeTupleCount());
+    TableTuple tuple(table->schema());
+    TableIterator emptyIterator(table);
+    EXPECT_FALSE(emptyIterator.next(tuple));
+
+    // the table is still usable afterwards
+    engine.setUndoToken(1);
+    engine.getExecutorContext()->setupForPlanFragments(engine.getCurrentUndoQuantum(), 0, 0);
+    fill(table, 10, true);
+    engine.releaseUndoToken(1);
+    EXPECT_EQ(10, table->activeTupleCount());
+    int count = 0;
+    TableIterator iterator(table);
+    while (iterator.next(tuple)) {
+        count++;
+    }
+    EXPECT_EQ(10, count);
+    delete table;
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
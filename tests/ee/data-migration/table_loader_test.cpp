@@ -0,0 +1,313 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <unistd.h>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "data-migration/tableExporter.h"
+#include "data-migration/tableLoader.h"
+#include "execution/VoltDBEngine.h"
+#include "indexes/tableindex.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/persistenttable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_COLUMNS 6
+
+// ID, GRP, VAL, TS, NAME and CODE, which is short enough to be inlined
+ValueType COLUMN_TYPES[NUM_OF_COLUMNS] = { VALUE_TYPE_INTEGER,
+                                           VALUE_TYPE_SMALLINT,
+                                           VALUE_TYPE_DOUBLE,
+                                           VALUE_TYPE_TIMESTAMP,
+                                           VALUE_TYPE_VARCHAR,
+                                           VALUE_TYPE_VARCHAR };
+
+class TableLoaderTest : public Test {
+public:
+    TableLoaderTest() : m_undoToken(0) {
+        char path[] = "/tmp/table_loader_testXXXXXX";
+        int fd = mkstemp(path);
+        close(fd);
+        m_path = path;
+        m_engine.initialize(1, 1, 0, 0, "");
+    }
+
+    ~TableLoaderTest() {
+        for (size_t i = 0; i < m_tables.size(); i++) {
+            delete m_tables[i];
+        }
+        unlink(m_path.c_str());
+    }
+
+protected:
+    /** (ID) is the primary key and GRP has a non-unique index */
+    PersistentTable* createTable(const std::string &name) {
+        std::vector<ValueType> columnTypes;
+        std::vector<int32_t> columnLengths;
+        std::vector<bool> columnAllowNull;
+        std::string names[NUM_OF_COLUMNS];
+        for (int i = 0; i < NUM_OF_COLUMNS; i++) {
+            columnTypes.push_back(COLUMN_TYPES[i]);
+            columnLengths.push_back(i == 4 ? 300 : i == 5 ? 12 :
+                                    NValue::getTupleStorageSize(COLUMN_TYPES[i]));
+            columnAllowNull.push_back(i != 0);
+            std::ostringstream column;
+            column << "C" << i;
+            names[i] = column.str();
+        }
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+
+        TableIndexScheme pkey("PKEY", BALANCED_TREE_INDEX, std::vector<int32_t>(1, 0),
+                              std::vector<ValueType>(1, VALUE_TYPE_INTEGER), true, true, schema);
+        std::vector<TableIndexScheme> indexes;
+        indexes.push_back(TableIndexScheme("GRP", BALANCED_TREE_INDEX, std::vector<int32_t>(1, 1),
+                                           std::vector<ValueType>(1, VALUE_TYPE_SMALLINT),
+                                           false, false, schema));
+        PersistentTable *table = dynamic_cast<PersistentTable*>(
+            TableFactory::getPersistentTable(1000, m_engine.getExecutorContext(), name,
+                                             schema, names, pkey, indexes, -1, false, false));
+        m_tables.push_back(table);
+        return table;
+    }
+
+    /** Rows with IDs [first, first + rows), NULLs in every nullable column of every seventh */
+    void fill(PersistentTable *table, int first, int rows) {
+        beginUndo();
+        TableTuple &tuple = table->tempTuple();
+        for (int id = first; id < first + rows; id++) {
+            tuple.setNValue(0, ValueFactory::getIntegerValue(id));
+            if (id % 7 == 3) {
+                for (int i = 1; i < NUM_OF_COLUMNS; i++) {
+                    tuple.setNValue(i, NValue::getNullValue(COLUMN_TYPES[i]));
+                }
+                table->insertTuple(tuple);
+                continue;
+            }
+            tuple.setNValue(1, ValueFactory::getSmallIntValue(static_cast<int16_t>(id % 10)));
+            tuple.setNValue(2, ValueFactory::getDoubleValue(id / 4.0 - 7.5));
+            tuple.setNValue(3, ValueFactory::getTimestampValue(1400000000000000LL + id));
+            // no empty strings, csv has no way to tell them from NULL
+            NValue name = ValueFactory::getStringValue(
+                std::string(id % 11 == 0 ? 250 : id % 17 + 1, static_cast<char>('a' + id % 26)));
+            tuple.setNValue(4, name);
+            NValue code = ValueFactory::getStringValue(std::string(id % 12 + 1, 'x'));
+            tuple.setNValue(5, code);
+            table->insertTuple(tuple);
+            name.free();
+            code.free();
+        }
+        m_engine.releaseUndoToken(m_undoToken);
+    }
+
+    void beginUndo() {
+        m_engine.setUndoToken(++m_undoToken);
+        m_engine.getExecutorContext()->setupForPlanFragments(m_engine.getCurrentUndoQuantum(), 0, 0);
+    }
+
+    void exportTable(PersistentTable *table, const std::string &shim) {
+        TableExporter::Format format;
+        ASSERT_TRUE(TableExporter::formatForShim(shim, format));
+        TableExporter exporter(table->schema(), format);
+        ASSERT_TRUE(exporter.open(m_path));
+        TableTuple tuple(table->schema());
+        TableIterator iterator(table);
+        while (iterator.next(tuple)) {
+            exporter.append(tuple);
+        }
+        ASSERT_TRUE(exporter.close());
+    }
+
+    void writeFile(const std::string &contents) {
+        FILE *fp = fopen(m_path.c_str(), "w");
+        fwrite(contents.data(), 1, contents.size(), fp);
+        fclose(fp);
+    }
+
+    bool load(PersistentTable *table, const std::string &shim) {
+        TableExporter::Format format;
+        EXPECT_TRUE(TableExporter::formatForShim(shim, format));
+        TableLoader loader(table, format);
+        return loader.load(m_path);
+    }
+
+    std::vector<std::string> contents(PersistentTable *table) {
+        std::vector<std::string> rows;
+        TableTuple tuple(table->schema());
+        TableIterator iterator(table);
+        while (iterator.next(tuple)) {
+            std::ostringstream row;
+            for (int i = 0; i < NUM_OF_COLUMNS; i++) {
+                const NValue value = tuple.getNValue(i);
+                if (COLUMN_TYPES[i] == VALUE_TYPE_VARCHAR && !value.isNull()) {
+                    // debug() has the address of the string in it
+                    row << std::string(static_cast<const char*>(ValuePeeker::peekObjectValue(value)),
+                                       ValuePeeker::peekObjectLength(value)) << ",";
+                } else {
+                    row << value.debug() << ",";
+                }
+            }
+            rows.push_back(row.str());
+        }
+        return rows;
+    }
+
+    /** the number of rows the index has for the key */
+    int lookup(TableIndex *index, const NValue &key) {
+        TableTuple searchKey(index->getKeySchema());
+        searchKey.move(new char[searchKey.tupleLength()]);
+        searchKey.setNValue(0, key);
+        int count = 0;
+        if (index->moveToKey(&searchKey)) {
+            while (!index->nextValueAtKey().isNullTuple()) {
+                count++;
+            }
+        }
+        delete[] searchKey.address();
+        return count;
+    }
+
+    void roundTrip(const std::string &shim) {
+        PersistentTable *source = createTable("SOURCE");
+        fill(source, 0, 3000);
+        exportTable(source, shim);
+
+        PersistentTable *target = createTable("TARGET");
+        TableExporter::Format format;
+        ASSERT_TRUE(TableExporter::formatForShim(shim, format));
+        TableLoader loader(target, format);
+        ASSERT_TRUE(loader.load(m_path));
+        EXPECT_EQ(3000, loader.rowCount());
+        EXPECT_EQ(3000, target->activeTupleCount());
+        EXPECT_TRUE(contents(source) == contents(target));
+
+        TableIndex *pkey = target->primaryKeyIndex();
+        EXPECT_EQ(3000, pkey->getSize());
+        EXPECT_EQ(1, lookup(pkey, ValueFactory::getIntegerValue(0)));
+        EXPECT_EQ(1, lookup(pkey, ValueFactory::getIntegerValue(2999)));
+        EXPECT_EQ(0, lookup(pkey, ValueFactory::getIntegerValue(3000)));
+        EXPECT_EQ(lookup(source->index("GRP"), ValueFactory::getSmallIntValue(4)),
+                  lookup(target->index("GRP"), ValueFactory::getSmallIntValue(4)));
+    }
+
+    VoltDBEngine m_engine;
+    int64_t m_undoToken;
+    std::vector<PersistentTable*> m_tables;
+    std::string m_path;
+};
+
+TEST_F(TableLoaderTest, PsqlRoundTrip) {
+    roundTrip("psql");
+}
+
+TEST_F(TableLoaderTest, ScidbRoundTrip) {
+    roundTrip("scidb");
+}
+
+TEST_F(TableLoaderTest, CsvRoundTrip) {
+    roundTrip("csv");
+}
+
+TEST_F(TableLoaderTest, AppendsToLoadedTable) {
+    PersistentTable *source = createTable("SOURCE");
+    fill(source, 500, 500);
+    exportTable(source, "psql");
+
+    PersistentTable *target = createTable("TARGET");
+    fill(target, 0, 500);
+    ASSERT_TRUE(load(target, "psql"));
+    EXPECT_EQ(1000, target->activeTupleCount());
+    EXPECT_EQ(1000, target->primaryKeyIndex()->getSize());
+    EXPECT_EQ(1, lookup(target->primaryKeyIndex(), ValueFactory::getIntegerValue(250)));
+    EXPECT_EQ(1, lookup(target->primaryKeyIndex(), ValueFactory::getIntegerValue(750)));
+}
+
+TEST_F(TableLoaderTest, DuplicateKeyLoadsNothing) {
+    PersistentTable *source = createTable("SOURCE");
+    fill(source, 400, 400);
+    exportTable(source, "scidb");
+
+    // IDs 400 to 499 are in the table and in the file
+    PersistentTable *target = createTable("TARGET");
+    fill(target, 0, 500);
+    std::vector<std::string> before = contents(target);
+    EXPECT_FALSE(load(target, "scidb"));
+    EXPECT_EQ(500, target->activeTupleCount());
+    EXPECT_EQ(500, target->primaryKeyIndex()->getSize());
+    EXPECT_EQ(0, lookup(target->primaryKeyIndex(), ValueFactory::getIntegerValue(700)));
+    EXPECT_TRUE(before == contents(target));
+
+    // and the table still takes more rows
+    fill(target, 500, 10);
+    EXPECT_EQ(510, target->activeTupleCount());
+    EXPECT_EQ(1, lookup(target->primaryKeyIndex(), ValueFactory::getIntegerValue(505)));
+}
+
+TEST_F(TableLoaderTest, BadRowLoadsNothing) {
+    PersistentTable *target = createTable("TARGET");
+    // NULL in the NOT NULL ID column
+    writeFile("1|2|0.5|10|abc|x\n|2|0.5|10|abc|x\n");
+    EXPECT_FALSE(load(target, "csv"));
+    EXPECT_EQ(0, target->activeTupleCount());
+    // not a number
+    writeFile("1|2|0.5|10|abc|x\n2|2x|0.5|10|abc|x\n");
+    EXPECT_FALSE(load(target, "csv"));
+    // too few fields
+    writeFile("1|2|0.5|10|abc|x\n2|2|0.5\n");
+    EXPECT_FALSE(load(target, "csv"));
+    // too long for CODE
+    writeFile("1|2|0.5|10|abc|xxxxxxxxxxxxxxxx\n");
+    EXPECT_FALSE(load(target, "csv"));
+    EXPECT_EQ(0, target->activeTupleCount());
+    EXPECT_EQ(0, target->primaryKeyIndex()->getSize());
+
+    // the last line does not need a '\n'
+    writeFile("1|2|0.5|10|abc|x\n2||||abc|");
+    EXPECT_TRUE(load(target, "csv"));
+    EXPECT_EQ(2, target->activeTupleCount());
+}
+
+TEST_F(TableLoaderTest, TruncatedFileLoadsNothing) {
+    PersistentTable *source = createTable("SOURCE");
+    fill(source, 0, 100);
+    exportTable(source, "psql");
+    truncate(m_path.c_str(), 1000);
+
+    PersistentTable *target = createTable("TARGET");
+    EXPECT_FALSE(load(target, "psql"));
+    EXPECT_EQ(0, target->activeTupleCount());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
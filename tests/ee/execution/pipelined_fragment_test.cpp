@@ -0,0 +1,242 @@
+/* Copyright (C) 2014 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/scoped_array.hpp>
+#include "harness.h"
+#include "common/common.h"
+#include "common/valuevector.h"
+#include "catalog/catalog.h"
+#include "execution/VoltDBEngine.h"
+#include "executors/abstractexecutor.h"
+#include "storage/persistenttable.h"
+#include "storage/tableutil.h"
+#include "triggers/trigger.h"
+
+using std::string;
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 25
+#define WINDOW_SIZE 10
+#define BUFFER_SIZE 65536
+
+// plan fragment ids are the names of the catalog fragments
+#define DRAIN_FRAGMENT 1
+#define TRIGGER_FRAGMENT 2
+
+static const string DATABASE = "/clusters[cluster]/databases[database]";
+static const char *COLUMNS[3] = { "ID", "WSTART", "WEND" };
+
+/** Catalog commands for a table of three INTEGER columns */
+static string tableCommands(const string &name, bool isStream, bool isWindow) {
+    string table = DATABASE + "/tables[" + name + "]";
+    string commands = "\nadd " + DATABASE + " tables " + name +
+        "\nset " + table + " isreplicated true" +
+        "\nset " + table + " isStream " + (isStream ? "true" : "false") +
+        "\nset " + table + " isWindow " + (isWindow ? "true" : "false");
+    if (isWindow) {
+        char size[16];
+        snprintf(size, sizeof(size), "%d", WINDOW_SIZE);
+        commands += "\nset " + table + " isRows true" +
+            "\nset " + table + " size " + size +
+            "\nset " + table + " slide 1" +
+            "\nset " + table + " groupByIndex -1";
+    }
+    for (int ii = 0; ii < 3; ii++) {
+        string column = table + "/columns[" + COLUMNS[ii] + "]";
+        char index[4];
+        snprintf(index, sizeof(index), "%d", ii);
+        commands += "\nadd " + table + " columns " + COLUMNS[ii] +
+            "\nset " + column + " index " + index +
+            "\nset " + column + " type 5" +
+            "\nset " + column + " size 0" +
+            "\nset " + column + " nullable false" +
+            "\nset " + column + " name \"" + COLUMNS[ii] + "\"";
+    }
+    return commands;
+}
+
+/**
+ * The planner's PlanNodeList for INSERT INTO target SELECT ID, WSTART, WEND
+ * FROM source, hex encoded. The columns are picked by a projection inlined
+ * in the scan, which makes the scan's output something that can be pushed.
+ */
+static string insertSelectPlan(const string &source, const string &target) {
+    string columns = "[";
+    string projected = "[";
+    for (int ii = 0; ii < 3; ii++) {
+        char column[128];
+        snprintf(column, sizeof(column),
+                 "{\"GUID\":%d,\"NAME\":\"%s\",\"TYPE\":\"INTEGER\",\"SIZE\":4", ii, COLUMNS[ii]);
+        char expression[256];
+        snprintf(expression, sizeof(expression),
+                 ",\"EXPRESSION\":{\"TYPE\":\"VALUE_TUPLE\",\"VALUE_TYPE\":\"INTEGER\",\"VALUE_SIZE\":4,"
+                 "\"COLUMN_IDX\":%d,\"TABLE_NAME\":\"%s\",\"COLUMN_NAME\":\"%s\"}",
+                 ii, source.c_str(), COLUMNS[ii]);
+        string separator = (ii < 2 ? "," : "]");
+        columns += string(column) + "}" + separator;
+        projected += string(column) + expression + "}" + separator;
+    }
+    string json = "{\"PLAN_NODES\":["
+        "{\"PLAN_NODE_TYPE\":\"INSERT\",\"ID\":1,\"INLINE_NODES\":[],"
+        "\"PARENT_IDS\":[],\"CHILDREN_IDS\":[2],\"OUTPUT_COLUMNS\":" + columns + ","
+        "\"TARGET_TABLE_NAME\":\"" + target + "\",\"MULTI_PARTITION\":false},"
+        "{\"PLAN_NODE_TYPE\":\"SEQSCAN\",\"ID\":2,\"INLINE_NODES\":["
+        "{\"PLAN_NODE_TYPE\":\"PROJECTION\",\"ID\":3,\"INLINE_NODES\":[],"
+        "\"PARENT_IDS\":[],\"CHILDREN_IDS\":[],\"OUTPUT_COLUMNS\":" + projected + "}],"
+        "\"PARENT_IDS\":[1],\"CHILDREN_IDS\":[],\"OUTPUT_COLUMNS\":" + columns + ","
+        "\"TARGET_TABLE_NAME\":\"" + source + "\"}],"
+        "\"EXECUTE_LIST\":[2,1],\"PARAMETERS\":[]}";
+    boost::scoped_array<char> hex(new char[json.size() * 2 + 1]);
+    catalog::Catalog::hexEncodeString(json.c_str(), hex.get());
+    return string(hex.get());
+}
+
+/** Catalog commands for a statement with a single plan fragment */
+static string statementCommands(const string &parent, const string &name, int fragmentId,
+                                const string &plan) {
+    string statement = parent + "/statements[" + name + "]";
+    char id[16];
+    snprintf(id, sizeof(id), "%d", fragmentId);
+    string fragment = statement + "/fragments[" + id + "]";
+    return "\nadd " + parent + " statements " + name +
+        "\nadd " + statement + " fragments " + id +
+        "\nset " + fragment + " id " + id +
+        "\nset " + fragment + " plannodetree \"" + plan + "\"";
+}
+
+/**
+ * The DRAIN statement copies the tuple window W into the stream S; the
+ * trigger on S copies whatever S holds into T, after which S is emptied.
+ */
+class PipelinedFragmentTest : public Test {
+public:
+    PipelinedFragmentTest() : m_txnId(100) {
+        m_catalog = "add / clusters cluster"
+            "\nadd /clusters[cluster] databases database"
+            "\nadd " + DATABASE + " programs program" +
+            tableCommands("W", false, true) +
+            tableCommands("S", true, false) +
+            tableCommands("T", false, false) +
+            "\nadd " + DATABASE + "/tables[S] triggers COPY_S" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] id 1" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] triggerType 0" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] forEach false" +
+            statementCommands(DATABASE + "/tables[S]/triggers[COPY_S]", "copy",
+                              TRIGGER_FRAGMENT, insertSelectPlan("S", "T")) +
+            "\nadd " + DATABASE + " procedures Drain" +
+            statementCommands(DATABASE + "/procedures[Drain]", "drain",
+                              DRAIN_FRAGMENT, insertSelectPlan("W", "S")) +
+            "\nadd /clusters[cluster] hosts 0"
+            "\nadd /clusters[cluster] partitions 0"
+            "\nadd /clusters[cluster] sites 0"
+            "\nset /clusters[cluster]/sites[0] partition /clusters[cluster]/partitions[0]"
+            "\nset /clusters[cluster]/sites[0] host /clusters[cluster]/hosts[0]";
+
+        m_engine = new VoltDBEngine();
+        m_engine->setBuffers(NULL, 0, m_resultBuffer, BUFFER_SIZE,
+                             m_exceptionBuffer, sizeof(m_exceptionBuffer));
+        m_engine->initialize(0, 0, 0, 0, "");
+    }
+
+    ~PipelinedFragmentTest() {
+        delete m_engine;
+    }
+
+protected:
+    void load(bool pipeline) {
+        m_engine->setPipelineExecutors(pipeline);
+        ASSERT_TRUE(m_engine->loadCatalog(m_catalog));
+        m_engine->setUndoToken(m_txnId);
+        ASSERT_TRUE(tableutil::addRandomTuples(m_engine->getTable("W"), NUM_OF_TUPLES));
+        PersistentTable *stream = dynamic_cast<PersistentTable*>(m_engine->getTable("S"));
+        ASSERT_TRUE(stream != NULL);
+        ASSERT_TRUE(stream->hasTriggers());
+        m_trigger = stream->getTriggers()->front();
+    }
+
+    void drain() {
+        m_txnId++;
+        m_engine->setUndoToken(m_txnId);
+        m_engine->resetReusedResultOutputBuffer();
+        NValueArray params(0);
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeQuery(DRAIN_FRAGMENT, 1, -1, params,
+                                         m_txnId, m_txnId - 1, true, true));
+    }
+
+    int64_t count(const string &table) {
+        return m_engine->getTable(table)->activeTupleCount();
+    }
+
+    /** The scan and the insert of the trigger's fragment */
+    const std::vector<AbstractExecutor*>& triggerExecutors() {
+        return m_trigger->getExecutorVectors()[0]->list;
+    }
+
+    VoltDBEngine *m_engine;
+    string m_catalog;
+    int64_t m_txnId;
+    Trigger *m_trigger;
+    char m_resultBuffer[BUFFER_SIZE];
+    char m_exceptionBuffer[4096];
+};
+
+TEST_F(PipelinedFragmentTest, Materialized) {
+    load(false);
+    int64_t windowed = count("W");
+    ASSERT_TRUE(windowed > 0);
+    ASSERT_EQ(2, triggerExecutors().size());
+    EXPECT_FALSE(triggerExecutors()[1]->isPipelined());
+
+    drain();
+    EXPECT_EQ(windowed, count("W"));
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(windowed, count("T"));
+}
+
+TEST_F(PipelinedFragmentTest, Pipelined) {
+    load(true);
+    int64_t windowed = count("W");
+    ASSERT_TRUE(windowed > 0);
+    ASSERT_EQ(2, triggerExecutors().size());
+    EXPECT_TRUE(triggerExecutors()[0]->canPushOutput());
+    EXPECT_TRUE(triggerExecutors()[1]->isPipelined());
+
+    // run twice to check that every run starts from scratch
+    for (int pass = 1; pass <= 2; pass++) {
+        drain();
+        EXPECT_EQ(windowed, count("W"));
+        EXPECT_EQ(0, count("S"));
+        EXPECT_EQ(pass * windowed, count("T"));
+        // the trigger's scan handed every tuple straight to the insert
+        EXPECT_EQ(0, triggerExecutors()[0]->getPlanNode()->getOutputTable()->activeTupleCount());
+    }
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
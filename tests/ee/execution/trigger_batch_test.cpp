@@ -0,0 +1,222 @@
+/* Copyright (C) 2014 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/scoped_array.hpp>
+#include "harness.h"
+#include "common/common.h"
+#include "common/valuevector.h"
+#include "catalog/catalog.h"
+#include "execution/VoltDBEngine.h"
+#include "storage/persistenttable.h"
+#include "storage/tableutil.h"
+#include "triggers/trigger.h"
+
+using std::string;
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 50
+#define BUFFER_SIZE 65536
+
+// plan fragment ids are the names of the catalog fragments
+#define FEED_FRAGMENT 1
+#define TRIGGER_FRAGMENT 2
+
+static const string DATABASE = "/clusters[cluster]/databases[database]";
+
+/** Catalog commands for a table of two INTEGER columns */
+static string tableCommands(const string &name, bool isStream) {
+    string table = DATABASE + "/tables[" + name + "]";
+    string commands = "\nadd " + DATABASE + " tables " + name +
+        "\nset " + table + " isreplicated true" +
+        "\nset " + table + " isStream " + (isStream ? "true" : "false");
+    const char *columns[2] = { "ID", "VALUE" };
+    for (int ii = 0; ii < 2; ii++) {
+        string column = table + "/columns[" + columns[ii] + "]";
+        commands += "\nadd " + table + " columns " + columns[ii] +
+            "\nset " + column + " index " + (ii == 0 ? "0" : "1") +
+            "\nset " + column + " type 5" +
+            "\nset " + column + " size 0" +
+            "\nset " + column + " nullable false" +
+            "\nset " + column + " name \"" + columns[ii] + "\"";
+    }
+    return commands;
+}
+
+/** The planner's PlanNodeList for INSERT INTO target SELECT * FROM source, hex encoded */
+static string insertSelectPlan(const string &source, const string &target) {
+    string columns = "[{\"GUID\":0,\"NAME\":\"ID\",\"TYPE\":\"INTEGER\",\"SIZE\":4},"
+                     "{\"GUID\":1,\"NAME\":\"VALUE\",\"TYPE\":\"INTEGER\",\"SIZE\":4}]";
+    string json = "{\"PLAN_NODES\":["
+        "{\"PLAN_NODE_TYPE\":\"INSERT\",\"ID\":1,\"INLINE_NODES\":[],"
+        "\"PARENT_IDS\":[],\"CHILDREN_IDS\":[2],\"OUTPUT_COLUMNS\":" + columns + ","
+        "\"TARGET_TABLE_NAME\":\"" + target + "\",\"MULTI_PARTITION\":false},"
+        "{\"PLAN_NODE_TYPE\":\"SEQSCAN\",\"ID\":2,\"INLINE_NODES\":[],"
+        "\"PARENT_IDS\":[1],\"CHILDREN_IDS\":[],\"OUTPUT_COLUMNS\":" + columns + ","
+        "\"TARGET_TABLE_NAME\":\"" + source + "\"}],"
+        "\"EXECUTE_LIST\":[2,1],\"PARAMETERS\":[]}";
+    boost::scoped_array<char> hex(new char[json.size() * 2 + 1]);
+    catalog::Catalog::hexEncodeString(json.c_str(), hex.get());
+    return string(hex.get());
+}
+
+/** Catalog commands for a statement with a single plan fragment */
+static string statementCommands(const string &parent, const string &name, int fragmentId,
+                                const string &plan) {
+    string statement = parent + "/statements[" + name + "]";
+    char id[16];
+    snprintf(id, sizeof(id), "%d", fragmentId);
+    string fragment = statement + "/fragments[" + id + "]";
+    return "\nadd " + parent + " statements " + name +
+        "\nadd " + statement + " fragments " + id +
+        "\nset " + fragment + " id " + id +
+        "\nset " + fragment + " plannodetree \"" + plan + "\"";
+}
+
+/**
+ * SRC feeds the stream S through the FEED statement; the trigger on S
+ * copies whatever S holds into T, after which S is emptied.
+ */
+class TriggerBatchTest : public Test {
+public:
+    TriggerBatchTest() : m_txnId(100) {
+        m_catalog = "add / clusters cluster"
+            "\nadd /clusters[cluster] databases database"
+            "\nadd " + DATABASE + " programs program" +
+            tableCommands("SRC", false) +
+            tableCommands("S", true) +
+            tableCommands("T", false) +
+            "\nadd " + DATABASE + "/tables[S] triggers COPY_S" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] id 1" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] triggerType 0" +
+            "\nset " + DATABASE + "/tables[S]/triggers[COPY_S] forEach false" +
+            statementCommands(DATABASE + "/tables[S]/triggers[COPY_S]", "copy",
+                              TRIGGER_FRAGMENT, insertSelectPlan("S", "T")) +
+            "\nadd " + DATABASE + " procedures Feed" +
+            statementCommands(DATABASE + "/procedures[Feed]", "feed",
+                              FEED_FRAGMENT, insertSelectPlan("SRC", "S")) +
+            "\nadd /clusters[cluster] hosts 0"
+            "\nadd /clusters[cluster] partitions 0"
+            "\nadd /clusters[cluster] sites 0"
+            "\nset /clusters[cluster]/sites[0] partition /clusters[cluster]/partitions[0]"
+            "\nset /clusters[cluster]/sites[0] host /clusters[cluster]/hosts[0]";
+
+        m_engine = new VoltDBEngine();
+        m_engine->setBuffers(NULL, 0, m_resultBuffer, BUFFER_SIZE,
+                             m_exceptionBuffer, sizeof(m_exceptionBuffer));
+        m_engine->initialize(0, 0, 0, 0, "");
+    }
+
+    ~TriggerBatchTest() {
+        delete m_engine;
+    }
+
+protected:
+    void load(bool batchTriggers) {
+        m_engine->setBatchTriggers(batchTriggers);
+        ASSERT_TRUE(m_engine->loadCatalog(m_catalog));
+        m_engine->setUndoToken(m_txnId);
+        ASSERT_TRUE(tableutil::addRandomTuples(m_engine->getTable("SRC"), NUM_OF_TUPLES));
+        m_stream = dynamic_cast<PersistentTable*>(m_engine->getTable("S"));
+        ASSERT_TRUE(m_stream != NULL);
+        ASSERT_TRUE(m_stream->hasTriggers());
+        m_trigger = m_stream->getTriggers()->front();
+    }
+
+    /** Runs the FEED fragment as one member of a batch, like the JNI batch call */
+    void feed(bool first, bool last) {
+        if (first) {
+            m_txnId++;
+            m_engine->setUndoToken(m_txnId);
+            m_engine->resetReusedResultOutputBuffer();
+        }
+        NValueArray params(0);
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeQuery(FEED_FRAGMENT, 1, -1, params,
+                                         m_txnId, m_txnId - 1, first, last));
+    }
+
+    int64_t count(const string &table) {
+        return m_engine->getTable(table)->activeTupleCount();
+    }
+
+    VoltDBEngine *m_engine;
+    string m_catalog;
+    int64_t m_txnId;
+    PersistentTable *m_stream;
+    Trigger *m_trigger;
+    char m_resultBuffer[BUFFER_SIZE];
+    char m_exceptionBuffer[4096];
+};
+
+TEST_F(TriggerBatchTest, FirePerStatement) {
+    load(false);
+    feed(true, false);
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(NUM_OF_TUPLES, count("T"));
+    feed(false, true);
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(2 * NUM_OF_TUPLES, count("T"));
+    EXPECT_EQ(2, m_trigger->firingLatency().count());
+    // one histogram per plan fragment of the trigger
+    ASSERT_EQ(1, m_trigger->getFragments()->size());
+    EXPECT_EQ(2, m_trigger->fragmentLatency(0).count());
+}
+
+TEST_F(TriggerBatchTest, CoalesceAcrossFragments) {
+    load(true);
+    feed(true, false);
+    // deferred until the last fragment of the batch
+    EXPECT_EQ(NUM_OF_TUPLES, count("S"));
+    EXPECT_EQ(0, count("T"));
+    EXPECT_EQ(0, m_trigger->firingLatency().count());
+    feed(false, true);
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(2 * NUM_OF_TUPLES, count("T"));
+    EXPECT_EQ(1, m_trigger->firingLatency().count());
+
+    // the next batch starts over
+    feed(true, true);
+    EXPECT_EQ(3 * NUM_OF_TUPLES, count("T"));
+    EXPECT_EQ(2, m_trigger->firingLatency().count());
+}
+
+TEST_F(TriggerBatchTest, UndoDropsPendingFirings) {
+    load(true);
+    feed(true, false);
+    m_engine->undoUndoToken(m_txnId);
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(0, count("T"));
+
+    feed(true, true);
+    EXPECT_EQ(0, count("S"));
+    EXPECT_EQ(NUM_OF_TUPLES, count("T"));
+    EXPECT_EQ(1, m_trigger->firingLatency().count());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,331 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "common/valuevector.h"
+#include "executors/compiledpredicate.h"
+#include "expressions/abstractexpression.h"
+#include "expressions/expressionutil.h"
+#include "expressions/tuplevalueexpression.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_COLUMNS 7
+#define NUM_OF_ROWS 3000
+
+ValueType COLUMN_TYPES[NUM_OF_COLUMNS] = { VALUE_TYPE_TINYINT,
+                                           VALUE_TYPE_SMALLINT,
+                                           VALUE_TYPE_INTEGER,
+                                           VALUE_TYPE_BIGINT,
+                                           VALUE_TYPE_TIMESTAMP,
+                                           VALUE_TYPE_DOUBLE,
+                                           VALUE_TYPE_VARCHAR };
+
+enum Column { TINYINT_COL, SMALLINT_COL, INTEGER_COL, BIGINT_COL,
+              TIMESTAMP_COL, DOUBLE_COL, VARCHAR_COL };
+
+ExpressionType COMPARISONS[6] = { EXPRESSION_TYPE_COMPARE_EQUAL,
+                                  EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                                  EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                  EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                  EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                  EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO };
+
+class CompiledPredicateTest : public Test {
+public:
+    CompiledPredicateTest() {
+        std::string *columnNames = new std::string[NUM_OF_COLUMNS];
+        std::vector<ValueType> columnTypes;
+        std::vector<int32_t> columnLengths;
+        std::vector<bool> columnAllowNull;
+        for (int ii = 0; ii < NUM_OF_COLUMNS; ii++) {
+            char buffer[32];
+            snprintf(buffer, 32, "column%02d", ii);
+            columnNames[ii] = buffer;
+            columnTypes.push_back(COLUMN_TYPES[ii]);
+            if (COLUMN_TYPES[ii] == VALUE_TYPE_VARCHAR) {
+                columnLengths.push_back(16);
+            } else {
+                columnLengths.push_back(NValue::getTupleStorageSize(COLUMN_TYPES[ii]));
+            }
+            columnAllowNull.push_back(true);
+        }
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        m_table = TableFactory::getTempTable(1000, "test_table", schema, columnNames, NULL);
+        delete[] columnNames;
+
+        // small values so that every comparison has both outcomes, and a
+        // NULL in every column now and then
+        srand(1234);
+        for (int row = 0; row < NUM_OF_ROWS; row++) {
+            TableTuple &tuple = m_table->tempTuple();
+            for (int col = 0; col < NUM_OF_COLUMNS; col++) {
+                const int value = rand() % 11 - 5;
+                if (rand() % 9 == 0) {
+                    tuple.setNValue(col, NValue::getNullValue(COLUMN_TYPES[col]));
+                    continue;
+                }
+                switch (COLUMN_TYPES[col]) {
+                case VALUE_TYPE_TINYINT:
+                    tuple.setNValue(col, ValueFactory::getTinyIntValue(static_cast<int8_t>(value)));
+                    break;
+                case VALUE_TYPE_SMALLINT:
+                    tuple.setNValue(col, ValueFactory::getSmallIntValue(static_cast<int16_t>(value)));
+                    break;
+                case VALUE_TYPE_INTEGER:
+                    tuple.setNValue(col, ValueFactory::getIntegerValue(value));
+                    break;
+                case VALUE_TYPE_BIGINT:
+                    tuple.setNValue(col, ValueFactory::getBigIntValue(value));
+                    break;
+                case VALUE_TYPE_TIMESTAMP:
+                    tuple.setNValue(col, ValueFactory::getTimestampValue(value));
+                    break;
+                case VALUE_TYPE_DOUBLE:
+                    tuple.setNValue(col, ValueFactory::getDoubleValue(value * 0.5));
+                    break;
+                default: {
+                    NValue string = ValueFactory::getStringValue("s");
+                    tuple.setNValue(col, string);
+                    string.free();
+                }
+                }
+            }
+            m_table->insertTuple(tuple);
+        }
+    }
+
+    ~CompiledPredicateTest() {
+        delete m_table;
+    }
+
+protected:
+    AbstractExpression* column(int column) {
+        return new TupleValueExpression(column, "test_table", "column");
+    }
+
+    AbstractExpression* compare(ExpressionType type, int col, NValue value) {
+        return comparisonFactory(type, column(col), constantValueFactory(value));
+    }
+
+    CompiledPredicate* compile(AbstractExpression *predicate) {
+        return CompiledPredicate::compile(predicate, m_table->schema());
+    }
+
+    /**
+     * Compile and bind the predicate, then check that it selects exactly
+     * the tuples for which eval() is true. Takes ownership of predicate.
+     * Returns how many tuples were selected.
+     */
+    int checkSameAsEval(AbstractExpression *predicate, const NValueArray &params) {
+        CompiledPredicate *compiled = compile(predicate);
+        EXPECT_TRUE(compiled != NULL);
+        if (compiled == NULL) {
+            delete predicate;
+            return -1;
+        }
+        predicate->substitute(params);
+        EXPECT_TRUE(compiled->bind());
+
+        int total = 0;
+        int mismatches = 0;
+        char *batch[CompiledPredicate::BATCH_SIZE];
+        uint16_t selection[CompiledPredicate::BATCH_SIZE];
+        TableIterator iter(m_table);
+        TableTuple tuple(m_table->schema());
+        bool more = true;
+        while (more) {
+            int count = 0;
+            while (count < CompiledPredicate::BATCH_SIZE && (more = iter.next(tuple))) {
+                batch[count++] = tuple.address();
+            }
+            const int selected = compiled->evaluate(batch, count, selection);
+            int next = 0;
+            for (int ii = 0; ii < count; ii++) {
+                tuple.move(batch[ii]);
+                const bool expected = predicate->eval(&tuple, NULL).isTrue();
+                const bool actual = next < selected && selection[next] == ii;
+                if (actual) {
+                    next++;
+                }
+                mismatches += expected != actual;
+            }
+            EXPECT_EQ(selected, next);
+            total += selected;
+        }
+        EXPECT_EQ(0, mismatches);
+
+        delete compiled;
+        delete predicate;
+        return total;
+    }
+
+    Table *m_table;
+};
+
+TEST_F(CompiledPredicateTest, IntegerComparisons) {
+    NValueArray params(0);
+    const int columns[] = { TINYINT_COL, SMALLINT_COL, INTEGER_COL, BIGINT_COL, TIMESTAMP_COL };
+    for (int col = 0; col < 5; col++) {
+        for (int cmp = 0; cmp < 6; cmp++) {
+            EXPECT_TRUE(checkSameAsEval(compare(COMPARISONS[cmp], columns[col],
+                                                ValueFactory::getIntegerValue(2)), params) > 0);
+            // constant on the left
+            EXPECT_TRUE(checkSameAsEval(comparisonFactory(COMPARISONS[cmp],
+                                                          constantValueFactory(ValueFactory::getTinyIntValue(-1)),
+                                                          column(columns[col])), params) > 0);
+        }
+    }
+}
+
+TEST_F(CompiledPredicateTest, DoubleComparisons) {
+    NValueArray params(0);
+    for (int cmp = 0; cmp < 6; cmp++) {
+        EXPECT_TRUE(checkSameAsEval(compare(COMPARISONS[cmp], DOUBLE_COL,
+                                            ValueFactory::getDoubleValue(0.5)), params) > 0);
+    }
+}
+
+TEST_F(CompiledPredicateTest, NullOperand) {
+    NValueArray params(1);
+    params[0] = NValue::getNullValue(VALUE_TYPE_BIGINT);
+    for (int cmp = 0; cmp < 6; cmp++) {
+        checkSameAsEval(compare(COMPARISONS[cmp], INTEGER_COL,
+                                NValue::getNullValue(VALUE_TYPE_INTEGER)), params);
+        checkSameAsEval(comparisonFactory(COMPARISONS[cmp], column(TINYINT_COL),
+                                          parameterValueFactory(0)), params);
+    }
+}
+
+TEST_F(CompiledPredicateTest, Parameters) {
+    NValueArray params(2);
+    AbstractExpression *predicate =
+        conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_AND,
+                           comparisonFactory(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                                             column(BIGINT_COL), parameterValueFactory(0)),
+                           comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                             column(DOUBLE_COL), parameterValueFactory(1)));
+    CompiledPredicate *compiled = compile(predicate);
+    ASSERT_TRUE(compiled != NULL);
+
+    // the same compiled predicate binds new values for each execution
+    char *batch[CompiledPredicate::BATCH_SIZE];
+    uint16_t selection[CompiledPredicate::BATCH_SIZE];
+    TableIterator iter(m_table);
+    TableTuple tuple(m_table->schema());
+    int count = 0;
+    while (count < CompiledPredicate::BATCH_SIZE && iter.next(tuple)) {
+        batch[count++] = tuple.address();
+    }
+    for (int round = 0; round < 3; round++) {
+        params[0] = ValueFactory::getBigIntValue(round - 1);
+        params[1] = ValueFactory::getDoubleValue(round * 1.5);
+        predicate->substitute(params);
+        ASSERT_TRUE(compiled->bind());
+        const int selected = compiled->evaluate(batch, count, selection);
+        int expected = 0;
+        for (int ii = 0; ii < count; ii++) {
+            tuple.move(batch[ii]);
+            expected += predicate->eval(&tuple, NULL).isTrue();
+        }
+        EXPECT_EQ(expected, selected);
+    }
+
+    // a double parameter changes an integer comparison, so it does not bind
+    params[0] = ValueFactory::getDoubleValue(1.5);
+    predicate->substitute(params);
+    EXPECT_FALSE(compiled->bind());
+
+    delete compiled;
+    delete predicate;
+}
+
+TEST_F(CompiledPredicateTest, Conjunctions) {
+    NValueArray params(1);
+    params[0] = ValueFactory::getIntegerValue(1);
+    // (tinyint < 0 AND smallint >= ?) OR (integer = 3 OR double > 1.0)
+    AbstractExpression *predicate =
+        conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_OR,
+            conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_AND,
+                compare(EXPRESSION_TYPE_COMPARE_LESSTHAN, TINYINT_COL,
+                        ValueFactory::getIntegerValue(0)),
+                comparisonFactory(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                                  column(SMALLINT_COL), parameterValueFactory(0))),
+            conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_OR,
+                compare(EXPRESSION_TYPE_COMPARE_EQUAL, INTEGER_COL,
+                        ValueFactory::getIntegerValue(3)),
+                compare(EXPRESSION_TYPE_COMPARE_GREATERTHAN, DOUBLE_COL,
+                        ValueFactory::getDoubleValue(1.0))));
+    const int selected = checkSameAsEval(predicate, params);
+    EXPECT_TRUE(selected > 0);
+    EXPECT_TRUE(selected < NUM_OF_ROWS);
+}
+
+TEST_F(CompiledPredicateTest, UnsupportedShapes) {
+    // strings
+    AbstractExpression *predicate =
+        compare(EXPRESSION_TYPE_COMPARE_EQUAL, VARCHAR_COL, ValueFactory::getStringValue("s"));
+    EXPECT_TRUE(compile(predicate) == NULL);
+    delete predicate;
+
+    // column against column
+    predicate = comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                  column(INTEGER_COL), column(BIGINT_COL));
+    EXPECT_TRUE(compile(predicate) == NULL);
+    delete predicate;
+
+    // a double constant on the left
+    predicate = comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                  constantValueFactory(ValueFactory::getDoubleValue(1.0)),
+                                  column(DOUBLE_COL));
+    EXPECT_TRUE(compile(predicate) == NULL);
+    delete predicate;
+
+    // one unsupported side makes the whole conjunction unsupported
+    predicate = conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_AND,
+                                   compare(EXPRESSION_TYPE_COMPARE_EQUAL, INTEGER_COL,
+                                           ValueFactory::getIntegerValue(1)),
+                                   comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                                     operatorFactory(EXPRESSION_TYPE_OPERATOR_PLUS,
+                                                                     column(INTEGER_COL),
+                                                                     column(BIGINT_COL)),
+                                                     constantValueFactory(ValueFactory::getIntegerValue(0))));
+    EXPECT_TRUE(compile(predicate) == NULL);
+    delete predicate;
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,224 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/SQLException.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "executors/flathashaggregator.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_COLUMNS 4
+
+// group key, bigint value, double value, tinyint value
+ValueType COLUMN_TYPES[NUM_OF_COLUMNS] = { VALUE_TYPE_INTEGER,
+                                           VALUE_TYPE_BIGINT,
+                                           VALUE_TYPE_DOUBLE,
+                                           VALUE_TYPE_TINYINT };
+
+class FlatHashAggregatorTest : public Test {
+public:
+    FlatHashAggregatorTest() {
+        std::string *columnNames = new std::string[NUM_OF_COLUMNS];
+        std::vector<ValueType> columnTypes;
+        std::vector<int32_t> columnLengths;
+        std::vector<bool> columnAllowNull;
+        for (int ii = 0; ii < NUM_OF_COLUMNS; ii++) {
+            char buffer[32];
+            snprintf(buffer, 32, "column%02d", ii);
+            columnNames[ii] = buffer;
+            columnTypes.push_back(COLUMN_TYPES[ii]);
+            columnLengths.push_back(NValue::getTupleStorageSize(COLUMN_TYPES[ii]));
+            columnAllowNull.push_back(true);
+        }
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        m_table = TableFactory::getTempTable(1000, "test_table", schema, columnNames, NULL);
+        delete[] columnNames;
+    }
+
+    ~FlatHashAggregatorTest() {
+        delete m_table;
+    }
+
+protected:
+    void insert(int32_t key, NValue bigint, NValue dbl, NValue tinyint) {
+        TableTuple &tuple = m_table->tempTuple();
+        tuple.setNValue(0, ValueFactory::getIntegerValue(key));
+        tuple.setNValue(1, bigint);
+        tuple.setNValue(2, dbl);
+        tuple.setNValue(3, tinyint);
+        m_table->insertTuple(tuple);
+    }
+
+    /** Feed the whole table, one tuple at a time or in batches of 100 */
+    void aggregate(FlatHashAggregator &aggregator, bool batched = false) {
+        aggregator.reset();
+        TableIterator iter(m_table);
+        if (batched) {
+            char *batch[100];
+            int count;
+            while ((count = iter.nextBatch(batch, 100)) > 0) {
+                aggregator.advance(batch, count);
+            }
+        } else {
+            TableTuple tuple(m_table->schema());
+            while (iter.next(tuple)) {
+                aggregator.advance(tuple);
+            }
+        }
+        aggregator.flush();
+    }
+
+    /** Group number of the given key, by looking at the group's first tuple */
+    int findGroup(FlatHashAggregator &aggregator, int32_t key) {
+        TableTuple tuple(m_table->schema());
+        for (int group = 0; group < aggregator.groupCount(); group++) {
+            tuple.move(aggregator.groupTuple(group));
+            if (ValuePeeker::peekInteger(tuple.getNValue(0)) == key) {
+                return group;
+            }
+        }
+        return -1;
+    }
+
+    Table *m_table;
+};
+
+TEST_F(FlatHashAggregatorTest, Supports) {
+    std::vector<int> groupBy(1, 0);
+    std::vector<ExpressionType> types(1, EXPRESSION_TYPE_AGGREGATE_SUM);
+    std::vector<int> columns(1, 1);
+    EXPECT_TRUE(FlatHashAggregator::supports(m_table->schema(), groupBy, types, columns));
+
+    // no double group keys
+    std::vector<int> doubleGroupBy(1, 2);
+    EXPECT_FALSE(FlatHashAggregator::supports(m_table->schema(), doubleGroupBy, types, columns));
+
+    // no weighted averages
+    std::vector<ExpressionType> weighted(1, EXPRESSION_TYPE_AGGREGATE_WEIGHTED_AVG);
+    EXPECT_FALSE(FlatHashAggregator::supports(m_table->schema(), groupBy, weighted, columns));
+}
+
+TEST_F(FlatHashAggregatorTest, ManyGroups) {
+    // more groups than the initial table and more rows than a batch
+    const int numGroups = 700;
+    const int rowsPerGroup = 5;
+    for (int row = 0; row < rowsPerGroup; row++) {
+        for (int key = 0; key < numGroups; key++) {
+            insert(key,
+                   ValueFactory::getBigIntValue(key * 10 + row),
+                   ValueFactory::getDoubleValue(0.5 * row),
+                   row == 0 ? NValue::getNullValue(VALUE_TYPE_TINYINT) :
+                              ValueFactory::getTinyIntValue(static_cast<int8_t>(row - 3)));
+        }
+    }
+
+    std::vector<int> groupBy(1, 0);
+    ExpressionType typeList[] = { EXPRESSION_TYPE_AGGREGATE_COUNT_STAR,
+                                  EXPRESSION_TYPE_AGGREGATE_SUM,
+                                  EXPRESSION_TYPE_AGGREGATE_MAX,
+                                  EXPRESSION_TYPE_AGGREGATE_AVG,
+                                  EXPRESSION_TYPE_AGGREGATE_COUNT,
+                                  EXPRESSION_TYPE_AGGREGATE_MIN };
+    int columnList[] = { 0, 1, 1, 2, 3, 3 };
+    std::vector<ExpressionType> types(typeList, typeList + 6);
+    std::vector<int> columns(columnList, columnList + 6);
+    ASSERT_TRUE(FlatHashAggregator::supports(m_table->schema(), groupBy, types, columns));
+    FlatHashAggregator aggregator(m_table->schema(), groupBy, types, columns);
+
+    // run twice to check that reset() leaves nothing behind, the second
+    // time handing over the rows in batches
+    for (int pass = 0; pass < 2; pass++) {
+        aggregate(aggregator, pass == 1);
+        ASSERT_EQ(numGroups, aggregator.groupCount());
+        for (int key = 0; key < numGroups; key += 37) {
+            int group = findGroup(aggregator, key);
+            ASSERT_TRUE(group >= 0);
+            EXPECT_EQ(rowsPerGroup, ValuePeeker::peekAsBigInt(aggregator.result(group, 0)));
+            EXPECT_EQ(key * 50 + 10, ValuePeeker::peekAsBigInt(aggregator.result(group, 1)));
+            EXPECT_EQ(key * 10 + 4, ValuePeeker::peekAsBigInt(aggregator.result(group, 2)));
+            EXPECT_EQ(1.0, ValuePeeker::peekDouble(aggregator.result(group, 3)));
+            // the NULL tinyint is not counted and not a minimum
+            EXPECT_EQ(4, ValuePeeker::peekAsBigInt(aggregator.result(group, 4)));
+            EXPECT_EQ(-2, ValuePeeker::peekAsBigInt(aggregator.result(group, 5)));
+        }
+    }
+}
+
+TEST_F(FlatHashAggregatorTest, NullsAndNoGroupBy) {
+    NValue nullTinyInt = NValue::getNullValue(VALUE_TYPE_TINYINT);
+    NValue nullBigInt = NValue::getNullValue(VALUE_TYPE_BIGINT);
+    NValue nullDouble = NValue::getNullValue(VALUE_TYPE_DOUBLE);
+    insert(1, nullBigInt, nullDouble, nullTinyInt);
+    insert(2, nullBigInt, nullDouble, nullTinyInt);
+
+    std::vector<int> groupBy;
+    ExpressionType typeList[] = { EXPRESSION_TYPE_AGGREGATE_SUM,
+                                  EXPRESSION_TYPE_AGGREGATE_MIN,
+                                  EXPRESSION_TYPE_AGGREGATE_COUNT,
+                                  EXPRESSION_TYPE_AGGREGATE_COUNT_STAR };
+    int columnList[] = { 1, 2, 3, 0 };
+    std::vector<ExpressionType> types(typeList, typeList + 4);
+    std::vector<int> columns(columnList, columnList + 4);
+    FlatHashAggregator aggregator(m_table->schema(), groupBy, types, columns);
+    aggregate(aggregator);
+
+    ASSERT_EQ(1, aggregator.groupCount());
+    EXPECT_TRUE(aggregator.result(0, 0).isNull());
+    EXPECT_TRUE(aggregator.result(0, 1).isNull());
+    EXPECT_EQ(0, ValuePeeker::peekAsBigInt(aggregator.result(0, 2)));
+    EXPECT_EQ(2, ValuePeeker::peekAsBigInt(aggregator.result(0, 3)));
+}
+
+TEST_F(FlatHashAggregatorTest, SumOverflow) {
+    NValue tinyint = ValueFactory::getTinyIntValue(1);
+    insert(1, ValueFactory::getBigIntValue(INT64_MAX - 1), ValueFactory::getDoubleValue(0), tinyint);
+    insert(1, ValueFactory::getBigIntValue(INT64_MAX - 1), ValueFactory::getDoubleValue(0), tinyint);
+
+    std::vector<int> groupBy(1, 0);
+    std::vector<ExpressionType> types(1, EXPRESSION_TYPE_AGGREGATE_SUM);
+    std::vector<int> columns(1, 1);
+    FlatHashAggregator aggregator(m_table->schema(), groupBy, types, columns);
+    bool threw = false;
+    try {
+        aggregate(aggregator);
+    } catch (SQLException &e) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,202 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "executors/hashjoinexecutor.h"
+#include "executors/nestloopexecutor.h"
+#include "expressions/expressionutil.h"
+#include "expressions/tuplevalueexpression.h"
+#include "plannodes/hashjoinnode.h"
+#include "plannodes/nestloopnode.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+/** Stands in for the scan below a join, handing it a table it owns */
+class InputPlanNode : public AbstractPlanNode {
+public:
+    InputPlanNode(Table *table, int guidBase) {
+        setOutputTable(table);
+        for (int ii = 0; ii < table->columnCount(); ii++) {
+            m_outputColumnGuids.push_back(guidBase + ii);
+        }
+    }
+    ~InputPlanNode() {
+        delete getOutputTable();
+    }
+    PlanNodeType getPlanNodeType() const {
+        return PLAN_NODE_TYPE_SEQSCAN;
+    }
+    std::string debugInfo(const std::string &spacer) const {
+        return spacer + getOutputTable()->name() + "\n";
+    }
+protected:
+    void loadFromJSONObject(json_spirit::Object &obj, const catalog::Database *catalog_db) {}
+};
+
+typedef std::multiset<std::pair<int32_t, int32_t> > JoinResult;
+
+enum JoinPredicate {
+    KEY_EQUAL,              // outer.KEY = inner.KEY
+    KEY_EQUAL_AND_ID_LESS,  // outer.KEY = inner.KEY AND outer.ID < inner.ID
+    ID_LESS                 // outer.ID < inner.ID, nothing to hash on
+};
+
+class HashJoinTest : public Test {
+public:
+    HashJoinTest() : m_outer(NULL), m_inner(NULL) {}
+
+    ~HashJoinTest() {
+        delete m_outer;
+        delete m_inner;
+    }
+
+protected:
+    /** Table of (ID, KEY) with a NULL key every nullEvery rows */
+    InputPlanNode* createInput(const std::string &name, int rows, int keys, int nullEvery, int guidBase) {
+        std::vector<ValueType> columnTypes(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> columnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> columnAllowNull(2, true);
+        std::string columnNames[2] = { "ID", "KEY" };
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        TempTable *table = TableFactory::getTempTable(1000, name, schema, columnNames, NULL);
+        for (int ii = 0; ii < rows; ii++) {
+            TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+            if (nullEvery > 0 && ii % nullEvery == 0) {
+                tuple.setNValue(1, NValue::getNullValue(VALUE_TYPE_INTEGER));
+            } else {
+                tuple.setNValue(1, ValueFactory::getIntegerValue(ii % keys));
+            }
+            table->insertTuple(tuple);
+        }
+
+        return new InputPlanNode(table, guidBase);
+    }
+
+    void createInputs(int outerRows, int innerRows) {
+        m_outer = createInput("OUTER_T", outerRows, 7, 11, 0);
+        m_inner = createInput("INNER_T", innerRows, 5, 6, 2);
+    }
+
+    AbstractExpression* column(const std::string &table, int column) {
+        return new TupleValueExpression(column, table, column == 0 ? "ID" : "KEY");
+    }
+
+    AbstractExpression* predicate(JoinPredicate which) {
+        AbstractExpression *keyEqual =
+            comparisonFactory(EXPRESSION_TYPE_COMPARE_EQUAL, column("OUTER_T", 1), column("INNER_T", 1));
+        switch (which) {
+        case KEY_EQUAL:
+            return keyEqual;
+        case KEY_EQUAL_AND_ID_LESS:
+            return conjunctionFactory(EXPRESSION_TYPE_CONJUNCTION_AND, keyEqual,
+                                      comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                                        column("OUTER_T", 0), column("INNER_T", 0)));
+        default:
+            delete keyEqual;
+            return comparisonFactory(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                     column("OUTER_T", 0), column("INNER_T", 0));
+        }
+    }
+
+    /** Run the join with the given node and executor, returning the (outer ID, inner ID) pairs */
+    JoinResult join(NestLoopPlanNode &node, AbstractExecutor &executor, JoinPredicate which) {
+        node.addChild(m_outer);
+        node.addChild(m_inner);
+        node.setPredicate(predicate(which));
+        int tempTableMemory = 0;
+        EXPECT_TRUE(executor.init(NULL, NULL, &tempTableMemory));
+        NValueArray params(0);
+        EXPECT_TRUE(executor.execute(params, NULL));
+
+        JoinResult result;
+        TableIterator iter(node.getOutputTable());
+        TableTuple tuple(node.getOutputTable()->schema());
+        while (iter.next(tuple)) {
+            EXPECT_EQ(4, tuple.sizeInValues());
+            result.insert(std::make_pair(ValuePeeker::peekInteger(tuple.getNValue(0)),
+                                         ValuePeeker::peekInteger(tuple.getNValue(2))));
+        }
+        return result;
+    }
+
+    void compareWithNestLoop(JoinPredicate which, bool expectMatches) {
+        NestLoopPlanNode nestLoopNode;
+        NestLoopExecutor nestLoop(NULL, &nestLoopNode);
+        JoinResult expected = join(nestLoopNode, nestLoop, which);
+
+        HashJoinPlanNode hashJoinNode;
+        HashJoinExecutor hashJoin(NULL, &hashJoinNode);
+        JoinResult actual = join(hashJoinNode, hashJoin, which);
+
+        EXPECT_EQ(expectMatches, !expected.empty());
+        EXPECT_EQ(expected.size(), actual.size());
+        EXPECT_TRUE(expected == actual);
+    }
+
+    InputPlanNode *m_outer;
+    InputPlanNode *m_inner;
+};
+
+TEST_F(HashJoinTest, BuildOnInner) {
+    createInputs(200, 30);
+    compareWithNestLoop(KEY_EQUAL, true);
+}
+
+TEST_F(HashJoinTest, BuildOnOuter) {
+    createInputs(30, 200);
+    compareWithNestLoop(KEY_EQUAL, true);
+}
+
+TEST_F(HashJoinTest, ResidualPredicate) {
+    createInputs(100, 40);
+    compareWithNestLoop(KEY_EQUAL_AND_ID_LESS, true);
+}
+
+TEST_F(HashJoinTest, NoEqualityFallsBack) {
+    createInputs(40, 40);
+    compareWithNestLoop(ID_LESS, true);
+}
+
+TEST_F(HashJoinTest, EmptyInput) {
+    createInputs(50, 0);
+    compareWithNestLoop(KEY_EQUAL, false);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
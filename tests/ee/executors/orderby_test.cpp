@@ -0,0 +1,216 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "common/valuevector.h"
+#include "executors/orderbyexecutor.h"
+#include "plannodes/limitnode.h"
+#include "plannodes/orderbynode.h"
+#include "plannodes/projectionnode.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 300
+#define NUM_OF_KEYS 53
+
+/** Stands in for the scan below the sort, handing it a table it owns */
+class InputPlanNode : public AbstractPlanNode {
+public:
+    InputPlanNode(Table *table) {
+        setOutputTable(table);
+    }
+    ~InputPlanNode() {
+        delete getOutputTable();
+    }
+    PlanNodeType getPlanNodeType() const {
+        return PLAN_NODE_TYPE_SEQSCAN;
+    }
+    int getColumnIndexFromGuid(int guid, const catalog::Database *db) const {
+        return guid;
+    }
+    std::string debugInfo(const std::string &spacer) const {
+        return spacer + getOutputTable()->name() + "\n";
+    }
+protected:
+    void loadFromJSONObject(json_spirit::Object &obj, const catalog::Database *catalog_db) {}
+};
+
+/** (KEY, ID) pairs in the order the test sorts by: KEY descending, then ID ascending */
+typedef std::pair<int32_t, int32_t> Row;
+
+static bool rowLess(const Row &a, const Row &b) {
+    if (a.first != b.first)
+        return a.first > b.first;
+    return a.second < b.second;
+}
+
+class OrderByTest : public Test {
+public:
+    OrderByTest() : m_input(NULL) {
+        std::vector<ValueType> columnTypes(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> columnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> columnAllowNull(2, false);
+        std::string columnNames[2] = { "ID", "KEY" };
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        TempTable *table = TableFactory::getTempTable(1000, "INPUT_T", schema, columnNames, NULL);
+        for (int ii = 0; ii < NUM_OF_TUPLES; ii++) {
+            TableTuple &tuple = table->tempTuple();
+            int32_t key = (ii * 37) % NUM_OF_KEYS;
+            tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(key));
+            table->insertTuple(tuple);
+            m_expected.push_back(std::make_pair(key, ii));
+        }
+        std::sort(m_expected.begin(), m_expected.end(), rowLess);
+        m_input = new InputPlanNode(table);
+
+        std::string sortNames[2] = { "KEY", "ID" };
+        SortDirectionType sortDirections[2] = { SORT_DIRECTION_TYPE_DESC, SORT_DIRECTION_TYPE_ASC };
+        std::vector<std::string> names(sortNames, sortNames + 2);
+        std::vector<SortDirectionType> directions(sortDirections, sortDirections + 2);
+        m_node.getSortColumnGuids().push_back(1);
+        m_node.getSortColumnGuids().push_back(0);
+        m_node.setSortColumnNames(names);
+        m_node.setSortDirections(directions);
+        m_node.addChild(m_input);
+    }
+
+    ~OrderByTest() {
+        delete m_input;
+    }
+
+protected:
+    std::vector<Row> execute(const NValueArray &params) {
+        OrderByExecutor executor(NULL, &m_node);
+        int tempTableMemory = 0;
+        EXPECT_TRUE(executor.init(NULL, NULL, &tempTableMemory));
+        EXPECT_TRUE(executor.execute(params, NULL));
+
+        std::vector<Row> result;
+        TableIterator iter(m_node.getOutputTable());
+        TableTuple tuple(m_node.getOutputTable()->schema());
+        while (iter.next(tuple)) {
+            result.push_back(std::make_pair(ValuePeeker::peekInteger(tuple.getNValue(1)),
+                                            ValuePeeker::peekInteger(tuple.getNValue(0))));
+        }
+        return result;
+    }
+
+    std::vector<Row> execute() {
+        NValueArray params(0);
+        return execute(params);
+    }
+
+    std::vector<Row> expected(int offset, int count) {
+        std::vector<Row> rows;
+        for (int ii = offset; ii < offset + count && ii < m_expected.size(); ii++) {
+            rows.push_back(m_expected[ii]);
+        }
+        return rows;
+    }
+
+    InputPlanNode *m_input;
+    OrderByPlanNode m_node;
+    std::vector<Row> m_expected;
+};
+
+TEST_F(OrderByTest, NoLimitSortsEverything) {
+    EXPECT_TRUE(execute() == m_expected);
+}
+
+TEST_F(OrderByTest, InlineLimit) {
+    LimitPlanNode *limit = new LimitPlanNode();
+    limit->setLimit(10);
+    m_node.addInlinePlanNode(limit);
+    EXPECT_TRUE(execute() == expected(0, 10));
+}
+
+TEST_F(OrderByTest, InlineLimitAndOffset) {
+    LimitPlanNode *limit = new LimitPlanNode();
+    limit->setLimit(5);
+    limit->setOffset(7);
+    m_node.addInlinePlanNode(limit);
+    EXPECT_TRUE(execute() == expected(7, 5));
+}
+
+TEST_F(OrderByTest, InlineLimitParameter) {
+    LimitPlanNode *limit = new LimitPlanNode();
+    limit->setLimitParamIdx(0);
+    m_node.addInlinePlanNode(limit);
+    NValueArray params(1);
+    params[0] = ValueFactory::getIntegerValue(25);
+    EXPECT_TRUE(execute(params) == expected(0, 25));
+}
+
+TEST_F(OrderByTest, LimitLargerThanInput) {
+    LimitPlanNode *limit = new LimitPlanNode();
+    limit->setLimit(NUM_OF_TUPLES * 2);
+    m_node.addInlinePlanNode(limit);
+    EXPECT_TRUE(execute() == m_expected);
+}
+
+TEST_F(OrderByTest, LimitZero) {
+    LimitPlanNode *limit = new LimitPlanNode();
+    limit->setLimit(0);
+    m_node.addInlinePlanNode(limit);
+    EXPECT_TRUE(execute().empty());
+}
+
+TEST_F(OrderByTest, ParentLimitThroughProjection) {
+    // LIMIT -> PROJECTION -> ORDER BY: we produce every row the limit can
+    // reach, including the ones its offset skips
+    LimitPlanNode limit;
+    limit.setLimit(4);
+    limit.setOffset(6);
+    ProjectionPlanNode projection;
+    limit.addChild(&projection);
+    projection.addParent(&limit);
+    projection.addChild(&m_node);
+    m_node.addParent(&projection);
+    EXPECT_TRUE(execute() == expected(0, 10));
+}
+
+TEST_F(OrderByTest, ParentWithoutLimit) {
+    ProjectionPlanNode projection;
+    projection.addChild(&m_node);
+    m_node.addParent(&projection);
+    EXPECT_TRUE(execute() == m_expected);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,206 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <string>
+#include <utility>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "common/valuevector.h"
+#include "executors/limitexecutor.h"
+#include "executors/projectionexecutor.h"
+#include "expressions/tuplevalueexpression.h"
+#include "plannodes/limitnode.h"
+#include "plannodes/projectionnode.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 300
+
+/** Stands in for the scan at the bottom of the chain, handing it a table it owns */
+class InputPlanNode : public AbstractPlanNode {
+public:
+    InputPlanNode(Table *table) {
+        setOutputTable(table);
+    }
+    ~InputPlanNode() {
+        delete getOutputTable();
+    }
+    PlanNodeType getPlanNodeType() const {
+        return PLAN_NODE_TYPE_SEQSCAN;
+    }
+    int getColumnIndexFromGuid(int guid, const catalog::Database *db) const {
+        return guid;
+    }
+    std::string debugInfo(const std::string &spacer) const {
+        return spacer + getOutputTable()->name() + "\n";
+    }
+protected:
+    void loadFromJSONObject(json_spirit::Object &obj, const catalog::Database *catalog_db) {}
+};
+
+typedef std::pair<int32_t, int32_t> Row;
+
+/** INPUT -> PROJECTION (KEY, ID) -> PROJECTION (ID, KEY) -> LIMIT */
+class PipelineTest : public Test {
+public:
+    PipelineTest() {
+        std::vector<ValueType> columnTypes(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> columnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> columnAllowNull(2, false);
+        std::string columnNames[2] = { "ID", "KEY" };
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        TempTable *table = TableFactory::getTempTable(1000, "INPUT_T", schema, columnNames, NULL);
+        for (int ii = 0; ii < NUM_OF_TUPLES; ii++) {
+            TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(ii * 7));
+            table->insertTuple(tuple);
+        }
+        m_input = new InputPlanNode(table);
+
+        swapColumns(m_swap, "KEY", "ID");
+        swapColumns(m_swapBack, "ID", "KEY");
+        m_limit.setLimit(10);
+        m_limit.setOffset(7);
+
+        m_swap.addChild(m_input);
+        m_input->addParent(&m_swap);
+        m_swapBack.addChild(&m_swap);
+        m_swap.addParent(&m_swapBack);
+        m_limit.addChild(&m_swapBack);
+        m_swapBack.addParent(&m_limit);
+
+        // the nodes own their executors
+        m_swap.setExecutor(new ProjectionExecutor(NULL, &m_swap));
+        m_swapBack.setExecutor(new ProjectionExecutor(NULL, &m_swapBack));
+        m_limit.setExecutor(new LimitExecutor(NULL, &m_limit));
+        m_executors.push_back(m_swap.getExecutor());
+        m_executors.push_back(m_swapBack.getExecutor());
+        m_executors.push_back(m_limit.getExecutor());
+        int tempTableMemory = 0;
+        for (int ii = 0; ii < m_executors.size(); ii++) {
+            EXPECT_TRUE(m_executors[ii]->init(NULL, NULL, &tempTableMemory));
+        }
+    }
+
+    ~PipelineTest() {
+        delete m_input;
+    }
+
+protected:
+    /** New projection that outputs the two input columns in the other order */
+    static void swapColumns(ProjectionPlanNode &node, std::string first, std::string second) {
+        std::vector<std::string> names;
+        names.push_back(first);
+        names.push_back(second);
+        std::vector<ValueType> types(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> sizes(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<AbstractExpression*> expressions;
+        expressions.push_back(new TupleValueExpression(1, "INPUT_T", first));
+        expressions.push_back(new TupleValueExpression(0, "INPUT_T", second));
+        node.setOutputColumnNames(names);
+        node.setOutputColumnTypes(types);
+        node.setOutputColumnSizes(sizes);
+        node.setOutputColumnExpressions(expressions);
+    }
+
+    /** Runs the executors the way the engine does, skipping pipelined ones */
+    std::vector<Row> execute() {
+        NValueArray params(0);
+        for (int ii = 0; ii < m_executors.size(); ii++) {
+            if (!m_executors[ii]->isPipelined()) {
+                EXPECT_TRUE(m_executors[ii]->execute(params, NULL));
+            }
+        }
+        return rows(m_limit.getOutputTable());
+    }
+
+    static std::vector<Row> rows(Table *table) {
+        std::vector<Row> result;
+        TableIterator iter(table);
+        TableTuple tuple(table->schema());
+        while (iter.next(tuple)) {
+            result.push_back(std::make_pair(ValuePeeker::peekInteger(tuple.getNValue(0)),
+                                            ValuePeeker::peekInteger(tuple.getNValue(1))));
+        }
+        return result;
+    }
+
+    std::vector<Row> expected() {
+        std::vector<Row> result;
+        for (int ii = 7; ii < 17; ii++) {
+            result.push_back(std::make_pair(ii, ii * 7));
+        }
+        return result;
+    }
+
+    InputPlanNode *m_input;
+    ProjectionPlanNode m_swap;
+    ProjectionPlanNode m_swapBack;
+    LimitPlanNode m_limit;
+    std::vector<AbstractExecutor*> m_executors;
+};
+
+TEST_F(PipelineTest, Materialized) {
+    EXPECT_TRUE(execute() == expected());
+    EXPECT_EQ(NUM_OF_TUPLES, m_swapBack.getOutputTable()->activeTupleCount());
+}
+
+TEST_F(PipelineTest, Pipelined) {
+    ASSERT_TRUE(m_swap.getExecutor()->canPushOutput());
+    ASSERT_TRUE(m_limit.getExecutor()->acceptsPushedTuples());
+    m_swap.getExecutor()->setPipelineParent(m_swapBack.getExecutor());
+    m_swapBack.getExecutor()->setPipelineParent(m_limit.getExecutor());
+    EXPECT_FALSE(m_swap.getExecutor()->isPipelined());
+    EXPECT_TRUE(m_swapBack.getExecutor()->isPipelined());
+    EXPECT_TRUE(m_limit.getExecutor()->isPipelined());
+
+    // run twice to check that every run starts from scratch
+    for (int pass = 0; pass < 2; pass++) {
+        EXPECT_TRUE(execute() == expected());
+        // nothing was materialized in between
+        EXPECT_EQ(0, m_swap.getOutputTable()->activeTupleCount());
+        EXPECT_EQ(0, m_swapBack.getOutputTable()->activeTupleCount());
+    }
+}
+
+TEST_F(PipelineTest, Unlinked) {
+    m_swap.getExecutor()->setPipelineParent(m_swapBack.getExecutor());
+    m_swap.getExecutor()->setPipelineParent(NULL);
+    EXPECT_FALSE(m_swapBack.getExecutor()->isPipelined());
+    EXPECT_TRUE(execute() == expected());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -49,10 +49,13 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <set>
+#include <string>
 #include "harness.h"
 #include "common/common.h"
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/debuglog.h"
 #include "common/SerializableEEException.h"
 #include "common/tabletuple.h"
@@ -323,6 +326,77 @@ public:
         }
     }
 
+    /*
+     * (ID BIGINT, SESSION VARCHAR(32), DEVICE VARCHAR(200), SHARD INTEGER).
+     * SESSION is short enough to be inlined, DEVICE is stored out of line.
+     */
+    void initStringTable(TableIndexScheme index)
+    {
+        CatalogId database_id = 1000;
+        string columnNames[4] = { "ID", "SESSION", "DEVICE", "SHARD" };
+        vector<ValueType> columnTypes;
+        vector<int32_t> columnLengths;
+        columnTypes.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        columnTypes.push_back(VALUE_TYPE_VARCHAR);
+        columnLengths.push_back(32);
+        columnTypes.push_back(VALUE_TYPE_VARCHAR);
+        columnLengths.push_back(200);
+        columnTypes.push_back(VALUE_TYPE_INTEGER);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        vector<bool> columnAllowNull(4, false);
+        TupleSchema* schema =
+            TupleSchema::createTupleSchema(columnTypes,
+                                           columnLengths,
+                                           columnAllowNull,
+                                           true);
+
+        index.tupleSchema = schema;
+        vector<int> pkey_column_indices(1, 0);
+        vector<ValueType> pkey_column_types(1, VALUE_TYPE_BIGINT);
+        TableIndexScheme pkey("idx_pkey",
+                              BALANCED_TREE_INDEX,
+                              pkey_column_indices,
+                              pkey_column_types,
+                              true, true, schema);
+
+        vector<TableIndexScheme> indexes;
+        indexes.push_back(index);
+        m_engine = new VoltDBEngine();
+        m_exceptionBuffer = new char[4096];
+        m_engine->setBuffers( NULL, 0, NULL, 0, m_exceptionBuffer, 4096);
+        m_engine->initialize(0, 0, 0, 0, "");
+        table =
+            dynamic_cast<PersistentTable*>
+          (TableFactory::getPersistentTable(database_id, m_engine->getExecutorContext(),
+                                            "test_string_table", schema,
+                                            columnNames, pkey, indexes, -1, false, false));
+
+        for (int64_t i = 1; i <= NUM_OF_TUPLES; ++i)
+        {
+            TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, ValueFactory::getBigIntValue(i));
+            NValue session = ValueFactory::getStringValue(sessionForRow(i));
+            NValue device = ValueFactory::getStringValue(deviceForRow(i));
+            tuple.setNValue(1, session);
+            tuple.setNValue(2, device);
+            tuple.setNValue(3, ValueFactory::getIntegerValue(static_cast<int32_t>(i % 4)));
+            assert(true == table->insertTuple(tuple));
+            session.free();
+            device.free();
+        }
+    }
+
+    string sessionForRow(int64_t row) {
+        char buffer[32];
+        snprintf(buffer, 32, "session-%05d", static_cast<int>(row));
+        return buffer;
+    }
+
+    /** Long enough that every device id lives out of line */
+    string deviceForRow(int64_t row) {
+        return string(100, 'd') + sessionForRow(row % 10);
+    }
 
     void verifyWideRow(TableTuple &tuple, int64_t row) {
         for (int i = 0; i < 10; i++)
@@ -902,6 +976,130 @@ TEST_F(IndexTest, TupleKeyUnique) {
     delete[] searchkey.address();
 }
 
+TEST_F(IndexTest, GenericHashUnique) {
+    vector<int> column_indices(1, 1);
+    vector<ValueType> column_types(1, VALUE_TYPE_VARCHAR);
+    initStringTable(TableIndexScheme("session_hash",
+                                     HASH_TABLE_INDEX,
+                                     column_indices,
+                                     column_types,
+                                     true, false, NULL));
+    TableIndex* index = table->index("session_hash");
+    ASSERT_TRUE(index != NULL);
+    EXPECT_EQ("HashTableUniqueIndex", index->getTypeName());
+    EXPECT_EQ(NUM_OF_TUPLES, index->getSize());
+
+    vector<ValueType> keyColumnTypes(1, VALUE_TYPE_VARCHAR);
+    vector<int32_t> keyColumnLengths(1, 32);
+    vector<bool> keyColumnAllowNull(1, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchema(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull,
+                                       true);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+
+    // every session is found by its bytes, whichever key it is compared with
+    TableTuple tuple(table->schema());
+    for (int64_t row = 1; row <= NUM_OF_TUPLES; ++row) {
+        NValue session = ValueFactory::getStringValue(sessionForRow(row));
+        searchkey.setNValue(0, session);
+        session.free();
+        ASSERT_TRUE(index->moveToKey(&searchkey));
+        tuple = index->nextValueAtKey();
+        ASSERT_FALSE(tuple.isNullTuple());
+        EXPECT_EQ(row, ValuePeeker::peekBigInt(tuple.getNValue(0)));
+        EXPECT_TRUE(index->nextValueAtKey().isNullTuple());
+    }
+
+    NValue missing = ValueFactory::getStringValue(sessionForRow(NUM_OF_TUPLES + 1));
+    searchkey.setNValue(0, missing);
+    missing.free();
+    EXPECT_FALSE(index->moveToKey(&searchkey));
+
+    // a duplicate session is rejected
+    TableTuple &duplicate = table->tempTuple();
+    duplicate.setNValue(0, ValueFactory::getBigIntValue(NUM_OF_TUPLES + 1));
+    NValue session = ValueFactory::getStringValue(sessionForRow(7));
+    NValue device = ValueFactory::getStringValue(deviceForRow(7));
+    duplicate.setNValue(1, session);
+    duplicate.setNValue(2, device);
+    duplicate.setNValue(3, ValueFactory::getIntegerValue(0));
+    bool exceptionThrown = false;
+    try {
+        table->insertTuple(duplicate);
+    } catch (SerializableEEException &e) {
+        exceptionThrown = true;
+    }
+    EXPECT_TRUE(exceptionThrown);
+
+    // deleting the row takes its session out of the index
+    searchkey.setNValue(0, session);
+    session.free();
+    device.free();
+    ASSERT_TRUE(index->moveToKey(&searchkey));
+    tuple = index->nextValueAtKey();
+    EXPECT_TRUE(table->deleteTuple(tuple, true));
+    EXPECT_FALSE(index->moveToKey(&searchkey));
+    EXPECT_EQ(NUM_OF_TUPLES - 1, index->getSize());
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
+
+TEST_F(IndexTest, GenericHashMultiOutOfLine) {
+    vector<int> column_indices;
+    vector<ValueType> column_types;
+    column_indices.push_back(2);
+    column_types.push_back(VALUE_TYPE_VARCHAR);
+    column_indices.push_back(3);
+    column_types.push_back(VALUE_TYPE_INTEGER);
+    initStringTable(TableIndexScheme("device_hash",
+                                     HASH_TABLE_INDEX,
+                                     column_indices,
+                                     column_types,
+                                     false, false, NULL));
+    TableIndex* index = table->index("device_hash");
+    ASSERT_TRUE(index != NULL);
+    EXPECT_EQ("HashTableMultiMapIndex", index->getTypeName());
+
+    vector<ValueType> keyColumnTypes(column_types);
+    vector<int32_t> keyColumnLengths;
+    keyColumnLengths.push_back(200);
+    keyColumnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+    vector<bool> keyColumnAllowNull(2, true);
+    TupleSchema* keySchema =
+        TupleSchema::createTupleSchema(keyColumnTypes,
+                                       keyColumnLengths,
+                                       keyColumnAllowNull,
+                                       true);
+    TableTuple searchkey(keySchema);
+    searchkey.move(new char[searchkey.tupleLength()]);
+
+    // (device of row 3, SHARD 1) matches the rows with ID % 20 == 13
+    NValue device = ValueFactory::getStringValue(deviceForRow(3));
+    searchkey.setNValue(0, device);
+    searchkey.setNValue(1, ValueFactory::getIntegerValue(1));
+    ASSERT_TRUE(index->moveToKey(&searchkey));
+    TableTuple tuple(table->schema());
+    set<int64_t> found;
+    while (!(tuple = index->nextValueAtKey()).isNullTuple()) {
+        found.insert(ValuePeeker::peekBigInt(tuple.getNValue(0)));
+    }
+    EXPECT_EQ(NUM_OF_TUPLES / 20, found.size());
+    for (set<int64_t>::iterator it = found.begin(); it != found.end(); ++it) {
+        EXPECT_EQ(13, *it % 20);
+    }
+
+    // the same device with a SHARD it never has matches nothing
+    searchkey.setNValue(1, ValueFactory::getIntegerValue(2));
+    EXPECT_FALSE(index->moveToKey(&searchkey));
+    device.free();
+
+    TupleSchema::freeTupleSchema(keySchema);
+    delete[] searchkey.address();
+}
 
 int main()
 {
@@ -0,0 +1,183 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "logging/AriesLogWriter.h"
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+
+using voltdb::AriesLogWriter;
+
+static const char *LOG_FILE_NAME = "aries_log_writer_test.log";
+
+class AriesLogWriterTest : public Test {
+public:
+    AriesLogWriterTest() {
+        unlink(LOG_FILE_NAME);
+    }
+
+    ~AriesLogWriterTest() {
+        unlink(LOG_FILE_NAME);
+    }
+
+    /** A transaction entry of a size and content that depend on its number */
+    std::string entry(int txn) {
+        return std::string(1 + (txn * 31) % 700, static_cast<char>('a' + txn % 26));
+    }
+
+    /** Append entries [first, last) and return what they add up to */
+    std::string appendEntries(AriesLogWriter &writer, int first, int last) {
+        std::string expected;
+        for (int txn = first; txn < last; txn++) {
+            std::string data = entry(txn);
+            writer.append(data.data(), data.size());
+            expected += data;
+        }
+        return expected;
+    }
+
+    std::string readLog() {
+        std::ifstream in(LOG_FILE_NAME, std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(AriesLogWriterTest, FlushMakesEntriesDurable) {
+    AriesLogWriter writer(LOG_FILE_NAME);
+    ASSERT_TRUE(writer.isOpen());
+
+    std::string expected = appendEntries(writer, 0, 1000);
+    EXPECT_TRUE(writer.flush());
+    EXPECT_EQ(1000, writer.syncedEntries());
+    EXPECT_TRUE(readLog() == expected);
+}
+
+#define NUM_OF_COMMITTERS 8
+#define COMMITS_PER_COMMITTER 100
+
+/** Commits one entry at a time, waiting for each one to be synced */
+static void* commitEntries(void *arg) {
+    AriesLogWriter *writer = static_cast<AriesLogWriter*>(arg);
+    std::string data(100, 'x');
+    for (int ii = 0; ii < COMMITS_PER_COMMITTER; ii++) {
+        int64_t mine = writer->append(data.data(), data.size());
+        if (mine < 0 || !writer->waitForSync(mine)) {
+            return arg;
+        }
+    }
+    return NULL;
+}
+
+TEST_F(AriesLogWriterTest, ConcurrentCommittersShareSyncs) {
+    AriesLogWriter writer(LOG_FILE_NAME);
+    ASSERT_TRUE(writer.isOpen());
+
+    pthread_t committers[NUM_OF_COMMITTERS];
+    for (int ii = 0; ii < NUM_OF_COMMITTERS; ii++) {
+        ASSERT_EQ(0, pthread_create(&committers[ii], NULL, commitEntries, &writer));
+    }
+    for (int ii = 0; ii < NUM_OF_COMMITTERS; ii++) {
+        void *failed = NULL;
+        pthread_join(committers[ii], &failed);
+        EXPECT_TRUE(failed == NULL);
+    }
+
+    const int64_t commits = NUM_OF_COMMITTERS * COMMITS_PER_COMMITTER;
+    EXPECT_EQ(commits, writer.syncedEntries());
+    EXPECT_EQ(commits * 100, readLog().size());
+    // committers that arrive while a sync is running share the next one
+    EXPECT_TRUE(writer.syncCount() >= 1);
+    EXPECT_TRUE(writer.syncCount() < commits);
+    EXPECT_EQ(0, writer.error());
+}
+
+TEST_F(AriesLogWriterTest, WaitForOwnEntry) {
+    AriesLogWriter writer(LOG_FILE_NAME);
+    appendEntries(writer, 0, 10);
+    std::string data = entry(10);
+    int64_t mine = writer.append(data.data(), data.size());
+    EXPECT_EQ(11, mine);
+    EXPECT_TRUE(writer.waitForSync(mine));
+    EXPECT_TRUE(writer.syncedEntries() >= mine);
+    EXPECT_EQ(0, writer.error());
+}
+
+TEST_F(AriesLogWriterTest, FlushWithNothingPending) {
+    AriesLogWriter writer(LOG_FILE_NAME);
+    writer.flush();
+    EXPECT_EQ(0, writer.syncedEntries());
+    EXPECT_EQ(0, writer.syncCount());
+
+    writer.append("", 0);
+    writer.flush();
+    EXPECT_EQ(0, writer.syncedEntries());
+    EXPECT_TRUE(readLog().empty());
+}
+
+TEST_F(AriesLogWriterTest, CloseDrainsPendingEntries) {
+    std::string expected;
+    {
+        AriesLogWriter writer(LOG_FILE_NAME);
+        expected = appendEntries(writer, 0, 200);
+    }
+    EXPECT_TRUE(readLog() == expected);
+
+    // a new writer appends after what is already there
+    {
+        AriesLogWriter writer(LOG_FILE_NAME);
+        expected += appendEntries(writer, 200, 300);
+    }
+    EXPECT_TRUE(readLog() == expected);
+}
+
+TEST_F(AriesLogWriterTest, BadPath) {
+    AriesLogWriter writer("/nonexistent/directory/aries.log");
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(ENOENT, writer.error());
+    EXPECT_EQ(-1, writer.append("abc", 3));
+    EXPECT_FALSE(writer.flush());
+    EXPECT_EQ(0, writer.syncedEntries());
+}
+
+TEST_F(AriesLogWriterTest, FailedWriteIsSticky) {
+    // every write to /dev/full fails with ENOSPC
+    AriesLogWriter writer("/dev/full");
+    ASSERT_TRUE(writer.isOpen());
+    int64_t first = writer.append("abc", 3);
+    EXPECT_EQ(1, first);
+    EXPECT_FALSE(writer.waitForSync(first));
+    EXPECT_EQ(0, writer.syncedEntries());
+    EXPECT_EQ(ENOSPC, writer.error());
+
+    EXPECT_EQ(-1, writer.append("def", 3));
+    EXPECT_FALSE(writer.flush());
+    EXPECT_EQ(0, writer.syncCount());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
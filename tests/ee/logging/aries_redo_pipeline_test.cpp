@@ -0,0 +1,191 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "common/RedoUndoQuantum.hpp"
+#include "common/SerializableEEException.h"
+#include "logging/AriesRedoPipeline.h"
+#include <set>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace voltdb;
+
+static const int KEYS = 8;
+
+/** Records the order tasks for one key were applied in */
+class AppendTask : public AriesRedoTask {
+public:
+    AppendTask(std::vector<int> *applied, int sequence, bool slow) :
+        m_applied(applied), m_sequence(sequence), m_slow(slow) {}
+
+    void apply() {
+        if (m_slow) {
+            usleep(100);
+        }
+        m_applied->push_back(m_sequence);
+    }
+
+private:
+    std::vector<int> *m_applied;
+    int m_sequence;
+    bool m_slow;
+};
+
+class FailingTask : public AriesRedoTask {
+public:
+    void apply() {
+        throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, "bad record");
+    }
+};
+
+/** Notes which pool the undo quantum hands the applying thread */
+class PoolTask : public AriesRedoTask {
+public:
+    PoolTask(UndoQuantum *quantum, std::set<Pool*> *pools) :
+        m_quantum(quantum), m_pools(pools) {}
+
+    void apply() {
+        m_pools->insert(m_quantum->getDataPool());
+    }
+
+private:
+    UndoQuantum *m_quantum;
+    std::set<Pool*> *m_pools;
+};
+
+class AriesRedoPipelineTest : public Test {
+public:
+    AriesRedoPipelineTest() : m_applied(KEYS) {}
+
+protected:
+    /** Dispatch count tasks spread over the keys, each key on its own lane */
+    void dispatch(AriesRedoPipeline &pipeline, int count, bool slow) {
+        for (int ii = 0; ii < count; ii++) {
+            int key = ii % KEYS;
+            int lane = pipeline.laneFor(&m_applied[key]);
+            EXPECT_TRUE(pipeline.dispatch(lane, new AppendTask(&m_applied[key], ii, slow)));
+        }
+    }
+
+    /** Every key saw all of its tasks, in dispatch order */
+    void expectApplied(int count) {
+        for (int key = 0; key < KEYS; key++) {
+            std::vector<int> &applied = m_applied[key];
+            EXPECT_EQ((count - key + KEYS - 1) / KEYS, static_cast<int>(applied.size()));
+            for (int ii = 0; ii < applied.size(); ii++) {
+                ASSERT_EQ(key + ii * KEYS, applied[ii]);
+            }
+        }
+    }
+
+    std::vector<std::vector<int> > m_applied;
+};
+
+TEST_F(AriesRedoPipelineTest, LanesAreStickyPerKey) {
+    AriesRedoPipeline pipeline(3);
+    EXPECT_EQ(3, pipeline.laneCount());
+    std::vector<int> lanes;
+    for (int key = 0; key < KEYS; key++) {
+        lanes.push_back(pipeline.laneFor(&m_applied[key]));
+    }
+    for (int key = 0; key < KEYS; key++) {
+        EXPECT_EQ(lanes[key], pipeline.laneFor(&m_applied[key]));
+        EXPECT_EQ(key % 3, lanes[key]);
+    }
+}
+
+TEST_F(AriesRedoPipelineTest, KeepsLogOrderPerKey) {
+    const int count = 50000;
+    AriesRedoPipeline pipeline(4);
+    dispatch(pipeline, count, false);
+    EXPECT_TRUE(pipeline.barrier());
+    EXPECT_EQ(count, pipeline.appliedTasks());
+    expectApplied(count);
+}
+
+TEST_F(AriesRedoPipelineTest, BarrierWaitsForSlowLanes) {
+    const int count = 400;
+    AriesRedoPipeline pipeline(2);
+    dispatch(pipeline, count, true);
+    EXPECT_TRUE(pipeline.barrier());
+    expectApplied(count);
+
+    // the lanes keep working after a barrier
+    dispatch(pipeline, count, false);
+    EXPECT_TRUE(pipeline.barrier());
+    EXPECT_EQ(2 * count, pipeline.appliedTasks());
+}
+
+TEST_F(AriesRedoPipelineTest, DestructorDrainsLanes) {
+    const int count = 200;
+    {
+        AriesRedoPipeline pipeline(3);
+        dispatch(pipeline, count, true);
+    }
+    expectApplied(count);
+}
+
+TEST_F(AriesRedoPipelineTest, FailureStopsRedo) {
+    AriesRedoPipeline pipeline(2);
+    EXPECT_FALSE(pipeline.failed());
+    pipeline.dispatch(0, new FailingTask());
+    EXPECT_FALSE(pipeline.barrier());
+    EXPECT_TRUE(pipeline.failed());
+    EXPECT_EQ(std::string("bad record"), pipeline.failure());
+
+    // later work is dropped rather than applied
+    EXPECT_FALSE(pipeline.dispatch(1, new AppendTask(&m_applied[0], 0, false)));
+    EXPECT_FALSE(pipeline.barrier());
+    EXPECT_EQ(0, m_applied[0].size());
+    EXPECT_EQ(0, pipeline.appliedTasks());
+}
+
+TEST_F(AriesRedoPipelineTest, UndoPoolPerThread) {
+    RedoUndoQuantum quantum;
+    EXPECT_TRUE(quantum.isDummy());
+    std::vector<std::set<Pool*> > pools(3);
+    {
+        AriesRedoPipeline pipeline(3);
+        for (int ii = 0; ii < 300; ii++) {
+            pipeline.dispatch(ii % 3, new PoolTask(&quantum, &pools[ii % 3]));
+        }
+        EXPECT_TRUE(pipeline.barrier());
+    }
+
+    // one pool per lane thread, none shared, and another for this thread
+    std::set<Pool*> all;
+    for (int lane = 0; lane < 3; lane++) {
+        EXPECT_EQ(1, pools[lane].size());
+        all.insert(pools[lane].begin(), pools[lane].end());
+    }
+    EXPECT_EQ(3, all.size());
+    Pool *mine = quantum.getDataPool();
+    EXPECT_TRUE(mine != NULL);
+    EXPECT_EQ(0, all.count(mine));
+    EXPECT_TRUE(mine == quantum.getDataPool());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
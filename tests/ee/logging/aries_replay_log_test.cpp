@@ -0,0 +1,112 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2010 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "harness.h"
+#include "logging/AriesReplayLog.h"
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+
+using voltdb::AriesReplayLog;
+
+static const char *LOG_FILE_NAME = "aries_replay_log_test.log";
+
+class AriesReplayLogTest : public Test {
+public:
+    AriesReplayLogTest() {
+        unlink(LOG_FILE_NAME);
+    }
+
+    ~AriesReplayLogTest() {
+        unlink(LOG_FILE_NAME);
+    }
+
+    /** Write a log of the given size whose every byte depends on its offset */
+    std::string writeLog(size_t size) {
+        std::string contents(size, '\0');
+        for (size_t ii = 0; ii < size; ii++) {
+            contents[ii] = static_cast<char>((ii * 7 + ii / 4096) % 251);
+        }
+        std::ofstream out(LOG_FILE_NAME, std::ios::out | std::ios::binary);
+        out.write(contents.data(), contents.size());
+        return contents;
+    }
+};
+
+TEST_F(AriesReplayLogTest, MapsWholeLog) {
+    std::string contents = writeLog(3 * 1024 * 1024 + 17);
+    int64_t length = -1;
+    char *data = AriesReplayLog::map(LOG_FILE_NAME, &length);
+    ASSERT_TRUE(data != NULL);
+    EXPECT_EQ(static_cast<int64_t>(contents.size()), length);
+    EXPECT_EQ(0, memcmp(data, contents.data(), contents.size()));
+    AriesReplayLog::unmap(data);
+}
+
+TEST_F(AriesReplayLogTest, ReleasedPagesReadBack) {
+    std::string contents = writeLog(1024 * 1024);
+    int64_t length = 0;
+    char *data = AriesReplayLog::map(LOG_FILE_NAME, &length);
+    ASSERT_TRUE(data != NULL);
+
+    // releases stop at the page holding the current position
+    const char *next = AriesReplayLog::release(data, data, data + 100);
+    EXPECT_TRUE(next == data);
+    next = AriesReplayLog::release(data, next, data + 300000);
+    EXPECT_TRUE(next > data && next <= data + 300000);
+    EXPECT_EQ(0, (next - data) % sysconf(_SC_PAGESIZE));
+    const char *last = AriesReplayLog::release(data, next, data + length);
+    EXPECT_TRUE(last >= next && last <= data + length);
+
+    // handing pages back does not lose anything
+    EXPECT_EQ(0, memcmp(data, contents.data(), contents.size()));
+    AriesReplayLog::unmap(data);
+}
+
+TEST_F(AriesReplayLogTest, ReleaseIgnoresOtherBuffers) {
+    size_t size = 256 * 1024;
+    char *buffer = new char[size];
+    memset(buffer, 'x', size);
+    const char *next = AriesReplayLog::release(buffer, buffer, buffer + size);
+    EXPECT_TRUE(next == buffer);
+    for (size_t ii = 0; ii < size; ii++) {
+        ASSERT_EQ('x', buffer[ii]);
+    }
+    delete[] buffer;
+}
+
+TEST_F(AriesReplayLogTest, MissingOrEmptyLog) {
+    int64_t length = -1;
+    EXPECT_TRUE(AriesReplayLog::map(LOG_FILE_NAME, &length) == NULL);
+    EXPECT_EQ(0, length);
+
+    writeLog(0);
+    length = -1;
+    EXPECT_TRUE(AriesReplayLog::map(LOG_FILE_NAME, &length) == NULL);
+    EXPECT_EQ(0, length);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
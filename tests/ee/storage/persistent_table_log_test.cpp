@@ -110,7 +110,9 @@ public:
     ~PersistentTableLogTest() {
         delete m_engine;
         delete m_table;
-        voltdb::TupleSchema::freeTupleSchema(m_primaryKeyIndexSchema);
+        if (m_primaryKeyIndexSchema != NULL) {
+            voltdb::TupleSchema::freeTupleSchema(m_primaryKeyIndexSchema);
+        }
     }
 
     void initTable(bool allowInlineStrings) {
@@ -141,6 +143,26 @@ public:
 
 
 
+    /*
+     * A stream without indexes, the kind of table whose deleteAllTuples()
+     * drops whole blocks.
+     */
+    void initStreamTable(bool allowInlineStrings) {
+        m_tableSchema = voltdb::TupleSchema::createTupleSchema(m_tableSchemaTypes,
+                                                               m_tableSchemaColumnSizes,
+                                                               m_tableSchemaAllowNull,
+                                                               allowInlineStrings);
+        m_primaryKeyIndexSchema = NULL;
+
+        std::vector<voltdb::TableIndexScheme> indexes;
+
+        m_table = dynamic_cast<voltdb::PersistentTable*>(voltdb::TableFactory::getPersistentTable
+                                                         (0, m_engine->getExecutorContext(), "FooStream",
+                                                          m_tableSchema, &m_columnNames[0], indexes, 0,
+                                                          false, false));
+        m_table->setIsStream(true);
+    }
+
     voltdb::VoltDBEngine *m_engine;
     voltdb::TupleSchema *m_tableSchema;
     voltdb::TupleSchema *m_primaryKeyIndexSchema;
@@ -243,6 +265,42 @@ TEST_F(PersistentTableLogTest, InsertThenUndoInsertsOneTest) {
     ASSERT_EQ( m_table->activeTupleCount(), 0);
 }
 
+TEST_F(PersistentTableLogTest, TruncateStreamThenUndoTest) {
+    initStreamTable(false);
+    tableutil::addRandomTuples(m_table, 1000);
+    ASSERT_EQ(1000, m_table->activeTupleCount());
+    voltdb::TableTuple tuple(m_tableSchema);
+    tableutil::getRandomTuple(m_table, tuple);
+    voltdb::TableTuple tupleBackup(m_tableSchema);
+    tupleBackup.move(new char[tupleBackup.tupleLength()]);
+    tupleBackup.copyForPersistentInsert(tuple);
+
+    m_engine->setUndoToken(INT64_MIN + 2);
+    // make the executor context pick up the new undo quantum
+    m_engine->getExecutorContext();
+    m_table->deleteAllTuples(true);
+    ASSERT_EQ(0, m_table->activeTupleCount());
+    ASSERT_TRUE(m_table->lookupTuple(tupleBackup).isNullTuple());
+
+    // tuples inserted after the truncate land in fresh blocks
+    tableutil::addRandomTuples(m_table, 10);
+    ASSERT_EQ(10, m_table->activeTupleCount());
+
+    m_engine->undoUndoToken(INT64_MIN + 2);
+    ASSERT_EQ(1000, m_table->activeTupleCount());
+    ASSERT_FALSE(m_table->lookupTuple(tupleBackup).isNullTuple());
+
+    m_engine->setUndoToken(INT64_MIN + 3);
+    m_engine->getExecutorContext();
+    m_table->deleteAllTuples(true);
+    m_engine->releaseUndoToken(INT64_MIN + 3);
+    ASSERT_EQ(0, m_table->activeTupleCount());
+    ASSERT_EQ(0, m_table->allocatedTupleCount());
+
+    tupleBackup.freeObjectColumns();
+    delete [] tupleBackup.address();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
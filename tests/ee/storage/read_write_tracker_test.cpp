@@ -0,0 +1,212 @@
+/* Copyright (C) 2013 by H-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Yale University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "storage/ReadWriteTracker.h"
+#include "storage/table.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 20000
+
+class ReadWriteTrackerTest : public Test {
+public:
+    ReadWriteTrackerTest() : m_manager(NULL) {
+        m_tables[0] = createTable("TABLE_A", 0);
+        m_tables[1] = createTable("TABLE_B", 1);
+    }
+
+    ~ReadWriteTrackerTest() {
+        delete m_tables[0];
+        delete m_tables[1];
+    }
+
+protected:
+    static Table* createTable(std::string name, int32_t relativeIndex) {
+        std::vector<ValueType> columnTypes(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> columnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> columnAllowNull(2, false);
+        std::string columnNames[2] = { "ID", "VALUE" };
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        TempTable *table = TableFactory::getTempTable(1000, name, schema, columnNames, NULL);
+        for (int ii = 0; ii < NUM_OF_TUPLES; ii++) {
+            TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(ii * 3));
+            table->insertTuple(tuple);
+        }
+        table->setRelativeIndex(relativeIndex);
+        return table;
+    }
+
+    /** Marks every step-th tuple of the table, in scan order */
+    static void mark(ReadWriteTracker &tracker, Table *table, int step, bool write) {
+        TableIterator iter(table);
+        TableTuple tuple(table->schema());
+        for (int ii = 0; iter.next(tuple); ii++) {
+            if (ii % step == 0) {
+                if (write)
+                    tracker.markTupleWritten(table, &tuple);
+                else
+                    tracker.markTupleRead(table, &tuple);
+            }
+        }
+    }
+
+    /** The TUPLE_IDs that the manager reports for table */
+    static std::vector<int32_t> tupleIds(Table *result, std::string table) {
+        std::vector<int32_t> ids;
+        TableIterator iter(result);
+        TableTuple tuple(result->schema());
+        while (iter.next(tuple)) {
+            NValue name = tuple.getNValue(0);
+            if (std::string(static_cast<char*>(ValuePeeker::peekObjectValue(name)),
+                            ValuePeeker::peekObjectLength(name)) == table) {
+                ids.push_back(ValuePeeker::peekInteger(tuple.getNValue(1)));
+            }
+        }
+        return ids;
+    }
+
+    Table *m_tables[2];
+    ReadWriteTrackerManager m_manager;
+};
+
+TEST_F(ReadWriteTrackerTest, RowOffsets) {
+    ReadWriteTracker *tracker = m_manager.enableTracking(1);
+    mark(*tracker, m_tables[0], 7, false);
+    mark(*tracker, m_tables[1], 1000, true);
+    // marking twice changes nothing
+    mark(*tracker, m_tables[0], 7, false);
+
+    std::vector<int32_t> reads = tupleIds(m_manager.getTuplesRead(tracker), "TABLE_A");
+    ASSERT_EQ((NUM_OF_TUPLES + 6) / 7, reads.size());
+    for (int ii = 0; ii < reads.size(); ii++) {
+        EXPECT_EQ(ii * 7, reads[ii]);
+    }
+    EXPECT_TRUE(tupleIds(m_manager.getTuplesRead(tracker), "TABLE_B").empty());
+    std::vector<int32_t> writes = tupleIds(m_manager.getTuplesWritten(tracker), "TABLE_B");
+    ASSERT_EQ(NUM_OF_TUPLES / 1000, writes.size());
+    EXPECT_EQ(19000, writes.back());
+
+    ASSERT_EQ(1, tracker->getTablesRead().size());
+    EXPECT_EQ("TABLE_A", tracker->getTablesRead()[0]);
+    ASSERT_EQ(1, tracker->getTablesWritten().size());
+    EXPECT_EQ("TABLE_B", tracker->getTablesWritten()[0]);
+
+    tracker->clear();
+    EXPECT_TRUE(tracker->getTablesRead().empty());
+    m_manager.removeTracker(1);
+}
+
+TEST_F(ReadWriteTrackerTest, BlockGranularity) {
+    ASSERT_TRUE(m_tables[0]->allocatedBlockCount() > 1);
+    m_manager.setBlockGranularity(true);
+    ReadWriteTracker *tracker = m_manager.enableTracking(1);
+    mark(*tracker, m_tables[0], 1, false);
+
+    std::vector<int32_t> blocks = tupleIds(m_manager.getTuplesRead(tracker), "TABLE_A");
+    ASSERT_EQ(m_tables[0]->allocatedBlockCount(), blocks.size());
+    for (int ii = 0; ii < blocks.size(); ii++) {
+        EXPECT_EQ(ii, blocks[ii]);
+    }
+    m_manager.removeTracker(1);
+}
+
+TEST_F(ReadWriteTrackerTest, Conflicts) {
+    ReadWriteTracker first(1);
+    ReadWriteTracker second(2);
+    mark(first, m_tables[0], 2, false);
+    mark(second, m_tables[0], 3, false);
+    // reads never conflict
+    EXPECT_FALSE(first.conflictsWith(second));
+
+    // writes to a table the other one did not touch
+    mark(second, m_tables[1], 5, true);
+    EXPECT_FALSE(first.conflictsWith(second));
+
+    // the other one read every third row of TABLE_A, row 0 among them
+    mark(first, m_tables[0], NUM_OF_TUPLES, true);
+    EXPECT_TRUE(first.conflictsWith(second));
+    EXPECT_TRUE(second.conflictsWith(first));
+}
+
+TEST_F(ReadWriteTrackerTest, SparseRows) {
+    RowSet rows;
+    EXPECT_TRUE(rows.empty());
+    uint32_t members[4] = { 5, 4095, 4096, 40000000 };
+    for (int ii = 3; ii >= 0; ii--) {
+        rows.insert(members[ii]);
+    }
+    EXPECT_FALSE(rows.empty());
+    EXPECT_TRUE(rows.contains(40000000));
+    EXPECT_FALSE(rows.contains(39999999));
+    EXPECT_FALSE(rows.contains(20000000));
+
+    std::vector<uint32_t> offsets;
+    rows.offsets(offsets);
+    ASSERT_EQ(4, offsets.size());
+    for (int ii = 0; ii < 4; ii++) {
+        EXPECT_EQ(members[ii], offsets[ii]);
+    }
+
+    RowSet other;
+    other.insert(20000000);
+    EXPECT_FALSE(rows.intersects(other));
+    other.insert(4096);
+    EXPECT_TRUE(rows.intersects(other));
+    EXPECT_TRUE(other.intersects(rows));
+
+    rows.clear();
+    EXPECT_TRUE(rows.empty());
+    EXPECT_FALSE(rows.intersects(other));
+}
+
+TEST_F(ReadWriteTrackerTest, ManagerConflicts) {
+    mark(*m_manager.enableTracking(1), m_tables[0], 10, true);
+    mark(*m_manager.enableTracking(2), m_tables[0], 15, false);
+    EXPECT_TRUE(m_manager.conflicts(1, 2));
+    // untracked txns never conflict
+    EXPECT_FALSE(m_manager.conflicts(1, 3));
+    m_manager.removeTracker(2);
+    EXPECT_FALSE(m_manager.conflicts(1, 2));
+    m_manager.removeTracker(1);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,135 @@
+/* Copyright (C) 2014 by S-Store Project
+ * Brown University
+ * Massachusetts Institute of Technology
+ * Portland State University
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "harness.h"
+#include "common/common.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "execution/VoltDBEngine.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/tableutil.h"
+
+using namespace voltdb;
+
+#define NUM_OF_TUPLES 200000
+#define NUM_OF_DELETES 30000
+
+class TableIteratorTest : public Test {
+public:
+    TableIteratorTest() {
+        srand(0);
+        m_engine = new VoltDBEngine();
+        m_engine->initialize(1, 1, 0, 0, "");
+        m_engine->setUndoToken(1);
+        m_engine->getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0);
+
+        std::vector<ValueType> columnTypes(2, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> columnLengths(2, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> columnAllowNull(2, false);
+        std::string columnNames[2] = { "ID", "VALUE" };
+        TupleSchema *schema = TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                             columnAllowNull, true);
+        m_table = TableFactory::getPersistentTable(0, m_engine->getExecutorContext(), "Foo",
+                                                   schema, columnNames, -1, false, false);
+        TableTuple &tuple = m_table->tempTuple();
+        for (int ii = 0; ii < NUM_OF_TUPLES; ii++) {
+            tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(rand()));
+            m_table->insertTuple(tuple);
+        }
+    }
+
+    ~TableIteratorTest() {
+        delete m_engine;
+        delete m_table;
+    }
+
+protected:
+    /** The addresses of the active tuples, in the order next() finds them */
+    std::vector<char*> scan() {
+        std::vector<char*> addresses;
+        TableIterator iterator(m_table);
+        TableTuple tuple(m_table->schema());
+        while (iterator.next(tuple)) {
+            addresses.push_back(tuple.address());
+        }
+        return addresses;
+    }
+
+    VoltDBEngine *m_engine;
+    Table *m_table;
+};
+
+TEST_F(TableIteratorTest, NextBatch) {
+    // leave deleted slots scattered through the blocks
+    ASSERT_TRUE(m_table->allocatedBlockCount() > 1);
+    TableTuple tuple(m_table->schema());
+    for (int ii = 0; ii < NUM_OF_DELETES; ii++) {
+        if (tableutil::getRandomTuple(m_table, tuple)) {
+            m_table->deleteTuple(tuple, true);
+        }
+    }
+
+    std::vector<char*> expected = scan();
+    ASSERT_TRUE(expected.size() < NUM_OF_TUPLES);
+    ASSERT_EQ(m_table->activeTupleCount(), expected.size());
+
+    // batch sizes that do and do not line up with the blocks
+    const int batchSizes[] = { 1, 37, 1024, 1000000 };
+    for (int scanAllBlocks = 0; scanAllBlocks < 2; scanAllBlocks++) {
+        for (int ii = 0; ii < 4; ii++) {
+            std::vector<char*> batch(batchSizes[ii]);
+            std::vector<char*> actual;
+            TableIterator batchIterator(m_table, scanAllBlocks == 1);
+            int count;
+            while ((count = batchIterator.nextBatch(&batch[0], batchSizes[ii])) > 0) {
+                ASSERT_TRUE(count <= batchSizes[ii]);
+                actual.insert(actual.end(), batch.begin(), batch.begin() + count);
+            }
+            ASSERT_EQ(expected.size(), actual.size());
+            ASSERT_TRUE(expected == actual);
+        }
+    }
+}
+
+TEST_F(TableIteratorTest, NextBatchOfEmptyTable) {
+    m_table->deleteAllTuples(true);
+    char *batch[16];
+    TableIterator iterator(m_table);
+    EXPECT_EQ(0, iterator.nextBatch(batch, 16));
+    TableIterator allBlocks(m_table, true);
+    EXPECT_EQ(0, allBlocks.nextBatch(batch, 16));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
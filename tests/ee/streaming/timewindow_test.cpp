@@ -313,6 +313,42 @@ TEST_F(TimeWindowTest, InsertTupleCount) {
     VOLT_DEBUG("END INSERT TUPLE");
 }
 
+/**
+ * Slide a window many times and verify that after every slide only the
+ * tuples of the current window remain and the expired ones are gone.
+ */
+TEST_F(TimeWindowTest, SlideExpiry) {
+    VOLT_DEBUG("SLIDE EXPIRY");
+    int wSize = 10;
+    int wSlide = 2;
+    int iterationCount = 100;
+    createWindow(wSize, wSlide);
+    for (int i = 0; i < iterationCount; i++)
+    {
+        assert(tableutil::addRandomTuplesFixedColumn(this->table, NUM_OF_TUPLES, TS_COL, ValueFactory::getIntegerValue(i)));
+        if (i < wSize)
+        {
+            continue;
+        }
+        ASSERT_EQ(wSize * NUM_OF_TUPLES, this->window_table->activeTupleCount());
+        int32_t minTS = INT32_MAX;
+        int32_t maxTS = INT32_MIN;
+        voltdb::TableIterator iterator = this->table->tableIterator();
+        voltdb::TableTuple tuple(table->schema());
+        while (iterator.next(tuple)) {
+            int32_t ts = ValuePeeker::peekAsInteger(tuple.getNValue(TS_COL));
+            minTS = std::min(minTS, ts);
+            maxTS = std::max(maxTS, ts);
+        }
+        ASSERT_EQ(wSize - 1, maxTS - minTS);
+        // the newest tuples sit in the stage until the next slide
+        ASSERT_TRUE(maxTS < i);
+        ASSERT_TRUE(i - maxTS <= wSlide);
+    }
+    table->deleteAllTuples(true);
+    VOLT_DEBUG("END SLIDE EXPIRY");
+}
+
 /**
  * Verify that the tuple contains the same data type specify in the schema.
  */ 
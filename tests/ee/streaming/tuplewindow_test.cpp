@@ -49,6 +49,8 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include "harness.h"
@@ -66,6 +68,7 @@
 #include "storage/tableiterator.h"
 #include "storage/tableutil.h"
 #include "streaming/TupleWindow.h"
+#include "streaming/WindowAggregate.h"
 #include "execution/VoltDBEngine.h"
 
 using std::string;
@@ -82,6 +85,7 @@ using namespace voltdb;
 
 #define WS_COL 1
 #define WE_COL 2
+#define WIDE_COLUMNS 500
 #define USEC 0.000001
 
 voltdb::ValueType COLUMN_TYPES[NUM_OF_COLUMNS] = { voltdb::VALUE_TYPE_INTEGER,
@@ -170,6 +174,49 @@ protected:
 		VOLT_DEBUG("END CREATE WINDOW");
 	}
 
+	/** ID, WSTART, WEND and WIDE_COLUMNS BIGINTs, so that a block holds few tuples */
+	void createWideWindow(int32_t size, int32_t slide) {
+		std::string *columnNames = new std::string[3 + WIDE_COLUMNS];
+		columnNames[TEST_ID_COL] = "ID";
+		columnNames[WS_COL] = "WSTART";
+		columnNames[WE_COL] = "WEND";
+		std::vector<voltdb::ValueType> columnTypes(3, voltdb::VALUE_TYPE_INTEGER);
+		columnTypes.resize(3 + WIDE_COLUMNS, voltdb::VALUE_TYPE_BIGINT);
+		std::vector<int32_t> columnLengths;
+		for (int ctr = 0; ctr < columnTypes.size(); ctr++) {
+			if (ctr >= 3) {
+				char buffer[32];
+				snprintf(buffer, 32, "column%03d", ctr);
+				columnNames[ctr] = buffer;
+			}
+			columnLengths.push_back(NValue::getTupleStorageSize(columnTypes[ctr]));
+		}
+		std::vector<bool> columnAllowNull(columnTypes.size(), true);
+		voltdb::TupleSchema *schema = voltdb::TupleSchema::createTupleSchema(
+				columnTypes, columnLengths, columnAllowNull, true);
+
+		table = voltdb::TableFactory::getWindowTable(1000,
+				m_engine->getExecutorContext(), "wide_table", schema,
+				columnNames, -1, false, false, size, slide, TUPLE_WINDOW,
+				GROUP_BY_NONE);
+		window_table = dynamic_cast<TupleWindow*>(table);
+	}
+
+	/** Lowest and highest ID and the sum of column 3 over the active window */
+	void scanWindow(int32_t &oldest, int32_t &newest, int64_t &total) {
+		oldest = INT32_MAX;
+		newest = INT32_MIN;
+		total = 0;
+		voltdb::TableIterator iterator = this->table->tableIterator();
+		voltdb::TableTuple tuple(table->schema());
+		while (iterator.next(tuple)) {
+			int32_t id = ValuePeeker::peekAsInteger(tuple.getNValue(TEST_ID_COL));
+			oldest = std::min(oldest, id);
+			newest = std::max(newest, id);
+			total += ValuePeeker::peekBigInt(tuple.getNValue(3));
+		}
+	}
+
 };
 
 /** Print time value to cout with endl */
@@ -211,6 +258,27 @@ TEST_F(TupleWindowTest, ValueTypesGroupByCol7) {
 	VOLT_DEBUG("END VALUE TYPES");
 }
 
+/**
+ * Test that every group key gets exactly one entry in the key table and
+ * that each group maintains its own window.
+ */
+TEST_F(TupleWindowTest, GroupByKeyCount) {
+	VOLT_DEBUG("GROUP BY KEY COUNT");
+	int numKeys = 50;
+	int wSize = 2;
+	createWindow(wSize, 1, 6);
+	for (int round = 0; round < 4; round++) {
+		for (int key = 0; key < numKeys; key++) {
+			assert(
+					tableutil::addRandomTuplesFixedColumn(this->table, 1, TEST_ID_COL, ValueFactory::getIntegerValue(round * numKeys + key), 6, ValueFactory::getIntegerValue(key)));
+		}
+		ASSERT_EQ(numKeys, this->window_table->getKeyActiveTupleCount());
+	}
+	ASSERT_EQ(numKeys * wSize, this->window_table->activeTupleCount());
+	ASSERT_EQ(0, this->window_table->getStageActiveTupleCount());
+	VOLT_DEBUG("END GROUP BY KEY COUNT");
+}
+
 /**
  * Verify that the tuple contains the same data type specify in the schema.
  */
@@ -324,6 +392,127 @@ TEST_F(TupleWindowTest, InsertPerformance) {
 	VOLT_DEBUG("END INSERT PERFORMANCE");
 }
 
+/**
+ * Aggregates registered with the window must always match a full
+ * recomputation over the active tuples while the window slides.
+ */
+TEST_F(TupleWindowTest, IncrementalAggregates) {
+	VOLT_DEBUG("INCREMENTAL AGGREGATES");
+	// running sums are only kept for exact types
+	EXPECT_TRUE(WindowAggregate::supports(EXPRESSION_TYPE_AGGREGATE_SUM, VALUE_TYPE_BIGINT));
+	EXPECT_TRUE(WindowAggregate::supports(EXPRESSION_TYPE_AGGREGATE_AVG, VALUE_TYPE_DECIMAL));
+	EXPECT_FALSE(WindowAggregate::supports(EXPRESSION_TYPE_AGGREGATE_SUM, VALUE_TYPE_DOUBLE));
+	EXPECT_FALSE(WindowAggregate::supports(EXPRESSION_TYPE_AGGREGATE_AVG, VALUE_TYPE_DOUBLE));
+	EXPECT_TRUE(WindowAggregate::supports(EXPRESSION_TYPE_AGGREGATE_MAX, VALUE_TYPE_DOUBLE));
+	int groupByIndexes[] = { GROUP_BY_NONE, 6 };
+	for (int g = 0; g < 2; g++) {
+		delete table;
+		createWindow(5, 2, groupByIndexes[g]);
+		int countStar = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR, 0);
+		int sum = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_SUM, 3);
+		int max = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_MAX, 3);
+		int min = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_MIN, 4);
+		int avg = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_AVG, 5);
+		ASSERT_EQ(sum, window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_SUM, 3));
+		ASSERT_EQ(5, window_table->aggregateCount());
+		EXPECT_TRUE(window_table->aggregateResult(sum).isNull());
+
+		for (int i = 0; i < 40; i++) {
+			assert(
+					tableutil::addRandomTuplesFixedColumn(this->table, 1, TEST_ID_COL, ValueFactory::getIntegerValue(i), 6, ValueFactory::getIntegerValue(i % 3)));
+			int64_t count = 0;
+			int64_t total = 0;
+			int64_t largest = INT64_MIN;
+			int8_t smallest = INT8_MAX;
+			int64_t avgTotal = 0;
+			voltdb::TableIterator iterator = this->table->tableIterator();
+			voltdb::TableTuple tuple(table->schema());
+			while (iterator.next(tuple)) {
+				int64_t value = ValuePeeker::peekBigInt(tuple.getNValue(3));
+				int8_t tiny = ValuePeeker::peekTinyInt(tuple.getNValue(4));
+				count++;
+				total += value;
+				largest = std::max(largest, value);
+				smallest = std::min(smallest, tiny);
+				avgTotal += ValuePeeker::peekSmallInt(tuple.getNValue(5));
+			}
+			ASSERT_EQ(count, ValuePeeker::peekBigInt(window_table->aggregateResult(countStar)));
+			if (count == 0) {
+				EXPECT_TRUE(window_table->aggregateResult(max).isNull());
+				continue;
+			}
+			ASSERT_EQ(total, ValuePeeker::peekBigInt(window_table->aggregateResult(sum)));
+			ASSERT_EQ(largest, ValuePeeker::peekBigInt(window_table->aggregateResult(max)));
+			ASSERT_EQ(smallest, ValuePeeker::peekTinyInt(window_table->aggregateResult(min)));
+			double average = ValuePeeker::peekDouble(window_table->aggregateResult(avg));
+			ASSERT_TRUE(fabs(average - (double)avgTotal / (double)count) < 0.000001);
+		}
+
+		// a rebuild from the window gives the same answer
+		int64_t maintained = ValuePeeker::peekBigInt(window_table->aggregateResult(sum));
+		window_table->invalidateAggregates();
+		EXPECT_EQ(maintained, ValuePeeker::peekBigInt(window_table->aggregateResult(sum)));
+
+		table->deleteAllTuples(true);
+		EXPECT_EQ(0, ValuePeeker::peekBigInt(window_table->aggregateResult(countStar)));
+		EXPECT_TRUE(window_table->aggregateResult(sum).isNull());
+		EXPECT_TRUE(window_table->aggregateResult(min).isNull());
+	}
+	VOLT_DEBUG("END INCREMENTAL AGGREGATES");
+}
+
+/**
+ * A slide that expires whole blocks at the head of an ungrouped window
+ * hands them over in one undo action, and rolling it back restores them.
+ */
+TEST_F(TupleWindowTest, ExpireHeadBlocks) {
+	VOLT_DEBUG("EXPIRE HEAD BLOCKS");
+	// one tuple allocates the first block
+	createWideWindow(1, 1);
+	m_engine->setUndoToken(INT64_MIN + 1);
+	m_engine->getExecutorContext();
+	assert(tableutil::addRandomTuplesFixedColumn(this->table, 1, TEST_ID_COL, ValueFactory::getIntegerValue(0)));
+	m_engine->releaseUndoToken(INT64_MIN + 1);
+	const int perBlock = static_cast<int>(this->table->allocatedTupleCount());
+	delete table;
+
+	// every slide expires exactly the oldest block
+	createWideWindow(2 * perBlock, perBlock);
+	int countStar = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR, 0);
+	int sum = window_table->registerAggregate(EXPRESSION_TYPE_AGGREGATE_SUM, 3);
+	int nextId = 0;
+	int32_t oldest, newest;
+	int64_t total;
+	for (int token = 2; token <= 4; token++) {
+		m_engine->setUndoToken(INT64_MIN + token);
+		m_engine->getExecutorContext();
+		int count = token == 2 ? 2 * perBlock : perBlock;
+		for (int i = 0; i < count; i++) {
+			assert(tableutil::addRandomTuplesFixedColumn(this->table, 1, TEST_ID_COL, ValueFactory::getIntegerValue(nextId++)));
+		}
+		scanWindow(oldest, newest, total);
+		ASSERT_EQ(2 * perBlock, this->table->activeTupleCount());
+		ASSERT_EQ((token - 2) * perBlock, oldest);
+		ASSERT_EQ(nextId - 1, newest);
+		ASSERT_EQ(2, this->table->allocatedBlockCount());
+		ASSERT_EQ(2 * perBlock, ValuePeeker::peekBigInt(window_table->aggregateResult(countStar)));
+		ASSERT_EQ(total, ValuePeeker::peekBigInt(window_table->aggregateResult(sum)));
+		if (token < 4) {
+			m_engine->releaseUndoToken(INT64_MIN + token);
+		}
+	}
+
+	// the last slide goes back to the window of the one before
+	m_engine->undoUndoToken(INT64_MIN + 4);
+	scanWindow(oldest, newest, total);
+	ASSERT_EQ(2 * perBlock, this->table->activeTupleCount());
+	ASSERT_EQ(perBlock, oldest);
+	ASSERT_EQ(3 * perBlock - 1, newest);
+	ASSERT_EQ(2 * perBlock, ValuePeeker::peekBigInt(window_table->aggregateResult(countStar)));
+	ASSERT_EQ(total, ValuePeeker::peekBigInt(window_table->aggregateResult(sum)));
+	VOLT_DEBUG("END EXPIRE HEAD BLOCKS");
+}
+
 int main() {
 	return TestSuite::globalInstance()->runAll();
 }